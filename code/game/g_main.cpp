@@ -173,6 +173,7 @@ cvar_t* g_noFootSlideWalkScale;
 
 cvar_t* g_nav1;
 cvar_t* g_nav2;
+cvar_t* g_navCache;
 cvar_t* g_bobaDebug;
 
 cvar_t* g_delayedShutdown;
@@ -713,6 +714,8 @@ void G_InitCvars()
 
 	g_nav1 = gi.cvar("g_nav1", "", 0);
 	g_nav2 = gi.cvar("g_nav2", "", 0);
+	g_navCache = gi.cvar("g_navCache", "1", 0);
+	//reuse nearest nav points while actors stay on them, and share path searches to a common goal
 
 	g_bobaDebug = gi.cvar("g_bobaDebug", "", 0);
 
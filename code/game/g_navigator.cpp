@@ -67,6 +67,7 @@ extern qboolean G_CheckInSolidTeleport(const vec3_t& teleport_pos, const gentity
 
 extern cvar_t* g_nav1;
 extern cvar_t* g_nav2;
+extern cvar_t* g_navCache;
 extern cvar_t* g_developer;
 extern int delayedShutDown;
 extern vec3_t playerMinsStep;
@@ -87,6 +88,9 @@ extern cvar_t* com_outcast;
 #if !defined(RATL_VECTOR_VS_INC)
 #include "../Ratl/vector_vs.h"
 #endif
+#if !defined(RATL_HEAP_VS_INC)
+#include "../Ratl/heap_vs.h"
+#endif
 #if !defined(RUFL_HSTRING_INC)
 #include "../Rufl/hstring.h"
 #endif
@@ -150,6 +154,13 @@ namespace NAV
 		MIN_WAY_NEIGHBORS = 4,
 		MAX_NONWP_NEIGHBORS = 1,
 
+		EDGE_CORRIDOR = 40,
+		// how far off an edge an actor can drift before we look for a new nearest point
+
+		MAX_GOAL_TREES = 8,
+		GOAL_TREE_LIFE = 1000,
+		// milliseconds a shared reverse search stays good for
+
 		// Human Sized
 		//-------------
 		SC_MEDIUM_RADIUS = 20,
@@ -372,6 +383,38 @@ using TNameToNodeMap = ratl::map_vs<hstring, TNamedNodeList, NAV::NUM_NODES>;
 using TEdgesPerEnt = ratl::vector_vs<NAV::TEdgeHandle, NAV::MAX_EDGES_PER_ENT>;
 using TEntEdgeMap = ratl::map_vs<int, TEdgesPerEnt, NAV::MAX_BLOCKING_ENTS>;
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Goal Tree
+//
+// A search run backwards from a single goal node out to every node that can reach it.
+// Actors headed for the same goal, whose edge costs don't depend on who they are, all
+// read their path straight off the one tree instead of each running their own A*.
+////////////////////////////////////////////////////////////////////////////////////////
+struct SGoalTree
+{
+	int mGoal;
+	int mTraits;
+	int mBuildTime;
+	int mLastUseTime;
+	ratl::bits_vs<NAV::NUM_NODES> mReached;
+	ratl::array_vs<short, NAV::NUM_NODES> mNext; // the next node on the way to mGoal
+};
+
+struct SGoalTreeOpen
+{
+	int mNode;
+	float mCost;
+
+	bool operator <(const SGoalTreeOpen& other) const
+	{
+		return mCost > other.mCost; // cheapest on top of the heap
+	}
+};
+
+using TGoalTrees = ratl::array_vs<SGoalTree, NAV::MAX_GOAL_TREES>;
+using TGoalTreeOpen = ratl::heap_vs<SGoalTreeOpen, NAV::NUM_EDGES * 2>;
+using TGoalTreeCosts = ratl::array_vs<float, NAV::NUM_NODES>;
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // Path Point
 //
@@ -743,6 +786,10 @@ TEntEdgeMap mEntEdgeMap;
 
 TNearestNavSort mNearestNavSort;
 
+TGoalTrees mGoalTrees;
+TGoalTreeOpen mGoalTreeOpen;
+TGoalTreeCosts mGoalTreeCosts;
+
 TPathUsers mPathUsers;
 TPathUserIndex mPathUserIndex;
 SPathUser mPathUserMaster;
@@ -759,6 +806,15 @@ trace_t mViewTrace;
 int mMoveTraceCount = 0;
 int mViewTraceCount = 0;
 int mConnectTraceCount = 0;
+int mNearestQueryCount = 0;
+int mNearestReuseCount = 0;
+int mNearestSearchCount = 0;
+int mNearestTraceCount = 0;
+int mPathSearchCount = 0;
+int mPathSearchVisited = 0;
+int mGoalTreeBuildCount = 0;
+int mGoalTreeShareCount = 0;
+int mGoalTreeVisited = 0;
 int mConnectTime = 0;
 int mIslandCount = 0;
 int mIslandRegion = 0;
@@ -811,6 +867,19 @@ int GetIslandRegion()
 	return mIslandRegion;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Throw Out Every Shared Goal Tree (The Graph Or Its Edges Changed Under Them)
+////////////////////////////////////////////////////////////////////////////////////////
+void ClearGoalTrees()
+{
+	for (int i = 0; i < NAV::MAX_GOAL_TREES; i++)
+	{
+		mGoalTrees[i].mGoal = WAYPOINT_NONE;
+		mGoalTrees[i].mBuildTime = 0;
+		mGoalTrees[i].mLastUseTime = 0;
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // Helper Function : View Trace
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -1167,7 +1236,18 @@ bool NAV::LoadFromFile(const char* filename, int checksum)
 	mIslandRegion = 0;
 	mAirRegion = 0;
 
+	mNearestQueryCount = 0;
+	mNearestReuseCount = 0;
+	mNearestSearchCount = 0;
+	mNearestTraceCount = 0;
+	mPathSearchCount = 0;
+	mPathSearchVisited = 0;
+	mGoalTreeBuildCount = 0;
+	mGoalTreeShareCount = 0;
+	mGoalTreeVisited = 0;
+
 	memset(&mEntityAlertList, 0, sizeof mEntityAlertList);
+	ClearGoalTrees();
 
 #if !defined(FINAL_BUILD)
 	ratl::ratl_base::OutputPrint = stupid_print;
@@ -1467,6 +1547,7 @@ bool NAV::LoadFromEntitiesAndSaveToFile(const char* filename, int checksum)
 		return true;
 	}
 	mUser.ClearActor();
+	ClearGoalTrees();
 
 	mMoveTraceCount = 0;
 	mViewTraceCount = 0;
@@ -2193,6 +2274,7 @@ void NAV::WayEdgesNowClear(gentity_t* ent)
 				}
 			}
 			mEntEdgeMap.erase(EntNum);
+			ClearGoalTrees();
 		}
 	}
 }
@@ -2275,6 +2357,57 @@ void NAV::SpawnedPoint(gentity_t* ent, const EPointType type)
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Is The Actor Still Where His Last Nearest Point Search Left Him?
+//
+// As long as he is inside the radius of the node he was given, or inside the corridor
+// of the edge he was given and not yet on either end of it, the full cell search would
+// just hand the same point back, so skip the sort and the traces.
+////////////////////////////////////////////////////////////////////////////////////////
+static bool StillAtNearestNode(const gentity_t* ent, const NAV::TNodeHandle goal, const bool allowZOffset)
+{
+	const CVec3 Pos(ent->currentOrigin);
+	const int waypoint = ent->waypoint;
+
+	if (waypoint > 0 && waypoint < NAV::NUM_NODES)
+	{
+		const c_way_node& node = mGraph.get_node(waypoint);
+		if (node.mPoint.Dist2(Pos) >= node.mRadius * node.mRadius)
+		{
+			return false;
+		}
+		if (!allowZOffset && fabsf(node.mPoint[2] - Pos[2]) > static_cast<float>(NAV::VIEW_RANGE) / 4)
+		{
+			return false;
+		}
+
+		// The Search Biases Away From Nodes Cut Off From The Goal, So Don't Keep One
+		//----------------------------------------------------------------------------
+		return !goal || goal == waypoint || NAV::InSameRegion(goal, waypoint);
+	}
+
+	if (waypoint < 0 && -waypoint < NAV::NUM_EDGES)
+	{
+		CWayEdge& edge = mGraph.get_edge(-waypoint);
+		const c_way_node& nodeA = mGraph.get_node(edge.mNodeA);
+		const c_way_node& nodeB = mGraph.get_node(edge.mNodeB);
+
+		// Reaching Either End Means The Node Itself Should Win Now
+		//----------------------------------------------------------
+		if (nodeA.mPoint.Dist2(Pos) < nodeA.mRadius * nodeA.mRadius ||
+			nodeB.mPoint.Dist2(Pos) < nodeB.mRadius * nodeB.mRadius)
+		{
+			return false;
+		}
+
+		CVec3 PointOnEdge(Pos);
+		const float PointOnEdgeRange = PointOnEdge.ProjectToLine(edge.PointA(), edge.PointB());
+		return PointOnEdgeRange > 0.0f && PointOnEdgeRange < 1.0f &&
+			PointOnEdge.Dist2(Pos) < NAV::EDGE_CORRIDOR * NAV::EDGE_CORRIDOR;
+	}
+	return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -2287,17 +2420,28 @@ NAV::TNodeHandle NAV::GetNearestNode(gentity_t* ent, const bool forceRecalcNow,
 
 	if (ent->waypoint == WAYPOINT_NONE || forceRecalcNow || level.time > ent->noWaypointTime)
 	{
+		const bool allowZOffset = ent->client && ent->client->moveType == MT_FLYSWIM;
+
 		if (ent->waypoint)
 		{
 			ent->lastWaypoint = ent->waypoint;
 		}
-		ent->waypoint =
-			GetNearestNode(
-				ent->currentOrigin,
-				ent->waypoint,
-				goal,
-				ent->s.number,
-				ent->client && ent->client->moveType == MT_FLYSWIM);
+
+		mNearestQueryCount++;
+		if (ent->waypoint != WAYPOINT_NONE && g_navCache->integer && StillAtNearestNode(ent, goal, allowZOffset))
+		{
+			mNearestReuseCount++;
+		}
+		else
+		{
+			ent->waypoint =
+				GetNearestNode(
+					ent->currentOrigin,
+					ent->waypoint,
+					goal,
+					ent->s.number,
+					allowZOffset);
+		}
 		ent->noWaypointTime = level.time + 1000; // Don't Erase This Result For 5 Seconds
 	}
 
@@ -2313,6 +2457,8 @@ NAV::TNodeHandle NAV::GetNearestNode(const vec3_t& position, const TNodeHandle p
 {
 	if (mGraph.size_edges() > 0)
 	{
+		mNearestSearchCount++;
+
 		// Get The List Of Nodes For This Cell Of The Map
 		//------------------------------------------------
 		TGraphCells::SCell& Cell = mCells.get_cell(position[0], position[1]);
@@ -2411,6 +2557,7 @@ NAV::TNodeHandle NAV::GetNearestNode(const vec3_t& position, const TNodeHandle p
 
 				// Otherwise, We Need To Trace To It
 				//-----------------------------------
+				mNearestTraceCount++;
 				if (ViewNavTrace(Pos, mGraph.get_node(mNearestNavSort[j].mHandle).mPoint))
 				{
 					return mNearestNavSort[j].mHandle;
@@ -2473,6 +2620,7 @@ NAV::TNodeHandle NAV::GetNearestNode(const vec3_t& position, const TNodeHandle p
 				{
 					// Otherwise, We Need To Trace To It
 					//-----------------------------------
+					mNearestTraceCount++;
 					if (ViewNavTrace(Pos, PointOnEdge))
 					{
 						return mNearestNavSort[j].mHandle * -1; // "Edges" have negative IDs
@@ -2659,6 +2807,145 @@ NAV::TNodeHandle NAV::ChooseFarthestNeighbor(gentity_t* actor, const vec3_t& tar
 	return best;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Goal Tree Traits
+//
+// Everything about an actor that changes which edges he may use.  Actors with the same
+// traits can share a goal tree.  Returns -1 if his costs are his alone (he has danger
+// alerts of his own, or can smash through breakables), and he must run his own A*.
+////////////////////////////////////////////////////////////////////////////////////////
+static int GoalTreeTraits(gentity_t* actor)
+{
+	const TAlertList& al = GetAlerts(actor);
+	for (int alIndex = 0; alIndex < TAlertList::CAPACITY; alIndex++)
+	{
+		if (al[alIndex].mDanger > 0.0f)
+		{
+			return -1;
+		}
+	}
+
+	int traits = NAV::ClassifyEntSize(actor);
+	if (actor->NPC)
+	{
+		if (actor->NPC->aiFlags & NPCAI_NAV_THROUGH_BREAKABLES)
+		{
+			return -1;
+		}
+		traits |= 1 << 8;
+		if (actor->NPC->scriptFlags & SCF_NAV_CAN_FLY)
+		{
+			traits |= 1 << 9;
+		}
+		if (actor->NPC->scriptFlags & SCF_NAV_CAN_JUMP)
+		{
+			traits |= 1 << 10;
+		}
+	}
+	if (INV_GoodieKeyCheck(actor))
+	{
+		traits |= 1 << 11;
+	}
+	return traits;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Build Goal Tree
+//
+// Dijkstra from the goal outward.  Edges are costed by the node they lead into, which
+// walking back from the goal is always the node we are expanding from, so every node
+// reached gets exactly the cost and the next hop an A* from there would have found.
+////////////////////////////////////////////////////////////////////////////////////////
+static void BuildGoalTree(SGoalTree& tree, const int goal, const int traits)
+{
+	tree.mGoal = goal;
+	tree.mTraits = traits;
+	tree.mBuildTime = level.time;
+	tree.mReached.clear();
+	tree.mNext.fill(0);
+
+	mGoalTreeCosts.fill(-1.0f);
+	mGoalTreeOpen.clear();
+
+	SGoalTreeOpen open = { goal, 0.0f };
+	mGoalTreeCosts[goal] = 0.0f;
+	mGoalTreeOpen.push(open);
+
+	while (!mGoalTreeOpen.empty())
+	{
+		const SGoalTreeOpen cur = mGoalTreeOpen.top();
+		mGoalTreeOpen.pop();
+		if (tree.mReached.get_bit(cur.mNode))
+		{
+			continue; // already closed at a lower cost
+		}
+		tree.mReached.set_bit(cur.mNode);
+		mGoalTreeVisited++;
+
+		const c_way_node& curNode = mGraph.get_node(cur.mNode);
+		TGraph::TNodeNeighbors& neighbors = mGraph.get_node_neighbors(cur.mNode);
+		for (int i = 0; i < neighbors.size(); i++)
+		{
+			const int next = neighbors[i].mNode;
+			if (tree.mReached.get_bit(next))
+			{
+				continue;
+			}
+
+			CWayEdge& edge = mGraph.get_edge(neighbors[i].mEdge);
+			if (!mUser.is_valid(edge, goal))
+			{
+				continue;
+			}
+
+			const float cost = cur.mCost + mUser.cost(edge, curNode);
+			if ((mGoalTreeCosts[next] < 0.0f || cost < mGoalTreeCosts[next]) && !mGoalTreeOpen.full())
+			{
+				mGoalTreeCosts[next] = cost;
+				tree.mNext[next] = static_cast<short>(cur.mNode);
+
+				open.mNode = next;
+				open.mCost = cost;
+				mGoalTreeOpen.push(open);
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Get Goal Tree
+//
+// Hands back a fresh enough tree for this goal and these traits, building one over the
+// least recently used slot if there isn't one.
+////////////////////////////////////////////////////////////////////////////////////////
+static const SGoalTree& GetGoalTree(const int goal, const int traits)
+{
+	int oldest = 0;
+	for (int i = 0; i < NAV::MAX_GOAL_TREES; i++)
+	{
+		SGoalTree& tree = mGoalTrees[i];
+		if (tree.mGoal == goal &&
+			tree.mTraits == traits &&
+			level.time >= tree.mBuildTime &&
+			level.time < tree.mBuildTime + NAV::GOAL_TREE_LIFE)
+		{
+			tree.mLastUseTime = level.time;
+			mGoalTreeShareCount++;
+			return tree;
+		}
+		if (tree.mLastUseTime < mGoalTrees[oldest].mLastUseTime)
+		{
+			oldest = i;
+		}
+	}
+
+	SGoalTree& tree = mGoalTrees[oldest];
+	BuildGoalTree(tree, goal, traits);
+	tree.mLastUseTime = level.time;
+	mGoalTreeBuildCount++;
+	return tree;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -2733,31 +3020,84 @@ bool NAV::FindPath(gentity_t* actor, TNodeHandle target, const float MaxDangerLe
 		return puser.mSuccess;
 	}
 
-	// Now, Run A*
-	//-------------
+	// Steer Clear Of A Dangerous Enemy
+	//---------------------------------
+	float dangerRadius = 0.0f;
 	if (actor->enemy && actor->enemy->client)
 	{
 		if (actor->enemy->client->ps.weapon == WP_SABER)
 		{
-			mUser.SetDangerSpot(actor->enemy->currentOrigin, 200.0f);
+			dangerRadius = 200.0f;
 		}
 		else if (
 			actor->enemy->client->NPC_class == CLASS_RANCOR ||
 			actor->enemy->client->NPC_class == CLASS_WAMPA)
 		{
-			mUser.SetDangerSpot(actor->enemy->currentOrigin, 400.0f);
+			dangerRadius = 400.0f;
 		}
 	}
-	mGraph.astar(mSearch, mUser);
-	mUser.ClearDangerSpot();
+
+	// If Nothing Makes This Actor's Costs His Own, Read The Path Off The Goal's Shared Tree
+	//---------------------------------------------------------------------------------------
+	const int traits = dangerRadius == 0.0f && g_navCache->integer ? GoalTreeTraits(actor) : -1;
+	const SGoalTree* goalTree = nullptr;
+	if (traits >= 0)
+	{
+		goalTree = &GetGoalTree(target, traits);
+		puser.mSuccess = goalTree->mReached.get_bit(start);
+	}
+
+	// Otherwise, Run A*
+	//-------------------
+	else
+	{
+		if (dangerRadius > 0.0f)
+		{
+			mUser.SetDangerSpot(actor->enemy->currentOrigin, dangerRadius);
+		}
+		mGraph.astar(mSearch, mUser);
+		mUser.ClearDangerSpot();
+
+		mPathSearchCount++;
+		mPathSearchVisited += mSearch.num_visited();
+		puser.mSuccess = mSearch.success();
+	}
 
 	puser.mLastAStarTime = level.time + Q_irand(3000, 6000);
-	puser.mSuccess = mSearch.success();
 	if (!puser.mSuccess)
 	{
 		return puser.mSuccess;
 	}
 
+	// Gather The Path Nodes, Goal First, The Way The A* Path Reads
+	//---------------------------------------------------------------
+	int pathNodes[NUM_NODES];
+	int numPathNodes = 0;
+	if (goalTree)
+	{
+		for (int node = start; numPathNodes < NUM_NODES; node = goalTree->mNext[node])
+		{
+			pathNodes[numPathNodes++] = node;
+			if (node == target)
+			{
+				break;
+			}
+		}
+		for (int i = 0, j = numPathNodes - 1; i < j; i++, j--)
+		{
+			const int swap = pathNodes[i];
+			pathNodes[i] = pathNodes[j];
+			pathNodes[j] = swap;
+		}
+	}
+	else
+	{
+		for (mSearch.path_begin(); !mSearch.path_end() && numPathNodes < NUM_NODES; mSearch.path_inc())
+		{
+			pathNodes[numPathNodes++] = mSearch.path_at();
+		}
+	}
+
 	// Grab A Couple "Current Conditions"
 	//------------------------------------
 	CVec3 At(actor->currentOrigin);
@@ -2791,7 +3131,7 @@ bool NAV::FindPath(gentity_t* actor, TNodeHandle target, const float MaxDangerLe
 	{
 		SPathPoint PPoint = {};
 		puser.mPath.clear();
-		for (mSearch.path_begin(); !mSearch.path_end() && !puser.mPath.full(); mSearch.path_inc())
+		for (int pathNode = 0; pathNode < numPathNodes && !puser.mPath.full(); pathNode++)
 		{
 			if (puser.mPath.full())
 			{
@@ -2804,7 +3144,7 @@ bool NAV::FindPath(gentity_t* actor, TNodeHandle target, const float MaxDangerLe
 				return false;
 			}
 
-			PPoint.mNode = mSearch.path_at();
+			PPoint.mNode = pathNodes[pathNode];
 			PPoint.mPoint = mGraph.get_node(PPoint.mNode).mPoint;
 			PPoint.mSpeed = AtSpeed;
 			PPoint.mSlowingRadius = 0.0f;
@@ -3838,6 +4178,7 @@ void NAV::ShowStats()
 	mGraph.ProfilePrint("Path   : (%d)", (sizeof(mPathUsers) + sizeof(mPathUserIndex)));
 	mGraph.ProfilePrint("Steer  : (%d)", (sizeof(mSteerUsers) + sizeof(mSteerUserIndex)));
 	mGraph.ProfilePrint("Alerts : (%d)", (sizeof(mEntityAlertList)));
+	mGraph.ProfilePrint("Goals  : (%d)", (sizeof(mGoalTrees) + sizeof(mGoalTreeOpen) + sizeof(mGoalTreeCosts)));
 	float totalBytes = (
 		sizeof(mCells) +
 		sizeof(mGraph) +
@@ -3846,7 +4187,10 @@ void NAV::ShowStats()
 		sizeof(mPathUserIndex) +
 		sizeof(mSteerUsers) +
 		sizeof(mSteerUserIndex) +
-		sizeof(mEntityAlertList));
+		sizeof(mEntityAlertList) +
+		sizeof(mGoalTrees) +
+		sizeof(mGoalTreeOpen) +
+		sizeof(mGoalTreeCosts));
 
 	mGraph.ProfilePrint("TOTAL :  (KiloBytes): (%5.3f)  MeggaBytes(%3.3f)",
 		((float)(totalBytes) / 1024.0f),
@@ -3858,6 +4202,13 @@ void NAV::ShowStats()
 	mGraph.ProfilePrint("");
 	mGraph.ProfilePrint("Move Trace: Count(%d) PerFrame(%f)", mMoveTraceCount, (float)(mMoveTraceCount) / (float)(level.time));
 	mGraph.ProfilePrint("View Trace: Count(%d) PerFrame(%f)", mViewTraceCount, (float)(mViewTraceCount) / (float)(level.time));
+	mGraph.ProfilePrint("");
+
+	const float tracesPerSearch = mNearestSearchCount ? (float)(mNearestTraceCount) / (float)(mNearestSearchCount) : 0.0f;
+	mGraph.ProfilePrint("Nearest Point: Queries(%d) Reused(%d) Searches(%d) Traces(%d)", mNearestQueryCount, mNearestReuseCount, mNearestSearchCount, mNearestTraceCount);
+	mGraph.ProfilePrint("Nearest Point: TracesPerSearch(%f) TracesSaved(~%d)", tracesPerSearch, (int)(mNearestReuseCount * tracesPerSearch));
+	mGraph.ProfilePrint("Path Search: A*(%d) Visited(%d)", mPathSearchCount, mPathSearchVisited);
+	mGraph.ProfilePrint("Goal Trees: Built(%d) Shared(%d) Visited(%d) SearchesSaved(%d)", mGoalTreeBuildCount, mGoalTreeShareCount, mGoalTreeVisited, mGoalTreeShareCount);
 
 #endif
 }
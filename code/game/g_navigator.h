@@ -50,7 +50,8 @@ constexpr auto USENEWNAVSYSTEM = 1;
 // This namespace provides the public interface to the NPC Navigation and Pathfinding
 // system.  This system is a bidirectional graph of nodes and weighted edges.  Finding
 // a path from one node to another is accomplished with A*, and cached internally for
-// each actor who requests a path.
+// each actor who requests a path.  Actors headed for the same goal share a single
+// reverse search whenever nothing about them changes the cost of the edges.
 ////////////////////////////////////////////////////////////////////////////////////////
 namespace NAV
 {
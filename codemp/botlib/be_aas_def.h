@@ -273,6 +273,11 @@ using aas_t = struct aas_s
 	//areas the reachabilities go through
 	int* reachabilityareaindex;
 	aas_reachabilityareas_t* reachabilityareas;
+	//node to start point lookups at for each cell of a uniform grid
+	vec3_t pointgridmins;
+	float pointgridscale;						//one over the cell size
+	int pointgriddims[3];
+	int* pointgrid;
 };
 
 #ifndef BSPCINCLUDE
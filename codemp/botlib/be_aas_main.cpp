@@ -265,6 +265,7 @@ int AAS_LoadMap(const char* mapname)
 	// to free the caches the old number of areas, number of clusters
 	// and number of areas in a clusters must be available
 	AAS_FreeRoutingCaches();
+	AAS_FreePointGrid();
 	//load the map
 	const int errnum = AAS_LoadFiles(mapname);
 	if (errnum != BLERR_NOERROR)
@@ -274,6 +275,8 @@ int AAS_LoadMap(const char* mapname)
 	} //end if
 	//
 	AAS_InitSettings();
+	//initialize the point lookup grid for the new map
+	AAS_InitPointGrid();
 	//initialize the AAS link heap for the new map
 	AAS_InitAASLinkHeap();
 	//initialize the AAS linked entities for the new map
@@ -324,6 +327,8 @@ void AAS_Shutdown(void)
 	AAS_FreeRoutingCaches();
 	//free aas link heap
 	AAS_FreeAASLinkHeap();
+	//free the point lookup grid
+	AAS_FreePointGrid();
 	//free aas linked entities
 	AAS_FreeAASLinkedEntities();
 	//free the aas data
@@ -334,6 +339,8 @@ void AAS_Shutdown(void)
 	Com_Memset(&aasworld, 0, sizeof(aas_t));
 	//aas has not been initialized
 	aasworld.initialized = qfalse;
+	//the routing caches and links are gone, return their pools to the zone
+	ReleaseMemoryPools();
 	//NOTE: as soon as a new .bsp file is loaded the .bsp file memory is
 	// freed and reallocated, so there's no need to free that memory here
 	//print shutdown
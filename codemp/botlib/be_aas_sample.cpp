@@ -50,6 +50,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "be_aas_def.h"
 
 extern botlib_import_t botimport;
+extern int Sys_MilliSeconds(void);
 
 //#define AAS_SAMPLE_DEBUG
 
@@ -59,6 +60,14 @@ constexpr auto BBOX_NORMAL_EPSILON = 0.001;
 
 constexpr auto TRACEPLANE_EPSILON = 0.125;
 
+//the point grid keeps for each cell the first node that splits the cell, or the
+//leaf the whole cell is in. A cell only counts as being on one side of a plane
+//when it's clear of it by POINTGRID_EPSILON, so rounding can't send a point
+//inside the cell down the other side
+constexpr auto POINTGRID_MAXCELLS = 65536;
+constexpr auto POINTGRID_MINCELLSIZE = 128.0f;
+constexpr auto POINTGRID_EPSILON = 1.0f;
+
 using aas_tracestack_t = struct aas_tracestack_s
 {
 	vec3_t start;		//start point of the piece of line to trace
@@ -205,26 +214,135 @@ void AAS_FreeAASLinkedEntities(void)
 	aasworld.arealinkedentities = nullptr;
 } //end of the function AAS_InitAASLinkedEntities
 //===========================================================================
-// returns the AAS area the point is in
+// returns the first node that doesn't have the whole box at one side
 //
 // Parameter:				-
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_PointAreaNum(vec3_t point)
+static int AAS_BoxNodeNum(vec3_t mins, vec3_t maxs)
+{
+	vec3_t center, extents;
+
+	VectorAdd(mins, maxs, center);
+	VectorScale(center, 0.5, center);
+	VectorSubtract(maxs, center, extents);
+	//start with node 1 because node zero is a dummy used for solid leafs
+	int nodenum = 1;
+	while (nodenum > 0)
+	{
+		const aas_node_t* node = &aasworld.nodes[nodenum];
+		const aas_plane_t* plane = &aasworld.planes[node->planenum];
+		const float dist = DotProduct(center, plane->normal) - plane->dist;
+		const float radius = fabs(plane->normal[0]) * extents[0] +
+			fabs(plane->normal[1]) * extents[1] +
+			fabs(plane->normal[2]) * extents[2];
+		if (dist - radius > POINTGRID_EPSILON) nodenum = node->children[0];
+		else if (dist + radius < -POINTGRID_EPSILON) nodenum = node->children[1];
+		else break;
+	} //end while
+	return nodenum;
+} //end of the function AAS_BoxNodeNum
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_FreePointGrid(void)
+{
+	if (aasworld.pointgrid) FreeMemory(aasworld.pointgrid);
+	aasworld.pointgrid = nullptr;
+} //end of the function AAS_FreePointGrid
+//===========================================================================
+// lays a uniform grid over the areas and finds the node to start at for
+// every cell, the cells grow until there are no more than POINTGRID_MAXCELLS
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_InitPointGrid(void)
+{
+	int i, numcells;
+	vec3_t mins, maxs, cellmins, cellmaxs;
+
+	AAS_FreePointGrid();
+	ClearBounds(mins, maxs);
+	for (i = 1; i < aasworld.numareas; i++)
+	{
+		AddPointToBounds(aasworld.areas[i].mins, mins, maxs);
+		AddPointToBounds(aasworld.areas[i].maxs, mins, maxs);
+	} //end for
+	if (mins[0] > maxs[0]) return;
+	//
+	float cellsize = POINTGRID_MINCELLSIZE;
+	while (true)
+	{
+		numcells = 1;
+		for (i = 0; i < 3; i++)
+		{
+			aasworld.pointgriddims[i] = static_cast<int>((maxs[i] - mins[i]) / cellsize) + 1;
+			numcells *= aasworld.pointgriddims[i];
+		} //end for
+		if (numcells <= POINTGRID_MAXCELLS) break;
+		cellsize *= 2;
+	} //end while
+	VectorCopy(mins, aasworld.pointgridmins);
+	aasworld.pointgridscale = 1.0f / cellsize;
+	aasworld.pointgrid = static_cast<int*>(GetMemory(numcells * sizeof(int)));
+	//
+	int* cell = aasworld.pointgrid;
+	for (int z = 0; z < aasworld.pointgriddims[2]; z++)
+	{
+		cellmins[2] = mins[2] + z * cellsize;
+		cellmaxs[2] = cellmins[2] + cellsize;
+		for (int y = 0; y < aasworld.pointgriddims[1]; y++)
+		{
+			cellmins[1] = mins[1] + y * cellsize;
+			cellmaxs[1] = cellmins[1] + cellsize;
+			for (int x = 0; x < aasworld.pointgriddims[0]; x++)
+			{
+				cellmins[0] = mins[0] + x * cellsize;
+				cellmaxs[0] = cellmins[0] + cellsize;
+				*cell++ = AAS_BoxNodeNum(cellmins, cellmaxs);
+			} //end for
+		} //end for
+	} //end for
+} //end of the function AAS_InitPointGrid
+//===========================================================================
+// returns the point grid cell the point is in or -1 if it's outside the grid
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_PointGridCell(const vec3_t point)
+{
+	int cell = 0;
+
+	if (!aasworld.pointgrid) return -1;
+	for (int i = 2; i >= 0; i--)
+	{
+		const float v = (point[i] - aasworld.pointgridmins[i]) * aasworld.pointgridscale;
+		//also catches NaNs
+		if (!(v >= 0 && v < aasworld.pointgriddims[i])) return -1;
+		cell = cell * aasworld.pointgriddims[i] + static_cast<int>(v);
+	} //end for
+	return cell;
+} //end of the function AAS_PointGridCell
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_PointAreaNumFromNode(vec3_t point, int nodenum)
 {
 	float	dist;
 	aas_node_t* node;
 	aas_plane_t* plane;
 
-	if (!aasworld.loaded)
-	{
-		botimport.Print(PRT_ERROR, "AAS_PointAreaNum: aas not loaded\n");
-		return 0;
-	} //end if
-
-	//start with node 1 because node zero is a dummy used for solid leafs
-	int nodenum = 1;
 	while (nodenum > 0)
 	{
 		//		botimport.Print(PRT_MESSAGE, "[%d]", nodenum);
@@ -256,6 +374,25 @@ int AAS_PointAreaNum(vec3_t point)
 		return 0;
 	} //end if
 	return -nodenum;
+} //end of the function AAS_PointAreaNumFromNode
+//===========================================================================
+// returns the AAS area the point is in
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int AAS_PointAreaNum(vec3_t point)
+{
+	if (!aasworld.loaded)
+	{
+		botimport.Print(PRT_ERROR, "AAS_PointAreaNum: aas not loaded\n");
+		return 0;
+	} //end if
+
+	const int cell = AAS_PointGridCell(point);
+	//start with node 1 because node zero is a dummy used for solid leafs
+	return AAS_PointAreaNumFromNode(point, cell >= 0 ? aasworld.pointgrid[cell] : 1);
 } //end of the function AAS_PointAreaNum
 //===========================================================================
 //
@@ -442,8 +579,8 @@ qboolean AAS_AreaEntityCollision(const int areanum, vec3_t start, vec3_t end,
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, const int presencetype,
-	const int passent)
+static aas_trace_t AAS_TraceClientBBoxFromNode(vec3_t start, vec3_t end, const int presencetype,
+	const int passent, const int startnode)
 {
 	int side, tmpplanenum;
 	float front, back, frac;
@@ -463,8 +600,7 @@ aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, const int presencetype
 	VectorCopy(start, tstack_p->start);
 	VectorCopy(end, tstack_p->end);
 	tstack_p->planenum = 0;
-	//start with node 1 because node zero is a dummy for a solid leaf
-	tstack_p->nodenum = 1;		//starting at the root of the tree
+	tstack_p->nodenum = startnode;
 	tstack_p++;
 
 	while (true)
@@ -712,8 +848,38 @@ aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, const int presencetype
 		} //end else
 	} //end while
 //	return trace;
+} //end of the function AAS_TraceClientBBoxFromNode
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, const int presencetype,
+	const int passent)
+{
+	//a line inside a single grid cell never leaves the subtree of the cell's node,
+	//otherwise start with node 1 because node zero is a dummy for a solid leaf
+	const int cell = AAS_PointGridCell(start);
+	const int startnode = cell >= 0 && cell == AAS_PointGridCell(end) ? aasworld.pointgrid[cell] : 1;
+
+	return AAS_TraceClientBBoxFromNode(start, end, presencetype, passent, startnode);
 } //end of the function AAS_TraceClientBBox
 //===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_TraceClientBBoxes(const int numtraces, vec3_t* starts, vec3_t* ends, const int presencetype,
+	const int passent, aas_trace_t* traces)
+{
+	for (int i = 0; i < numtraces; i++)
+	{
+		traces[i] = AAS_TraceClientBBox(starts[i], ends[i], presencetype, passent);
+	} //end for
+} //end of the function AAS_TraceClientBBoxes
+//===========================================================================
 // recursive subdivision of the line by the BSP tree.
 //
 // Parameter:				-
@@ -1368,4 +1534,89 @@ aas_plane_t* AAS_PlaneFromNum(const int planenum)
 	if (!aasworld.loaded) return nullptr;
 
 	return &aasworld.planes[planenum];
-} //end of the function AAS_PlaneFromNum
\ No newline at end of file
+} //end of the function AAS_PlaneFromNum
+//===========================================================================
+// runs random point lookups and short traces around the areas of the loaded
+// map through the point grid and from the root of the tree, and compares
+// the results and times
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_PointGridBenchmark(int numqueries)
+{
+	int i, mismatches;
+
+	if (!aasworld.loaded || aasworld.numareas < 2)
+	{
+		botimport.Print(PRT_MESSAGE, "no AAS loaded\n");
+		return;
+	} //end if
+	if (numqueries <= 0) numqueries = 100000;
+	//
+	const auto starts = static_cast<vec3_t*>(GetMemory(numqueries * sizeof(vec3_t)));
+	const auto ends = static_cast<vec3_t*>(GetMemory(numqueries * sizeof(vec3_t)));
+	const auto areas = static_cast<int*>(GetMemory(numqueries * 2 * sizeof(int)));
+	const auto traces = static_cast<aas_trace_t*>(GetMemory(numqueries * 2 * sizeof(aas_trace_t)));
+	//points somewhere in the bounds of random areas and movement sized steps from there
+	for (i = 0; i < numqueries; i++)
+	{
+		const aas_area_t* area = &aasworld.areas[1 + rand() % (aasworld.numareas - 1)];
+		for (int j = 0; j < 3; j++)
+		{
+			starts[i][j] = area->mins[j] + randoms() * (area->maxs[j] - area->mins[j]);
+		} //end for
+		ends[i][0] = starts[i][0] + crandoms() * 64;
+		ends[i][1] = starts[i][1] + crandoms() * 64;
+		ends[i][2] = starts[i][2] + crandoms() * 16;
+	} //end for
+	//
+	int start_time = Sys_MilliSeconds();
+	for (i = 0; i < numqueries; i++)
+	{
+		areas[i] = AAS_PointAreaNumFromNode(starts[i], 1);
+	} //end for
+	const int rootpointtime = Sys_MilliSeconds() - start_time;
+	start_time = Sys_MilliSeconds();
+	for (i = 0; i < numqueries; i++)
+	{
+		areas[numqueries + i] = AAS_PointAreaNum(starts[i]);
+	} //end for
+	const int gridpointtime = Sys_MilliSeconds() - start_time;
+	mismatches = 0;
+	for (i = 0; i < numqueries; i++)
+	{
+		if (areas[i] != areas[numqueries + i]) mismatches++;
+	} //end for
+	botimport.Print(PRT_MESSAGE, "%d point lookups: root %d msec, grid %d msec, %s (%d)\n", numqueries,
+		rootpointtime, gridpointtime, mismatches ? "MISMATCH" : "match", mismatches);
+	//
+	start_time = Sys_MilliSeconds();
+	for (i = 0; i < numqueries; i++)
+	{
+		traces[i] = AAS_TraceClientBBoxFromNode(starts[i], ends[i], PRESENCE_NORMAL, -1, 1);
+	} //end for
+	const int roottracetime = Sys_MilliSeconds() - start_time;
+	start_time = Sys_MilliSeconds();
+	AAS_TraceClientBBoxes(numqueries, starts, ends, PRESENCE_NORMAL, -1, traces + numqueries);
+	const int gridtracetime = Sys_MilliSeconds() - start_time;
+	mismatches = 0;
+	for (i = 0; i < numqueries; i++)
+	{
+		const aas_trace_t* a = &traces[i];
+		const aas_trace_t* b = &traces[numqueries + i];
+		if (a->startsolid != b->startsolid || a->fraction != b->fraction || !VectorCompare(a->endpos, b->endpos) ||
+			a->ent != b->ent || a->lastarea != b->lastarea || a->area != b->area || a->planenum != b->planenum)
+		{
+			mismatches++;
+		} //end if
+	} //end for
+	botimport.Print(PRT_MESSAGE, "%d client bbox traces: root %d msec, grid %d msec, %s (%d)\n", numqueries,
+		roottracetime, gridtracetime, mismatches ? "MISMATCH" : "match", mismatches);
+	//
+	FreeMemory(starts);
+	FreeMemory(ends);
+	FreeMemory(areas);
+	FreeMemory(traces);
+} //end of the function AAS_PointGridBenchmark
@@ -41,6 +41,8 @@ void AAS_InitAASLinkHeap(void);
 void AAS_InitAASLinkedEntities(void);
 void AAS_FreeAASLinkHeap(void);
 void AAS_FreeAASLinkedEntities(void);
+void AAS_InitPointGrid(void);
+void AAS_FreePointGrid(void);
 aas_face_t* AAS_AreaGroundFace(int areanum, vec3_t point);
 aas_face_t* AAS_TraceEndFace(aas_trace_t* trace);
 aas_plane_t* AAS_PlaneFromNum(int planenum);
@@ -61,6 +63,9 @@ int AAS_AreaPresenceType(int areanum);
 int AAS_PointPresenceType(vec3_t point);
 //returns the result of the trace of a client bbox
 aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, int presencetype, int passent);
+//traces a client bbox for each start and end pair
+void AAS_TraceClientBBoxes(int numtraces, vec3_t* starts, vec3_t* ends, int presencetype, int passent,
+	aas_trace_t* traces);
 //stores the areas the trace went through and returns the number of passed areas
 int AAS_TraceAreas(vec3_t start, vec3_t end, int* areas, vec3_t* points, int maxareas);
 //returns the areas the bounding box is in
@@ -73,3 +78,5 @@ int AAS_PointAreaNum(vec3_t point);
 int AAS_PointReachabilityAreaIndex(vec3_t origin);
 //returns the plane the given face is in
 void AAS_FacePlane(int facenum, vec3_t normal, float* dist);
+//compares and times point lookups and traces with and without the point grid
+void AAS_PointGridBenchmark(int numqueries);
@@ -219,6 +219,8 @@ int Export_BotLibShutdown(void)
 	LibVarDeAllocAll();
 	//remove all global defines from the pre compiler
 	PC_RemoveAllGlobalDefines();
+	//give the emptied memory pools back to the zone
+	ReleaseMemoryPools();
 
 	//dump all allocated memory
 //	DumpMemory();
@@ -897,6 +899,8 @@ botlib_export_t * GetBotLibAPI(const int apiVersion, botlib_import_t * import) {
 	be_botlib_export.BotLibLoadMap = Export_BotLibLoadMap;
 	be_botlib_export.BotLibUpdateEntity = Export_BotLibUpdateEntity;
 	be_botlib_export.Test = BotExportTest;
+	be_botlib_export.BotLibMemoryInfo = PrintUsedMemorySize;
+	be_botlib_export.AASBenchmark = AAS_PointGridBenchmark;
 
 	return &be_botlib_export;
 }
\ No newline at end of file
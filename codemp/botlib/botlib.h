@@ -439,6 +439,10 @@ typedef struct botlib_export_s
 	int (*BotLibUpdateEntity)(int ent, bot_entitystate_t* state);
 	//just for testing
 	int (*Test)(int parm0, char* parm1, vec3_t parm2, vec3_t parm3);
+	//print the memory pool counters
+	void (*BotLibMemoryInfo)(void);
+	//compare and time AAS point lookups and traces
+	void (*AASBenchmark)(int numqueries);
 } botlib_export_t;
 
 //linking of bot library
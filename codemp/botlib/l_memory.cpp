@@ -337,6 +337,126 @@ void DumpMemory(void)
 
 #else
 
+// routing caches, entity links, script tokens and goal/weight structures are
+// nearly all small and freed again soon after, so those come out of power of
+// two size class pools carved from big zone chunks instead of one zone block
+// each; anything bigger than the largest class still goes straight to the zone
+constexpr auto POOL_ID = 0x13579b00l; // low byte holds the pool number
+constexpr auto NUM_MEMORY_POOLS = 8;
+constexpr auto MIN_POOL_BLOCK = 16; // payload of the smallest size class
+constexpr auto POOL_CHUNK_SIZE = 32 * 1024;
+
+using memorypool_t = struct memorypool_s
+{
+	void* freelist; // free blocks, linked through their headers
+	void* chunks; // zone chunks, linked through their first bytes
+	int numchunks;
+	int live, peak; // blocks handed out
+	int allocs, frees;
+};
+
+static memorypool_t memorypools[NUM_MEMORY_POOLS];
+static int poolfreebytes; // zone memory sitting unused in the pools
+static int zoneallocs, zonefrees; // blocks too big for the pools
+
+static int PoolBlockSize(const int pool)
+{
+	return (MIN_POOL_BLOCK << pool) + static_cast<int>(sizeof(qmax_align_t));
+}
+
+static int PoolChunkBlocks(const int pool)
+{
+	return (POOL_CHUNK_SIZE - static_cast<int>(sizeof(qmax_align_t))) / PoolBlockSize(pool);
+}
+//===========================================================================
+// returns the smallest pool the given size fits in or -1
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int MemoryPoolForSize(const unsigned long size)
+{
+	int pool = 0;
+
+	for (unsigned long blocksize = MIN_POOL_BLOCK; blocksize < size; blocksize <<= 1)
+	{
+		if (++pool >= NUM_MEMORY_POOLS) return -1;
+	} //end for
+	return pool;
+} //end of the function MemoryPoolForSize
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static qboolean GrowMemoryPool(const int pool)
+{
+	memorypool_t* mp = &memorypools[pool];
+	const int blocksize = PoolBlockSize(pool);
+	const int numblocks = PoolChunkBlocks(pool);
+
+	const auto chunk = static_cast<char*>(botimport.GetMemory(POOL_CHUNK_SIZE));
+	if (!chunk) return qfalse;
+	*reinterpret_cast<void**>(chunk) = mp->chunks;
+	mp->chunks = chunk;
+	mp->numchunks++;
+	//link the blocks back to front so they're handed out in address order
+	for (int i = numblocks - 1; i >= 0; i--)
+	{
+		char* block = chunk + sizeof(qmax_align_t) + i * blocksize;
+		*reinterpret_cast<void**>(block) = mp->freelist;
+		mp->freelist = block;
+	} //end for
+	poolfreebytes += numblocks * blocksize;
+	return qtrue;
+} //end of the function GrowMemoryPool
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void* GetPoolMemory(const int pool)
+{
+	memorypool_t* mp = &memorypools[pool];
+
+	if (!mp->freelist && !GrowMemoryPool(pool)) return nullptr;
+	const auto memid = static_cast<unsigned long*>(mp->freelist);
+	mp->freelist = *static_cast<void**>(mp->freelist);
+	*memid = POOL_ID + pool;
+	mp->allocs++;
+	if (++mp->live > mp->peak) mp->peak = mp->live;
+	poolfreebytes -= PoolBlockSize(pool);
+	return reinterpret_cast<char*>(memid) + sizeof(qmax_align_t);
+} //end of the function GetPoolMemory
+//===========================================================================
+// gives the chunks of every pool without blocks in use back to the zone,
+// called once the AAS world or the whole library has been freed
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void ReleaseMemoryPools(void)
+{
+	for (int pool = 0; pool < NUM_MEMORY_POOLS; pool++)
+	{
+		memorypool_t* mp = &memorypools[pool];
+
+		if (mp->live) continue;
+		while (mp->chunks)
+		{
+			void* chunk = mp->chunks;
+			mp->chunks = *static_cast<void**>(chunk);
+			botimport.FreeMemory(chunk);
+		} //end while
+		poolfreebytes -= mp->numchunks * PoolChunkBlocks(pool) * PoolBlockSize(pool);
+		mp->numchunks = 0;
+		mp->freelist = nullptr;
+	} //end for
+} //end of the function ReleaseMemoryPools
 //===========================================================================
 //
 // Parameter:			-
@@ -349,10 +469,14 @@ void* GetMemoryDebug(unsigned long size, char* label, char* file, int line)
 void* GetMemory(const unsigned long size)
 #endif //MEMDEBUG
 {
+	const int pool = MemoryPoolForSize(size);
+	if (pool >= 0) return GetPoolMemory(pool);
+
 	void* ptr = botimport.GetMemory(size + sizeof(qmax_align_t));
 	if (!ptr) return nullptr;
 	const auto memid = static_cast<unsigned long*>(ptr);
 	*memid = MEM_ID;
+	zoneallocs++;
 	return reinterpret_cast<unsigned long int*>(static_cast<char*>(ptr) + sizeof(qmax_align_t));
 } //end of the function GetMemory
 //===========================================================================
@@ -425,8 +549,20 @@ void FreeMemory(void* ptr)
 {
 	const auto memid = reinterpret_cast<unsigned long int*>(static_cast<char*>(ptr) - sizeof(qmax_align_t));
 
-	if (*memid == MEM_ID)
+	if ((*memid & ~0xfful) == static_cast<unsigned long>(POOL_ID))
 	{
+		const int pool = static_cast<int>(*memid & 0xff);
+		memorypool_t* mp = &memorypools[pool];
+
+		*reinterpret_cast<void**>(memid) = mp->freelist;
+		mp->freelist = memid;
+		mp->live--;
+		mp->frees++;
+		poolfreebytes += PoolBlockSize(pool);
+	} //end if
+	else if (*memid == MEM_ID)
+	{
+		zonefrees++;
 		botimport.FreeMemory(memid);
 	} //end if
 } //end of the function FreeMemory
@@ -438,7 +574,8 @@ void FreeMemory(void* ptr)
 //===========================================================================
 int AvailableMemory(void)
 {
-	return botimport.AvailableMemory();
+	//free pool blocks are as good as free zone memory to the routing cache
+	return botimport.AvailableMemory() + poolfreebytes;
 } //end of the function AvailableMemory
 //===========================================================================
 //
@@ -448,6 +585,21 @@ int AvailableMemory(void)
 //===========================================================================
 void PrintUsedMemorySize(void)
 {
+	int totalchunks = 0;
+
+	botimport.Print(PRT_MESSAGE, "block    live    peak  chunks      allocs       frees\n");
+	for (int pool = 0; pool < NUM_MEMORY_POOLS; pool++)
+	{
+		const memorypool_t* mp = &memorypools[pool];
+
+		botimport.Print(PRT_MESSAGE, "%5d %7d %7d %7d %11d %11d\n", MIN_POOL_BLOCK << pool,
+			mp->live, mp->peak, mp->numchunks, mp->allocs, mp->frees);
+		totalchunks += mp->numchunks;
+	} //end for
+	botimport.Print(PRT_MESSAGE, "pool memory: %d KB, %d KB unused\n",
+		totalchunks * POOL_CHUNK_SIZE >> 10, poolfreebytes >> 10);
+	botimport.Print(PRT_MESSAGE, "zone blocks: %d live, %d allocs, %d frees\n",
+		zoneallocs - zonefrees, zoneallocs, zonefrees);
 } //end of the function PrintUsedMemorySize
 //===========================================================================
 //
@@ -81,3 +81,5 @@ void PrintMemoryLabels(void);
 int MemoryByteSize(void* ptr);
 //free all allocated memory
 void DumpMemory(void);
+//give pooled memory that is no longer in use back to the zone
+void ReleaseMemoryPools(void);
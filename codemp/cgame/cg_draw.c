@@ -6100,13 +6100,13 @@ static void CG_DrawHUD(const centity_t* cent)
 		{
 			//A duel that requires more than one kill to knock the current enemy back to the queue
 			//show current kills out of how many needed
-			score_str = va("%s: %i/%i", CG_GetStringEdString("MP_INGAME", "SCORE"), cg.snap->ps.persistant[PERS_SCORE],
+			score_str = va("%s: %i/%i", CG_GetStaticStringEdString("MP_INGAME", "SCORE"), cg.snap->ps.persistant[PERS_SCORE],
 				cgs.fraglimit);
 		}
 		else
 		{
 			// Don't draw a bias.
-			score_str = va("%s: %i", CG_GetStringEdString("MP_INGAME", "SCORE"), cg.snap->ps.persistant[PERS_SCORE]);
+			score_str = va("%s: %i", CG_GetStaticStringEdString("MP_INGAME", "SCORE"), cg.snap->ps.persistant[PERS_SCORE]);
 		}
 
 		menu_hud = Menus_FindByName("righthud");
@@ -6570,7 +6570,7 @@ static void CG_DrawForceSelect(void)
 	if (showPowersName[cg.forceSelect])
 	{
 		CG_DrawProportionalString(320, y + 30 + y_offset,
-			CG_GetStringEdString("SP_INGAME", showPowersName[cg.forceSelect]),
+			CG_GetStaticStringEdString("SP_INGAME", showPowersName[cg.forceSelect]),
 			UI_CENTER | UI_SMALLFONT, colorTable[CT_ICON_BLUE]);
 	}
 }
@@ -6655,7 +6655,7 @@ void CG_DrawForceSelect_sidetextvert(void)
 
 	if (showPowersName[cg.forceSelect])
 	{
-		CG_Text_Paint(12, 456, 0.5f, colorTable[CT_ICON_BLUE], CG_GetStringEdString("SP_INGAME", showPowersName[cg.forceSelect]), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
+		CG_Text_Paint(12, 456, 0.5f, colorTable[CT_ICON_BLUE], CG_GetStaticStringEdString("SP_INGAME", showPowersName[cg.forceSelect]), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
 	}
 }
 
@@ -6739,7 +6739,7 @@ void CG_DrawForceSelect_sidetexthoz(void)
 
 	if (showPowersName[cg.forceSelect])
 	{
-		CG_Text_Paint(65, 457, 0.5f, colorTable[CT_ICON_BLUE], CG_GetStringEdString("SP_INGAME", showPowersName[cg.forceSelect]), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
+		CG_Text_Paint(65, 457, 0.5f, colorTable[CT_ICON_BLUE], CG_GetStaticStringEdString("SP_INGAME", showPowersName[cg.forceSelect]), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
 	}
 }
 
@@ -6822,7 +6822,7 @@ void CG_DrawInventorySelect_sidetexthoz(void)
 	{
 		vec4_t text_color = { .312f, .75f, .621f, 1.0f };
 
-		CG_Text_Paint(9, 464, 0.5f, text_color, CG_GetStringEdString("SP_INGAME", bg_itemlist[BG_GetItemIndexByTag(cg.itemSelect, IT_HOLDABLE)].classname), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
+		CG_Text_Paint(9, 464, 0.5f, text_color, CG_GetStaticStringEdString("SP_INGAME", bg_itemlist[BG_GetItemIndexByTag(cg.itemSelect, IT_HOLDABLE)].classname), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
 	}
 }
 
@@ -6904,7 +6904,7 @@ void CG_DrawInventorySelect_sidetextvert(void)
 	{
 		vec4_t text_color = { .312f, .75f, .621f, 1.0f };
 
-		CG_Text_Paint(9, 463, 0.5f, text_color, CG_GetStringEdString("SP_INGAME", bg_itemlist[BG_GetItemIndexByTag(cg.itemSelect, IT_HOLDABLE)].classname), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
+		CG_Text_Paint(9, 463, 0.5f, text_color, CG_GetStaticStringEdString("SP_INGAME", bg_itemlist[BG_GetItemIndexByTag(cg.itemSelect, IT_HOLDABLE)].classname), 0, 0, ITEM_TEXTSTYLE_SHADOWED, FONT_SMALL);
 	}
 }
 
@@ -8070,9 +8070,9 @@ static float CG_DrawMiniScoreboard(float y)
 	{
 		const int x_offset = 0;
 		char temp[MAX_QPATH];
-		Q_strncpyz(temp, va("%s: ", CG_GetStringEdString("MP_INGAME", "RED")), sizeof temp);
+		Q_strncpyz(temp, va("%s: ", CG_GetStaticStringEdString("MP_INGAME", "RED")), sizeof temp);
 		Q_strcat(temp, sizeof temp, cgs.scores1 == SCORE_NOT_PRESENT ? "-" : va("%i", cgs.scores1));
-		Q_strcat(temp, sizeof temp, va(" %s: ", CG_GetStringEdString("MP_INGAME", "BLUE")));
+		Q_strcat(temp, sizeof temp, va(" %s: ", CG_GetStaticStringEdString("MP_INGAME", "BLUE")));
 		Q_strcat(temp, sizeof temp, cgs.scores2 == SCORE_NOT_PRESENT ? "-" : va("%i", cgs.scores2));
 
 		CG_Text_Paint(630 - CG_Text_Width(temp, 0.7f, FONT_MEDIUM) + x_offset, y, 0.7f, colorWhite, temp, 0, 0,
@@ -8123,14 +8123,14 @@ static float CG_DrawEnemyInfo(float y)
 	if (cgs.gametype == GT_MOVIEDUELS_JEDIMASTER)
 	{
 		//title = "Jedi Master";
-		title = CG_GetStringEdString("MP_INGAME", "MASTERY7");
+		title = CG_GetStaticStringEdString("MP_INGAME", "MASTERY7");
 		clientNum = cgs.jediMaster;
 
 		if (clientNum < 0)
 		{
 			//return y;
 			//			title = "Get Saber!";
-			title = CG_GetStringEdString("MP_INGAME", "GET_SABER");
+			title = CG_GetStaticStringEdString("MP_INGAME", "GET_SABER");
 
 			size = ICON_SIZE * 1.25;
 			y += 5;
@@ -8148,12 +8148,12 @@ static float CG_DrawEnemyInfo(float y)
 	else if (cg.snap->ps.duelInProgress)
 	{
 		//		title = "Dueling";
-		title = CG_GetStringEdString("MP_INGAME", "DUELING");
+		title = CG_GetStaticStringEdString("MP_INGAME", "DUELING");
 		clientNum = cg.snap->ps.duelIndex;
 	}
 	else if (cgs.gametype == GT_MOVIEDUELS_DUEL && cgs.clientinfo[cg.snap->ps.clientNum].team != TEAM_SPECTATOR)
 	{
-		title = CG_GetStringEdString("MP_INGAME", "DUELING");
+		title = CG_GetStaticStringEdString("MP_INGAME", "DUELING");
 		if (cg.snap->ps.clientNum == cgs.duelist1)
 		{
 			clientNum = cgs.duelist2; //if power duel, should actually draw both duelists 2 and 3 I guess
@@ -8179,7 +8179,7 @@ static float CG_DrawEnemyInfo(float y)
 			return y;
 		}
 
-		title = va("%s: %i", CG_GetStringEdString("MP_INGAME", "LEADER"), cgs.scores1);
+		title = va("%s: %i", CG_GetStaticStringEdString("MP_INGAME", "LEADER"), cgs.scores1);
 
 		clientNum = cgs.duelWinner;
 	}
@@ -9524,11 +9524,11 @@ static void CG_DrawDisconnect(void)
 
 	if (cg.mMapChange)
 	{
-		s = CG_GetStringEdString("MP_INGAME", "SERVER_CHANGING_MAPS"); // s = "Server Changing Maps";
+		s = CG_GetStaticStringEdString("MP_INGAME", "SERVER_CHANGING_MAPS"); // s = "Server Changing Maps";
 		w = CG_DrawStrlen(s) * BIGCHAR_WIDTH;
 		CG_DrawBigString(320 - w / 2, 100, s, 1.0f);
 
-		s = CG_GetStringEdString("MP_INGAME", "PLEASE_WAIT"); // s = "Please wait...";
+		s = CG_GetStaticStringEdString("MP_INGAME", "PLEASE_WAIT"); // s = "Please wait...";
 		w = CG_DrawStrlen(s) * BIGCHAR_WIDTH;
 		CG_DrawBigString(320 - w / 2, 200, s, 1.0f);
 		return;
@@ -9545,7 +9545,7 @@ static void CG_DrawDisconnect(void)
 	}
 
 	// also add text in center of screen
-	s = CG_GetStringEdString("MP_INGAME", "CONNECTION_INTERRUPTED");
+	s = CG_GetStaticStringEdString("MP_INGAME", "CONNECTION_INTERRUPTED");
 	// s = "Connection Interrupted"; // bk 010215 - FIXME
 	w = CG_DrawStrlen(s) * BIGCHAR_WIDTH;
 	CG_DrawBigString(320 - w / 2, 100, s, 1.0f);
@@ -12181,7 +12181,7 @@ CG_DrawSpectator
 */
 //static void CG_DrawSpectator(void)
 //{
-//	const char* s = CG_GetStringEdString("MP_INGAME", "SPECTATOR");
+//	const char* s = CG_GetStaticStringEdString("MP_INGAME", "SPECTATOR");
 //	if ((cgs.gametype == GT_MOVIEDUELS_DUEL || cgs.gametype == GT_MOVIEDUELS_POWERDUEL) &&
 //		cgs.duelist1 != -1 &&
 //		cgs.duelist2 != -1)
@@ -12192,13 +12192,13 @@ CG_DrawSpectator
 //		if (cgs.gametype == GT_MOVIEDUELS_POWERDUEL && cgs.duelist3 != -1)
 //		{
 //			Com_sprintf(text, sizeof text, "%s^7 %s %s^7 %s %s", cgs.clientinfo[cgs.duelist1].name,
-//				CG_GetStringEdString("MP_INGAME", "SPECHUD_VERSUS"), cgs.clientinfo[cgs.duelist2].name,
-//				CG_GetStringEdString("MP_INGAME", "AND"), cgs.clientinfo[cgs.duelist3].name);
+//				CG_GetStaticStringEdString("MP_INGAME", "SPECHUD_VERSUS"), cgs.clientinfo[cgs.duelist2].name,
+//				CG_GetStaticStringEdString("MP_INGAME", "AND"), cgs.clientinfo[cgs.duelist3].name);
 //		}
 //		else
 //		{
 //			Com_sprintf(text, sizeof text, "%s^7 %s %s", cgs.clientinfo[cgs.duelist1].name,
-//				CG_GetStringEdString("MP_INGAME", "SPECHUD_VERSUS"), cgs.clientinfo[cgs.duelist2].name);
+//				CG_GetStaticStringEdString("MP_INGAME", "SPECHUD_VERSUS"), cgs.clientinfo[cgs.duelist2].name);
 //		}
 //		CG_Text_Paint(320 - CG_Text_Width(text, 1.0f, 3) / 2, 420, 1.0f, colorWhite, text, 0, 0, 0, 3);
 //
@@ -12251,13 +12251,13 @@ CG_DrawSpectator
 //
 //	if (cgs.gametype == GT_MOVIEDUELS_DUEL || cgs.gametype == GT_MOVIEDUELS_POWERDUEL)
 //	{
-//		s = CG_GetStringEdString("MP_INGAME", "WAITING_TO_PLAY"); // "waiting to play";
+//		s = CG_GetStaticStringEdString("MP_INGAME", "WAITING_TO_PLAY"); // "waiting to play";
 //		CG_Text_Paint(320 - CG_Text_Width(s, 1.0f, 3) / 2, 440, 1.0f, colorWhite, s, 0, 0, 0, 3);
 //	}
 //	else //if ( cgs.gametype >= GT_MOVIEDUELS_TEAM )
 //	{
 //		//s = "press ESC and use the JOIN menu to play";
-//		s = CG_GetStringEdString("MP_INGAME", "SPEC_CHOOSEJOIN");
+//		s = CG_GetStaticStringEdString("MP_INGAME", "SPEC_CHOOSEJOIN");
 //		CG_Text_Paint(320 - CG_Text_Width(s, 1.0f, 3) / 2, 440, 1.0f, colorWhite, s, 0, 0, 0, 3);
 //	}
 //}
@@ -12289,35 +12289,35 @@ static void CG_DrawVote(void)
 	}
 
 	if (!Q_strncmp(cgs.voteString, "map_restart", 11))
-		trap->SE_GetStringTextString("MENUS_RESTART_MAP", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "RESTART_MAP"), sizeof s_cmd);
 	else if (!Q_strncmp(cgs.voteString, "vstr nextmap", 12))
-		trap->SE_GetStringTextString("MENUS_NEXT_MAP", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "NEXT_MAP"), sizeof s_cmd);
 	else if (!Q_strncmp(cgs.voteString, "g_doWarmup", 10))
-		trap->SE_GetStringTextString("MENUS_WARMUP", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "WARMUP"), sizeof s_cmd);
 	else if (!Q_strncmp(cgs.voteString, "g_gametype", 10))
 	{
-		trap->SE_GetStringTextString("MENUS_GAME_TYPE", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "GAME_TYPE"), sizeof s_cmd);
 
-		if (!Q_stricmp("Free For All", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "OLD_FREE_FOR_ALL");
-		else if (!Q_stricmp("MovieDuels Free For All", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "FREE_FOR_ALL");
-		else if (!Q_stricmp("MovieDuels Holocron", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "HOLOCRON_FFA");
-		else if (!Q_stricmp("MovieDuels Jedi Master", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "JEDIMASTER");
-		else if (!Q_stricmp("MovieDuels Duel", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "DUEL");
-		else if (!Q_stricmp("MovieDuels Power Duel", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "POWERDUEL");
-		else if (!Q_stricmp("MovieDuels missions", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "COOP");
-		else if (!Q_stricmp("MovieDuels Team", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "TEAM_FFA");
-		else if (!Q_stricmp("MovieDuels Siege", cgs.voteString + 11)) s_parm = CG_GetStringEdString("MENUS", "SIEGE");
-		else if (!Q_stricmp("MovieDuels CTF", cgs.voteString + 11))s_parm = CG_GetStringEdString("MENUS", "CAPTURE_THE_FLAG");
-		else if (!Q_stricmp("MovieDuels CTY", cgs.voteString + 11))s_parm = CG_GetStringEdString("MENUS", "CAPTURE_THE_YSALIMARI");
+		if (!Q_stricmp("Free For All", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "OLD_FREE_FOR_ALL");
+		else if (!Q_stricmp("MovieDuels Free For All", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "FREE_FOR_ALL");
+		else if (!Q_stricmp("MovieDuels Holocron", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "HOLOCRON_FFA");
+		else if (!Q_stricmp("MovieDuels Jedi Master", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "JEDIMASTER");
+		else if (!Q_stricmp("MovieDuels Duel", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "DUEL");
+		else if (!Q_stricmp("MovieDuels Power Duel", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "POWERDUEL");
+		else if (!Q_stricmp("MovieDuels missions", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "COOP");
+		else if (!Q_stricmp("MovieDuels Team", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "TEAM_FFA");
+		else if (!Q_stricmp("MovieDuels Siege", cgs.voteString + 11)) s_parm = CG_GetStaticStringEdString("MENUS", "SIEGE");
+		else if (!Q_stricmp("MovieDuels CTF", cgs.voteString + 11))s_parm = CG_GetStaticStringEdString("MENUS", "CAPTURE_THE_FLAG");
+		else if (!Q_stricmp("MovieDuels CTY", cgs.voteString + 11))s_parm = CG_GetStaticStringEdString("MENUS", "CAPTURE_THE_YSALIMARI");
 	}
 	else if (!Q_strncmp(cgs.voteString, "map", 3))
 	{
-		trap->SE_GetStringTextString("MENUS_NEW_MAP", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "NEW_MAP"), sizeof s_cmd);
 		s_parm = cgs.voteString + 4;
 	}
 	else if (!Q_strncmp(cgs.voteString, "kick", 4))
 	{
-		trap->SE_GetStringTextString("MENUS_KICK_PLAYER", s_cmd, sizeof s_cmd);
+		Q_strncpyz(s_cmd, CG_GetStaticStringEdString("MENUS", "KICK_PLAYER"), sizeof s_cmd);
 		s_parm = cgs.voteString + 5;
 	}
 	else
@@ -12326,9 +12326,9 @@ static void CG_DrawVote(void)
 		s_parm = cgs.voteString;
 	}
 
-	trap->SE_GetStringTextString("MENUS_VOTE", s_vote, sizeof s_vote);
-	trap->SE_GetStringTextString("MENUS_YES", s_yes, sizeof s_yes);
-	trap->SE_GetStringTextString("MENUS_NO", s_no, sizeof s_no);
+	Q_strncpyz(s_vote, CG_GetStaticStringEdString("MENUS", "VOTE"), sizeof s_vote);
+	Q_strncpyz(s_yes, CG_GetStaticStringEdString("MENUS", "YES"), sizeof s_yes);
+	Q_strncpyz(s_no, CG_GetStaticStringEdString("MENUS", "NO"), sizeof s_no);
 
 	if (s_parm && s_parm[0])
 		s = va("%s(%i):<%s %s> %s:%i %s:%i", s_vote, sec, s_cmd, s_parm, s_yes, cgs.voteYes, s_no, cgs.voteNo);
@@ -12337,7 +12337,7 @@ static void CG_DrawVote(void)
 	CG_DrawSmallString(4, 58, s, 1.0f);
 	if (cgs.clientinfo[cg.clientNum].team != TEAM_SPECTATOR)
 	{
-		s = CG_GetStringEdString("MP_INGAME", "OR_PRESS_ESC_THEN_CLICK_VOTE"); //	s = "or press ESC then click Vote";
+		s = CG_GetStaticStringEdString("MP_INGAME", "OR_PRESS_ESC_THEN_CLICK_VOTE"); //	s = "or press ESC then click Vote";
 		CG_DrawSmallString(4, 58 + SMALLCHAR_HEIGHT + 2, s, 1.0f);
 	}
 }
@@ -12455,20 +12455,20 @@ static qboolean CG_DrawFollow(void)
 
 		if (ci->duelTeam == DUELTEAM_LONE)
 		{
-			s = CG_GetStringEdString("MP_INGAME", "FOLLOWINGLONE");
+			s = CG_GetStaticStringEdString("MP_INGAME", "FOLLOWINGLONE");
 		}
 		else if (ci->duelTeam == DUELTEAM_DOUBLE)
 		{
-			s = CG_GetStringEdString("MP_INGAME", "FOLLOWINGDOUBLE");
+			s = CG_GetStaticStringEdString("MP_INGAME", "FOLLOWINGDOUBLE");
 		}
 		else
 		{
-			s = CG_GetStringEdString("MP_INGAME", "FOLLOWING");
+			s = CG_GetStaticStringEdString("MP_INGAME", "FOLLOWING");
 		}
 	}
 	else
 	{
-		s = CG_GetStringEdString("MP_INGAME", "FOLLOWING");
+		s = CG_GetStaticStringEdString("MP_INGAME", "FOLLOWING");
 	}
 
 	CG_Text_Paint(320 - CG_Text_Width(s, 0.5f, FONT_SMALL) / 2, 30, 0.5f, colorWhite, s, 0, 0, 0, FONT_SMALL);
@@ -12561,7 +12561,7 @@ static void CG_DrawWarmup(void)
 	if (sec < 0)
 	{
 		//		s = "Waiting for players";
-		s = CG_GetStringEdString("MP_INGAME", "WAITING_FOR_PLAYERS");
+		s = CG_GetStaticStringEdString("MP_INGAME", "WAITING_FOR_PLAYERS");
 		w = CG_DrawStrlen(s) * BIGCHAR_WIDTH;
 		CG_DrawBigString(320 - w / 2, 24, s, 1.0f);
 		cg.warmupCount = 0;
@@ -12622,19 +12622,19 @@ static void CG_DrawWarmup(void)
 	}
 	else
 	{
-		if (cgs.gametype == GT_FFA) s = CG_GetStringEdString("MENUS", "OLD_FREE_FOR_ALL"); //"Free For All";
-		else if (cgs.gametype == GT_MOVIEDUELS_FFA) s = CG_GetStringEdString("MENUS", "FREE_FOR_ALL"); //"Free For All";
-		else if (cgs.gametype == GT_MOVIEDUELS_HOLOCRON) s = CG_GetStringEdString("MENUS", "HOLOCRON_FFA"); //"Holocron FFA";
-		else if (cgs.gametype == GT_MOVIEDUELS_JEDIMASTER) s = CG_GetStringEdString("MENUS", "JEDIMASTER"); //"Holocron FFA";
+		if (cgs.gametype == GT_FFA) s = CG_GetStaticStringEdString("MENUS", "OLD_FREE_FOR_ALL"); //"Free For All";
+		else if (cgs.gametype == GT_MOVIEDUELS_FFA) s = CG_GetStaticStringEdString("MENUS", "FREE_FOR_ALL"); //"Free For All";
+		else if (cgs.gametype == GT_MOVIEDUELS_HOLOCRON) s = CG_GetStaticStringEdString("MENUS", "HOLOCRON_FFA"); //"Holocron FFA";
+		else if (cgs.gametype == GT_MOVIEDUELS_JEDIMASTER) s = CG_GetStaticStringEdString("MENUS", "JEDIMASTER"); //"Holocron FFA";
 
-		else if (cgs.gametype == GT_MOVIEDUELS_DUEL) s = CG_GetStringEdString("MENUS", "DUEL"); //"Team FFA";
-		else if (cgs.gametype == GT_MOVIEDUELS_POWERDUEL) s = CG_GetStringEdString("MENUS", "POWERDUEL"); //"Siege";
-		else if (cgs.gametype == GT_MOVIEDUELS_MISSIONS) s = CG_GetStringEdString("MENUS", "COOP"); //"Capture the Flag";
+		else if (cgs.gametype == GT_MOVIEDUELS_DUEL) s = CG_GetStaticStringEdString("MENUS", "DUEL"); //"Team FFA";
+		else if (cgs.gametype == GT_MOVIEDUELS_POWERDUEL) s = CG_GetStaticStringEdString("MENUS", "POWERDUEL"); //"Siege";
+		else if (cgs.gametype == GT_MOVIEDUELS_MISSIONS) s = CG_GetStaticStringEdString("MENUS", "COOP"); //"Capture the Flag";
 
-		else if (cgs.gametype == GT_MOVIEDUELS_TEAM) s = CG_GetStringEdString("MENUS", "TEAM_FFA"); //"Team FFA";
-		else if (cgs.gametype == GT_MOVIEDUELS_SIEGE) s = CG_GetStringEdString("MENUS", "SIEGE"); //"Siege";
-		else if (cgs.gametype == GT_MOVIEDUELS_CTF) s = CG_GetStringEdString("MENUS", "CAPTURE_THE_FLAG"); //"Capture the Flag";
-		else if (cgs.gametype == GT_MOVIEDUELS_CTY) s = CG_GetStringEdString("MENUS", "CAPTURE_THE_YSALIMARI");
+		else if (cgs.gametype == GT_MOVIEDUELS_TEAM) s = CG_GetStaticStringEdString("MENUS", "TEAM_FFA"); //"Team FFA";
+		else if (cgs.gametype == GT_MOVIEDUELS_SIEGE) s = CG_GetStaticStringEdString("MENUS", "SIEGE"); //"Siege";
+		else if (cgs.gametype == GT_MOVIEDUELS_CTF) s = CG_GetStaticStringEdString("MENUS", "CAPTURE_THE_FLAG"); //"Capture the Flag";
+		else if (cgs.gametype == GT_MOVIEDUELS_CTY) s = CG_GetStaticStringEdString("MENUS", "CAPTURE_THE_YSALIMARI");
 		else s = "";
 		w = CG_Text_Width(s, 1.5f, FONT_MEDIUM);
 		CG_Text_Paint(320 - w / 2, 90, 1.5f, colorWhite, s, 0, 0, ITEM_TEXTSTYLE_SHADOWEDMORE, FONT_MEDIUM);
@@ -12647,7 +12647,7 @@ static void CG_DrawWarmup(void)
 		sec = 0;
 	}
 	//	s = va( "Starts in: %i", sec + 1 );
-	s = va("%s: %i", CG_GetStringEdString("MP_INGAME", "STARTS_IN"), sec + 1);
+	s = va("%s: %i", CG_GetStaticStringEdString("MP_INGAME", "STARTS_IN"), sec + 1);
 	if (sec != cg.warmupCount)
 	{
 		cg.warmupCount = sec;
@@ -14223,7 +14223,7 @@ static void CG_Draw2D(void)
 		switch (cgSiegeRoundState)
 		{
 		case 1:
-			CG_CenterPrint(CG_GetStringEdString("MP_INGAME", "WAITING_FOR_PLAYERS"), SCREEN_HEIGHT * 0.30, BIGCHAR_WIDTH);
+			CG_CenterPrint(CG_GetStaticStringEdString("MP_INGAME", "WAITING_FOR_PLAYERS"), SCREEN_HEIGHT * 0.30, BIGCHAR_WIDTH);
 			break;
 		case 2:
 			r_time = SIEGE_ROUND_BEGIN_TIME - (cg.time - cgSiegeRoundTime);
@@ -14266,7 +14266,7 @@ static void CG_Draw2D(void)
 				}
 			}
 
-			Q_strncpyz(p_str, va("%s %i...", CG_GetStringEdString("MP_INGAME", "ROUNDBEGINSIN"), r_time), sizeof p_str);
+			Q_strncpyz(p_str, va("%s %i...", CG_GetStaticStringEdString("MP_INGAME", "ROUNDBEGINSIN"), r_time), sizeof p_str);
 			CG_CenterPrint(p_str, SCREEN_HEIGHT * 0.30, BIGCHAR_WIDTH);
 			//same
 			break;
@@ -2316,6 +2316,7 @@ int			BG_ProperForceIndex(int power);
 void		bg_cycle_force(playerState_t* ps, int direction);
 
 const char* CG_GetStringEdString(char* refSection, char* refName);
+const char* CG_GetStaticStringEdString(const char* refSection, const char* refName);
 
 void FX_TurretProjectileThink(centity_t* cent, const struct weapon_info_s* weapon);
 void FX_TurretHitWall(vec3_t origin, vec3_t normal);
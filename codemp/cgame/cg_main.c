@@ -1836,6 +1836,60 @@ const char* CG_GetStringEdString(char* refSection, char* refName)
 	return text[index];
 }
 
+//Same as CG_GetStringEdString, for the lookups the HUD makes every frame. refSection and refName have to be
+//strings that never change (literals or constant tables), the resolved StringEd handle is cached under the
+//pair of pointers so after the first call it's a pointer hash and a copy instead of building the reference.
+#define MAX_STATIC_STRINGED_REFS 512 //power of two
+
+typedef struct staticStringEdRef_s
+{
+	const char* refSection;
+	const char* refName;
+	int handle;
+} staticStringEdRef_t;
+
+static staticStringEdRef_t staticStringEdRefs[MAX_STATIC_STRINGED_REFS];
+
+const char* CG_GetStaticStringEdString(const char* refSection, const char* refName)
+{
+	static char text[8][1024];	//a few calls can be held at once, eg the vote line
+	static int		index = 0;
+
+	index = (index + 1) & 7;
+
+	if (trap->SE_GetStringHandle)
+	{
+		const uintptr_t key = ((uintptr_t)refSection * 31) ^ (uintptr_t)refName;
+		int slot = (int)((key >> 3) ^ (key >> 12)) & (MAX_STATIC_STRINGED_REFS - 1);
+
+		for (int i = 0; i < MAX_STATIC_STRINGED_REFS; i++, slot = (slot + 1) & (MAX_STATIC_STRINGED_REFS - 1))
+		{
+			staticStringEdRef_t* ref = &staticStringEdRefs[slot];
+
+			if (!ref->refName)
+			{
+				ref->refSection = refSection;
+				ref->refName = refName;
+				ref->handle = trap->SE_GetStringHandle(va("%s_%s", refSection, refName));
+			}
+			else if (ref->refSection != refSection || ref->refName != refName)
+			{
+				continue;
+			}
+
+			if (ref->handle && trap->SE_GetStringFromHandle(ref->handle, text[index], sizeof(text[0])))
+			{
+				return text[index];
+			}
+			break;
+		}
+	}
+
+	//full table, or the reference is missing and needs the usual ??REF
+	Q_strncpyz(text[index], CG_GetStringEdString((char*)refSection, (char*)refName), sizeof(text[0]));
+	return text[index];
+}
+
 int CG_GetClassCount(team_t team, int siegeClass);
 int CG_GetTeamNonScoreCount(team_t team);
 
@@ -3256,6 +3310,7 @@ Called before every level change or subsystem restart
 void CG_Shutdown(void)
 {
 	BG_ClearAnimsets(); //free all dynamic allocations made through the engine
+	BG_ReleaseSharedData(); //and let go of the parsed files shared with the other module
 
 	CG_DestroyAllGhoul2();
 
@@ -23,7 +23,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
-#define	CGAME_API_VERSION		2
+#define	CGAME_API_VERSION		4
 
 #define	CMD_BACKUP			128
 #define	CMD_MASK			(CMD_BACKUP - 1)
@@ -717,6 +717,15 @@ typedef struct cgameImport_s {
 	struct {
 		float			(*R_Font_StrLenPixels)					(const char* text, int iFontIndex, float scale);
 	} ext;
+
+	// parsed files shared with game, see BG_AcquireSharedData
+	const void* (*SharedData_Acquire)					(const char* name, size_t* size);
+	const void* (*SharedData_Store)						(const char* name, const void* data, size_t size);
+	void			(*SharedData_Release)					(const void* data);
+
+	// interned StringEd lookups, resolve a reference once then fetch it by handle
+	int				(*SE_GetStringHandle)					(const char* text);
+	qboolean(*SE_GetStringFromHandle)				(int handle, char* buffer, int bufferLength);
 } cgameImport_t;
 
 typedef struct cgameExport_s {
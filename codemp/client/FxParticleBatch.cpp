@@ -0,0 +1,453 @@
+/*
+===========================================================================
+Copyright (C) 2000 - 2013, Raven Software, Inc.
+Copyright (C) 2001 - 2013, Activision, Inc.
+Copyright (C) 2013 - 2015, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// FxParticleBatch.cpp -- structure-of-arrays store for plain sprite particles
+
+#include "client.h"
+#include "FxScheduler.h"
+#include "FxParticleBatch.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FX_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+extern int drawnFx;
+void ClampRGB(const vec3_t in, byte* out);
+
+CParticleBatch theParticleBatch[2];
+
+//----------------------------
+bool CParticleBatch::Add(const SParticleSpawn& spawn)
+{
+	if (mCount >= MAX_BATCHED_PARTICLES)
+	{
+		return false;
+	}
+
+	const int i = mCount++;
+
+	mOrgX[i] = spawn.org[0];
+	mOrgY[i] = spawn.org[1];
+	mOrgZ[i] = spawn.org[2];
+	mVelX[i] = spawn.vel[0];
+	mVelY[i] = spawn.vel[1];
+	mVelZ[i] = spawn.vel[2];
+	mAccelX[i] = spawn.accel[0];
+	mAccelY[i] = spawn.accel[1];
+	mAccelZ[i] = spawn.accel[2];
+	mTimeStart[i] = theFxHelper.mTime;
+	mTimeEnd[i] = theFxHelper.mTime + spawn.killTime;
+	mNoNearCull[i] = spawn.flags & FX_DEPTH_HACK ? ~0 : 0;
+
+	mFlags[i] = spawn.flags;
+	mSizeStart[i] = spawn.sizeStart;
+	mSizeEnd[i] = spawn.sizeEnd;
+	mSizeParm[i] = spawn.sizeParm;
+	mAlphaStart[i] = spawn.alphaStart;
+	mAlphaEnd[i] = spawn.alphaEnd;
+	mAlphaParm[i] = spawn.alphaParm;
+	VectorCopy(spawn.rgbStart, mRGBStart[i]);
+	VectorCopy(spawn.rgbEnd, mRGBEnd[i]);
+	mRGBParm[i] = spawn.rgbParm;
+	mRotation[i] = spawn.rotation;
+	mRotationDelta[i] = spawn.rotationDelta;
+	mShader[i] = spawn.shader;
+	mDeathID[i] = spawn.deathID;
+
+	return true;
+}
+
+//----------------------------
+void CParticleBatch::Remove(const int index)
+{
+	const int last = --mCount;
+
+	if (index == last)
+	{
+		return;
+	}
+
+	mOrgX[index] = mOrgX[last];
+	mOrgY[index] = mOrgY[last];
+	mOrgZ[index] = mOrgZ[last];
+	mVelX[index] = mVelX[last];
+	mVelY[index] = mVelY[last];
+	mVelZ[index] = mVelZ[last];
+	mAccelX[index] = mAccelX[last];
+	mAccelY[index] = mAccelY[last];
+	mAccelZ[index] = mAccelZ[last];
+	mTimeStart[index] = mTimeStart[last];
+	mTimeEnd[index] = mTimeEnd[last];
+	mNoNearCull[index] = mNoNearCull[last];
+
+	mFlags[index] = mFlags[last];
+	mSizeStart[index] = mSizeStart[last];
+	mSizeEnd[index] = mSizeEnd[last];
+	mSizeParm[index] = mSizeParm[last];
+	mAlphaStart[index] = mAlphaStart[last];
+	mAlphaEnd[index] = mAlphaEnd[last];
+	mAlphaParm[index] = mAlphaParm[last];
+	VectorCopy(mRGBStart[last], mRGBStart[index]);
+	VectorCopy(mRGBEnd[last], mRGBEnd[index]);
+	mRGBParm[index] = mRGBParm[last];
+	mRotation[index] = mRotation[last];
+	mRotationDelta[index] = mRotationDelta[last];
+	mShader[index] = mShader[last];
+	mDeathID[index] = mDeathID[last];
+}
+
+//----------------------------
+// Integrate
+//
+// Same math as CParticle::UpdateOrigin without physics, plus the linear life
+// percentage every Update* function starts from.
+//----------------------------
+void CParticleBatch::Integrate(const int time, const float dt)
+{
+	int i = 0;
+
+#ifdef FX_BATCH_SSE2
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 vone = _mm_set1_ps(1.0f);
+	const __m128i vtime = _mm_set1_epi32(time);
+
+	for (; i + 4 <= mCount; i += 4)
+	{
+		const __m128i ts = _mm_load_si128(reinterpret_cast<const __m128i*>(&mTimeStart[i]));
+		const __m128i te = _mm_load_si128(reinterpret_cast<const __m128i*>(&mTimeEnd[i]));
+
+		// particles spawned this frame don't move yet
+		const __m128 moving = _mm_castsi128_ps(_mm_cmplt_epi32(ts, vtime));
+
+#define FX_BATCH_AXIS( org, vel, accel )																\
+		{																								\
+			const __m128 v = _mm_load_ps(&(vel)[i]);													\
+			const __m128 o = _mm_load_ps(&(org)[i]);													\
+			const __m128 nv = _mm_add_ps(v, _mm_mul_ps(vdt, _mm_load_ps(&(accel)[i])));				\
+			const __m128 no = _mm_add_ps(o, _mm_mul_ps(vdt, nv));										\
+			_mm_store_ps(&(vel)[i], _mm_or_ps(_mm_and_ps(moving, nv), _mm_andnot_ps(moving, v)));		\
+			_mm_store_ps(&(org)[i], _mm_or_ps(_mm_and_ps(moving, no), _mm_andnot_ps(moving, o)));		\
+		}
+
+		FX_BATCH_AXIS(mOrgX, mVelX, mAccelX)
+		FX_BATCH_AXIS(mOrgY, mVelY, mAccelY)
+		FX_BATCH_AXIS(mOrgZ, mVelZ, mAccelZ)
+
+#undef FX_BATCH_AXIS
+
+		const __m128 age = _mm_cvtepi32_ps(_mm_sub_epi32(vtime, ts));
+		const __m128 life = _mm_cvtepi32_ps(_mm_sub_epi32(te, ts));
+		_mm_store_ps(&mLifePerc[i], _mm_sub_ps(vone, _mm_div_ps(age, life)));
+	}
+#endif
+
+	for (; i < mCount; i++)
+	{
+		if (mTimeStart[i] < time)
+		{
+			mVelX[i] = mVelX[i] + dt * mAccelX[i];
+			mVelY[i] = mVelY[i] + dt * mAccelY[i];
+			mVelZ[i] = mVelZ[i] + dt * mAccelZ[i];
+
+			mOrgX[i] = mOrgX[i] + dt * mVelX[i];
+			mOrgY[i] = mOrgY[i] + dt * mVelY[i];
+			mOrgZ[i] = mOrgZ[i] + dt * mVelZ[i];
+		}
+
+		mLifePerc[i] = 1.0f - static_cast<float>(time - mTimeStart[i]) / static_cast<float>(mTimeEnd[i] - mTimeStart[i]);
+	}
+}
+
+//----------------------------
+// Cull
+//
+// Same tests as CParticle::Cull
+//----------------------------
+void CParticleBatch::Cull(const vec3_t viewOrg, const vec3_t viewForward, const float nearCull)
+{
+	int i = 0;
+
+#ifdef FX_BATCH_SSE2
+	const __m128 ox = _mm_set1_ps(viewOrg[0]);
+	const __m128 oy = _mm_set1_ps(viewOrg[1]);
+	const __m128 oz = _mm_set1_ps(viewOrg[2]);
+	const __m128 fx = _mm_set1_ps(viewForward[0]);
+	const __m128 fy = _mm_set1_ps(viewForward[1]);
+	const __m128 fz = _mm_set1_ps(viewForward[2]);
+	const __m128 vnear = _mm_set1_ps(nearCull);
+	const __m128 vzero = _mm_setzero_ps();
+
+	for (; i + 4 <= mCount; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_load_ps(&mOrgX[i]), ox);
+		const __m128 dy = _mm_sub_ps(_mm_load_ps(&mOrgY[i]), oy);
+		const __m128 dz = _mm_sub_ps(_mm_load_ps(&mOrgZ[i]), oz);
+
+		const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, dx), _mm_mul_ps(fy, dy)), _mm_mul_ps(fz, dz));
+		const __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		const __m128 behind = _mm_cmplt_ps(dot, vzero);
+		const __m128 tooClose = _mm_andnot_ps(_mm_load_ps(reinterpret_cast<const float*>(&mNoNearCull[i])),
+			_mm_cmplt_ps(lenSq, vnear));
+
+		_mm_store_ps(reinterpret_cast<float*>(&mVisible[i]), _mm_andnot_ps(_mm_or_ps(behind, tooClose),
+			_mm_castsi128_ps(_mm_set1_epi32(~0))));
+	}
+#endif
+
+	for (; i < mCount; i++)
+	{
+		vec3_t dir;
+
+		dir[0] = mOrgX[i] - viewOrg[0];
+		dir[1] = mOrgY[i] - viewOrg[1];
+		dir[2] = mOrgZ[i] - viewOrg[2];
+
+		if (DotProduct(viewForward, dir) < 0)
+		{
+			mVisible[i] = 0;
+		}
+		else if (mNoNearCull[i])
+		{
+			mVisible[i] = ~0;
+		}
+		else
+		{
+			mVisible[i] = VectorLengthSquared(dir) < nearCull ? 0 : ~0;
+		}
+	}
+}
+
+//----------------------------
+// FX_BatchPerc
+//
+// The part of CParticle::UpdateSize/UpdateRGB/UpdateAlpha that picks the
+// blend between start and end values. linear, nonLinear, wave and clamp are
+// the flag values for the channel, parmMask masks its parm bits.
+//----------------------------
+static float FX_BatchPerc(const int flags, const int linear, const int parmMask, const int nonLinear,
+	const int wave, const int clamp, const float parm, const float lifePerc, const int timeStart,
+	const int timeEnd)
+{
+	const int time = theFxHelper.mTime;
+	float perc1 = 1.0f, perc2 = 1.0f;
+
+	if (flags & linear)
+	{
+		perc1 = lifePerc;
+	}
+
+	if ((flags & parmMask) == nonLinear)
+	{
+		if (time > parm)
+		{
+			perc2 = 1.0f - (time - parm) / (timeEnd - parm);
+		}
+
+		perc1 = flags & linear ? perc1 * 0.5f + perc2 * 0.5f : perc2;
+	}
+	else if ((flags & parmMask) == wave)
+	{
+		perc1 = perc1 * cosf((time - timeStart) * parm);
+	}
+	else if ((flags & parmMask) == clamp)
+	{
+		if (time < parm)
+		{
+			perc2 = (parm - time) / (parm - timeStart);
+		}
+		else
+		{
+			perc2 = 0.0f;
+		}
+
+		perc1 = flags & linear ? perc1 * 0.5f + perc2 * 0.5f : perc2;
+	}
+
+	return perc1;
+}
+
+//----------------------------
+// Draw
+//
+// Fades the particle exactly like CParticle::UpdateSize, UpdateRGB,
+// UpdateAlpha and UpdateRotation do, then hands it to the renderer.
+//----------------------------
+void CParticleBatch::Draw(const int index, const float lifePerc)
+{
+	const int flags = mFlags[index];
+	const int timeStart = mTimeStart[index];
+	const int timeEnd = mTimeEnd[index];
+	miniRefEntity_t ent;
+
+	memset(&ent, 0, sizeof ent);
+
+	// Size----------------
+	float perc = FX_BatchPerc(flags, FX_SIZE_LINEAR, FX_SIZE_PARM_MASK, FX_SIZE_NONLINEAR, FX_SIZE_WAVE,
+		FX_SIZE_CLAMP, mSizeParm[index], lifePerc, timeStart, timeEnd);
+
+	if (flags & FX_SIZE_RAND)
+	{
+		perc = flrand(0.0f, perc);
+	}
+
+	ent.radius = mSizeStart[index] * perc + mSizeEnd[index] * (1.0f - perc);
+
+	// RGB----------------
+	perc = FX_BatchPerc(flags, FX_RGB_LINEAR, FX_RGB_PARM_MASK, FX_RGB_NONLINEAR, FX_RGB_WAVE,
+		FX_RGB_CLAMP, mRGBParm[index], lifePerc, timeStart, timeEnd);
+
+	if (flags & FX_RGB_RAND)
+	{
+		perc = flrand(0.0f, perc);
+	}
+
+	vec3_t res;
+
+	VectorScale(mRGBStart[index], perc, res);
+	VectorMA(res, 1.0f - perc, mRGBEnd[index], res);
+
+	ClampRGB(res, ent.shaderRGBA);
+
+	// Alpha----------------
+	// CParticle::UpdateAlpha compares the parm bits against FX_RGB_LINEAR rather
+	//	than FX_ALPHA_CLAMP, keep doing the same so both paths look identical
+	perc = FX_BatchPerc(flags, FX_ALPHA_LINEAR, FX_ALPHA_PARM_MASK, FX_ALPHA_NONLINEAR, FX_ALPHA_WAVE,
+		FX_RGB_LINEAR, mAlphaParm[index], lifePerc, timeStart, timeEnd);
+
+	perc = mAlphaStart[index] * perc + mAlphaEnd[index] * (1.0f - perc);
+	perc = Com_Clamp(0.0f, 1.0f, perc);
+
+	if (flags & FX_ALPHA_RAND)
+	{
+		perc = flrand(0.0f, perc);
+	}
+
+	const int alpha = Com_Clamp(0, 255, perc * 255.0f);
+
+	if (flags & FX_USE_ALPHA)
+	{
+		ent.shaderRGBA[3] = static_cast<byte>(alpha);
+	}
+	else
+	{
+		ent.shaderRGBA[0] = static_cast<int>(ent.shaderRGBA[0]) * alpha >> 8;
+		ent.shaderRGBA[1] = static_cast<int>(ent.shaderRGBA[1]) * alpha >> 8;
+		ent.shaderRGBA[2] = static_cast<int>(ent.shaderRGBA[2]) * alpha >> 8;
+	}
+
+	// Rotation----------------
+	mRotation[index] += theFxHelper.mFrameTime * 0.01f * mRotationDelta[index];
+	mRotationDelta[index] *= 1.0f - theFxHelper.mFrameTime * 0.0007f;
+
+	ent.reType = RT_SPRITE;
+	ent.customShader = mShader[index];
+	ent.rotation = mRotation[index];
+	ent.origin[0] = mOrgX[index];
+	ent.origin[1] = mOrgY[index];
+	ent.origin[2] = mOrgZ[index];
+
+	if (flags & FX_DEPTH_HACK)
+	{
+		ent.renderfx |= RF_DEPTHHACK;
+	}
+
+	if (flags & FX_SET_SHADER_TIME)
+	{
+		ent.shaderTime = timeStart * 0.001f;
+	}
+
+	theFxHelper.AddFxToScene(&ent);
+	drawnFx++;
+}
+
+//----------------------------
+// Update
+//----------------------------
+void CParticleBatch::Update()
+{
+	if (!mCount)
+	{
+		return;
+	}
+
+	const int time = theFxHelper.mTime;
+
+	// Retire the dead first so the passes below only see live particles
+	for (int i = 0; i < mCount;)
+	{
+		bool runDeath;
+
+		if (time > mTimeEnd[i])
+		{
+			// FX_Add clears FX_KILL_ON_IMPACT on expired effects before they die
+			runDeath = !!(mFlags[i] & FX_DEATH_RUNS_FX);
+		}
+		else if (mTimeStart[i] > time)
+		{
+			// Game pausing can cause dumb time things to happen, so kill the effect in this instance
+			runDeath = mFlags[i] & FX_DEATH_RUNS_FX && !(mFlags[i] & FX_KILL_ON_IMPACT);
+		}
+		else
+		{
+			i++;
+			continue;
+		}
+
+		if (runDeath && mNumDeaths < MAX_BATCHED_PARTICLES)
+		{
+			SDeath& death = mDeaths[mNumDeaths++];
+
+			VectorSet(death.org, mOrgX[i], mOrgY[i], mOrgZ[i]);
+			death.id = mDeathID[i];
+		}
+
+		Remove(i);
+	}
+
+	Integrate(time, theFxHelper.mRealTime);
+	Cull(theFxHelper.refdef->vieworg, theFxHelper.refdef->viewaxis[0], fx_nearCull->value);
+
+	for (int i = 0; i < mCount; i++)
+	{
+		if (mVisible[i])
+		{
+			// Only update these if the thing is visible.
+			Draw(i, mLifePerc[i]);
+		}
+	}
+
+	// Death effects can spawn new particles into this batch, so they wait until now
+	const int numDeaths = mNumDeaths;
+	mNumDeaths = 0;
+
+	for (int i = 0; i < numDeaths; i++)
+	{
+		vec3_t norm;
+
+		VectorSet(norm, flrand(-1.0f, 1.0f), flrand(-1.0f, 1.0f), flrand(-1.0f, 1.0f));
+		VectorNormalize(norm);
+
+		theFxScheduler.PlayEffect(mDeaths[i].id, mDeaths[i].org, norm);
+	}
+}
@@ -0,0 +1,135 @@
+/*
+===========================================================================
+Copyright (C) 2000 - 2013, Raven Software, Inc.
+Copyright (C) 2001 - 2013, Activision, Inc.
+Copyright (C) 2013 - 2015, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#pragma once
+
+#include "FxPrimitives.h"
+
+// FxParticleBatch.h -- structure-of-arrays store for plain sprite particles
+
+// Particles that don't bolt to a model, aren't 2D player view sprites and
+// don't run traces are by far the most common primitive in saber and blaster
+// effects. Those live here in flat arrays instead of as heap allocated
+// CParticles in the effect list, so a frame's worth of them can be moved,
+// culled and faded in one pass. They behave exactly like CParticle does.
+constexpr auto MAX_BATCHED_PARTICLES = 2048;
+
+struct SParticleSpawn
+{
+	vec3_t org;
+	vec3_t vel;
+	vec3_t accel;
+	float sizeStart, sizeEnd, sizeParm;
+	float alphaStart, alphaEnd, alphaParm;
+	vec3_t rgbStart;
+	vec3_t rgbEnd;
+	float rgbParm;
+	float rotation, rotationDelta;
+	int deathID;
+	int killTime;
+	qhandle_t shader;
+	int flags;
+};
+
+class CParticleBatch
+{
+public:
+	CParticleBatch() : mCount(0), mNumDeaths(0)
+	{
+	}
+
+	// true if a particle with these flags can live in a batch
+	static bool CanBatch(const int flags)
+	{
+		if (flags & (FX_RELATIVE | FX_PLAYER_VIEW))
+		{
+			return false;
+		}
+
+		// traces and impact effects need a CEffect to hand to the scheduler
+		return !(flags & FX_APPLY_PHYSICS && flags & FX_EXPENSIVE_PHYSICS);
+	}
+
+	// takes the already converted parms, returns false if the batch is full
+	bool Add(const SParticleSpawn& spawn);
+
+	// moves, culls, fades and draws everything, then retires the dead
+	void Update();
+
+	// drops everything without running death effects
+	void Clear() { mCount = 0; mNumDeaths = 0; }
+
+	int Count() const { return mCount; }
+
+private:
+	void Integrate(int time, float dt);
+	void Cull(const vec3_t viewOrg, const vec3_t viewForward, float nearCull);
+	void Draw(int index, float lifePerc);
+	void Remove(int index);
+
+	int mCount;
+
+	// the hot per frame data, kept in separate arrays so they can be streamed
+	alignas(16) float mOrgX[MAX_BATCHED_PARTICLES];
+	alignas(16) float mOrgY[MAX_BATCHED_PARTICLES];
+	alignas(16) float mOrgZ[MAX_BATCHED_PARTICLES];
+	alignas(16) float mVelX[MAX_BATCHED_PARTICLES];
+	alignas(16) float mVelY[MAX_BATCHED_PARTICLES];
+	alignas(16) float mVelZ[MAX_BATCHED_PARTICLES];
+	alignas(16) float mAccelX[MAX_BATCHED_PARTICLES];
+	alignas(16) float mAccelY[MAX_BATCHED_PARTICLES];
+	alignas(16) float mAccelZ[MAX_BATCHED_PARTICLES];
+	alignas(16) int mTimeStart[MAX_BATCHED_PARTICLES];
+	alignas(16) int mTimeEnd[MAX_BATCHED_PARTICLES];
+	alignas(16) int mNoNearCull[MAX_BATCHED_PARTICLES]; // ~0 for FX_DEPTH_HACK
+	alignas(16) float mLifePerc[MAX_BATCHED_PARTICLES]; // 1 at birth, 0 at death
+	alignas(16) int mVisible[MAX_BATCHED_PARTICLES];
+
+	// only touched for particles that end up drawn
+	int mFlags[MAX_BATCHED_PARTICLES];
+	float mSizeStart[MAX_BATCHED_PARTICLES];
+	float mSizeEnd[MAX_BATCHED_PARTICLES];
+	float mSizeParm[MAX_BATCHED_PARTICLES];
+	float mAlphaStart[MAX_BATCHED_PARTICLES];
+	float mAlphaEnd[MAX_BATCHED_PARTICLES];
+	float mAlphaParm[MAX_BATCHED_PARTICLES];
+	vec3_t mRGBStart[MAX_BATCHED_PARTICLES];
+	vec3_t mRGBEnd[MAX_BATCHED_PARTICLES];
+	float mRGBParm[MAX_BATCHED_PARTICLES];
+	float mRotation[MAX_BATCHED_PARTICLES];
+	float mRotationDelta[MAX_BATCHED_PARTICLES];
+	qhandle_t mShader[MAX_BATCHED_PARTICLES];
+	int mDeathID[MAX_BATCHED_PARTICLES];
+
+	// death effects are played once the frame's pass is over, since they can add particles
+	struct SDeath
+	{
+		vec3_t org;
+		int id;
+	};
+
+	SDeath mDeaths[MAX_BATCHED_PARTICLES];
+	int mNumDeaths;
+};
+
+// one batch for the main view, one for the sky portal
+extern CParticleBatch theParticleBatch[2];
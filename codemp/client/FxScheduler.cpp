@@ -49,6 +49,212 @@ CFxScheduler::CFxScheduler()
 	mNextFree2DEffect = 0;
 	memset(&mEffectTemplates, 0, sizeof mEffectTemplates);
 	memset(&mLoopedEffectArray, 0, sizeof mLoopedEffectArray);
+
+	memset(mFxWheel0, 0, sizeof mFxWheel0);
+	memset(mFxWheelN, 0, sizeof mFxWheelN);
+	mFxFar = nullptr;
+	mFxReady[0] = mFxReady[1] = nullptr;
+	mFxWheelTime = 0;
+
+	mFreeScheduled = nullptr;
+	mNumScheduled = 0;
+	mScheduledHighWatermark = 0;
+	mNumScheduledAdded = 0;
+	mNumScheduledFired = 0;
+}
+
+CFxScheduler::~CFxScheduler()
+{
+	for (const auto block : mScheduledBlocks)
+	{
+		delete[] block;
+	}
+}
+
+//------------------------------------------------------
+// AllocScheduledEffect / FreeScheduledEffect
+//	Scheduled effects are carved out of blocks so scheduling
+//	doesn't hit the heap once the pool has warmed up
+//------------------------------------------------------
+CFxScheduler::SScheduledEffect* CFxScheduler::AllocScheduledEffect()
+{
+	if (mFreeScheduled == nullptr)
+	{
+		const auto block = new SScheduledEffect[FX_SCHEDULED_BLOCK];
+
+		for (int i = 0; i < FX_SCHEDULED_BLOCK - 1; i++)
+		{
+			block[i].mNext = &block[i + 1];
+		}
+		block[FX_SCHEDULED_BLOCK - 1].mNext = nullptr;
+
+		mScheduledBlocks.push_back(block);
+		mFreeScheduled = block;
+	}
+
+	SScheduledEffect* sfx = mFreeScheduled;
+	mFreeScheduled = sfx->mNext;
+
+	if (++mNumScheduled > mScheduledHighWatermark)
+	{
+		mScheduledHighWatermark = mNumScheduled;
+	}
+
+	return sfx;
+}
+
+void CFxScheduler::FreeScheduledEffect(SScheduledEffect* sfx)
+{
+	sfx->mNext = mFreeScheduled;
+	mFreeScheduled = sfx;
+	mNumScheduled--;
+}
+
+//------------------------------------------------------
+// ScheduleEffect
+//	Files a scheduled effect in the wheel slot for its start
+//	time, relative to how far the wheel has turned
+//------------------------------------------------------
+void CFxScheduler::ScheduleEffect(SScheduledEffect* sfx)
+{
+	const int start = sfx->mStartTime;
+	const int delta = start - mFxWheelTime;
+	SScheduledEffect** slot;
+
+	if (delta <= 0)
+	{
+		slot = &mFxReady[sfx->mPortalEffect];
+	}
+	else if (delta <= FX_WHEEL0_SIZE)
+	{
+		slot = &mFxWheel0[start & (FX_WHEEL0_SIZE - 1)];
+	}
+	else
+	{
+		slot = &mFxFar;
+
+		for (int level = 0; level < FX_WHEEL_LEVELS; level++)
+		{
+			// a slot is emptied when the wheel enters its span, so the entry
+			//	has to land within the next turn of this level
+			const int shift = FX_WHEEL0_BITS + FX_WHEELN_BITS * level;
+
+			if ((start >> shift) - (mFxWheelTime >> shift) <= FX_WHEELN_SIZE)
+			{
+				slot = &mFxWheelN[level][(start >> shift) & (FX_WHEELN_SIZE - 1)];
+				break;
+			}
+		}
+	}
+
+	sfx->mNext = *slot;
+	*slot = sfx;
+}
+
+void CFxScheduler::CascadeScheduled(SScheduledEffect* list)
+{
+	while (list)
+	{
+		SScheduledEffect* next = list->mNext;
+		ScheduleEffect(list);
+		list = next;
+	}
+}
+
+//------------------------------------------------------
+// CollectScheduled
+//	Pulls every pending entry out of the wheel, in no
+//	particular order
+//------------------------------------------------------
+CFxScheduler::SScheduledEffect* CFxScheduler::CollectScheduled()
+{
+	SScheduledEffect* all = nullptr;
+
+	const auto take = [&all](SScheduledEffect*& list)
+	{
+		while (list)
+		{
+			SScheduledEffect* next = list->mNext;
+			list->mNext = all;
+			all = list;
+			list = next;
+		}
+	};
+
+	for (auto& slot : mFxWheel0)
+	{
+		take(slot);
+	}
+	for (auto& level : mFxWheelN)
+	{
+		for (auto& slot : level)
+		{
+			take(slot);
+		}
+	}
+	take(mFxFar);
+	take(mFxReady[0]);
+	take(mFxReady[1]);
+
+	return all;
+}
+
+//------------------------------------------------------
+// AdvanceSchedule
+//	Turns the wheel up to the given time, moving everything
+//	that has come due onto the ready lists
+//------------------------------------------------------
+void CFxScheduler::AdvanceSchedule(const int time)
+{
+	if (time < mFxWheelTime || time - mFxWheelTime > FX_WHEEL0_SIZE << FX_WHEELN_BITS)
+	{
+		// time went backwards (map change, demo seek) or jumped a long way,
+		//	just refile everything rather than stepping through each msec
+		SScheduledEffect* all = CollectScheduled();
+		mFxWheelTime = time;
+		CascadeScheduled(all);
+		return;
+	}
+
+	while (mFxWheelTime < time)
+	{
+		const int t = ++mFxWheelTime;
+
+		if ((t & (FX_WHEEL0_SIZE - 1)) == 0)
+		{
+			// level 0 wrapped, pull the next slot down from the levels above,
+			//	highest first so entries can fall all the way through
+			int levels = 1;
+			while (levels < FX_WHEEL_LEVELS &&
+				((t >> (FX_WHEEL0_BITS + FX_WHEELN_BITS * levels - FX_WHEELN_BITS)) & (FX_WHEELN_SIZE - 1)) == 0)
+			{
+				levels++;
+			}
+
+			if (levels == FX_WHEEL_LEVELS && (t & (FX_WHEEL_SPAN - 1)) == 0)
+			{
+				SScheduledEffect* far = mFxFar;
+				mFxFar = nullptr;
+				CascadeScheduled(far);
+			}
+
+			for (int level = levels - 1; level >= 0; level--)
+			{
+				const int shift = FX_WHEEL0_BITS + FX_WHEELN_BITS * level;
+				SScheduledEffect*& slot = mFxWheelN[level][(t >> shift) & (FX_WHEELN_SIZE - 1)];
+				SScheduledEffect* list = slot;
+
+				slot = nullptr;
+				CascadeScheduled(list);
+			}
+		}
+
+		SScheduledEffect*& slot = mFxWheel0[t & (FX_WHEEL0_SIZE - 1)];
+		SScheduledEffect* list = slot;
+
+		slot = nullptr;
+		CascadeScheduled(list);
+	}
 }
 
 int CFxScheduler::ScheduleLoopedEffect(const int id, const int boltInfo, CGhoul2Info_v* ghoul2, const bool isPortal,
@@ -194,19 +400,17 @@ SEffectTemplate& SEffectTemplate::operator=(const SEffectTemplate& that)
 void CFxScheduler::Clean(const bool bRemoveTemplates /*= true*/, const int idToPreserve /*= 0*/)
 {
 	// Ditch any scheduled effects
-	auto itr = mFxSchedule.begin();
+	SScheduledEffect* sfx = CollectScheduled();
 
-	while (itr != mFxSchedule.end())
+	while (sfx)
 	{
-		auto next = itr;
-		++next;
-
-		mScheduledEffectsPool.Free(*itr);
-		mFxSchedule.erase(itr);
-
-		itr = next;
+		SScheduledEffect* next = sfx->mNext;
+		FreeScheduledEffect(sfx);
+		sfx = next;
 	}
 
+	mFxWheelTime = theFxHelper.mTime;
+
 	if (bRemoveTemplates)
 	{
 		// Ditch any effect templates
@@ -918,12 +1122,7 @@ void CFxScheduler::PlayEffect(const int id, vec3_t origin, matrix3_t axis, const
 			}
 			else
 			{
-				SScheduledEffect* sfx = mScheduledEffectsPool.Alloc();
-
-				if (sfx == nullptr)
-				{
-					Com_Error(ERR_DROP, "ERROR: Failed to allocate EFX from memory pool.");
-				}
+				SScheduledEffect* sfx = AllocScheduledEffect();
 
 				sfx->mStartTime = theFxHelper.mTime + delay;
 				sfx->mpTemplate = prim;
@@ -973,7 +1172,8 @@ void CFxScheduler::PlayEffect(const int id, vec3_t origin, matrix3_t axis, const
 					sfx->mStartTime++;
 				}
 
-				mFxSchedule.push_front(sfx);
+				ScheduleEffect(sfx);
+				mNumScheduledAdded++;
 			}
 		}
 	}
@@ -1048,9 +1248,10 @@ bool gEffectsInPortal = qfalse;
 
 void CFxScheduler::AddScheduledEffects(const bool portal)
 {
-	TScheduledEffect::iterator next;
 	int oldEntNum = -1, oldBoltIndex = -1, oldModelNum = -1;
 	qboolean doesBoltExist = qfalse;
+	matrix3_t axis;
+	vec3_t origin;
 
 	if (portal)
 	{
@@ -1061,78 +1262,76 @@ void CFxScheduler::AddScheduledEffects(const bool portal)
 		AddLoopedEffects();
 	}
 
-	for (auto itr = mFxSchedule.begin(); itr != mFxSchedule.end(); /* do nothing */)
+	AdvanceSchedule(theFxHelper.mTime);
+
+	//only render portal fx on the skyportal pass and vice versa, anything
+	//	scheduled while these are being created waits for the next pass
+	SScheduledEffect* effect = mFxReady[portal];
+	mFxReady[portal] = nullptr;
+
+	while (effect)
 	{
-		SScheduledEffect* effect = *itr;
+		SScheduledEffect* next = effect->mNext;
 
-		if (portal == effect->mPortalEffect && effect->mStartTime <= theFxHelper.mTime)
+		if (effect->mBoltNum == -1)
 		{
-			//only render portal fx on the skyportal pass and vice versa
-			if (effect->mBoltNum == -1)
+			// ok, are we spawning a bolt on effect or a normal one?
+			if (effect->mEntNum != ENTITYNUM_NONE)
 			{
-				// ok, are we spawning a bolt on effect or a normal one?
-				if (effect->mEntNum != ENTITYNUM_NONE)
-				{
-					// Find out where the entity currently is
-					const auto data = reinterpret_cast<TCGVectorData*>(cl.mSharedMemory);
+				// Find out where the entity currently is
+				const auto data = reinterpret_cast<TCGVectorData*>(cl.mSharedMemory);
+
+				data->mentity_num = effect->mEntNum;
+				CGVM_GetLerpOrigin();
+				CreateEffect(effect->mpTemplate,
+					data->mPoint, effect->mAxis,
+					theFxHelper.mTime - effect->mStartTime);
+			}
+			else
+			{
+				CreateEffect(effect->mpTemplate,
+					effect->mOrigin, effect->mAxis,
+					theFxHelper.mTime - effect->mStartTime);
+			}
+		}
+		else
+		{
+			//bolted on effect
+			// do we need to go and re-get the bolt matrix again? Since it takes time lets try to do it only once
+			if (effect->mModelNum != oldModelNum ||
+				effect->mEntNum != oldEntNum ||
+				effect->mBoltNum != oldBoltIndex)
+			{
+				oldModelNum = effect->mModelNum;
+				oldEntNum = effect->mEntNum;
+				oldBoltIndex = effect->mBoltNum;
 
-					data->mentity_num = effect->mEntNum;
-					CGVM_GetLerpOrigin();
+				doesBoltExist = theFxHelper.GetOriginAxisFromBolt(effect->ghoul2, effect->mEntNum,
+					effect->mModelNum, effect->mBoltNum, origin,
+					axis);
+			}
+
+			// only do this if we found the bolt
+			if (doesBoltExist)
+			{
+				if (effect->mIsRelative)
+				{
 					CreateEffect(effect->mpTemplate,
-						data->mPoint, effect->mAxis,
-						theFxHelper.mTime - effect->mStartTime);
+						origin, axis, 0, -1,
+						effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum);
 				}
 				else
 				{
 					CreateEffect(effect->mpTemplate,
-						effect->mOrigin, effect->mAxis,
+						origin, axis,
 						theFxHelper.mTime - effect->mStartTime);
 				}
 			}
-			else
-			{
-				matrix3_t axis;
-				vec3_t origin;
-				//bolted on effect
-				// do we need to go and re-get the bolt matrix again? Since it takes time lets try to do it only once
-				if (effect->mModelNum != oldModelNum ||
-					effect->mEntNum != oldEntNum ||
-					effect->mBoltNum != oldBoltIndex)
-				{
-					oldModelNum = effect->mModelNum;
-					oldEntNum = effect->mEntNum;
-					oldBoltIndex = effect->mBoltNum;
-
-					doesBoltExist = theFxHelper.GetOriginAxisFromBolt(effect->ghoul2, effect->mEntNum,
-						effect->mModelNum, effect->mBoltNum, origin,
-						axis);
-				}
-
-				// only do this if we found the bolt
-				if (doesBoltExist)
-				{
-					if (effect->mIsRelative)
-					{
-						CreateEffect(effect->mpTemplate,
-							origin, axis, 0, -1,
-							effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum);
-					}
-					else
-					{
-						CreateEffect(effect->mpTemplate,
-							origin, axis,
-							theFxHelper.mTime - effect->mStartTime);
-					}
-				}
-			}
-
-			mScheduledEffectsPool.Free(effect);
-			itr = mFxSchedule.erase(itr);
-		}
-		else
-		{
-			++itr;
 		}
+
+		FreeScheduledEffect(effect);
+		mNumScheduledFired++;
+		effect = next;
 	}
 
 	// Add all active effects into the scene
@@ -395,181 +395,6 @@ struct SEffectTemplate
 	SEffectTemplate& operator=(const SEffectTemplate& that);
 };
 
-template <typename T, int N>
-class PoolAllocator
-{
-public:
-	PoolAllocator()
-		: pool(new T[N])
-		, freeAndAllocated(new int[N])
-		, numFree(N)
-		, highWatermark(0)
-	{
-		for (int i = 0; i < N; i++)
-		{
-			freeAndAllocated[i] = i;
-		}
-	}
-
-	T* Alloc()
-	{
-		if (numFree == 0)
-		{
-			return nullptr;
-		}
-
-		T* ptr = new(&pool[freeAndAllocated[0]]) T;
-
-		std::rotate(freeAndAllocated, freeAndAllocated + 1, freeAndAllocated + N);
-		numFree--;
-
-		highWatermark = Q_max(highWatermark, N - numFree);
-
-		return ptr;
-	}
-
-	void TransferTo(PoolAllocator<T, N>& allocator)
-	{
-		allocator.freeAndAllocated = freeAndAllocated;
-		allocator.highWatermark = highWatermark;
-		allocator.numFree = numFree;
-		allocator.pool = pool;
-
-		highWatermark = 0;
-		numFree = N;
-		freeAndAllocated = nullptr;
-		pool = NULL;
-	}
-
-	bool OwnsPtr(const T* ptr) const
-	{
-		return ptr >= pool && ptr < pool + N;
-	}
-
-	void Free(T* ptr)
-	{
-		for (int i = numFree; i < N; i++)
-		{
-			T* p = &pool[freeAndAllocated[i]];
-
-			if (p == ptr)
-			{
-				if (i > numFree)
-				{
-					std::rotate(freeAndAllocated + numFree, freeAndAllocated + i, freeAndAllocated + i + 1);
-				}
-
-				p->~T();
-				numFree++;
-
-				break;
-			}
-		}
-	}
-
-	int GetHighWatermark() const { return highWatermark; }
-
-	~PoolAllocator()
-	{
-		for (int i = numFree; i < N; i++)
-		{
-			T* p = &pool[freeAndAllocated[i]];
-
-			p->~T();
-		}
-
-		delete[] freeAndAllocated;
-		delete[] pool;
-	}
-
-private:
-	PoolAllocator(const PoolAllocator<T, N>&);
-	PoolAllocator& operator =(const PoolAllocator<T, N>&);
-
-	T* pool;
-
-	// The first 'numFree' elements are the indexes of the free slots.
-	// The remaining elements are the indexes of the allocated slots.
-	int* freeAndAllocated;
-	int numFree;
-
-	int highWatermark;
-};
-
-template <typename T, int N>
-class PagedPoolAllocator
-{
-public:
-	PagedPoolAllocator()
-		: numPages(1)
-		, pages(new PoolAllocator<T, N>[1]())
-	{
-	}
-
-	T* Alloc()
-	{
-		T* ptr = nullptr;
-		for (int i = 0; i < numPages && ptr == nullptr; i++)
-		{
-			ptr = pages[i].Alloc();
-		}
-
-		if (ptr == nullptr)
-		{
-			PoolAllocator<T, N>* newPages = new PoolAllocator<T, N>[numPages + 1]();
-			for (int i = 0; i < numPages; i++)
-			{
-				pages[i].TransferTo(newPages[i]);
-			}
-
-			delete[] pages;
-			pages = newPages;
-
-			ptr = pages[numPages].Alloc();
-			if (ptr == nullptr)
-			{
-				return nullptr;
-			}
-
-			numPages++;
-		}
-
-		return ptr;
-	}
-
-	void Free(T* ptr)
-	{
-		for (int i = 0; i < numPages; i++)
-		{
-			if (pages[i].OwnsPtr(ptr))
-			{
-				pages[i].Free(ptr);
-				break;
-			}
-		}
-	}
-
-	int GetHighWatermark() const
-	{
-		int total = 0;
-		for (int i = 0; i < numPages; i++)
-		{
-			total += pages[i].GetHighWatermark();
-		}
-
-		return total;
-	}
-
-	~PagedPoolAllocator()
-	{
-		delete[] pages;
-	}
-
-private:
-	int numPages;
-	PoolAllocator<T, N>* pages;
-};
-
 //-----------------------------------------------------------------
 //
 // CFxScheduler
@@ -595,6 +420,7 @@ private:
 		CGhoul2Info_v* ghoul2;
 		vec3_t mOrigin;
 		matrix3_t mAxis;
+		SScheduledEffect* mNext; // next in the same wheel slot, or in the free list
 	};
 
 	/* Looped Effects get stored and reschedule at mRepeatRate */
@@ -643,8 +469,6 @@ private:
 	// this makes looking up the index based on the string name much easier
 	using TEffectID = std::map<std::string, int>;
 
-	using TScheduledEffect = std::list<SScheduledEffect*>;
-
 	// Effects
 	SEffectTemplate mEffectTemplates[FX_MAX_EFFECTS];
 	TEffectID mEffectIDs; // if you only have the unique effect name, you'll have to use this to get the ID.
@@ -653,10 +477,44 @@ private:
 	CScheduled2DEffect m2DEffects[FX_MAX_2DEFFECTS];
 	int mNextFree2DEffect;
 
-	// List of scheduled effects that will need to be created at the correct time.
-	TScheduledEffect mFxSchedule;
+	// Scheduled effects that will need to be created at the correct time live
+	//	in a timing wheel. Level 0 has a slot per msec for the next 256 msec, a
+	//	slot on each level above covers a full turn of the level below, and
+	//	anything further out than that waits in mFxFar. Entries move down a
+	//	level as their time gets close, and into mFxReady once they are due.
+	enum
+	{
+		FX_WHEEL0_BITS = 8,
+		FX_WHEEL0_SIZE = 1 << FX_WHEEL0_BITS,
+		FX_WHEELN_BITS = 6,
+		FX_WHEELN_SIZE = 1 << FX_WHEELN_BITS,
+		FX_WHEEL_LEVELS = 2, // above level 0
+		FX_WHEEL_SPAN = FX_WHEEL0_SIZE << (FX_WHEELN_BITS * FX_WHEEL_LEVELS),
+		FX_SCHEDULED_BLOCK = 1024
+	};
 
-	PagedPoolAllocator<SScheduledEffect, 1024> mScheduledEffectsPool;
+	SScheduledEffect* mFxWheel0[FX_WHEEL0_SIZE];
+	SScheduledEffect* mFxWheelN[FX_WHEEL_LEVELS][FX_WHEELN_SIZE];
+	SScheduledEffect* mFxFar;
+	SScheduledEffect* mFxReady[2]; // due, indexed by mPortalEffect
+	int mFxWheelTime; // everything up to this time has been moved to mFxReady
+
+	// entries come from blocks that are never freed, spares are kept in a list
+	std::vector<SScheduledEffect*> mScheduledBlocks;
+	SScheduledEffect* mFreeScheduled;
+	int mNumScheduled;
+	int mScheduledHighWatermark;
+
+	// for fx_debug, since the last GetScheduleCounts
+	int mNumScheduledAdded;
+	int mNumScheduledFired;
+
+	SScheduledEffect* AllocScheduledEffect();
+	void FreeScheduledEffect(SScheduledEffect* sfx);
+	void ScheduleEffect(SScheduledEffect* sfx);
+	void CascadeScheduled(SScheduledEffect* list);
+	void AdvanceSchedule(int time);
+	SScheduledEffect* CollectScheduled();
 
 	// Private function prototypes
 	SEffectTemplate* GetNewEffectTemplate(int* id, const char* file);
@@ -670,6 +528,7 @@ private:
 
 public:
 	CFxScheduler();
+	~CFxScheduler();
 
 	int RegisterEffect(const char* path, bool bHasCorrectPath = false); // handles pre-caching
 
@@ -697,8 +556,16 @@ public:
 	// kef -- called once per cgame frame AFTER trap->RenderScene
 	void Draw2DEffects(float screenXScale, float screenYScale);
 
-	int GetHighWatermark() const { return mScheduledEffectsPool.GetHighWatermark(); }
-	int NumScheduledFx() const { return static_cast<int>(mFxSchedule.size()); }
+	int GetHighWatermark() const { return mScheduledHighWatermark; }
+	int NumScheduledFx() const { return mNumScheduled; }
+
+	// how many effects were scheduled and fired since the last call
+	void GetScheduleCounts(int* added, int* fired)
+	{
+		*added = mNumScheduledAdded;
+		*fired = mNumScheduledFired;
+		mNumScheduledAdded = mNumScheduledFired = 0;
+	}
 	void Clean(bool bRemoveTemplates = true, int idToPreserve = 0); // clean out the system
 
 	// FX Override functions
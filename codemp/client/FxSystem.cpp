@@ -32,6 +32,7 @@ cvar_t* fx_freeze;
 cvar_t* fx_countScale;
 cvar_t* fx_nearCull;
 cvar_t* fx_optimizedParticles;
+cvar_t* fx_particleBatch;
 
 constexpr auto DEFAULT_EXPLOSION_RADIUS = 512;
 
@@ -41,7 +42,7 @@ SFxHelper::SFxHelper() :
 	mTime(0),
 	mOldTime(0),
 	mFrameTime(0),
-	mTimeFrozen(false), mRealTime(0),
+	mTimeFrozen(false), mSkipDraw(false), mRealTime(0),
 	refdef(nullptr)
 {
 }
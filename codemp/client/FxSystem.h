@@ -34,6 +34,7 @@ extern cvar_t* fx_freeze;
 extern cvar_t* fx_countScale;
 extern cvar_t* fx_nearCull;
 extern cvar_t* fx_optimizedParticles;
+extern cvar_t* fx_particleBatch;
 
 class SFxHelper
 {
@@ -42,6 +43,7 @@ public:
 	int mOldTime;
 	int mFrameTime;
 	bool mTimeFrozen;
+	bool mSkipDraw; // set by fx_particleBench so nothing reaches the renderer
 	float mRealTime;
 	refdef_t* refdef;
 #ifdef _DEBUG
@@ -168,6 +170,11 @@ public:
 
 	void AddFxToScene(const refEntity_t* ent)
 	{
+		if (mSkipDraw)
+		{
+			return;
+		}
+
 #ifdef _DEBUG
 		mMainRefs++;
 
@@ -178,6 +185,11 @@ public:
 
 	void AddFxToScene(const miniRefEntity_t* ent)
 	{
+		if (mSkipDraw)
+		{
+			return;
+		}
+
 #ifdef _DEBUG
 		mMiniRefs++;
 
@@ -22,6 +22,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "client.h"
 #include "FxScheduler.h"
+#include "FxParticleBatch.h"
 
 vec3_t WHITE = { 1.0f, 1.0f, 1.0f };
 
@@ -42,6 +43,17 @@ int activeFx = 0;
 int drawnFx;
 qboolean fxInitialized = qfalse;
 
+// fx_particleRecord / fx_particleBench
+struct SRecordedParticle
+{
+	int time; // since recording started
+	SParticleSpawn spawn;
+};
+
+static std::vector<SRecordedParticle> recordedParticles;
+static bool fxRecordParticles = false;
+static int fxRecordStart;
+
 //-------------------------
 // FX_Free
 //
@@ -61,6 +73,9 @@ bool FX_Free(const bool templates)
 
 	activeFx = 0;
 
+	theParticleBatch[0].Clear();
+	theParticleBatch[1].Clear();
+
 	theFxScheduler.Clean(templates);
 	return true;
 }
@@ -84,6 +99,9 @@ void FX_Stop()
 
 	activeFx = 0;
 
+	theParticleBatch[0].Clear();
+	theParticleBatch[1].Clear();
+
 	theFxScheduler.Clean(false);
 }
 
@@ -113,6 +131,7 @@ int FX_Init(refdef_t* refdef)
 	fx_countScale = Cvar_Get("fx_countScale", "1", CVAR_ARCHIVE_ND);
 	fx_nearCull = Cvar_Get("fx_nearCull", "16", CVAR_ARCHIVE_ND);
 	fx_optimizedParticles = Cvar_Get("fx_optimizedParticles", "0", CVAR_ARCHIVE);
+	fx_particleBatch = Cvar_Get("fx_particleBatch", "1", CVAR_ARCHIVE_ND);
 
 	theFxHelper.ReInit(refdef);
 
@@ -219,12 +238,19 @@ void FX_Add(const bool portal)
 		}
 	}
 
+	theParticleBatch[portal].Update();
+
 	if (fx_debug->integer && !portal)
 	{
 		theFxHelper.Print("Active    FX: %i\n", activeFx);
+		theFxHelper.Print("Batched   FX: %i\n", theParticleBatch[0].Count() + theParticleBatch[1].Count());
 		theFxHelper.Print("Drawn     FX: %i\n", drawnFx);
 		theFxHelper.Print("Scheduled FX: %i High: %i\n", theFxScheduler.NumScheduledFx(),
 			theFxScheduler.GetHighWatermark());
+
+		int added, fired;
+		theFxScheduler.GetScheduleCounts(&added, &fired);
+		theFxHelper.Print("Schedule  FX: %i added, %i fired\n", added, fired);
 	}
 }
 
@@ -250,8 +276,89 @@ void FX_AddPrimitive(CEffect** p_effect, const int kill_time)
 	(*p_effect)->SetTimeEnd(theFxHelper.mTime + kill_time);
 }
 
+//-------------------------
+//  FX_ConvertParm
+//
+// Turns a template's wave frequency or 0-100 percent of life into what the
+// primitives expect at runtime
+//-------------------------
+static float FX_ConvertParm(const int flags, const int parm_mask, const int wave, const float parm,
+	const int kill_time)
+{
+	if ((flags & parm_mask) == wave)
+	{
+		return parm * PI * 0.001f;
+	}
+	if (flags & parm_mask)
+	{
+		return parm * 0.01f * kill_time + theFxHelper.mTime;
+	}
+	return 0.0f;
+}
+
+//-------------------------
+//  FX_NewParticle
+//
+// Sets up everything but the physics and bolt info, the caller runs Init
+//-------------------------
+static CParticle* FX_NewParticle(SParticleSpawn& spawn)
+{
+	const auto fx = new CParticle;
+
+	fx->SetOrigin1(spawn.org);
+	fx->SetVel(spawn.vel);
+	fx->SetAccel(spawn.accel);
+
+	// RGB----------------
+	fx->SetRGBStart(spawn.rgbStart);
+	fx->SetRGBEnd(spawn.rgbEnd);
+	if (spawn.flags & FX_RGB_PARM_MASK)
+	{
+		fx->SetRGBParm(spawn.rgbParm);
+	}
+
+	// Alpha----------------
+	fx->SetAlphaStart(spawn.alphaStart);
+	fx->SetAlphaEnd(spawn.alphaEnd);
+	if (spawn.flags & FX_ALPHA_PARM_MASK)
+	{
+		fx->SetAlphaParm(spawn.alphaParm);
+	}
+
+	// Size----------------
+	fx->SetSizeStart(spawn.sizeStart);
+	fx->SetSizeEnd(spawn.sizeEnd);
+	if (spawn.flags & FX_SIZE_PARM_MASK)
+	{
+		fx->SetSizeParm(spawn.sizeParm);
+	}
+
+	fx->SetFlags(spawn.flags);
+	fx->SetShader(spawn.shader);
+	fx->SetRotation(spawn.rotation);
+	fx->SetRotationDelta(spawn.rotationDelta);
+	fx->SetDeathFxID(spawn.deathID);
+
+	return fx;
+}
+
+static void FX_CopyOrClear(const vec3_t in, vec3_t out)
+{
+	if (in)
+	{
+		VectorCopy(in, out);
+	}
+	else
+	{
+		VectorClear(out);
+	}
+}
+
 //-------------------------
 //  FX_AddParticle
+//
+// Returns NULL when the particle went into a CParticleBatch rather than the
+// effect list
 //-------------------------
 CParticle* FX_AddParticle(vec3_t org, vec3_t vel, vec3_t accel, const float size1, const float size2,
 	const float size_parm,
@@ -271,80 +378,57 @@ CParticle* FX_AddParticle(vec3_t org, vec3_t vel, vec3_t accel, const float size
 		return nullptr;
 	}
 
-	auto fx = new CParticle;
-
-	if (fx)
+	SParticleSpawn spawn;
+
+	FX_CopyOrClear(org, spawn.org);
+	FX_CopyOrClear(vel, spawn.vel);
+	FX_CopyOrClear(accel, spawn.accel);
+	FX_CopyOrClear(s_rgb, spawn.rgbStart);
+	FX_CopyOrClear(e_rgb, spawn.rgbEnd);
+	spawn.rgbParm = FX_ConvertParm(flags, FX_RGB_PARM_MASK, FX_RGB_WAVE, rgb_parm, kill_time);
+	spawn.alphaStart = alpha1;
+	spawn.alphaEnd = alpha2;
+	spawn.alphaParm = FX_ConvertParm(flags, FX_ALPHA_PARM_MASK, FX_ALPHA_WAVE, alpha_parm, kill_time);
+	spawn.sizeStart = size1;
+	spawn.sizeEnd = size2;
+	spawn.sizeParm = FX_ConvertParm(flags, FX_SIZE_PARM_MASK, FX_SIZE_WAVE, size_parm, kill_time);
+	spawn.rotation = rotation;
+	spawn.rotationDelta = rotation_delta;
+	spawn.deathID = death_id;
+	spawn.killTime = kill_time;
+	spawn.shader = shader;
+	spawn.flags = flags;
+
+	if (CParticleBatch::CanBatch(flags))
 	{
-		if (flags & FX_RELATIVE && ghoul2 != nullptr)
-		{
-			fx->SetOrigin1(nullptr);
-			fx->SetOrgOffset(org);
-			fx->SetBoltinfo(ghoul2, entNum, model_num, bolt_num);
-		}
-		else
-		{
-			fx->SetOrigin1(org);
-		}
-		fx->SetOrigin1(org);
-		fx->SetMatImpactFX(mat_impact_fx);
-		fx->SetMatImpactParm(fx_parm);
-		fx->SetVel(vel);
-		fx->SetAccel(accel);
-
-		// RGB----------------
-		fx->SetRGBStart(s_rgb);
-		fx->SetRGBEnd(e_rgb);
-
-		if ((flags & FX_RGB_PARM_MASK) == FX_RGB_WAVE)
+		if (fxRecordParticles && recordedParticles.size() < 65536)
 		{
-			fx->SetRGBParm(rgb_parm * PI * 0.001f);
-		}
-		else if (flags & FX_RGB_PARM_MASK)
-		{
-			// rgbParm should be a value from 0-100..
-			fx->SetRGBParm(rgb_parm * 0.01f * kill_time + theFxHelper.mTime);
+			recordedParticles.push_back({ theFxHelper.mTime - fxRecordStart, spawn });
 		}
 
-		// Alpha----------------
-		fx->SetAlphaStart(alpha1);
-		fx->SetAlphaEnd(alpha2);
-
-		if ((flags & FX_ALPHA_PARM_MASK) == FX_ALPHA_WAVE)
+		if (fx_particleBatch->integer && theParticleBatch[gEffectsInPortal].Add(spawn))
 		{
-			fx->SetAlphaParm(alpha_parm * PI * 0.001f);
-		}
-		else if (flags & FX_ALPHA_PARM_MASK)
-		{
-			fx->SetAlphaParm(alpha_parm * 0.01f * kill_time + theFxHelper.mTime);
+			return nullptr;
 		}
+	}
 
-		// Size----------------
-		fx->SetSizeStart(size1);
-		fx->SetSizeEnd(size2);
+	auto fx = FX_NewParticle(spawn);
 
-		if ((flags & FX_SIZE_PARM_MASK) == FX_SIZE_WAVE)
-		{
-			fx->SetSizeParm(size_parm * PI * 0.001f);
-		}
-		else if (flags & FX_SIZE_PARM_MASK)
-		{
-			fx->SetSizeParm(size_parm * 0.01f * kill_time + theFxHelper.mTime);
-		}
-
-		fx->SetFlags(flags);
-		fx->SetShader(shader);
-		fx->SetRotation(rotation);
-		fx->SetRotationDelta(rotation_delta);
-		fx->SetElasticity(elasticity);
-		fx->SetMin(min);
-		fx->SetMax(max);
-		fx->SetDeathFxID(death_id);
-		fx->SetImpactFxID(impact_id);
+	if (flags & FX_RELATIVE && ghoul2 != nullptr)
+	{
+		fx->SetOrgOffset(org);
+		fx->SetBoltinfo(ghoul2, entNum, model_num, bolt_num);
+	}
+	fx->SetMatImpactFX(mat_impact_fx);
+	fx->SetMatImpactParm(fx_parm);
+	fx->SetElasticity(elasticity);
+	fx->SetMin(min);
+	fx->SetMax(max);
+	fx->SetImpactFxID(impact_id);
 
-		fx->Init();
+	fx->Init();
 
-		FX_AddPrimitive(reinterpret_cast<CEffect**>(&fx), kill_time);
-	}
+	FX_AddPrimitive(reinterpret_cast<CEffect**>(&fx), kill_time);
 
 	return fx;
 }
@@ -1251,4 +1335,307 @@ CBezier* FX_AddBezier(vec3_t start, vec3_t end,
 	}
 
 	return fx;
-}
\ No newline at end of file
+}
+//-------------------------
+// FX_ParticleRecord_f
+//
+// Toggles capturing every batchable particle as it spawns, for fx_particleBench
+//-------------------------
+void FX_ParticleRecord_f(void)
+{
+	if (fxRecordParticles)
+	{
+		fxRecordParticles = false;
+		Com_Printf("Recorded %i particles over %i msec\n", static_cast<int>(recordedParticles.size()),
+			theFxHelper.mTime - fxRecordStart);
+		return;
+	}
+
+	recordedParticles.clear();
+	fxRecordStart = theFxHelper.mTime;
+	fxRecordParticles = true;
+
+	Com_Printf("Recording particles, run fx_particleRecord again to stop\n");
+}
+
+constexpr auto FX_BENCH_FRAME_MSEC = 16;
+
+//-------------------------
+// FX_ParticleBench_f
+//
+// Replays the recorded particles, or a synthetic stream when nothing was
+// recorded, through both the CParticle and the CParticleBatch path without
+// drawing anything and prints how long each took
+//-------------------------
+void FX_ParticleBench_f(void)
+{
+	if (fxRecordParticles)
+	{
+		Com_Printf("Stop fx_particleRecord first\n");
+		return;
+	}
+
+	const int passes = Cmd_Argc() > 1 ? Com_Clampi(1, 100, atoi(Cmd_Argv(1))) : 4;
+	std::vector<SRecordedParticle> stream = recordedParticles;
+	int baseTime = fxRecordStart;
+
+	if (stream.empty())
+	{
+		// something like a steady rain of blaster sparks
+		baseTime = 0;
+		for (int t = 0; t < 2000; t += FX_BENCH_FRAME_MSEC)
+		{
+			for (int j = 0; j < 32; j++)
+			{
+				SRecordedParticle p;
+
+				memset(&p, 0, sizeof p);
+				p.time = t;
+				VectorSet(p.spawn.org, 256.0f + flrand(-1.0f, 1.0f) * 64.0f, flrand(-1.0f, 1.0f) * 64.0f, flrand(-1.0f, 1.0f) * 64.0f);
+				VectorSet(p.spawn.vel, flrand(-1.0f, 1.0f) * 100.0f, flrand(-1.0f, 1.0f) * 100.0f, flrand(0.0f, 1.0f) * 200.0f);
+				VectorSet(p.spawn.accel, 0.0f, 0.0f, -400.0f);
+				VectorCopy(WHITE, p.spawn.rgbStart);
+				VectorCopy(WHITE, p.spawn.rgbEnd);
+				p.spawn.sizeStart = 4.0f;
+				p.spawn.sizeEnd = 1.0f;
+				p.spawn.alphaStart = 1.0f;
+				p.spawn.rotationDelta = flrand(-1.0f, 1.0f) * 10.0f;
+				p.spawn.killTime = irand(300, 1000);
+				p.spawn.flags = FX_SIZE_LINEAR | FX_ALPHA_LINEAR;
+				stream.push_back(p);
+			}
+		}
+	}
+
+	int endTime = 0;
+	for (auto& p : stream)
+	{
+		// death effects would go through the scheduler and muddy the timings
+		p.spawn.flags &= ~FX_DEATH_RUNS_FX;
+		endTime = Q_max(endTime, p.time + p.spawn.killTime);
+	}
+	endTime += FX_BENCH_FRAME_MSEC;
+
+	const SFxHelper savedHelper = theFxHelper;
+	const int savedDrawn = drawnFx;
+	refdef_t benchRefdef;
+
+	if (!theFxHelper.refdef)
+	{
+		memset(&benchRefdef, 0, sizeof benchRefdef);
+		AxisClear(benchRefdef.viewaxis);
+		theFxHelper.refdef = &benchRefdef;
+	}
+	theFxHelper.mSkipDraw = true;
+
+	// CParticle path
+	std::vector<CParticle*> live;
+	std::vector<int> killTimes;
+	int objectDrawn = 0;
+	int start = Sys_Milliseconds();
+
+	for (int pass = 0; pass < passes; pass++)
+	{
+		size_t next = 0;
+
+		theFxHelper.mTime = baseTime;
+		for (int t = 0; t <= endTime; t += FX_BENCH_FRAME_MSEC)
+		{
+			theFxHelper.AdjustTime(baseTime + t + FX_BENCH_FRAME_MSEC);
+
+			for (; next < stream.size() && stream[next].time <= t; next++)
+			{
+				const auto fx = FX_NewParticle(stream[next].spawn);
+
+				fx->Init();
+				fx->SetTimeStart(theFxHelper.mTime);
+				fx->SetTimeEnd(theFxHelper.mTime + stream[next].spawn.killTime);
+				live.push_back(fx);
+				killTimes.push_back(theFxHelper.mTime + stream[next].spawn.killTime);
+			}
+
+			drawnFx = 0;
+			for (size_t i = 0; i < live.size();)
+			{
+				if (theFxHelper.mTime > killTimes[i] || !live[i]->Update())
+				{
+					delete live[i];
+					live[i] = live.back();
+					killTimes[i] = killTimes.back();
+					live.pop_back();
+					killTimes.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+			objectDrawn += drawnFx;
+		}
+
+		for (const auto fx : live)
+		{
+			delete fx;
+		}
+		live.clear();
+		killTimes.clear();
+	}
+
+	const int objectMsec = Sys_Milliseconds() - start;
+
+	// CParticleBatch path
+	const auto batch = new CParticleBatch;
+	int batchDrawn = 0;
+	int dropped = 0;
+	start = Sys_Milliseconds();
+
+	for (int pass = 0; pass < passes; pass++)
+	{
+		size_t next = 0;
+
+		theFxHelper.mTime = baseTime;
+		for (int t = 0; t <= endTime; t += FX_BENCH_FRAME_MSEC)
+		{
+			theFxHelper.AdjustTime(baseTime + t + FX_BENCH_FRAME_MSEC);
+
+			for (; next < stream.size() && stream[next].time <= t; next++)
+			{
+				if (!batch->Add(stream[next].spawn))
+				{
+					dropped++;
+				}
+			}
+
+			drawnFx = 0;
+			batch->Update();
+			batchDrawn += drawnFx;
+		}
+
+		batch->Clear();
+	}
+
+	const int batchMsec = Sys_Milliseconds() - start;
+	delete batch;
+
+	theFxHelper = savedHelper;
+	drawnFx = savedDrawn;
+
+	Com_Printf("%i particles, %i frames, %i passes\n", static_cast<int>(stream.size()),
+		endTime / FX_BENCH_FRAME_MSEC + 1, passes);
+	Com_Printf("CParticle:      %5i msec, %i drawn\n", objectMsec, objectDrawn);
+	Com_Printf("CParticleBatch: %5i msec, %i drawn", batchMsec, batchDrawn);
+	if (dropped)
+	{
+		Com_Printf(", %i didn't fit", dropped);
+	}
+	Com_Printf("\n");
+}
+
+static void FX_ListEffectFiles(const char* dir, std::vector<std::string>& files, const int depth)
+{
+	int num;
+	char** list = FS_ListFiles(dir, ".efx", &num);
+
+	for (int i = 0; i < num; i++)
+	{
+		files.push_back(va("%s/%s", dir, list[i]));
+	}
+	FS_FreeFileList(list);
+
+	if (depth >= 4)
+	{
+		return;
+	}
+
+	list = FS_ListFiles(dir, "/", &num);
+	for (int i = 0; i < num; i++)
+	{
+		if (list[i][0] && list[i][0] != '.')
+		{
+			FX_ListEffectFiles(va("%s/%s", dir, list[i]), files, depth + 1);
+		}
+	}
+	FS_FreeFileList(list);
+}
+
+//-------------------------
+// FX_ParseBench_f
+//
+// Runs every .efx under effects/ through the generic parser a number of
+// times, which is most of what registering an effect costs, and prints the
+// throughput. Parsing works in place, so each pass starts from a fresh copy
+//-------------------------
+void FX_ParseBench_f(void)
+{
+	const int passes = Cmd_Argc() > 1 ? Com_Clampi(1, 1000, atoi(Cmd_Argv(1))) : 10;
+	std::vector<std::string> names;
+	std::vector<std::string> texts;
+	size_t totalBytes = 0;
+
+	FX_ListEffectFiles("effects", names, 0);
+	for (const auto& name : names)
+	{
+		void* buffer = nullptr;
+		const long len = FS_ReadFile(name.c_str(), &buffer);
+
+		if (len > 0)
+		{
+			texts.emplace_back(static_cast<const char*>(buffer), len);
+			totalBytes += len;
+		}
+		if (buffer)
+		{
+			FS_FreeFile(buffer);
+		}
+	}
+
+	if (texts.empty())
+	{
+		Com_Printf("No effect files found\n");
+		return;
+	}
+
+	std::vector<char> scratch;
+
+	// copying on its own, so it can be taken off the parse time
+	int start = Sys_Milliseconds();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (const auto& text : texts)
+		{
+			scratch.assign(text.begin(), text.end());
+			scratch.push_back(0);
+		}
+	}
+	const int copyMsec = Sys_Milliseconds() - start;
+
+	CGenericParser2 parser;
+	size_t largestArena = 0;
+	int failed = 0;
+
+	start = Sys_Milliseconds();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (const auto& text : texts)
+		{
+			scratch.assign(text.begin(), text.end());
+			scratch.push_back(0);
+
+			if (!parser.Parse(scratch.data()))
+			{
+				failed++;
+			}
+			largestArena = Q_max(largestArena, parser.GetArenaUsed());
+			parser.Clean();
+		}
+	}
+	const int parseMsec = Q_max(Sys_Milliseconds() - start - copyMsec, 1);
+
+	Com_Printf("%i files, %i KB, %i passes\n", static_cast<int>(texts.size()), static_cast<int>(totalBytes / 1024), passes);
+	Com_Printf("%i msec parsing (%i more copying), %.1f MB/sec, largest tree %i bytes\n", parseMsec, copyMsec,
+		static_cast<double>(totalBytes) * passes / (1024.0 * 1024.0) / (parseMsec / 1000.0), static_cast<int>(largestArena));
+	if (failed)
+	{
+		Com_Printf(S_COLOR_YELLOW "%i files didn't parse\n", failed / passes);
+	}
+}
@@ -30,6 +30,10 @@ void FX_SetRefDef(refdef_t* refdef);
 void FX_Add(bool portal); // called every cgame frame to add all fx into the scene.
 void FX_Stop(); // ditches all active effects without touching the templates.
 
+void FX_ParticleRecord_f(void);
+void FX_ParticleBench_f(void);
+void FX_ParseBench_f(void);
+
 CParticle* FX_AddParticle(vec3_t org, vec3_t vel, vec3_t accel,
 	float size1, float size2, float size_parm,
 	float alpha1, float alpha2, float alpha_parm,
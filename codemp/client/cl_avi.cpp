@@ -23,6 +23,12 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "client.h"
 #include "snd_local.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
 #define INDEX_FILE_EXTENSION ".index.dat"
 
 constexpr auto MAX_RIFF_CHUNKS = 16;
@@ -56,6 +62,8 @@ using aviFileData_t = struct aviFileData_s
 	int numVideoFrames;
 	int maxRecordSize;
 	qboolean motionJpeg;
+	int jpegQuality;
+	int fileSizeBound; // fileSize plus the most the queued chunks can add
 
 	qboolean audio;
 	audioFormat_t a;
@@ -70,10 +78,81 @@ using aviFileData_t = struct aviFileData_s
 static aviFileData_t afd;
 
 constexpr auto MAX_AVI_BUFFER = 2048;
+constexpr auto PCM_BUFFER_SIZE = 44100;
 
 static byte buffer[MAX_AVI_BUFFER];
 static int bufIndex;
 
+/*
+===============================================================================
+
+CAPTURE QUEUE
+
+With cl_aviThreads set, the renderer hands the frame it read back to
+CL_QueueAVIVideoFrame, which copies it into a slot of a ring of cl_aviQueue
+of them, and that's all the frame pays for. Encoder threads (R/B swap and line padding, or motion JPEG through
+re->SaveJPGToBuffer) take whichever slots are waiting, and the writer thread
+muxes them into the file strictly in ring order, so the chunks come out in
+the order they were captured. Audio chunks are queued in the same ring.
+
+A full ring stalls the game until a slot frees up, or with cl_aviDropFrames
+set, skips the video frame and writes an empty chunk in its place, which
+players show as a repeat of the previous frame and keeps audio in sync.
+
+Everything the writer updates (fileSize, moviSize, maxRecordSize) is only
+looked at from the main thread after CL_AVIFlush.
+
+===============================================================================
+*/
+
+constexpr auto MAX_AVI_ENCODERS = 8;
+constexpr auto MAX_AVI_SLOTS = 64;
+
+enum
+{
+	AVI_SLOT_FREE,
+	AVI_SLOT_FILLING, // the main thread's copying into it
+	AVI_SLOT_QUEUED, // waiting for an encoder
+	AVI_SLOT_ENCODING,
+	AVI_SLOT_READY // waiting for the writer
+};
+
+using aviSlot_t = struct aviSlot_s
+{
+	int state;
+	qboolean audio;
+	byte* capture; // frame as read back, or an audio chunk
+	byte* encode;
+	int padding; // at the end of each line in capture
+	const byte* data; // chunk contents once ready
+	int size;
+	int dropsBefore; // empty video chunks to write ahead of this one
+};
+
+static struct
+{
+	std::thread encoders[MAX_AVI_ENCODERS];
+	std::thread writer;
+	std::mutex mutex;
+	std::condition_variable work; // a slot queued for encoding, or time to quit
+	std::condition_variable ready; // a slot encoded, or time to quit
+	std::condition_variable space; // the writer freed a slot
+	aviSlot_t slots[MAX_AVI_SLOTS];
+	int numSlots;
+	int numEncoders;
+	int head; // next slot to fill
+	int tail; // next slot to write
+	int numUsed;
+	bool quit;
+	bool running;
+	bool failed; // a write went wrong, reported on the main thread
+
+	// main thread only...
+	int pendingDrops;
+	int numDropped;
+	int stallMsec;
+} aviQueue;
+
 /*
 ===============
 SafeFS_Write
@@ -315,13 +394,384 @@ void CL_WriteAVIHeader(void)
 
 /*
 ===============
-CL_OpenAVIForWriting
+PUT_4BYTES
+===============
+*/
+static QINLINE void PUT_4BYTES(byte* p, const int x)
+{
+	p[0] = static_cast<byte>(x >> 0 & 0xFF);
+	p[1] = static_cast<byte>(x >> 8 & 0xFF);
+	p[2] = static_cast<byte>(x >> 16 & 0xFF);
+	p[3] = static_cast<byte>(x >> 24 & 0xFF);
+}
+
+/*
+===============
+CL_WriteAVIChunk
+
+Appends a chunk to the movi list and its entry to the index. Runs on the
+writer thread when the capture queue is up, so it doesn't touch buffer
+===============
+*/
+static qboolean CL_WriteAVIChunk(const char* tag, const qboolean video, const byte* data, const int size)
+{
+	const int chunkOffset = afd.fileSize - afd.moviOffset - 8;
+	const int chunkSize = 8 + size;
+	const int paddingSize = PADLEN(size, 2);
+	constexpr byte padding[4] = { 0 };
+	byte header[16];
+
+	Com_Memcpy(header, tag, 4);
+	PUT_4BYTES(header + 4, size);
+
+	if (FS_Write(header, 8, afd.f) < 8 || FS_Write(data, size, afd.f) < size
+		|| FS_Write(padding, paddingSize, afd.f) < paddingSize)
+	{
+		return qfalse;
+	}
+	afd.fileSize += chunkSize + paddingSize;
+	afd.moviSize += chunkSize + paddingSize;
+
+	if (video && size > afd.maxRecordSize)
+		afd.maxRecordSize = size;
+
+	// Index
+	Com_Memcpy(header, tag, 4); //dwIdentifier
+	PUT_4BYTES(header + 4, video && size ? 0x00000010 : 0); //dwFlags (all frames are KeyFrames, empty ones are drops)
+	PUT_4BYTES(header + 8, chunkOffset); //dwOffset
+	PUT_4BYTES(header + 12, size); //dwLength
+
+	return static_cast<qboolean>(FS_Write(header, 16, afd.idxF) == 16);
+}
+
+/*
+===============
+CL_EncodeAVIFrame
+
+The same as RB_TakeVideoFrameCmd does when it writes frames itself
+===============
+*/
+static void CL_EncodeAVIFrame(aviSlot_t* slot)
+{
+	const int linelen = afd.width * 3;
+	const int avipadwidth = PAD(linelen, AVI_LINE_PADDING);
+
+	slot->data = slot->encode;
+
+	if (afd.motionJpeg)
+	{
+		slot->size = static_cast<int>(re->SaveJPGToBuffer(slot->encode, linelen * afd.height, afd.jpegQuality,
+			afd.width, afd.height, slot->capture, slot->padding));
+		return;
+	}
+
+	const byte* srcptr = slot->capture;
+	byte* destptr = slot->encode;
+
+	// swap R and B and remove line paddings
+	for (int y = 0; y < afd.height; y++)
+	{
+		const byte* lineend = srcptr + linelen;
+		while (srcptr < lineend)
+		{
+			*destptr++ = srcptr[2];
+			*destptr++ = srcptr[1];
+			*destptr++ = srcptr[0];
+			srcptr += 3;
+		}
+
+		Com_Memset(destptr, '\0', avipadwidth - linelen);
+		destptr += avipadwidth - linelen;
+
+		srcptr += slot->padding;
+	}
+
+	slot->size = avipadwidth * afd.height;
+}
+
+static aviSlot_t* CL_AVINextQueued(void)
+{
+	for (int i = 0, n = aviQueue.tail; i < aviQueue.numUsed; i++, n = (n + 1) % aviQueue.numSlots)
+	{
+		if (aviQueue.slots[n].state == AVI_SLOT_QUEUED)
+		{
+			return &aviQueue.slots[n];
+		}
+	}
+
+	return nullptr;
+}
+
+static void CL_AVIEncoderThread(void)
+{
+	std::unique_lock<std::mutex> lock(aviQueue.mutex);
+
+	while (true)
+	{
+		aviSlot_t* slot = nullptr;
+		aviQueue.work.wait(lock, [&slot] { return aviQueue.quit || (slot = CL_AVINextQueued()) != nullptr; });
+		if (aviQueue.quit)
+		{
+			break;
+		}
+
+		slot->state = AVI_SLOT_ENCODING;
+		lock.unlock();
+
+		CL_EncodeAVIFrame(slot);
+
+		lock.lock();
+		slot->state = AVI_SLOT_READY;
+		aviQueue.ready.notify_one();
+	}
+}
+
+static void CL_AVIWriterThread(void)
+{
+	std::unique_lock<std::mutex> lock(aviQueue.mutex);
+
+	while (true)
+	{
+		aviQueue.ready.wait(lock, []
+			{
+				return aviQueue.quit || (aviQueue.numUsed && aviQueue.slots[aviQueue.tail].state == AVI_SLOT_READY);
+			});
+		if (aviQueue.quit)
+		{
+			break;
+		}
+
+		aviSlot_t* slot = &aviQueue.slots[aviQueue.tail];
+		bool ok = !aviQueue.failed;
+		lock.unlock();
+
+		// once something's failed to write, just keep the ring moving until the main thread notices
+		for (int i = 0; ok && i < slot->dropsBefore; i++)
+		{
+			ok = CL_WriteAVIChunk("00dc", qtrue, nullptr, 0);
+		}
+		if (ok)
+		{
+			ok = slot->audio ? CL_WriteAVIChunk("01wb", qfalse, slot->data, slot->size)
+				: CL_WriteAVIChunk("00dc", qtrue, slot->data, slot->size);
+		}
+
+		lock.lock();
+		if (!ok)
+		{
+			aviQueue.failed = true;
+		}
+		slot->state = AVI_SLOT_FREE;
+		aviQueue.tail = (aviQueue.tail + 1) % aviQueue.numSlots;
+		aviQueue.numUsed--;
+		aviQueue.space.notify_all();
+	}
+}
+
+/*
+===============
+CL_AVIStartQueue
+===============
+*/
+static void CL_AVIStartQueue(void)
+{
+	if (cl_aviThreads->integer <= 0 || (afd.motionJpeg && !re->SaveJPGToBuffer))
+	{
+		return;
+	}
+
+	const int captureSize = (afd.width * 3 + 15) * afd.height;
+	const int encodeSize = PAD(afd.width * 3, AVI_LINE_PADDING) * afd.height;
+
+	aviQueue.numSlots = Com_Clampi(2, MAX_AVI_SLOTS, cl_aviQueue->integer);
+	aviQueue.numEncoders = Com_Clampi(1, MAX_AVI_ENCODERS, cl_aviThreads->integer);
+	for (int i = 0; i < aviQueue.numSlots; i++)
+	{
+		aviSlot_t* slot = &aviQueue.slots[i];
+
+		slot->state = AVI_SLOT_FREE;
+		slot->capture = static_cast<byte*>(Z_Malloc(Q_max(captureSize, PCM_BUFFER_SIZE), TAG_AVI, qfalse));
+		slot->encode = static_cast<byte*>(Z_Malloc(encodeSize, TAG_AVI, qfalse));
+	}
+	aviQueue.head = aviQueue.tail = aviQueue.numUsed = 0;
+	aviQueue.quit = false;
+	aviQueue.failed = false;
+	aviQueue.pendingDrops = 0;
+	aviQueue.numDropped = 0;
+	aviQueue.stallMsec = 0;
+
+	int numStarted = 0;
+	try
+	{
+		aviQueue.writer = std::thread(CL_AVIWriterThread);
+		for (; numStarted < aviQueue.numEncoders; numStarted++)
+		{
+			aviQueue.encoders[numStarted] = std::thread(CL_AVIEncoderThread);
+		}
+	}
+	catch (const std::system_error&)
+	{
+		if (!numStarted)
+		{
+			Com_Printf(S_COLOR_YELLOW "WARNING: couldn't start the video capture threads, writing frames as they come\n");
+			if (aviQueue.writer.joinable())
+			{
+				{
+					std::lock_guard<std::mutex> lock(aviQueue.mutex);
+					aviQueue.quit = true;
+				}
+				aviQueue.ready.notify_all();
+				aviQueue.writer.join();
+			}
+			for (int i = 0; i < aviQueue.numSlots; i++)
+			{
+				Z_Free(aviQueue.slots[i].capture);
+				Z_Free(aviQueue.slots[i].encode);
+			}
+			return;
+		}
+	}
+	aviQueue.numEncoders = numStarted;
+	aviQueue.running = true;
+}
+
+/*
+===============
+CL_AVIFlush
+
+Waits for everything queued to be written
+===============
+*/
+static void CL_AVIFlush(void)
+{
+	if (!aviQueue.running)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(aviQueue.mutex);
+	aviQueue.space.wait(lock, [] { return aviQueue.numUsed == 0; });
+
+	afd.fileSizeBound = afd.fileSize;
+}
+
+/*
+===============
+CL_AVIStopQueue
+===============
+*/
+static void CL_AVIStopQueue(void)
+{
+	if (!aviQueue.running)
+	{
+		return;
+	}
+
+	CL_AVIFlush();
+
+	{
+		std::lock_guard<std::mutex> lock(aviQueue.mutex);
+		aviQueue.quit = true;
+	}
+	aviQueue.work.notify_all();
+	aviQueue.ready.notify_all();
+	for (int i = 0; i < aviQueue.numEncoders; i++)
+	{
+		aviQueue.encoders[i].join();
+	}
+	aviQueue.writer.join();
+	aviQueue.running = false;
+
+	for (int i = 0; i < aviQueue.numSlots; i++)
+	{
+		Z_Free(aviQueue.slots[i].capture);
+		Z_Free(aviQueue.slots[i].encode);
+	}
+
+	// frames dropped since the last one that made it
+	for (; aviQueue.pendingDrops; aviQueue.pendingDrops--)
+	{
+		if (!CL_WriteAVIChunk("00dc", qtrue, nullptr, 0))
+		{
+			aviQueue.failed = true;
+			break;
+		}
+	}
+}
+
+/*
+===============
+CL_AVIFillSlot
+
+Takes the next slot in the ring, waiting for the writer to free one if
+they're all taken, unless it's video and cl_aviDropFrames says not to
+===============
+*/
+static aviSlot_t* CL_AVIFillSlot(const qboolean audio)
+{
+	std::unique_lock<std::mutex> lock(aviQueue.mutex);
+
+	if (aviQueue.failed)
+	{
+		lock.unlock();
+		Com_Error(ERR_DROP, "Failed to write avi file");
+	}
+
+	if (aviQueue.numUsed == aviQueue.numSlots)
+	{
+		if (!audio && cl_aviDropFrames->integer)
+		{
+			return nullptr;
+		}
+
+		const int msec = Sys_Milliseconds();
+		aviQueue.space.wait(lock, [] { return aviQueue.numUsed < aviQueue.numSlots; });
+		aviQueue.stallMsec += Sys_Milliseconds() - msec;
+	}
+
+	aviSlot_t* slot = &aviQueue.slots[aviQueue.head];
+	aviQueue.head = (aviQueue.head + 1) % aviQueue.numSlots;
+	aviQueue.numUsed++;
+
+	slot->state = AVI_SLOT_FILLING;
+	slot->audio = audio;
+	slot->dropsBefore = aviQueue.pendingDrops;
+	aviQueue.pendingDrops = 0;
+
+	return slot;
+}
+
+/*
+===============
+CL_AVIPostSlot
+===============
+*/
+static void CL_AVIPostSlot(aviSlot_t* slot, const int state)
+{
+	{
+		std::lock_guard<std::mutex> lock(aviQueue.mutex);
+		slot->state = state;
+	}
+
+	if (state == AVI_SLOT_QUEUED)
+	{
+		aviQueue.work.notify_one();
+	}
+	else
+	{
+		aviQueue.ready.notify_one();
+	}
+}
+
+/*
+===============
+CL_OpenAVI
 
 Creates an AVI file and gets it into a state where
 writing the actual data can begin
 ===============
 */
-qboolean CL_OpenAVIForWriting(const char* file_name)
+static qboolean CL_OpenAVI(const char* file_name, const int width, const int height, const qboolean motionJpeg)
 {
 	if (afd.fileOpen)
 		return qfalse;
@@ -349,13 +799,10 @@ qboolean CL_OpenAVIForWriting(const char* file_name)
 
 	afd.frameRate = cl_aviFrameRate->integer;
 	afd.framePeriod = static_cast<int>(1000000.0f / afd.frameRate);
-	afd.width = cls.glconfig.vidWidth;
-	afd.height = cls.glconfig.vidHeight;
-
-	if (cl_aviMotionJpeg->integer)
-		afd.motionJpeg = qtrue;
-	else
-		afd.motionJpeg = qfalse;
+	afd.width = width;
+	afd.height = height;
+	afd.motionJpeg = motionJpeg;
+	afd.jpegQuality = Com_Clampi(10, 100, Cvar_VariableIntegerValue("r_aviMotionJpegQuality"));
 
 	// Buffers only need to store RGB pixels.
 	// Allocate a bit more space for the capture buffer to account for possible
@@ -418,11 +865,25 @@ qboolean CL_OpenAVIForWriting(const char* file_name)
 	SafeFS_Write(buffer, bufIndex, afd.idxF);
 
 	afd.moviSize = 4; // For the "movi"
+	afd.fileSizeBound = afd.fileSize;
 	afd.fileOpen = qtrue;
 
+	CL_AVIStartQueue();
+
 	return qtrue;
 }
 
+/*
+===============
+CL_OpenAVIForWriting
+===============
+*/
+qboolean CL_OpenAVIForWriting(const char* file_name)
+{
+	return CL_OpenAVI(file_name, cls.glconfig.vidWidth, cls.glconfig.vidHeight,
+		static_cast<qboolean>(cl_aviMotionJpeg->integer != 0));
+}
+
 /*
 ===============
 CL_CheckFileSize
@@ -430,22 +891,34 @@ CL_CheckFileSize
 */
 static qboolean CL_CheckFileSize(const int bytesToAdd)
 {
-	const unsigned int newFileSize = afd.fileSize + // Current file size
+	// with the capture queue up only the most it could come to is known,
+	// until the queue's been flushed
+	unsigned int newFileSize = afd.fileSizeBound + // Current file size
 		bytesToAdd + // What we want to add
 		afd.numIndices * 16 + // The index
 		4; // The index size
 
 	if (cl_avi2GBLimit->integer)
 	{
+		if (newFileSize > INT_MAX && aviQueue.running)
+		{
+			CL_AVIFlush();
+			newFileSize = afd.fileSize + bytesToAdd + afd.numIndices * 16 + 4;
+		}
+
 		// I assume all the operating systems
 		// we target can handle a 2Gb file
 		if (newFileSize > INT_MAX)
 		{
+			const int width = afd.width;
+			const int height = afd.height;
+			const qboolean motionJpeg = afd.motionJpeg;
+
 			// Close the current file...
 			CL_CloseAVI();
 
 			// ...And open a new one
-			CL_OpenAVIForWriting(va("%s_", afd.fileName));
+			CL_OpenAVI(va("%s_", afd.fileName), width, height, motionJpeg);
 
 			return qtrue;
 		}
@@ -461,11 +934,6 @@ CL_WriteAVIVideoFrame
 */
 void CL_WriteAVIVideoFrame(const byte* imageBuffer, const int size)
 {
-	const int chunkOffset = afd.fileSize - afd.moviOffset - 8;
-	const int chunkSize = 8 + size;
-	const int paddingSize = PADLEN(size, 2);
-	constexpr byte padding[4] = { 0 };
-
 	if (!afd.fileOpen)
 		return;
 
@@ -473,33 +941,55 @@ void CL_WriteAVIVideoFrame(const byte* imageBuffer, const int size)
 	if (CL_CheckFileSize(8 + size + 2))
 		return;
 
-	bufIndex = 0;
-	WRITE_STRING("00dc");
-	WRITE_4BYTES(size);
-
-	SafeFS_Write(buffer, 8, afd.f);
-	SafeFS_Write(imageBuffer, size, afd.f);
-	SafeFS_Write(padding, paddingSize, afd.f);
-	afd.fileSize += chunkSize + paddingSize;
+	if (!CL_WriteAVIChunk("00dc", qtrue, imageBuffer, size))
+		Com_Error(ERR_DROP, "Failed to write avi file");
+	afd.fileSizeBound = afd.fileSize;
 
 	afd.numVideoFrames++;
-	afd.moviSize += chunkSize + paddingSize;
+	afd.numIndices++;
+}
 
-	if (size > afd.maxRecordSize)
-		afd.maxRecordSize = size;
+/*
+===============
+CL_QueueAVIVideoFrame
 
-	// Index
-	bufIndex = 0;
-	WRITE_STRING("00dc"); //dwIdentifier
-	WRITE_4BYTES(0x00000010); //dwFlags (all frames are KeyFrames)
-	WRITE_4BYTES(chunkOffset); //dwOffset
-	WRITE_4BYTES(size); //dwLength
-	SafeFS_Write(buffer, 16, afd.idxF);
+Called by the renderer with the frame it's just read back (RGB, bottom line
+first, each line followed by padding bytes). Returns qfalse if it should
+encode it and call CL_WriteAVIVideoFrame itself
+===============
+*/
+qboolean CL_QueueAVIVideoFrame(const byte* pixels, const int padding)
+{
+	if (!afd.fileOpen || !aviQueue.running)
+		return qfalse;
+
+	const int maxSize = PAD(afd.width * 3, AVI_LINE_PADDING) * afd.height;
 
+	// Chunk header + contents + padding
+	if (CL_CheckFileSize(8 + maxSize + 2))
+		return qtrue;
+
+	afd.numVideoFrames++;
 	afd.numIndices++;
-}
 
-constexpr auto PCM_BUFFER_SIZE = 44100;
+	aviSlot_t* slot = CL_AVIFillSlot(qfalse);
+	if (!slot)
+	{
+		// written as an empty chunk ahead of the next one that makes it
+		aviQueue.pendingDrops++;
+		aviQueue.numDropped++;
+		afd.fileSizeBound += 8;
+		return qtrue;
+	}
+
+	Com_Memcpy(slot->capture, pixels, (afd.width * 3 + padding) * afd.height);
+	slot->padding = padding;
+	afd.fileSizeBound += 8 + maxSize + 1;
+
+	CL_AVIPostSlot(slot, AVI_SLOT_QUEUED);
+
+	return qtrue;
+}
 
 /*
 ===============
@@ -535,32 +1025,26 @@ void CL_WriteAVIAudioFrame(const byte* pcmBuffer, int size)
 	if (bytesInBuffer >= static_cast<int>(ceil(static_cast<float>(afd.a.rate) / static_cast<float>(afd.frameRate))) *
 		afd.a.sampleSize)
 	{
-		const int chunkOffset = afd.fileSize - afd.moviOffset - 8;
-		const int chunkSize = 8 + bytesInBuffer;
-		const int paddingSize = PADLEN(bytesInBuffer, 2);
-		constexpr byte padding[4] = { 0 };
+		if (aviQueue.running)
+		{
+			aviSlot_t* slot = CL_AVIFillSlot(qtrue);
 
-		bufIndex = 0;
-		WRITE_STRING("01wb");
-		WRITE_4BYTES(bytesInBuffer);
+			Com_Memcpy(slot->capture, pcmCaptureBuffer, bytesInBuffer);
+			slot->data = slot->capture;
+			slot->size = bytesInBuffer;
+			afd.fileSizeBound += 8 + bytesInBuffer + PADLEN(bytesInBuffer, 2);
 
-		SafeFS_Write(buffer, 8, afd.f);
-		SafeFS_Write(pcmCaptureBuffer, bytesInBuffer, afd.f);
-		SafeFS_Write(padding, paddingSize, afd.f);
-		afd.fileSize += chunkSize + paddingSize;
+			CL_AVIPostSlot(slot, AVI_SLOT_READY);
+		}
+		else
+		{
+			if (!CL_WriteAVIChunk("01wb", qfalse, pcmCaptureBuffer, bytesInBuffer))
+				Com_Error(ERR_DROP, "Failed to write avi file");
+			afd.fileSizeBound = afd.fileSize;
+		}
 
 		afd.numAudioFrames++;
-		afd.moviSize += chunkSize + paddingSize;
 		afd.a.totalBytes += bytesInBuffer;
-
-		// Index
-		bufIndex = 0;
-		WRITE_STRING("01wb"); //dwIdentifier
-		WRITE_4BYTES(0); //dwFlags
-		WRITE_4BYTES(chunkOffset); //dwOffset
-		WRITE_4BYTES(bytesInBuffer); //dwLength
-		SafeFS_Write(buffer, 16, afd.idxF);
-
 		afd.numIndices++;
 
 		bytesInBuffer = 0;
@@ -598,6 +1082,13 @@ qboolean CL_CloseAVI(void)
 	if (!afd.fileOpen)
 		return qfalse;
 
+	CL_AVIStopQueue();
+	if (aviQueue.failed)
+	{
+		Com_Printf(S_COLOR_RED "ERROR: failed to write some of %s\n", afd.fileName);
+		aviQueue.failed = false;
+	}
+
 	afd.fileOpen = qfalse;
 
 	FS_Seek(afd.idxF, 4, FS_SEEK_SET);
@@ -651,6 +1142,12 @@ qboolean CL_CloseAVI(void)
 	FS_FCloseFile(afd.f);
 
 	Com_Printf("Wrote %d:%d frames to %s\n", afd.numVideoFrames, afd.numAudioFrames, afd.fileName);
+	if (aviQueue.numDropped || aviQueue.stallMsec)
+	{
+		Com_Printf("%d frames dropped, %d msec waiting for the capture queue\n", aviQueue.numDropped,
+			aviQueue.stallMsec);
+		aviQueue.numDropped = aviQueue.stallMsec = 0;
+	}
 
 	return qtrue;
 }
@@ -663,4 +1160,167 @@ CL_VideoRecording
 qboolean CL_VideoRecording(void)
 {
 	return afd.fileOpen;
-}
\ No newline at end of file
+}
+/*
+===============
+CL_VideoTest_f
+
+Records synthetic frames (and silence, if audio would be captured) into
+videos/videotest.avi the same way a recording goes, then reads the file back
+and checks the index against the chunks it points at
+===============
+*/
+void CL_VideoTest_f(void)
+{
+	constexpr int width = 161; // odd, so the lines need padding both ways
+	constexpr int height = 120;
+	constexpr int padding = 1;
+	const char* fileName = "videos/videotest.avi";
+
+	if (CL_VideoRecording())
+	{
+		Com_Printf("Already recording\n");
+		return;
+	}
+
+	const int numFrames = Cmd_Argc() > 1 ? Com_Clampi(1, 10000, atoi(Cmd_Argv(1))) : 300;
+
+	if (!CL_OpenAVI(fileName, width, height, qfalse))
+	{
+		Com_Printf(S_COLOR_RED "video_test: couldn't open %s\n", fileName);
+		return;
+	}
+
+	const auto capture = static_cast<byte*>(Z_Malloc((width * 3 + padding) * height, TAG_AVI, qfalse));
+	const auto pcm = static_cast<byte*>(Z_Malloc(PCM_BUFFER_SIZE, TAG_AVI, qtrue));
+	const int pcmBytes = afd.audio
+		? static_cast<int>(ceil(static_cast<float>(afd.a.rate) / static_cast<float>(afd.frameRate))) * afd.a.sampleSize
+		: 0;
+	const qboolean queued = static_cast<qboolean>(aviQueue.running);
+
+	int msec = Sys_Milliseconds();
+	for (int i = 0; i < numFrames; i++)
+	{
+		if (pcmBytes)
+		{
+			CL_WriteAVIAudioFrame(pcm, pcmBytes);
+		}
+
+		// every byte of frame n is n, so the order can be checked
+		Com_Memset(capture, i & 0xff, (width * 3 + padding) * height);
+		if (!CL_QueueAVIVideoFrame(capture, padding))
+		{
+			aviSlot_t slot{};
+			slot.capture = capture;
+			slot.encode = afd.eBuffer;
+			slot.padding = padding;
+			CL_EncodeAVIFrame(&slot);
+			CL_WriteAVIVideoFrame(slot.data, slot.size);
+		}
+	}
+	const int captureMsec = Sys_Milliseconds() - msec;
+	const int numDropped = aviQueue.numDropped;
+
+	Z_Free(pcm);
+	Z_Free(capture);
+
+	msec = Sys_Milliseconds();
+	CL_CloseAVI();
+	const int closeMsec = Sys_Milliseconds() - msec;
+
+	Com_Printf("%s, %d frames: %d msec capturing, %d msec finishing\n", queued ? "queued" : "unqueued", numFrames,
+		captureMsec, closeMsec);
+
+	// now read it back
+	byte* buf;
+	const int len = FS_ReadFile(fileName, reinterpret_cast<void**>(&buf));
+	if (len <= 0)
+	{
+		Com_Printf(S_COLOR_RED "video_test: couldn't read %s back\n", fileName);
+		return;
+	}
+
+	const auto get4 = [buf](const int ofs) { return buf[ofs] | buf[ofs + 1] << 8 | buf[ofs + 2] << 16 | buf[ofs + 3] << 24; };
+	const char* error = nullptr;
+	int numVideo = 0, numAudio = 0, numEmpty = 0;
+
+	const int movi = afd.moviOffset + 8; // where the index offsets count from
+	const int idx = movi + afd.moviSize;
+
+	if (len < idx + 8 || memcmp(buf, "RIFF", 4) || get4(4) != len - 8 || memcmp(buf + 8, "AVI ", 4))
+	{
+		error = "bad RIFF header";
+	}
+	else if (memcmp(buf + afd.moviOffset, "LIST", 4) || memcmp(buf + movi, "movi", 4))
+	{
+		error = "no movi list";
+	}
+	else if (memcmp(buf + idx, "idx1", 4) || get4(idx + 4) % 16 || idx + 8 + get4(idx + 4) != len)
+	{
+		error = "bad idx1 chunk";
+	}
+	else
+	{
+		const int numEntries = get4(idx + 4) / 16;
+		int lastOffset = 0;
+
+		for (int i = 0; i < numEntries && !error; i++)
+		{
+			const int entry = idx + 8 + i * 16;
+			const int offset = get4(entry + 8);
+			const int size = get4(entry + 12);
+			const int chunk = movi + offset;
+
+			if (offset <= lastOffset || chunk + 8 + size > idx)
+			{
+				error = "index entry out of order or outside the movi list";
+			}
+			else if (memcmp(buf + chunk, buf + entry, 4) || get4(chunk + 4) != size)
+			{
+				error = "index entry doesn't match its chunk";
+			}
+			else if (!memcmp(buf + entry, "01wb", 4))
+			{
+				numAudio++;
+			}
+			else if (memcmp(buf + entry, "00dc", 4))
+			{
+				error = "unknown chunk";
+			}
+			else if (!size)
+			{
+				numEmpty++;
+				numVideo++;
+			}
+			else if (size != PAD(width * 3, AVI_LINE_PADDING) * height || buf[chunk + 8] != (numVideo & 0xff))
+			{
+				error = "video frame out of order or the wrong size";
+			}
+			else
+			{
+				numVideo++;
+			}
+			lastOffset = offset;
+		}
+
+		if (!error && (numVideo != numFrames || numAudio != (pcmBytes ? numFrames : 0) || numEmpty != numDropped))
+		{
+			error = "wrong number of chunks";
+		}
+		else if (!error && get4(48) != numFrames)
+		{
+			error = "wrong frame count in the header";
+		}
+	}
+
+	FS_FreeFile(buf);
+
+	if (error)
+	{
+		Com_Printf(S_COLOR_RED "video_test: FAILED, %s\n", error);
+		return;
+	}
+
+	Com_Printf("video_test: %s ok, %d video chunks (%d dropped), %d audio chunks\n", fileName, numVideo, numEmpty,
+		numAudio);
+}
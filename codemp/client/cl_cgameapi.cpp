@@ -565,6 +565,22 @@ static qboolean CL_SE_GetStringTextString(const char* text, char* buffer, const
 	return qfalse;
 }
 
+static qboolean CL_SE_GetStringFromHandle(const int handle, char* buffer, const int bufferLength)
+{
+	assert(buffer);
+
+	const char* str = SE_GetStringFromHandle(handle);
+
+	if (str[0])
+	{
+		Q_strncpyz(buffer, str, bufferLength);
+		return qtrue;
+	}
+
+	Com_sprintf(buffer, bufferLength, "??%s", str);
+	return qfalse;
+}
+
 static void CL_G2API_ListModelSurfaces(void* ghlInfo)
 {
 	re->G2API_ListSurfaces(static_cast<CGhoul2Info*>(ghlInfo));
@@ -2162,6 +2178,13 @@ void CL_BindCGame(void)
 
 		cgi.ext.R_Font_StrLenPixels = re->ext.Font_StrLenPixels;
 
+		cgi.SharedData_Acquire = SD_Acquire;
+		cgi.SharedData_Store = SD_Store;
+		cgi.SharedData_Release = SD_Release;
+
+		cgi.SE_GetStringHandle = SE_GetStringHandle;
+		cgi.SE_GetStringFromHandle = CL_SE_GetStringFromHandle;
+
 		const auto GetCGameAPI = reinterpret_cast<GetCGameAPI_t>(cgvm->GetModuleAPI);
 		cgameExport_t* ret = GetCGameAPI(CGAME_API_VERSION, &cgi);
 		if (!ret)
@@ -44,6 +44,18 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include <cmath>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CIN_SSE2
+#include <emmintrin.h>
+#endif
+
 constexpr auto MAXSIZE = 8;
 constexpr auto MINSIZE = 4;
 
@@ -116,11 +128,6 @@ using cin_cache_t = struct cin_cache_s
 	unsigned int roq_id;
 	long screenDelta;
 
-	void (*VQ0)(byte* status, void* qdata);
-	void (*VQ1)(byte* status, void* qdata);
-	void (*VQNormal)(byte* status, void* qdata);
-	void (*VQBuffer)(byte* status, void* qdata);
-
 	long samplesPerPixel; // defaults to 2
 	byte* gray;
 	unsigned int xsize, ysize, maxsize, minsize;
@@ -421,7 +428,7 @@ static void blit2_32(const byte* src, byte* dst, const int spl)
 *
 ******************************************************************************/
 
-static void blitVQQuad32fs(byte** status, unsigned char* data)
+static void blitVQQuad32fs(byte** status, const unsigned char* data, const int* mcomp, const int spl)
 {
 	unsigned int i;
 
@@ -429,8 +436,6 @@ static void blitVQQuad32fs(byte** status, unsigned char* data)
 	unsigned short celdata = 0;
 	unsigned int index = 0;
 
-	const int spl = cinTable[currentHandle].samplesPerLine;
-
 	do
 	{
 		if (!newd)
@@ -490,7 +495,7 @@ static void blitVQQuad32fs(byte** status, unsigned char* data)
 					data++;
 					break;
 				case 0x4000: // motion compensation
-					move4_32(status[index] + cin.mcomp[(*data)], status[index], spl);
+					move4_32(status[index] + mcomp[(*data)], status[index], spl);
 					data++;
 					break;
 				default:;
@@ -499,7 +504,7 @@ static void blitVQQuad32fs(byte** status, unsigned char* data)
 			}
 			break;
 		case 0x4000: // motion compensation
-			move8_32(status[index] + cin.mcomp[(*data)], status[index], spl);
+			move8_32(status[index] + mcomp[(*data)], status[index], spl);
 			data++;
 			index += 5;
 			break;
@@ -636,6 +641,33 @@ static unsigned int yuv_to_rgb24(const long y, const long u, const long v)
 	return LittleLong((r) | (g << 8) | (b << 16) | (255 << 24));
 }
 
+#ifdef CIN_SSE2
+// cin_bench turns this off to get the scalar numbers
+static bool cinSIMD = true;
+
+// the four pixels of a codebook entry share their chroma, so they go through
+// yuv_to_rgb24 side by side. packs/packus do the same clamping as the scalar
+// version, so the results are bit for bit the same
+static void yuv_to_rgb24x4(const byte* input, unsigned int* out)
+{
+	const __m128i yy = _mm_setr_epi32(ROQ_YY_tab[input[0]], ROQ_YY_tab[input[1]], ROQ_YY_tab[input[2]],
+		ROQ_YY_tab[input[3]]);
+	const long u = input[4];
+	const long v = input[5];
+
+	const __m128i r = _mm_srai_epi32(_mm_add_epi32(yy, _mm_set1_epi32(ROQ_VR_tab[v])), 6);
+	const __m128i g = _mm_srai_epi32(_mm_add_epi32(yy, _mm_set1_epi32(ROQ_UG_tab[u] + ROQ_VG_tab[v])), 6);
+	const __m128i b = _mm_srai_epi32(_mm_add_epi32(yy, _mm_set1_epi32(ROQ_UB_tab[u])), 6);
+
+	// r0..r3 g0..g3 b0..b3 a0..a3, then interleaved into four RGBA pixels
+	const __m128i planes = _mm_packus_epi16(_mm_packs_epi32(r, g), _mm_packs_epi32(b, _mm_set1_epi32(255)));
+	const __m128i rg = _mm_unpacklo_epi8(planes, _mm_srli_si128(planes, 4));
+	const __m128i ba = _mm_unpacklo_epi8(_mm_srli_si128(planes, 8), _mm_srli_si128(planes, 12));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(rg, ba));
+}
+#endif
+
 /******************************************************************************
 *
 * Function:
@@ -644,7 +676,7 @@ static unsigned int yuv_to_rgb24(const long y, const long u, const long v)
 *
 ******************************************************************************/
 
-static void decodeCodeBook(byte* input, unsigned short roq_flags)
+static void decodeCodeBook(const int handle, const byte* input, unsigned short roq_flags)
 {
 	long i, j, two, four;
 	unsigned short* aptr, * bptr, * cptr, * dptr;
@@ -671,16 +703,16 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 
 	bptr = static_cast<unsigned short*>(vq2);
 
-	if (!cinTable[currentHandle].half)
+	if (!cinTable[handle].half)
 	{
 		long y3;
 		long y1;
-		if (!cinTable[currentHandle].smootheddouble)
+		if (!cinTable[handle].smootheddouble)
 		{
 			//
 			// normal height
 			//
-			if (cinTable[currentHandle].samplesPerPixel == 2)
+			if (cinTable[handle].samplesPerPixel == 2)
 			{
 				for (i = 0; i < two; i++)
 				{
@@ -707,9 +739,21 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 						VQ2TO4(aptr, bptr, cptr, dptr);
 				}
 			}
-			else if (cinTable[currentHandle].samplesPerPixel == 4)
+			else if (cinTable[handle].samplesPerPixel == 4)
 			{
 				ibptr.s = bptr;
+#ifdef CIN_SSE2
+				if (cinSIMD)
+				{
+					for (i = 0; i < two; i++)
+					{
+						yuv_to_rgb24x4(input, ibptr.i);
+						input += 6;
+						ibptr.i += 4;
+					}
+				}
+				else
+#endif
 				for (i = 0; i < two; i++)
 				{
 					y0 = static_cast<long>(*input++);
@@ -737,15 +781,15 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 						VQ2TO4(iaptr.i, ibptr.i, icptr.i, idptr.i);
 				}
 			}
-			else if (cinTable[currentHandle].samplesPerPixel == 1)
+			else if (cinTable[handle].samplesPerPixel == 1)
 			{
 				bbptr = reinterpret_cast<byte*>(bptr);
 				for (i = 0; i < two; i++)
 				{
-					*bbptr++ = cinTable[currentHandle].gray[*input++];
-					*bbptr++ = cinTable[currentHandle].gray[*input++];
-					*bbptr++ = cinTable[currentHandle].gray[*input++];
-					*bbptr++ = cinTable[currentHandle].gray[*input];
+					*bbptr++ = cinTable[handle].gray[*input++];
+					*bbptr++ = cinTable[handle].gray[*input++];
+					*bbptr++ = cinTable[handle].gray[*input++];
+					*bbptr++ = cinTable[handle].gray[*input];
 					input += 3;
 				}
 
@@ -766,7 +810,7 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 			//
 			// double height, smoothed
 			//
-			if (cinTable[currentHandle].samplesPerPixel == 2)
+			if (cinTable[handle].samplesPerPixel == 2)
 			{
 				for (i = 0; i < two; i++)
 				{
@@ -800,7 +844,7 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 					}
 				}
 			}
-			else if (cinTable[currentHandle].samplesPerPixel == 4)
+			else if (cinTable[handle].samplesPerPixel == 4)
 			{
 				ibptr.s = bptr;
 				for (i = 0; i < two; i++)
@@ -837,7 +881,7 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 					}
 				}
 			}
-			else if (cinTable[currentHandle].samplesPerPixel == 1)
+			else if (cinTable[handle].samplesPerPixel == 1)
 			{
 				bbptr = reinterpret_cast<byte*>(bptr);
 				for (i = 0; i < two; i++)
@@ -847,14 +891,14 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 					y2 = static_cast<long>(*input++);
 					y3 = static_cast<long>(*input);
 					input += 3;
-					*bbptr++ = cinTable[currentHandle].gray[y0];
-					*bbptr++ = cinTable[currentHandle].gray[y1];
-					*bbptr++ = cinTable[currentHandle].gray[((y0 * 3) + y2) / 4];
-					*bbptr++ = cinTable[currentHandle].gray[((y1 * 3) + y3) / 4];
-					*bbptr++ = cinTable[currentHandle].gray[(y0 + (y2 * 3)) / 4];
-					*bbptr++ = cinTable[currentHandle].gray[(y1 + (y3 * 3)) / 4];
-					*bbptr++ = cinTable[currentHandle].gray[y2];
-					*bbptr++ = cinTable[currentHandle].gray[y3];
+					*bbptr++ = cinTable[handle].gray[y0];
+					*bbptr++ = cinTable[handle].gray[y1];
+					*bbptr++ = cinTable[handle].gray[((y0 * 3) + y2) / 4];
+					*bbptr++ = cinTable[handle].gray[((y1 * 3) + y3) / 4];
+					*bbptr++ = cinTable[handle].gray[(y0 + (y2 * 3)) / 4];
+					*bbptr++ = cinTable[handle].gray[(y1 + (y3 * 3)) / 4];
+					*bbptr++ = cinTable[handle].gray[y2];
+					*bbptr++ = cinTable[handle].gray[y3];
 				}
 
 				bcptr = reinterpret_cast<byte*>(vq4);
@@ -878,7 +922,7 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 		//
 		// 1/4 screen
 		//
-		if (cinTable[currentHandle].samplesPerPixel == 2)
+		if (cinTable[handle].samplesPerPixel == 2)
 		{
 			for (i = 0; i < two; i++)
 			{
@@ -905,15 +949,15 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 				}
 			}
 		}
-		else if (cinTable[currentHandle].samplesPerPixel == 1)
+		else if (cinTable[handle].samplesPerPixel == 1)
 		{
 			bbptr = reinterpret_cast<byte*>(bptr);
 
 			for (i = 0; i < two; i++)
 			{
-				*bbptr++ = cinTable[currentHandle].gray[*input];
+				*bbptr++ = cinTable[handle].gray[*input];
 				input += 2;
-				*bbptr++ = cinTable[currentHandle].gray[*input];
+				*bbptr++ = cinTable[handle].gray[*input];
 				input += 4;
 			}
 
@@ -930,7 +974,7 @@ static void decodeCodeBook(byte* input, unsigned short roq_flags)
 				}
 			}
 		}
-		else if (cinTable[currentHandle].samplesPerPixel == 4)
+		else if (cinTable[handle].samplesPerPixel == 4)
 		{
 			ibptr.s = bptr;
 			for (i = 0; i < two; i++)
@@ -1076,9 +1120,6 @@ static void readQuadInfo(const byte* qData)
 	cinTable[currentHandle].half = qfalse;
 	cinTable[currentHandle].smootheddouble = qfalse;
 
-	cinTable[currentHandle].VQ0 = cinTable[currentHandle].VQNormal;
-	cinTable[currentHandle].VQ1 = cinTable[currentHandle].VQBuffer;
-
 	cinTable[currentHandle].t[0] = cinTable[currentHandle].screenDelta;
 	cinTable[currentHandle].t[1] = -cinTable[currentHandle].screenDelta;
 
@@ -1110,11 +1151,11 @@ static void readQuadInfo(const byte* qData)
 *
 ******************************************************************************/
 
-static void RoQPrepMcomp(const long xoff, const long yoff)
+static void RoQPrepMcomp(const int handle, const long xoff, const long yoff, const long normalBuffer0, int* mcomp)
 {
-	long i = cinTable[currentHandle].samplesPerLine;
-	long j = cinTable[currentHandle].samplesPerPixel;
-	if (cinTable[currentHandle].xsize == (cinTable[currentHandle].ysize * 4) && !cinTable[currentHandle].half)
+	long i = cinTable[handle].samplesPerLine;
+	long j = cinTable[handle].samplesPerPixel;
+	if (cinTable[handle].xsize == (cinTable[handle].ysize * 4) && !cinTable[handle].half)
 	{
 		j = j + j;
 		i = i + i;
@@ -1126,9 +1167,252 @@ static void RoQPrepMcomp(const long xoff, const long yoff)
 		for (long x = 0; x < 16; x++)
 		{
 			const long temp = (x + xoff - 8) * j;
-			cin.mcomp[(x * 16) + y] = cinTable[currentHandle].normalBuffer0 - (temp2 + temp);
+			mcomp[(x * 16) + y] = normalBuffer0 - (temp2 + temp);
+		}
+	}
+}
+
+/*
+===============================================================================
+
+DECODE THREAD
+
+With cl_cinThread set, the codebook and VQ chunks RoQInterrupt reads are
+decoded on a thread of their own while the game gets on with the frame.
+RoQInterrupt queues them up (the chunk data stays in cin.file until the next
+FS_Read) and hands the batch over once the packet's been read; the sound
+chunks are still done right there since they go straight to S_RawSamples.
+
+A decoded frame only becomes cinTable[].buf once the worker is done with it,
+in CIN_PollDecode when the frame gets drawn or uploaded, or in
+CIN_FinishDecode, which anything that's about to touch cin.file, cin.linbuf,
+the codebook or the quad layout calls first. The worker writes into the half
+of linbuf that isn't on screen, so a frame shows up at most one frame late.
+
+===============================================================================
+*/
+
+enum
+{
+	CIN_DECODE_CODEBOOK,
+	CIN_DECODE_VQ
+};
+
+using cinDecodeOp_t = struct cinDecodeOp_s
+{
+	int type;
+	int handle;
+	const byte* data; // in cin.file
+	unsigned short flags; // codebook
+	int which; // VQ: the half of linbuf and cin.qStatus being drawn into
+	long normalBuffer0, roqF0, roqF1;
+	qboolean firstFrame; // VQ: copy it into the other half as well
+};
+
+constexpr auto MAX_DECODE_OPS = 16;
+
+static struct
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake; // a batch handed over, or time to quit
+	std::condition_variable idle; // the worker's done with its batch
+	cinDecodeOp_t ops[MAX_DECODE_OPS]; // the worker's while it's busy
+	int numOps; // in the batch being decoded
+	bool busy;
+	bool quit;
+	bool running;
+	std::atomic<int> decodeMsec;
+
+	// main thread only...
+	int numQueued; // in ops, not handed over yet
+	bool handedOver; // the worker may still be busy with a batch
+	int pendingHandle;
+	byte* pendingBuf; // last VQ frame queued, not published yet
+	int numFrames;
+	int numWaits; // CIN_FinishDecode had to block
+} cinDecode;
+
+static void CIN_RunDecodeOps(const int numOps)
+{
+	for (int i = 0; i < numOps; i++)
+	{
+		const cinDecodeOp_t* op = &cinDecode.ops[i];
+
+		if (op->type == CIN_DECODE_CODEBOOK)
+		{
+			decodeCodeBook(op->handle, op->data, op->flags);
+			continue;
+		}
+
+		const cin_cache_t* c = &cinTable[op->handle];
+
+		RoQPrepMcomp(op->handle, op->roqF0, op->roqF1, op->normalBuffer0, cin.mcomp);
+		blitVQQuad32fs(cin.qStatus[op->which], op->data, cin.mcomp, c->samplesPerLine);
+		if (op->firstFrame)
+		{
+			Com_Memcpy(cin.linbuf + c->screenDelta, cin.linbuf, c->samplesPerLine * c->ysize);
+		}
+	}
+}
+
+static void CIN_DecodeThread(void)
+{
+	std::unique_lock<std::mutex> lock(cinDecode.mutex);
+
+	while (true)
+	{
+		cinDecode.wake.wait(lock, [] { return cinDecode.quit || cinDecode.busy; });
+		if (cinDecode.quit)
+		{
+			break;
+		}
+		lock.unlock();
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		CIN_RunDecodeOps(cinDecode.numOps);
+
+		cinDecode.decodeMsec += static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - startTime).count());
+
+		lock.lock();
+		cinDecode.busy = false;
+		cinDecode.idle.notify_all();
+	}
+}
+
+static void CIN_StartDecodeThread(void)
+{
+	if (cinDecode.running || !cl_cinThread->integer)
+	{
+		return;
+	}
+
+	cinDecode.busy = false;
+	cinDecode.quit = false;
+
+	try
+	{
+		cinDecode.thread = std::thread(CIN_DecodeThread);
+		cinDecode.running = true;
+	}
+	catch (const std::system_error&)
+	{
+		Com_Printf(S_COLOR_YELLOW "WARNING: couldn't start the cinematic decode thread, decoding in the frame\n");
+	}
+}
+
+static void CIN_PublishFrame(void)
+{
+	if (!cinDecode.pendingBuf)
+	{
+		return;
+	}
+
+	cinTable[cinDecode.pendingHandle].buf = cinDecode.pendingBuf;
+	cinTable[cinDecode.pendingHandle].dirty = qtrue;
+	cinDecode.pendingBuf = nullptr;
+	cinDecode.numFrames++;
+}
+
+// hands whatever RoQInterrupt queued to the worker, or decodes it right away without one
+static void CIN_KickDecode(void)
+{
+	if (!cinDecode.numQueued)
+	{
+		return;
+	}
+
+	if (!cinDecode.running || !cl_cinThread->integer)
+	{
+		const int msec = Sys_Milliseconds();
+		CIN_RunDecodeOps(cinDecode.numQueued);
+		cinDecode.decodeMsec += Sys_Milliseconds() - msec;
+		cinDecode.numQueued = 0;
+		CIN_PublishFrame();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cinDecode.mutex);
+		cinDecode.numOps = cinDecode.numQueued;
+		cinDecode.busy = true;
+	}
+	cinDecode.wake.notify_one();
+	cinDecode.numQueued = 0;
+	cinDecode.handedOver = true;
+}
+
+// waits for the worker and publishes its frame, call before touching anything it uses
+static void CIN_FinishDecode(void)
+{
+	CIN_KickDecode();
+
+	if (cinDecode.handedOver)
+	{
+		std::unique_lock<std::mutex> lock(cinDecode.mutex);
+		if (cinDecode.busy)
+		{
+			cinDecode.numWaits++;
+			cinDecode.idle.wait(lock, [] { return !cinDecode.busy; });
+		}
+		cinDecode.handedOver = false;
+	}
+
+	CIN_PublishFrame();
+}
+
+// publishes the worker's frame if it's done, without waiting for it
+static void CIN_PollDecode(void)
+{
+	if (!cinDecode.pendingBuf)
+	{
+		return;
+	}
+
+	if (cinDecode.handedOver)
+	{
+		std::lock_guard<std::mutex> lock(cinDecode.mutex);
+		if (cinDecode.busy)
+		{
+			return;
 		}
+		cinDecode.handedOver = false;
 	}
+
+	CIN_PublishFrame();
+}
+
+static cinDecodeOp_t* CIN_QueueDecode(const int type)
+{
+	if (cinDecode.handedOver || cinDecode.numQueued == MAX_DECODE_OPS)
+	{
+		CIN_FinishDecode();
+	}
+
+	cinDecodeOp_t* op = &cinDecode.ops[cinDecode.numQueued++];
+	op->type = type;
+	op->handle = currentHandle;
+	return op;
+}
+
+void CIN_Shutdown(void)
+{
+	CIN_FinishDecode();
+
+	if (!cinDecode.running)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cinDecode.mutex);
+		cinDecode.quit = true;
+	}
+	cinDecode.wake.notify_all();
+	cinDecode.thread.join();
+	cinDecode.running = false;
 }
 
 /******************************************************************************
@@ -1143,8 +1427,6 @@ static void initRoQ(void)
 {
 	if (currentHandle < 0) return;
 
-	cinTable[currentHandle].VQNormal = reinterpret_cast<void (*)(byte*, void*)>(blitVQQuad32fs);
-	cinTable[currentHandle].VQBuffer = reinterpret_cast<void (*)(byte*, void*)>(blitVQQuad32fs);
 	cinTable[currentHandle].samplesPerPixel = 4;
 	ROQ_GenYUVTables();
 	RllSetupTable();
@@ -1177,6 +1459,7 @@ static void RoQReset(void)
 {
 	if (currentHandle < 0) return;
 
+	CIN_FinishDecode();
 	FS_FCloseFile(cinTable[currentHandle].iFile);
 	FS_FOpenFileRead(cinTable[currentHandle].fileName, &cinTable[currentHandle].iFile, qtrue);
 	// let the background thread start reading ahead
@@ -1200,6 +1483,7 @@ static void RoQInterrupt(void)
 
 	if (currentHandle < 0) return;
 
+	CIN_FinishDecode();
 	FS_Read(cin.file, cinTable[currentHandle].RoQFrameSize + 8, cinTable[currentHandle].iFile);
 	if (cinTable[currentHandle].RoQPlayed >= cinTable[currentHandle].ROQSize)
 	{
@@ -1229,32 +1513,27 @@ redump:
 	switch (cinTable[currentHandle].roq_id)
 	{
 	case ROQ_QUAD_VQ:
-		if ((cinTable[currentHandle].numQuads & 1))
-		{
-			cinTable[currentHandle].normalBuffer0 = cinTable[currentHandle].t[1];
-			RoQPrepMcomp(cinTable[currentHandle].roqF0, cinTable[currentHandle].roqF1);
-			cinTable[currentHandle].VQ1(reinterpret_cast<byte*>(cin.qStatus[1]), framedata);
-			cinTable[currentHandle].buf = cin.linbuf + cinTable[currentHandle].screenDelta;
-		}
-		else
-		{
-			cinTable[currentHandle].normalBuffer0 = cinTable[currentHandle].t[0];
-			RoQPrepMcomp(cinTable[currentHandle].roqF0, cinTable[currentHandle].roqF1);
-			cinTable[currentHandle].VQ0(reinterpret_cast<byte*>(cin.qStatus[0]), framedata);
-			cinTable[currentHandle].buf = cin.linbuf;
-		}
-		if (cinTable[currentHandle].numQuads == 0)
-		{
-			// first frame
-			Com_Memcpy(cin.linbuf + cinTable[currentHandle].screenDelta, cin.linbuf,
-				cinTable[currentHandle].samplesPerLine * cinTable[currentHandle].ysize);
-		}
+	{
+		cinDecodeOp_t* op = CIN_QueueDecode(CIN_DECODE_VQ);
+		op->which = cinTable[currentHandle].numQuads & 1;
+		cinTable[currentHandle].normalBuffer0 = cinTable[currentHandle].t[op->which];
+		op->data = framedata;
+		op->normalBuffer0 = cinTable[currentHandle].normalBuffer0;
+		op->roqF0 = cinTable[currentHandle].roqF0;
+		op->roqF1 = cinTable[currentHandle].roqF1;
+		op->firstFrame = static_cast<qboolean>(cinTable[currentHandle].numQuads == 0);
+		cinDecode.pendingHandle = currentHandle;
+		cinDecode.pendingBuf = op->which ? cin.linbuf + cinTable[currentHandle].screenDelta : cin.linbuf;
 		cinTable[currentHandle].numQuads++;
-		cinTable[currentHandle].dirty = qtrue;
 		break;
+	}
 	case ROQ_CODEBOOK:
-		decodeCodeBook(framedata, static_cast<unsigned short>(cinTable[currentHandle].roq_flags));
+	{
+		cinDecodeOp_t* op = CIN_QueueDecode(CIN_DECODE_CODEBOOK);
+		op->data = framedata;
+		op->flags = static_cast<unsigned short>(cinTable[currentHandle].roq_flags);
 		break;
+	}
 	case ZA_SOUND_MONO:
 		if (!cinTable[currentHandle].silent)
 		{
@@ -1279,6 +1558,7 @@ redump:
 	case ROQ_QUAD_INFO:
 		if (cinTable[currentHandle].numQuads == -1)
 		{
+			CIN_FinishDecode();
 			readQuadInfo(framedata);
 			setupQuad(0, 0);
 			cinTable[currentHandle].startTime = cinTable[currentHandle].lastTime = Sys_Milliseconds() * com_timescale->
@@ -1319,6 +1599,7 @@ redump:
 		{
 			cinTable[currentHandle].status = FMV_IDLE;
 		}
+		CIN_KickDecode();
 		return;
 	}
 
@@ -1337,6 +1618,7 @@ redump:
 		{
 			RoQReset();
 		}
+		CIN_KickDecode();
 		return;
 	}
 	if (cinTable[currentHandle].inMemory && (cinTable[currentHandle].status != FMV_EOF))
@@ -1352,6 +1634,9 @@ redump:
 	//	assert(cinTable[currentHandle].RoQFrameSize <= 65536);
 	//	r = FS_Read( cin.file, cinTable[currentHandle].RoQFrameSize+8, cinTable[currentHandle].iFile );
 	cinTable[currentHandle].RoQPlayed += cinTable[currentHandle].RoQFrameSize + 8;
+
+	// off to the decode thread while the frame carries on
+	CIN_KickDecode();
 }
 
 /******************************************************************************
@@ -1394,6 +1679,8 @@ static void RoQ_init(void)
 
 static void RoQShutdown(void)
 {
+	CIN_FinishDecode();
+
 	if (!cinTable[currentHandle].buf)
 	{
 		return;
@@ -1443,6 +1730,8 @@ e_status CIN_StopCinematic(const int handle)
 
 	Com_DPrintf("trFMV::stop(), closing %s\n", cinTable[currentHandle].fileName);
 
+	CIN_FinishDecode();
+
 	if (!cinTable[currentHandle].buf)
 	{
 		return FMV_EOF;
@@ -1524,6 +1813,16 @@ e_status CIN_RunCinematic(const int handle)
 
 	cinTable[currentHandle].lastTime = thisTime;
 
+	// nothing on screen yet, so there's nothing to overlap the first frame with
+	if (!cinTable[currentHandle].buf)
+	{
+		CIN_FinishDecode();
+	}
+	else
+	{
+		CIN_PollDecode();
+	}
+
 	if (cinTable[currentHandle].status == FMV_LOOPED)
 	{
 		cinTable[currentHandle].status = FMV_PLAY;
@@ -1576,6 +1875,8 @@ int CIN_PlayCinematic(const char* arg, const int x, const int y, const int w, co
 
 	Com_DPrintf("CIN_PlayCinematic( %s )\n", arg);
 
+	CIN_StartDecodeThread();
+	CIN_FinishDecode();
 	Com_Memset(&cin, 0, sizeof(cinematics_t));
 	currentHandle = CIN_HandleForVideo();
 
@@ -1666,6 +1967,50 @@ void CIN_SetLooping(const int handle, const qboolean loop)
 	cinTable[handle].looping = loop;
 }
 
+#ifdef CIN_SSE2
+// box filters 512 wide RGBA rows down to 256, two rows into one when rows is 2,
+// the same truncating averages as the scalar loops in CIN_ResampleCinematic
+static void CIN_ResampleHalf(const byte* src, byte* dst, const int rows)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i shift = _mm_cvtsi32_si128(rows);
+
+	for (int iy = 0; iy < 256; iy++)
+	{
+		const byte* row0 = src + iy * rows * 2048;
+		const byte* row1 = rows == 2 ? row0 + 2048 : nullptr;
+
+		for (int ix = 0; ix < 2048; ix += 32, dst += 16)
+		{
+			// eight source pixels, 16 bits a channel, two to a register
+			const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + ix));
+			const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + ix + 16));
+			__m128i p01 = _mm_unpacklo_epi8(a0, zero);
+			__m128i p23 = _mm_unpackhi_epi8(a0, zero);
+			__m128i p45 = _mm_unpacklo_epi8(a1, zero);
+			__m128i p67 = _mm_unpackhi_epi8(a1, zero);
+
+			if (row1)
+			{
+				const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + ix));
+				const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + ix + 16));
+				p01 = _mm_add_epi16(p01, _mm_unpacklo_epi8(b0, zero));
+				p23 = _mm_add_epi16(p23, _mm_unpackhi_epi8(b0, zero));
+				p45 = _mm_add_epi16(p45, _mm_unpacklo_epi8(b1, zero));
+				p67 = _mm_add_epi16(p67, _mm_unpackhi_epi8(b1, zero));
+			}
+
+			// add up neighbouring pixels
+			const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+			const __m128i s1 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+				_mm_packus_epi16(_mm_srl_epi16(s0, shift), _mm_srl_epi16(s1, shift)));
+		}
+	}
+}
+#endif
+
 /*
 ==================
 CIN_ResampleCinematic
@@ -1688,6 +2033,13 @@ void CIN_ResampleCinematic(const int handle, int* buf2)
 	}
 
 	const auto buf3 = reinterpret_cast<int*>(buf);
+#ifdef CIN_SSE2
+	if (cinSIMD && xm == 2 && (ym == 2 || ym == 1))
+	{
+		CIN_ResampleHalf(buf, reinterpret_cast<byte*>(buf2), ym);
+	}
+	else
+#endif
 	if (xm == 2 && ym == 2)
 	{
 		auto bc2 = reinterpret_cast<byte*>(buf2);
@@ -1743,6 +2095,8 @@ void CIN_DrawCinematic(const int handle)
 {
 	if (handle < 0 || handle >= MAX_VIDEO_HANDLES || cinTable[handle].status == FMV_EOF) return;
 
+	CIN_PollDecode();
+
 	if (!cinTable[handle].buf)
 	{
 		return;
@@ -1841,6 +2195,8 @@ void CIN_UploadCinematic(const int handle)
 {
 	if (handle >= 0 && handle < MAX_VIDEO_HANDLES)
 	{
+		CIN_PollDecode();
+
 		if (!cinTable[handle].buf)
 		{
 			return;
@@ -1893,4 +2249,141 @@ void CIN_UploadCinematic(const int handle)
 			cinTable[handle].playonwalls = 1;
 		}
 	}
-}
\ No newline at end of file
+}
+/*
+==================
+CIN_Bench_f
+
+Decodes a whole RoQ into memory as fast as it'll go, once with the scalar
+kernels on the main thread and once the way it normally plays, and checks
+both passes come out with the same frames
+==================
+*/
+void CIN_Bench_f(void)
+{
+	if (Cmd_Argc() != 2)
+	{
+		Com_Printf("usage: cin_bench <roq file>\n");
+		return;
+	}
+
+	using cinBenchPass_t = struct
+	{
+		int frames;
+		int msec; // in RoQInterrupt
+		int waitMsec; // waiting for the worker
+		int decodeMsec;
+		uint32_t checksum;
+	};
+	cinBenchPass_t passes[2]{};
+	int resampleMsec[2]{};
+	int resampleMismatch = -1;
+
+	const int cinThread = cl_cinThread->integer;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		cinBenchPass_t* p = &passes[pass];
+
+#ifdef CIN_SSE2
+		cinSIMD = pass != 0;
+#endif
+		Cvar_Set("cl_cinThread", pass ? va("%i", cinThread) : "0");
+
+		const int handle = CIN_PlayCinematic(Cmd_Argv(1), 0, 0, 0, 0, CIN_silent);
+		if (handle < 0)
+		{
+			Com_Printf(S_COLOR_RED "cin_bench: couldn't open \"%s\"\n", Cmd_Argv(1));
+			break;
+		}
+		if (cinTable[handle].numQuads != -1)
+		{
+			Com_Printf(S_COLOR_RED "cin_bench: \"%s\" is already playing\n", Cmd_Argv(1));
+			break;
+		}
+		cinTable[handle].buf = nullptr;
+		cinTable[handle].dirty = qfalse;
+
+		const int decodeMsec = cinDecode.decodeMsec;
+		while (cinTable[handle].status == FMV_PLAY)
+		{
+			int msec = Sys_Milliseconds();
+			RoQInterrupt();
+			p->msec += Sys_Milliseconds() - msec;
+
+			msec = Sys_Milliseconds();
+			CIN_FinishDecode();
+			p->waitMsec += Sys_Milliseconds() - msec;
+
+			if (cinTable[handle].dirty)
+			{
+				p->checksum = p->checksum * 31 + Com_BlockChecksum(cinTable[handle].buf,
+					cinTable[handle].samplesPerLine * cinTable[handle].ysize);
+				p->frames++;
+				cinTable[handle].dirty = qfalse;
+			}
+		}
+		p->decodeMsec = cinDecode.decodeMsec - decodeMsec;
+
+		// and the last frame through the resampler, both ways
+		if (pass && cinTable[handle].buf && cinTable[handle].CIN_WIDTH / 256 == 2)
+		{
+			const auto scalar = static_cast<int*>(Hunk_AllocateTempMemory(256 * 256 * 4));
+			const auto vec = static_cast<int*>(Hunk_AllocateTempMemory(256 * 256 * 4));
+
+			for (int i = 0; i < 2; i++)
+			{
+#ifdef CIN_SSE2
+				cinSIMD = i != 0;
+#endif
+				const int msec = Sys_Milliseconds();
+				for (int j = 0; j < 100; j++)
+				{
+					CIN_ResampleCinematic(handle, i ? vec : scalar);
+				}
+				resampleMsec[i] = Sys_Milliseconds() - msec;
+			}
+			resampleMismatch = memcmp(scalar, vec, 256 * 256 * 4) != 0;
+
+			Hunk_FreeTempMemory(vec);
+			Hunk_FreeTempMemory(scalar);
+		}
+
+		if (cinTable[handle].iFile)
+		{
+			FS_FCloseFile(cinTable[handle].iFile);
+			cinTable[handle].iFile = 0;
+		}
+		cinTable[handle].buf = nullptr;
+		cinTable[handle].status = FMV_IDLE;
+		cinTable[handle].fileName[0] = 0;
+		currentHandle = -1;
+	}
+
+#ifdef CIN_SSE2
+	cinSIMD = true;
+#endif
+	Cvar_Set("cl_cinThread", va("%i", cinThread));
+
+	if (!passes[0].frames)
+	{
+		return;
+	}
+
+	Com_Printf("frames: %s\n", passes[0].frames == passes[1].frames && passes[0].checksum == passes[1].checksum
+		? "match" : S_COLOR_RED "MISMATCH");
+	Com_Printf("scalar: %i frames, %i msec\n", passes[0].frames, passes[0].msec + passes[0].waitMsec);
+	Com_Printf("%s, thread %s: %i frames, %i msec on the main thread, %i msec waiting, %i msec decoding\n",
+#ifdef CIN_SSE2
+		"vector",
+#else
+		"scalar",
+#endif
+		cinDecode.running && cinThread ? "on" : "off", passes[1].frames, passes[1].msec, passes[1].waitMsec,
+		passes[1].decodeMsec);
+	if (resampleMismatch >= 0)
+	{
+		Com_Printf("resample x 100: %s, scalar %i msec, vector %i msec\n",
+			resampleMismatch ? S_COLOR_RED "MISMATCH" : "match", resampleMsec[0], resampleMsec[1]);
+	}
+}
@@ -35,6 +35,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "cl_uiapi.h"
 #include "cl_lan.h"
 #include "snd_local.h"
+#include "FxUtil.h"
 #include "sys/sys_loadlib.h"
 
 cvar_t* cl_renderer;
@@ -62,6 +63,9 @@ cvar_t* cl_timedemo;
 cvar_t* cl_aviFrameRate;
 cvar_t* cl_aviMotionJpeg;
 cvar_t* cl_avi2GBLimit;
+cvar_t* cl_aviThreads;
+cvar_t* cl_aviQueue;
+cvar_t* cl_aviDropFrames;
 cvar_t* cl_forceavidemo;
 
 cvar_t* cl_freelook;
@@ -87,6 +91,7 @@ cvar_t* cl_allowDownload;
 cvar_t* cl_allowAltEnter;
 cvar_t* cl_conXOffset;
 cvar_t* cl_inGameVideo;
+cvar_t* cl_cinThread;
 
 cvar_t* cl_serverStatusResendTime;
 cvar_t* cl_framerate;
@@ -2569,6 +2574,7 @@ void CL_InitRef(void)
 	ri.FS_FOpenFileByMode = FS_FOpenFileByMode;
 	ri.FS_FileExists = FS_FileExists;
 	ri.FS_FileIsInPAK = FS_FileIsInPAK;
+	ri.FS_FilePakChecksum = FS_FilePakChecksum;
 	ri.FS_ListFiles = FS_ListFiles;
 	ri.FS_Write = FS_Write;
 	ri.FS_WriteFile = FS_WriteFile;
@@ -2587,6 +2593,7 @@ void CL_InitRef(void)
 	ri.CIN_PlayCinematic = CIN_PlayCinematic;
 	ri.CIN_UploadCinematic = CIN_UploadCinematic;
 	ri.CL_WriteAVIVideoFrame = CL_WriteAVIVideoFrame;
+	ri.CL_QueueAVIVideoFrame = CL_QueueAVIVideoFrame;
 
 	// g2 data access
 	ri.GetSharedMemory = GetSharedMemory;
@@ -2851,6 +2858,11 @@ void CL_Init(void)
 	cl_aviFrameRate = Cvar_Get("cl_aviFrameRate", "25", CVAR_ARCHIVE);
 	cl_aviMotionJpeg = Cvar_Get("cl_aviMotionJpeg", "1", CVAR_ARCHIVE);
 	cl_avi2GBLimit = Cvar_Get("cl_avi2GBLimit", "1", CVAR_ARCHIVE);
+	cl_aviThreads = Cvar_Get("cl_aviThreads", "2", CVAR_ARCHIVE_ND,
+		"Threads encoding captured video frames, 0 encodes and writes them in the frame");
+	cl_aviQueue = Cvar_Get("cl_aviQueue", "8", CVAR_ARCHIVE_ND, "Captured frames waiting to be encoded and written");
+	cl_aviDropFrames = Cvar_Get("cl_aviDropFrames", "0", CVAR_ARCHIVE_ND,
+		"Skip captured frames instead of waiting when the capture queue is full");
 	cl_forceavidemo = Cvar_Get("cl_forceavidemo", "0", 0);
 
 	rconAddress = Cvar_Get("rconAddress", "", 0, "Alternate server address to remotely access via rcon protocol");
@@ -2886,6 +2898,7 @@ void CL_Init(void)
 
 	cl_conXOffset = Cvar_Get("cl_conXOffset", "0", 0);
 	cl_inGameVideo = Cvar_Get("r_inGameVideo", "1", CVAR_ARCHIVE_ND);
+	cl_cinThread = Cvar_Get("cl_cinThread", "1", CVAR_ARCHIVE_ND, "Decode cinematics on a thread of their own");
 
 	cl_serverStatusResendTime = Cvar_Get("cl_serverStatusResendTime", "750", 0);
 
@@ -2963,6 +2976,7 @@ void CL_Init(void)
 	Cmd_AddCommand("vid_restart", CL_Vid_Restart_f, "Restart the renderer - or change the resolution");
 	Cmd_AddCommand("disconnect", CL_Disconnect_f, "Disconnect from current server");
 	Cmd_AddCommand("cinematic", CL_PlayCinematic_f, "Play a cinematic video");
+	Cmd_AddCommand("cin_bench", CIN_Bench_f, "Time decoding a cinematic video into memory");
 	Cmd_AddCommand("connect", CL_Connect_f, "Connect to a server");
 	Cmd_AddCommand("reconnect", CL_Reconnect_f, "Reconnect to current server");
 	Cmd_AddCommand("localservers", CL_LocalServers_f, "Query LAN for local servers");
@@ -2977,6 +2991,10 @@ void CL_Init(void)
 	Cmd_AddCommand("forcepowers", CL_SetForcePowers_f);
 	Cmd_AddCommand("video", CL_Video_f, "Record demo to avi");
 	Cmd_AddCommand("stopvideo", CL_StopVideo_f, "Stop avi recording");
+	Cmd_AddCommand("video_test", CL_VideoTest_f, "Record test frames through avi capture and check the file");
+	Cmd_AddCommand("fx_particleRecord", FX_ParticleRecord_f, "Toggle recording spawned particles for fx_particleBench");
+	Cmd_AddCommand("fx_particleBench", FX_ParticleBench_f, "Time the recorded particles through both particle paths");
+	Cmd_AddCommand("fx_parseBench", FX_ParseBench_f, "Time parsing every effect file");
 
 	CL_InitRef();
 
@@ -3023,6 +3041,7 @@ void CL_Shutdown(void)
 
 	// RJ: added the shutdown all to close down the cgame (to free up some memory, such as in the fx system)
 	CL_ShutdownAll(qtrue);
+	CIN_Shutdown();
 
 	S_Shutdown();
 	//CL_ShutdownUI();
@@ -3036,6 +3055,7 @@ void CL_Shutdown(void)
 	Cmd_RemoveCommand("record");
 	Cmd_RemoveCommand("demo");
 	Cmd_RemoveCommand("cinematic");
+	Cmd_RemoveCommand("cin_bench");
 	Cmd_RemoveCommand("stoprecord");
 	Cmd_RemoveCommand("connect");
 	Cmd_RemoveCommand("reconnect");
@@ -3052,6 +3072,10 @@ void CL_Shutdown(void)
 	Cmd_RemoveCommand("forcepowers");
 	Cmd_RemoveCommand("video");
 	Cmd_RemoveCommand("stopvideo");
+	Cmd_RemoveCommand("video_test");
+	Cmd_RemoveCommand("fx_particleRecord");
+	Cmd_RemoveCommand("fx_particleBench");
+	Cmd_RemoveCommand("fx_parseBench");
 
 	CL_ShutdownInput();
 	Con_Shutdown();
@@ -256,6 +256,13 @@ static qboolean CL_SE_GetStringTextString(const char* text, char* buffer, const
 	return qtrue;
 }
 
+static qboolean CL_SE_GetStringFromHandle(const int handle, char* buffer, const int bufferLength)
+{
+	assert(buffer);
+	Q_strncpyz(buffer, SE_GetStringFromHandle(handle), bufferLength);
+	return qtrue;
+}
+
 static void CL_R_ShaderNameFromIndex(char* name, const int index)
 {
 	const char* retMem = re->ShaderNameFromIndex(index);
@@ -1609,6 +1616,9 @@ void CL_BindUI()
 		uii.ext.AddCommand = CL_AddUICommand;
 		uii.ext.RemoveCommand = UIVM_Cmd_RemoveCommand;
 
+		uii.SE_GetStringHandle = SE_GetStringHandle;
+		uii.SE_GetStringFromHandle = CL_SE_GetStringFromHandle;
+
 		const auto GetUIAPI = reinterpret_cast<GetUIAPI_t>(uivm->GetModuleAPI);
 		uiExport_t* ret = GetUIAPI(UI_API_VERSION, &uii);
 		if (!ret)
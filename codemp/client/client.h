@@ -398,6 +398,9 @@ extern cvar_t* cl_timedemo;
 extern cvar_t* cl_aviFrameRate;
 extern cvar_t* cl_aviMotionJpeg;
 extern cvar_t* cl_avi2GBLimit;
+extern cvar_t* cl_aviThreads;
+extern cvar_t* cl_aviQueue;
+extern cvar_t* cl_aviDropFrames;
 
 extern cvar_t* cl_forceavidemo;
 
@@ -407,6 +410,7 @@ extern cvar_t* cl_allowDownload;
 extern cvar_t* cl_allowAltEnter;
 extern cvar_t* cl_conXOffset;
 extern cvar_t* cl_inGameVideo;
+extern cvar_t* cl_cinThread;
 
 extern cvar_t* cl_consoleKeys;
 extern cvar_t* cl_consoleUseScanCode;
@@ -555,6 +559,8 @@ void CIN_SetExtents(int handle, int x, int y, int w, int h);
 void CIN_SetLooping(int handle, qboolean loop);
 void CIN_UploadCinematic(int handle);
 void CIN_CloseAllVideos(void);
+void CIN_Shutdown(void);
+void CIN_Bench_f(void);
 
 //
 // cl_cgame.c
@@ -590,6 +596,8 @@ qboolean CL_Netchan_Process(netchan_t* chan, msg_t* msg);
 qboolean CL_OpenAVIForWriting(const char* file_name);
 void CL_TakeVideoFrame(void);
 void CL_WriteAVIVideoFrame(const byte* imageBuffer, int size);
+qboolean CL_QueueAVIVideoFrame(const byte* pixels, int padding);
 void CL_WriteAVIAudioFrame(const byte* pcmBuffer, int size);
 qboolean CL_CloseAVI(void);
 qboolean CL_VideoRecording(void);
+void CL_VideoTest_f(void);
@@ -196,6 +196,9 @@ cvar_t* s_dynamix;
 cvar_t* s_debugdynamic;
 
 cvar_t* s_doppler;
+cvar_t* s_mixThread;
+cvar_t* s_memoryDevice;
+cvar_t* s_mp3CacheMegs;
 
 using loopSound_t = struct
 {
@@ -477,6 +480,10 @@ void S_Init(void)
 	s_language = Cvar_Get("s_language", "english", CVAR_ARCHIVE | CVAR_NORESTART, "Sound language");
 
 	s_doppler = Cvar_Get("s_doppler", "1", CVAR_ARCHIVE_ND);
+	s_mixThread = Cvar_Get("s_mixThread", "0", CVAR_ARCHIVE | CVAR_LATCH, "Mix sound on a thread of its own");
+	s_memoryDevice = Cvar_Get("s_memoryDevice", "0", CVAR_LATCH, "Mix into a memory buffer instead of the sound card");
+	s_mp3CacheMegs = Cvar_Get("s_mp3CacheMegs", "16", CVAR_ARCHIVE | CVAR_LATCH,
+		"Megabytes of MP3 sound effects to keep decoded, 0 to decode them while mixing");
 
 	MP3_InitCvars();
 
@@ -500,6 +507,8 @@ void S_Init(void)
 	Cmd_AddCommand("s_dynamic", S_SetDynamicMusic_f, "Change dynamic music state");
 	Cmd_AddCommand("menumusic", S_MenuMusic_f, "Play the menumusic");
 	Cmd_AddCommand("totgmapmusic", S_totgmapmusic_f, "Play the totgmapmusic");
+	Cmd_AddCommand("s_mixtest", S_MixTest_f, "Check the sound mix kernels");
+	Cmd_AddCommand("s_mp3cacheinfo", S_MP3PCM_Info_f, "Show the decoded MP3 cache");
 
 #ifdef USE_OPENAL
 	cv = Cvar_Get("s_UseOpenAL", "0", CVAR_ARCHIVE | CVAR_LATCH);
@@ -629,10 +638,13 @@ void S_Init(void)
 	else
 	{
 #endif
-		const qboolean r = SNDDMA_Init(s_khz->integer);
+		const qboolean r = S_DMA_Init(s_khz->integer);
 
 		if (r)
 		{
+			S_MixInit();
+			S_MP3PCM_Init();
+
 			s_soundStarted = 1;
 			s_soundMuted = qtrue;
 			//		s_numSfx = 0;	// do NOT do this here now!!!
@@ -686,7 +698,10 @@ void S_Shutdown(void)
 		return;
 	}
 
+	S_MixShutdown();
+
 	S_FreeAllSFXMem();
+	S_MP3PCM_Shutdown();
 	S_UnCacheDynamicMusic();
 
 #ifdef USE_OPENAL
@@ -732,7 +747,7 @@ void S_Shutdown(void)
 	else
 	{
 #endif
-		SNDDMA_Shutdown();
+		S_DMA_Shutdown();
 #ifdef USE_OPENAL
 	}
 #endif
@@ -748,6 +763,8 @@ void S_Shutdown(void)
 	Cmd_RemoveCommand("soundstop");
 	Cmd_RemoveCommand("mp3_calcvols");
 	Cmd_RemoveCommand("s_dynamic");
+	Cmd_RemoveCommand("s_mixtest");
+	Cmd_RemoveCommand("s_mp3cacheinfo");
 	AS_Free();
 }
 
@@ -1016,6 +1033,8 @@ Creates a default buzz sound if the file can't be loaded
 */
 sfxHandle_t S_RegisterSound(const char* name)
 {
+	S_MixSync();
+
 	if (!s_soundStarted)
 	{
 		return 0;
@@ -1077,6 +1096,12 @@ void S_memoryLoad(sfx_t* sfx)
 		sfx->bDefaultSound = qtrue;
 	}
 	sfx->bInMemory = qtrue;
+
+	// anything kept as MP3 gets decoded in the background, it mixes from the MP3 until that's done
+	if (sfx->eSoundCompressionMethod == ct_MP3)
+	{
+		S_MP3PCM_Queue(sfx);
+	}
 }
 
 //=============================================================================
@@ -1108,6 +1133,8 @@ S_PickChannel
 */
 channel_t* S_PickChannel(const int entnum, const int entchannel)
 {
+	S_MixSync();
+
 	int ch_idx;
 	channel_t* ch, * firstToDie;
 	qboolean foundChan = qfalse;
@@ -1543,6 +1570,8 @@ Mutes sound on specified channel for specified entity.
 */
 void S_MuteSound(const int entityNum, const int entchannel)
 {
+	S_MixSync();
+
 	//I guess this works.
 	channel_t* ch = S_PickChannel(entityNum, entchannel);
 
@@ -1572,6 +1601,8 @@ entchannel 0 will never override a playing sound
 */
 void S_StartSound(const vec3_t origin, const int entityNum, const int entchannel, const sfxHandle_t sfxHandle)
 {
+	S_MixSync();
+
 	channel_t* ch;
 
 	if (!s_soundStarted || s_soundMuted)
@@ -1763,6 +1794,8 @@ so sound doesn't stutter.
 */
 void S_ClearSoundBuffer(void)
 {
+	S_MixSync();
+
 	if (!s_soundStarted || s_soundMuted)
 	{
 		return;
@@ -1786,10 +1819,10 @@ void S_ClearSoundBuffer(void)
 		else
 			clear = 0;
 
-		SNDDMA_BeginPainting();
+		S_DMA_BeginPainting();
 		if (dma.buffer)
 			memset(dma.buffer, clear, dma.samples * dma.samplebits / 8);
-		SNDDMA_Submit();
+		S_DMA_Submit();
 	}
 #ifdef USE_OPENAL
 	else
@@ -1804,6 +1837,8 @@ void S_ClearSoundBuffer(void)
 //
 void S_CIN_StopSound(const sfxHandle_t sfxHandle)
 {
+	S_MixSync();
+
 	if (sfxHandle < 0 || sfxHandle >= s_numSfx)
 	{
 		Com_Error(ERR_DROP, "S_CIN_StopSound: handle %i out of range", sfxHandle);
@@ -1845,6 +1880,8 @@ S_StopAllSounds
 */
 void S_StopSounds(void)
 {
+	S_MixSync();
+
 	if (!s_soundStarted)
 	{
 		return;
@@ -2090,6 +2127,8 @@ sum up the channel multipliers.
 */
 void S_AddLoopSounds(void)
 {
+	S_MixSync();
+
 	int left, right, right_total;
 	static int loopFrame;
 
@@ -2189,6 +2228,8 @@ void S_RawSamples(const int samples, const int rate, const int width, const int
 	const float volume,
 	const int bFirstOrOnlyUpdateThisFrame)
 {
+	S_MixSync();
+
 	int i;
 	int src, dst;
 
@@ -2373,6 +2414,8 @@ let the sound system know where an entity currently is
 */
 void S_UpdateEntityPosition(const int entityNum, const vec3_t origin)
 {
+	S_MixSync();
+
 	if (entityNum < 0 || entityNum >= MAX_GENTITIES)
 	{
 		Com_Error(ERR_DROP, "S_UpdateEntityPosition: bad entitynum %i", entityNum);
@@ -2464,6 +2507,13 @@ static int S_CheckAmplitude(channel_t* ch, const unsigned int s_oldpaintedtime)
 
 				case ct_MP3:
 				{
+					if (ch->thesfx->pDecodedPCM)
+					{
+						const int iIndex = offset + i * 100;
+						sample = iIndex < ch->thesfx->iSoundLengthInSamples ? ch->thesfx->pDecodedPCM[iIndex] : 0;
+						break;
+					}
+
 					const int iIndex = i * 100 + (offset * /*ch->thesfx->width*/2 - ch->iMP3SlidingDecodeWindowPos);
 					const short* pwSamples = (short*)(ch->MP3SlidingDecodeBuffer + iIndex);
 
@@ -2538,6 +2588,8 @@ Change the volumes of all the playing sounds for changes in their positions
 */
 void S_Respatialize(const int entityNum, const vec3_t head, matrix3_t axis, const int inwater)
 {
+	S_MixSync();
+
 #ifdef USE_OPENAL
 	EAXOCCLUSIONPROPERTIES eaxOCProp{};
 	EAXACTIVEFXSLOTS eaxActiveSlots{};
@@ -2791,6 +2843,9 @@ Called once each time through the main loop
 */
 void S_Update(void)
 {
+	S_MixSync();
+	S_MP3PCM_Update();
+
 	if (!s_soundStarted || s_soundMuted)
 	{
 		return;
@@ -2854,7 +2909,7 @@ void S_GetSoundtime(void)
 
 	// it is possible to miscount buffers if it has wrapped twice between
 	// calls to S_Update.  Oh well.
-	const int samplepos = SNDDMA_GetDMAPos();
+	const int samplepos = S_DMA_GetPos();
 	if (samplepos < oldsamplepos)
 	{
 		buffers++; // buffer wrapped
@@ -2890,6 +2945,10 @@ void S_GetSoundtime(void)
 	}
 }
 
+// S_DoLipSynchs for the last paint, when the mixing thread did it
+static qboolean s_lipSyncPending = qfalse;
+static unsigned s_lipSyncPaintedTime;
+
 void S_Update_(void)
 {
 	if (!s_soundStarted || s_soundMuted)
@@ -3021,6 +3080,7 @@ void S_Update_(void)
 				for (i = 0; i < NUM_STREAMING_BUFFERS; i++)
 				{
 					int nTotalBytesDecoded = 0;
+					const CMP3DecoderLock decoderLock;
 
 					for (int j = 0; j < (STREAMING_BUFFER_SIZE / 1152); j++)
 					{
@@ -3144,6 +3204,14 @@ void S_Update_(void)
 	else
 	{
 #endif
+		S_MixSync();
+
+		if (s_lipSyncPending)
+		{
+			s_lipSyncPending = qfalse;
+			S_DoLipSynchs(s_lipSyncPaintedTime);
+		}
+
 		// Updates s_soundtime
 		S_GetSoundtime();
 
@@ -3165,13 +3233,19 @@ void S_Update_(void)
 		if (endtime - s_soundtime > static_cast<unsigned>(samps))
 			endtime = s_soundtime + samps;
 
-		SNDDMA_BeginPainting();
-
-		S_PaintChannels(endtime);
+		S_MixPaint(endtime);
 
-		SNDDMA_Submit();
-
-		S_DoLipSynchs(s_oldpaintedtime);
+		if (S_MixThreaded())
+		{
+			// lip syncing reads the MP3 windows painting fills in, so it has
+			//	to wait until the mixing thread is done with them
+			s_lipSyncPaintedTime = s_oldpaintedtime;
+			s_lipSyncPending = qtrue;
+		}
+		else
+		{
+			S_DoLipSynchs(s_oldpaintedtime);
+		}
 #ifdef USE_OPENAL
 	}
 #endif
@@ -3257,6 +3331,7 @@ void UpdateSingleShotSounds()
 						if (ch->buffers[j].Status == UNQUEUED && ch->MP3StreamHeader.iSourceBytesRemaining > 0)
 						{
 							int nTotalBytesDecoded = 0;
+							const CMP3DecoderLock decoderLock;
 
 							for (int k = 0; k < STREAMING_BUFFER_SIZE / 1152; k++)
 							{
@@ -4308,12 +4383,16 @@ static qboolean S_StartBackgroundTrack_Actual(MusicInfo_t* pMusicInfo, const qbo
 			// init stream struct...
 			//
 			memset(&pMusicInfo->streamMP3_Bgrnd, 0, sizeof pMusicInfo->streamMP3_Bgrnd);
-			char* psError = C_MP3Stream_DecodeInit(&pMusicInfo->streamMP3_Bgrnd, pbMP3DataSegment,
-				pMusicInfo->iLoadedDataLen,
-				dma.speed,
-				16, // sfx->width * 8,
-				qtrue // bStereoDesired
-			);
+			char* psError;
+			{
+				const CMP3DecoderLock decoderLock;
+				psError = C_MP3Stream_DecodeInit(&pMusicInfo->streamMP3_Bgrnd, pbMP3DataSegment,
+					pMusicInfo->iLoadedDataLen,
+					dma.speed,
+					16, // sfx->width * 8,
+					qtrue // bStereoDesired
+				);
+			}
 
 			if (psError == nullptr)
 			{
@@ -5250,7 +5329,12 @@ byte* SND_malloc(const int iSize, const sfx_t* sfx)
 	{
 		while (Z_MemSize(TAG_SND_RAWDATA) + Z_MemSize(TAG_SND_MP3STREAMHDR) > -s_soundpoolmegs->integer * 1024 * 1024)
 		{
-			const int iBytesFreed = SND_FreeOldestSound(sfx);
+			// decoded copies of MP3s are the cheapest thing to lose, so they go first
+			int iBytesFreed = SND_FreeOldestDecodedPCM(sfx);
+			if (iBytesFreed == 0)
+			{
+				iBytesFreed = SND_FreeOldestSound(sfx);
+			}
 			if (iBytesFreed == 0)
 				break; // sanity
 		}
@@ -5287,6 +5371,11 @@ static int SND_MemUsed(const sfx_t* sfx)
 		iSize += Z_Size(sfx->pMP3StreamHeader);
 	}
 
+	if (sfx->pDecodedPCM)
+	{
+		iSize += Z_Size(sfx->pDecodedPCM);
+	}
+
 	return iSize;
 }
 
@@ -5296,7 +5385,10 @@ static int SND_MemUsed(const sfx_t* sfx)
 //
 static int SND_FreeSFXMem(sfx_t* sfx)
 {
-	int iBytesFreed = 0;
+	S_MixSync();
+
+	// before the MP3 goes, since a background decode may still be reading it
+	int iBytesFreed = S_MP3PCM_Free(sfx);
 
 #ifdef USE_OPENAL
 	if (s_UseOpenAL)
@@ -5444,6 +5536,48 @@ int SND_FreeOldestSound(const sfx_t* pButNotThisOne /* = NULL */)
 	return iBytesFreed;
 }
 
+// same again, but only throws away the decoded copy of an MP3 (which will play from the MP3 itself from then on)...
+//
+// returns number of bytes freed up...
+//
+int SND_FreeOldestDecodedPCM(const sfx_t* pButNotThisOne /* = NULL */)
+{
+	int iOldest = Com_Milliseconds();
+	sfx_t* pOldest = nullptr;
+
+	for (int i = 1; i < s_numSfx; i++)
+	{
+		sfx_t* sfx = &s_knownSfx[i];
+
+		if (sfx != pButNotThisOne && sfx->pDecodedPCM && sfx->iLastTimeUsed < iOldest)
+		{
+			// a channel part way through it would lose its place in the MP3, so leave those alone...
+			//
+			int iChannel;
+			for (iChannel = 0; iChannel < MAX_CHANNELS; iChannel++)
+			{
+				if (s_channels[iChannel].thesfx == sfx)
+					break;
+			}
+			if (iChannel == MAX_CHANNELS)
+			{
+				pOldest = sfx;
+				iOldest = sfx->iLastTimeUsed;
+			}
+		}
+	}
+
+	if (!pOldest)
+	{
+		return 0;
+	}
+
+	Com_DPrintf("SND_FreeOldestDecodedPCM: dropping decoded copy of %s\n", pOldest->sSoundName);
+
+	S_MixSync();
+	return S_MP3PCM_Free(pOldest);
+}
+
 int SND_FreeOldestSound(void)
 {
 	return SND_FreeOldestSound(nullptr); // I had to add a void-arg version of this because of link issues, sigh
@@ -80,6 +80,7 @@ using sfx_t = struct sfx_s
 	// not in Memory, set qtrue when loaded, and qfalse when its buffers are freed up because of being old, so can be reloaded
 	SoundCompressionMethod_t eSoundCompressionMethod;
 	MP3STREAM* pMP3StreamHeader; // NULL ptr unless thisis an MP3. Use Z_Malloc and Z_Free
+	short* pDecodedPCM; // MP3s only, the whole thing as 16-bit samples once the background decode is done, else NULL
 	int iSoundLengthInSamples;
 	// length in samples, always kept as 16bit now so this is #shorts (watch for stereo later for music?)
 	char sSoundName[MAX_QPATH];
@@ -207,6 +208,9 @@ extern cvar_t* s_testsound;
 extern cvar_t* s_separation;
 
 extern cvar_t* s_doppler;
+extern cvar_t* s_mixThread;
+extern cvar_t* s_memoryDevice;
+extern cvar_t* s_mp3CacheMegs;
 
 wavinfo_t GetWavinfo(const char* name, byte* wav, int wavlength);
 
@@ -214,6 +218,29 @@ qboolean S_LoadSound(sfx_t* sfx);
 
 void S_PaintChannels(int endtime);
 
+// the output device, either the sound card or the s_memoryDevice buffer
+qboolean S_DMA_Init(int khz);
+void S_DMA_Shutdown(void);
+int S_DMA_GetPos(void);
+void S_DMA_BeginPainting(void);
+void S_DMA_Submit(void);
+
+// s_mixThread, see snd_mix.cpp
+void S_MixInit(void);
+void S_MixShutdown(void);
+qboolean S_MixThreaded(void);
+void S_MixSync(void); // call before touching anything the painter reads
+void S_MixPaint(int endtime);
+void S_MixTest_f(void);
+
+// decoded-PCM cache for sound effects kept as MP3, see snd_mp3.cpp
+void S_MP3PCM_Init(void);
+void S_MP3PCM_Shutdown(void);
+void S_MP3PCM_Queue(sfx_t* sfx); // start decoding in the background
+void S_MP3PCM_Update(void); // hand finished decodes to their sfx_t, mixer must be synced
+int S_MP3PCM_Free(sfx_t* sfx); // cancels or drops the decode, returns bytes freed
+void S_MP3PCM_Info_f(void);
+
 // picks a channel based on priorities, empty slots, number of channels
 channel_t* S_PickChannel(int entnum, int entchannel);
 
@@ -224,6 +251,7 @@ channel_t* S_PickChannel(int entnum, int entchannel);
 byte* SND_malloc(int iSize, const sfx_t* sfx);
 void SND_setup();
 int SND_FreeOldestSound(const sfx_t* pButNotThisOne = nullptr);
+int SND_FreeOldestDecodedPCM(const sfx_t* pButNotThisOne = nullptr);
 void SND_TouchSFX(sfx_t* sfx);
 
 qboolean SND_RegisterAudio_LevelLoadEnd(qboolean bDeleteEverythingNotUsedThisLevel /* 99% qfalse */);
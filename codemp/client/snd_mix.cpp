@@ -25,37 +25,149 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "client.h"
 #include "snd_local.h"
+#include "sdl/sdl_sound.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SND_MIX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SND_MIX_NEON
+#include <arm_neon.h>
+#endif
 
 portable_samplepair_t paintbuffer[PAINTBUFFER_SIZE];
 int* snd_p, snd_linear_count, snd_vol;
 short* snd_out;
 
-// FIXME: proper fix for that ?
-#if !defined(_MSC_VER) || !id386
-void S_WriteLinearBlastStereo16(void)
+/*
+===============================================================================
+
+MIX KERNELS
+
+The vector versions give bit for bit the same results as the scalar ones,
+s_mixtest checks that.
+
+===============================================================================
+*/
+
+// adds a mono 16 bit source into the stereo paint buffer
+static void S_MixMono16_Scalar(portable_samplepair_t* dest, const short* src, const int count, const int leftvol,
+	const int rightvol)
 {
-	int		i;
-	int		val;
+	for (int i = 0; i < count; i++)
+	{
+		const int data = src[i];
 
-	for (i = 0; i < snd_linear_count; i += 2)
+		dest[i].left += (data * leftvol) >> 8;
+		dest[i].right += (data * rightvol) >> 8;
+	}
+}
+
+#ifdef SND_MIX_SSE2
+// SSE2 has no 32 bit multiply that keeps the low half, the low 32 bits of the
+//	unsigned products are the same as the signed ones though
+static inline __m128i S_MulLo32(const __m128i a, const __m128i b)
+{
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+		_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+static void S_MixMono16(portable_samplepair_t* dest, const short* src, const int count, const int leftvol,
+	const int rightvol)
+{
+	int i = 0;
+
+#if defined(SND_MIX_SSE2)
+	const __m128i vol = _mm_set_epi32(rightvol, leftvol, rightvol, leftvol);
+
+	for (; i + 4 <= count; i += 4)
 	{
-		val = snd_p[i] >> 8;
-		if (val > 0x7fff)
-			snd_out[i] = 0x7fff;
-		else if (val < (short)0x8000)
-			snd_out[i] = (short)0x8000;
-		else
-			snd_out[i] = val;
+		__m128i data = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+		data = _mm_srai_epi32(_mm_unpacklo_epi16(data, data), 16);
+
+		// one left/right pair per sample
+		const __m128i lo = _mm_srai_epi32(S_MulLo32(_mm_unpacklo_epi32(data, data), vol), 8);
+		const __m128i hi = _mm_srai_epi32(S_MulLo32(_mm_unpackhi_epi32(data, data), vol), 8);
+
+		const auto out = reinterpret_cast<__m128i*>(dest + i);
+		_mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), lo));
+		_mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), hi));
+	}
+#elif defined(SND_MIX_NEON)
+	const int32_t volPairs[4] = { leftvol, rightvol, leftvol, rightvol };
+	const int32x4_t vol = vld1q_s32(volPairs);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const int32x4_t data = vmovl_s16(vld1_s16(src + i));
+		const int32x4x2_t pairs = vzipq_s32(data, data);
+
+		const auto out = reinterpret_cast<int32_t*>(dest + i);
+		vst1q_s32(out, vaddq_s32(vld1q_s32(out), vshrq_n_s32(vmulq_s32(pairs.val[0], vol), 8)));
+		vst1q_s32(out + 4, vaddq_s32(vld1q_s32(out + 4), vshrq_n_s32(vmulq_s32(pairs.val[1], vol), 8)));
+	}
+#endif
+
+	S_MixMono16_Scalar(dest + i, src + i, count - i, leftvol, rightvol);
+}
+
+// shifts the paint buffer down to 16 bits with saturation
+static void S_ClipStereo16_Scalar(const int* in, short* out, const int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const int val = in[i] >> 8;
 
-		val = snd_p[i + 1] >> 8;
 		if (val > 0x7fff)
-			snd_out[i + 1] = 0x7fff;
+			out[i] = 0x7fff;
 		else if (val < (short)0x8000)
-			snd_out[i + 1] = (short)0x8000;
+			out[i] = (short)0x8000;
 		else
-			snd_out[i + 1] = val;
+			out[i] = val;
 	}
 }
+
+static void S_ClipStereo16(const int* in, short* out, const int count)
+{
+	int i = 0;
+
+#if defined(SND_MIX_SSE2)
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i a = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), 8);
+		const __m128i b = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4)), 8);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+	}
+#elif defined(SND_MIX_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		const int16x4_t a = vqmovn_s32(vshrq_n_s32(vld1q_s32(in + i), 8));
+		const int16x4_t b = vqmovn_s32(vshrq_n_s32(vld1q_s32(in + i + 4), 8));
+
+		vst1q_s16(out + i, vcombine_s16(a, b));
+	}
+#endif
+
+	S_ClipStereo16_Scalar(in + i, out + i, count - i);
+}
+
+// FIXME: proper fix for that ?
+#if !defined(_MSC_VER) || !id386
+void S_WriteLinearBlastStereo16(void)
+{
+	S_ClipStereo16(snd_p, snd_out, snd_linear_count);
+}
 #else
 unsigned int uiMMXAvailable = 0;	// leave as 32 bit
 __declspec(naked) void S_WriteLinearBlastStereo16(void)
@@ -261,76 +373,48 @@ CHANNEL MIXING
 
 ===============================================================================
 */
-static void S_PaintChannelFrom16(channel_t* ch, const sfx_t* sfx, int count, int sampleOffset, int bufferOffset)
+static void S_PaintChannelFrom16Doppler(const channel_t* ch, const short* pSamples, const int count,
+	const int sampleOffset, const int bufferOffset)
 {
-	portable_samplepair_t* pSamplesDest;
-	int iData;
 	float ofst = sampleOffset;
 
-	int iLeftVol = ch->leftvol * snd_vol;
-	int iRightVol = ch->rightvol * snd_vol;
+	const int iLeftVol = ch->leftvol * snd_vol;
+	const int iRightVol = ch->rightvol * snd_vol;
 
-	pSamplesDest = &paintbuffer[bufferOffset];
+	portable_samplepair_t* pSamplesDest = &paintbuffer[bufferOffset];
 
 	for (int i = 0; i < count; i++)
 	{
-		iData = sfx->pSoundData[(int)ofst];
+		const int iData = pSamples[(int)ofst];
 
 		pSamplesDest[i].left += (iData * iLeftVol) >> 8;
 		pSamplesDest[i].right += (iData * iRightVol) >> 8;
-		if (ch->doppler && ch->dopplerScale > 1) {
-			ofst += 1 * ch->dopplerScale;
-		}
-		else {
-			ofst++;
-		}
+		ofst += ch->dopplerScale;
 	}
 }
 
-void S_PaintChannelFromMP3(channel_t* ch, const sfx_t* sc, int count, int sampleOffset, int bufferOffset)
+static void S_PaintChannelFrom16(const channel_t* ch, const short* pSamples, const int count, const int sampleOffset,
+	const int bufferOffset)
 {
-	int data;
-	int leftvol, rightvol;
-	signed short* sfx;
-	int	i;
-	portable_samplepair_t* samp;
-	static short tempMP3Buffer[PAINTBUFFER_SIZE];
-
-	MP3Stream_GetSamples(ch, sampleOffset, count, tempMP3Buffer, qfalse);	// qfalse = not stereo
-
-	leftvol = ch->leftvol * snd_vol;
-	rightvol = ch->rightvol * snd_vol;
-	sfx = tempMP3Buffer;
-
-	samp = &paintbuffer[bufferOffset];
-
-	while (count & 3) {
-		data = *sfx;
-		samp->left += (data * leftvol) >> 8;
-		samp->right += (data * rightvol) >> 8;
-
-		sfx++;
-		samp++;
-		count--;
+	if (ch->doppler && ch->dopplerScale > 1)
+	{
+		S_PaintChannelFrom16Doppler(ch, pSamples, count, sampleOffset, bufferOffset);
+		return;
 	}
 
-	for (i = 0; i < count; i += 4) {
-		data = sfx[i];
-		samp[i].left += (data * leftvol) >> 8;
-		samp[i].right += (data * rightvol) >> 8;
+	// plain playback reads the samples in order, so it can go through the kernel
+	S_MixMono16(&paintbuffer[bufferOffset], pSamples + sampleOffset, count, ch->leftvol * snd_vol,
+		ch->rightvol * snd_vol);
+}
 
-		data = sfx[i + 1];
-		samp[i + 1].left += (data * leftvol) >> 8;
-		samp[i + 1].right += (data * rightvol) >> 8;
+void S_PaintChannelFromMP3(channel_t* ch, const sfx_t* sc, const int count, const int sampleOffset,
+	const int bufferOffset)
+{
+	static short tempMP3Buffer[PAINTBUFFER_SIZE];
 
-		data = sfx[i + 2];
-		samp[i + 2].left += (data * leftvol) >> 8;
-		samp[i + 2].right += (data * rightvol) >> 8;
+	MP3Stream_GetSamples(ch, sampleOffset, count, tempMP3Buffer, qfalse);	// qfalse = not stereo
 
-		data = sfx[i + 3];
-		samp[i + 3].left += (data * leftvol) >> 8;
-		samp[i + 3].right += (data * rightvol) >> 8;
-	}
+	S_MixMono16(&paintbuffer[bufferOffset], tempMP3Buffer, count, ch->leftvol * snd_vol, ch->rightvol * snd_vol);
 }
 
 // subroutinised to save code dup (called twice)	-ste
@@ -341,12 +425,21 @@ void ChannelPaint(channel_t* ch, sfx_t* sc, int count, int sampleOffset, int buf
 	{
 	case ct_16:
 
-		S_PaintChannelFrom16(ch, sc, count, sampleOffset, bufferOffset);
+		S_PaintChannelFrom16(ch, sc->pSoundData, count, sampleOffset, bufferOffset);
 		break;
 
 	case ct_MP3:
 
-		S_PaintChannelFromMP3(ch, sc, count, sampleOffset, bufferOffset);
+		// once the background decode has finished this plays like any other 16-bit sample, channels already
+		//	part way through just pick up at the same offset
+		if (sc->pDecodedPCM)
+		{
+			S_PaintChannelFrom16(ch, sc->pDecodedPCM, count, sampleOffset, bufferOffset);
+		}
+		else
+		{
+			S_PaintChannelFromMP3(ch, sc, count, sampleOffset, bufferOffset);
+		}
 		break;
 
 	default:
@@ -459,4 +552,317 @@ void S_PaintChannels(int endtime)
 		S_TransferPaintBuffer(end);
 		s_paintedtime = end;
 	}
-}
\ No newline at end of file
+}
+/*
+===============================================================================
+
+MEMORY DEVICE
+
+With s_memoryDevice set, sound is mixed into a plain memory buffer whose play
+position follows the system clock instead of going to the sound card. This
+lets the whole mixing path run headless, e.g. for s_mixtest.
+
+===============================================================================
+*/
+static qboolean s_memoryDMA = qfalse;
+static int s_memoryDMAStart;
+
+static qboolean S_MemoryDMA_Init(const int khz)
+{
+	memset(&dma, 0, sizeof dma);
+
+	dma.speed = khz >= 44 ? 44100 : khz >= 22 ? 22050 : 11025;
+	dma.channels = 2;
+	dma.samplebits = 16;
+	dma.samples = 32768; // must be a power of two
+	dma.submission_chunk = 1;
+	dma.buffer = static_cast<byte*>(Z_Malloc(dma.samples * (dma.samplebits / 8), TAG_GENERAL, qtrue));
+
+	s_memoryDMAStart = Sys_Milliseconds();
+	s_memoryDMA = qtrue;
+
+	Com_Printf("Mixing into memory at %i Hz\n", dma.speed);
+
+	return qtrue;
+}
+
+qboolean S_DMA_Init(const int khz)
+{
+	if (s_memoryDevice->integer)
+	{
+		return S_MemoryDMA_Init(khz);
+	}
+
+	s_memoryDMA = qfalse;
+	return SNDDMA_Init(khz);
+}
+
+void S_DMA_Shutdown(void)
+{
+	if (!s_memoryDMA)
+	{
+		SNDDMA_Shutdown();
+		return;
+	}
+
+	Z_Free(dma.buffer);
+	dma.buffer = nullptr;
+	s_memoryDMA = qfalse;
+}
+
+int S_DMA_GetPos(void)
+{
+	if (!s_memoryDMA)
+	{
+		return SNDDMA_GetDMAPos();
+	}
+
+	const long long played = static_cast<long long>(Sys_Milliseconds() - s_memoryDMAStart) * dma.speed / 1000;
+
+	return static_cast<int>((played * dma.channels) & (dma.samples - 1));
+}
+
+void S_DMA_BeginPainting(void)
+{
+	if (!s_memoryDMA)
+	{
+		SNDDMA_BeginPainting();
+	}
+}
+
+void S_DMA_Submit(void)
+{
+	if (!s_memoryDMA)
+	{
+		SNDDMA_Submit();
+	}
+}
+
+/*
+===============================================================================
+
+MIXING THREAD
+
+With s_mixThread set, painting runs on a thread of its own. S_Update_ posts
+paint commands through a single producer, single consumer ring and carries on
+with the frame. Anything on the game thread that touches the channels, the
+raw samples or sound memory calls S_MixSync first, so the two never overlap.
+
+===============================================================================
+*/
+constexpr auto MIX_QUEUE_SIZE = 8; // must be a power of two
+
+struct mixCommand_t
+{
+	int endtime;
+};
+
+static struct
+{
+	std::thread thread;
+	std::mutex mutex; // only used to sleep and wake, never held while mixing
+	std::condition_variable wake;
+	std::condition_variable idle;
+
+	mixCommand_t queue[MIX_QUEUE_SIZE];
+	std::atomic<unsigned> head; // written by the game thread
+	std::atomic<unsigned> tail; // written by the mixing thread
+	std::atomic<bool> quit;
+	bool running;
+} s_mix;
+
+static void S_PaintToDMA(const int endtime)
+{
+	S_DMA_BeginPainting();
+	S_PaintChannels(endtime);
+	S_DMA_Submit();
+}
+
+static void S_MixThread(void)
+{
+	for (;;)
+	{
+		const unsigned tail = s_mix.tail.load(std::memory_order_relaxed);
+
+		if (tail == s_mix.head.load(std::memory_order_acquire))
+		{
+			std::unique_lock<std::mutex> lock(s_mix.mutex);
+
+			s_mix.idle.notify_all();
+			s_mix.wake.wait(lock, [tail]
+			{
+				return s_mix.quit.load() || s_mix.head.load(std::memory_order_acquire) != tail;
+			});
+
+			if (s_mix.head.load(std::memory_order_acquire) == tail)
+			{
+				return;
+			}
+			continue;
+		}
+
+		S_PaintToDMA(s_mix.queue[tail & (MIX_QUEUE_SIZE - 1)].endtime);
+
+		s_mix.tail.store(tail + 1, std::memory_order_release);
+	}
+}
+
+void S_MixInit(void)
+{
+	if (s_mix.running || !s_mixThread->integer)
+	{
+		return;
+	}
+
+	s_mix.head = 0;
+	s_mix.tail = 0;
+	s_mix.quit = false;
+
+	try
+	{
+		s_mix.thread = std::thread(S_MixThread);
+		s_mix.running = true;
+	}
+	catch (const std::system_error&)
+	{
+		Com_Printf(S_COLOR_YELLOW "WARNING: couldn't start the mixing thread, mixing on the main thread\n");
+	}
+}
+
+void S_MixShutdown(void)
+{
+	if (!s_mix.running)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_mix.mutex);
+		s_mix.quit = true;
+	}
+	s_mix.wake.notify_one();
+	s_mix.thread.join();
+
+	s_mix.running = false;
+}
+
+qboolean S_MixThreaded(void)
+{
+	return static_cast<qboolean>(s_mix.running);
+}
+
+void S_MixSync(void)
+{
+	if (!s_mix.running || s_mix.tail.load(std::memory_order_acquire) == s_mix.head.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(s_mix.mutex);
+	s_mix.idle.wait(lock, []
+	{
+		return s_mix.tail.load(std::memory_order_acquire) == s_mix.head.load(std::memory_order_relaxed);
+	});
+}
+
+void S_MixPaint(const int endtime)
+{
+	// avi capture writes the audio out while painting, keep that on the main thread
+	if (!s_mix.running || CL_VideoRecording())
+	{
+		S_MixSync();
+		S_PaintToDMA(endtime);
+		return;
+	}
+
+	const unsigned head = s_mix.head.load(std::memory_order_relaxed);
+
+	if (head - s_mix.tail.load(std::memory_order_acquire) >= MIX_QUEUE_SIZE)
+	{
+		S_MixSync();
+	}
+
+	s_mix.queue[head & (MIX_QUEUE_SIZE - 1)].endtime = endtime;
+	s_mix.head.store(head + 1, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> lock(s_mix.mutex);
+	}
+	s_mix.wake.notify_one();
+}
+
+/*
+=================
+S_MixTest_f
+
+Runs the mix kernels against their scalar versions on random data, and on
+the memory device reports how loud the mixed buffer is
+=================
+*/
+void S_MixTest_f(void)
+{
+	constexpr int passes = 2000;
+	static short src[PAINTBUFFER_SIZE];
+	static portable_samplepair_t start[PAINTBUFFER_SIZE], scalar[PAINTBUFFER_SIZE], vec[PAINTBUFFER_SIZE];
+	static short clipScalar[PAINTBUFFER_SIZE * 2], clipVec[PAINTBUFFER_SIZE * 2];
+
+	for (int i = 0; i < PAINTBUFFER_SIZE; i++)
+	{
+		src[i] = static_cast<short>(irand(-32768, 32767));
+		start[i].left = irand(-0x3fffffff, 0x3fffffff);
+		start[i].right = irand(-0x3fffffff, 0x3fffffff);
+	}
+
+	// odd counts and offsets so the scalar tails get exercised too
+	int mismatches = 0;
+	for (int i = 0; i < 64; i++)
+	{
+		const int count = irand(1, PAINTBUFFER_SIZE - 8);
+		const int offset = irand(0, 7);
+		const int leftvol = irand(0, 255) * irand(0, 256);
+		const int rightvol = irand(0, 255) * irand(0, 256);
+
+		memcpy(scalar, start, sizeof scalar);
+		memcpy(vec, start, sizeof vec);
+		S_MixMono16_Scalar(scalar + offset, src + offset, count, leftvol, rightvol);
+		S_MixMono16(vec + offset, src + offset, count, leftvol, rightvol);
+		mismatches += memcmp(scalar, vec, sizeof scalar) != 0;
+
+		S_ClipStereo16_Scalar(&start[0].left + offset, clipScalar, count);
+		S_ClipStereo16(&start[0].left + offset, clipVec, count);
+		mismatches += memcmp(clipScalar, clipVec, count * sizeof(short)) != 0;
+	}
+
+	int msec = Sys_Milliseconds();
+	for (int i = 0; i < passes; i++)
+	{
+		S_MixMono16_Scalar(scalar, src, PAINTBUFFER_SIZE, 200 * 128, 100 * 128);
+	}
+	const int scalarMsec = Sys_Milliseconds() - msec;
+
+	msec = Sys_Milliseconds();
+	for (int i = 0; i < passes; i++)
+	{
+		S_MixMono16(vec, src, PAINTBUFFER_SIZE, 200 * 128, 100 * 128);
+	}
+	const int vecMsec = Sys_Milliseconds() - msec;
+
+	Com_Printf("mix kernels: %s\n", mismatches ? S_COLOR_RED "MISMATCH" : "match");
+	Com_Printf("%i x %i samples: scalar %i msec, vector %i msec\n", passes, PAINTBUFFER_SIZE, scalarMsec, vecMsec);
+	Com_Printf("mixing thread: %s\n", s_mix.running ? "on" : "off");
+
+	if (s_memoryDMA && dma.buffer)
+	{
+		S_MixSync();
+
+		const auto samples = reinterpret_cast<const short*>(dma.buffer);
+		int peak = 0;
+
+		for (int i = 0; i < dma.samples; i++)
+		{
+			peak = Q_max(peak, abs(samples[i]));
+		}
+
+		Com_Printf("memory device: %i samples, peak %i\n", dma.samples, peak);
+	}
+}
@@ -29,6 +29,27 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "snd_mp3.h"					// only included directly by a few snd_xxxx.cpp files plus this one
 #include "mp3code/mp3struct.h"	// keep this rather awful file secret from the rest of the program
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+// recursive since some of the wrappers call each other...
+//
+static std::recursive_mutex s_mp3DecoderMutex;
+
+CMP3DecoderLock::CMP3DecoderLock()
+{
+	s_mp3DecoderMutex.lock();
+}
+
+CMP3DecoderLock::~CMP3DecoderLock()
+{
+	s_mp3DecoderMutex.unlock();
+}
+
 // expects data already loaded, filename arg is for error printing only
 //
 // returns success/fail
@@ -36,6 +57,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 qboolean MP3_IsValid(const char* psLocalFilename, void* pvData, const int iDataLen,
 	const qboolean bStereoDesired /* = qfalse */)
 {
+	const CMP3DecoderLock decoderLock;
 	char* psError = C_MP3_IsValid(pvData, iDataLen, bStereoDesired);
 
 	if (psError)
@@ -55,6 +77,7 @@ int MP3_GetUnpackedSize(const char* psLocalFilename, void* pvData, const int iDa
 	, const qboolean bStereoDesired /* = qfalse */
 )
 {
+	const CMP3DecoderLock decoderLock;
 	int iUnpackedSize = 0;
 
 	// always do this now that we have fast-unpack code for measuring output size... (much safer than relying on tags that may have been edited, or if MP3 has been re-saved with same tag)
@@ -80,6 +103,7 @@ int MP3_GetUnpackedSize(const char* psLocalFilename, void* pvData, const int iDa
 int MP3_UnpackRawPCM(const char* psLocalFilename, void* pvData, const int iDataLen, byte* pbUnpackBuffer,
 	const qboolean bStereoDesired /* = qfalse */)
 {
+	const CMP3DecoderLock decoderLock;
 	int iUnpackedSize;
 	char* psError = C_MP3_UnpackRawPCM(pvData, iDataLen, &iUnpackedSize, pbUnpackBuffer, bStereoDesired);
 
@@ -97,6 +121,7 @@ int MP3_UnpackRawPCM(const char* psLocalFilename, void* pvData, const int iDataL
 qboolean MP3Stream_InitPlayingTimeFields(const LP_MP3STREAM lpMP3Stream, const char* psLocalFilename, void* pvData,
 	const int iDataLen, const qboolean bStereoDesired /* = qfalse */)
 {
+	const CMP3DecoderLock decoderLock;
 	qboolean bRetval = qfalse;
 
 	int iRate, iWidth, iChannels;
@@ -161,6 +186,7 @@ qboolean MP3_FakeUpWAVInfo(const char* psLocalFilename, void* pvData, const int
 
 	// some things need to be read...  (though the whole stereo flag thing is crap)
 	//
+	const CMP3DecoderLock decoderLock;
 	char* psError = C_MP3_GetHeaderData(pvData, iDataLen, &rate, &width, &channels, bStereoDesired);
 	if (psError)
 	{
@@ -290,11 +316,16 @@ qboolean MP3Stream_InitFromFile(sfx_t* sfx, byte* pbSrcData, const int iSrcDatal
 		// now init the low-level MP3 stuff...
 		//
 		MP3STREAM SFX_MP3Stream = {}; // important to init to all zeroes!
-		char* psError = C_MP3Stream_DecodeInit(&SFX_MP3Stream, /*sfx->data*/ /*sfx->soundData*/ pbSrcData, iSrcDatalen,
-			dma.speed, //(s_khz->value == 44)?44100:(s_khz->value == 22)?22050:11025,
-			2/*sfx->width*/ * 8,
-			bStereoDesired
-		);
+		char* psError;
+		{
+			// (not held any longer than this, the Z_Malloc below can end up waiting on the MP3 decode thread)
+			const CMP3DecoderLock decoderLock;
+			psError = C_MP3Stream_DecodeInit(&SFX_MP3Stream, /*sfx->data*/ /*sfx->soundData*/ pbSrcData, iSrcDatalen,
+				dma.speed, //(s_khz->value == 44)?44100:(s_khz->value == 22)?22050:11025,
+				2/*sfx->width*/ * 8,
+				bStereoDesired
+			);
+		}
 		SFX_MP3Stream.pbSourceData = reinterpret_cast<byte*>(sfx->pSoundData);
 		if (psError)
 		{
@@ -335,6 +366,8 @@ int MP3Stream_Decode(const LP_MP3STREAM lpMP3Stream, qboolean bDoingMusic)
 	lpMP3Stream->iCopyOffset = 0;
 
 	{
+		const CMP3DecoderLock decoderLock;
+
 		// SOF2 music, or EF1 anything...
 		//
 		return C_MP3Stream_Decode(lpMP3Stream, qfalse); // bFastForwarding
@@ -367,6 +400,7 @@ qboolean MP3Stream_SeekTo(channel_t* ch, float fTimeToSeekTo)
 
 		// when decoding, use fast-forward until within 3 seconds, then slow-decode (which should init stuff properly?)...
 		//
+		const CMP3DecoderLock decoderLock;
 		const int iBytesDecodedThisPacket = C_MP3Stream_Decode(&ch->MP3StreamHeader, fAbsTimeDiff > 3.0f);
 		// bFastForwarding
 		if (iBytesDecodedThisPacket == 0)
@@ -489,4 +523,375 @@ qboolean MP3Stream_GetSamples(channel_t* ch, int startingSampleNum, int count, s
 	return qbStreamStillGoing;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// decoded-PCM cache...
+//
+// Sound effects big enough to be kept as MP3 get decoded a packet at a time by whichever channel is playing them,
+//	which puts the decoder on the mix path. So each one is also queued for a whole-file decode on a worker thread when
+//	it's loaded, and once that's done ChannelPaint plays it from sfx->pDecodedPCM like any other 16-bit sample. The
+//	decoded copies are limited to s_mp3CacheMegs (oldest unplayed ones go first, see SND_FreeOldestDecodedPCM), and
+//	SND_FreeSFXMem takes them along with the rest of the sfx_t.
+//
+// All the Z_Malloc / Z_Free calls happen on the main thread, the worker only ever fills in a job's buffer.
+//
+
+using mp3PCMJob_t = struct mp3PCMJob_s
+{
+	sfx_t* sfx;
+	short* pcm; // iSamples long, alloc'd when the job is queued
+	int iSamples;
+	MP3STREAM stream; // own copy of sfx->pMP3StreamHeader, so channels playing the MP3 meanwhile aren't disturbed
+	mp3PCMJob_s* next;
+};
+
+static struct
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake; // something queued, or time to quit
+	std::condition_variable idle; // the worker put a job down
+	mp3PCMJob_t* queueHead; // waiting, oldest first
+	mp3PCMJob_t* queueTail;
+	mp3PCMJob_t* current; // the worker's right now
+	mp3PCMJob_t* done; // finished, waiting for S_MP3PCM_Update
+	std::atomic<bool> cancelCurrent;
+	std::atomic<int> iDecodeMsec;
+	bool quit;
+	bool running;
+
+	// main thread only...
+	int iBytes; // decoded data attached to sfx_t's, plus buffers reserved by jobs
+	int iNumQueued;
+	int iNumDecoded;
+	int iNumCancelled;
+	int iNumDropped;
+} s_mp3PCM;
+
+static void S_MP3PCM_Thread(void)
+{
+	std::unique_lock<std::mutex> lock(s_mp3PCM.mutex);
+
+	while (true)
+	{
+		s_mp3PCM.wake.wait(lock, [] { return s_mp3PCM.quit || s_mp3PCM.queueHead != nullptr; });
+		if (s_mp3PCM.quit)
+		{
+			break;
+		}
+
+		mp3PCMJob_t* job = s_mp3PCM.queueHead;
+		s_mp3PCM.queueHead = job->next;
+		if (!s_mp3PCM.queueHead)
+		{
+			s_mp3PCM.queueTail = nullptr;
+		}
+		s_mp3PCM.current = job;
+		s_mp3PCM.cancelCurrent = false;
+		lock.unlock();
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		// one packet at a time, so a channel decoding on the mixer never waits long for the decoder...
+		//
+		int iSamplesDone = 0;
+		while (iSamplesDone < job->iSamples && !s_mp3PCM.cancelCurrent)
+		{
+			const int iBytesDecoded = MP3Stream_Decode(&job->stream, qfalse);
+			if (iBytesDecoded <= 0)
+			{
+				break;
+			}
+
+			int iCopy = iBytesDecoded / 2;
+			if (iCopy > job->iSamples - iSamplesDone)
+			{
+				iCopy = job->iSamples - iSamplesDone;
+			}
+			memcpy(job->pcm + iSamplesDone, job->stream.bDecodeBuffer, iCopy * sizeof(short));
+			iSamplesDone += iCopy;
+		}
+
+		// same as the sliding buffer does when the MP3 runs out early
+		memset(job->pcm + iSamplesDone, 0, (job->iSamples - iSamplesDone) * sizeof(short));
+
+		s_mp3PCM.iDecodeMsec += static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - startTime).count());
+
+		lock.lock();
+		job->next = s_mp3PCM.done;
+		s_mp3PCM.done = job;
+		s_mp3PCM.current = nullptr;
+		s_mp3PCM.idle.notify_all();
+	}
+}
+
+static int S_MP3PCM_FreeJob(mp3PCMJob_t* job)
+{
+	const int iBytesFreed = Z_Size(job->pcm);
+
+	Z_Free(job->pcm);
+	Z_Free(job);
+
+	return iBytesFreed;
+}
+
+void S_MP3PCM_Init(void)
+{
+	if (s_mp3PCM.running || s_mp3CacheMegs->integer <= 0)
+	{
+		return;
+	}
+
+	s_mp3PCM.queueHead = s_mp3PCM.queueTail = nullptr;
+	s_mp3PCM.current = nullptr;
+	s_mp3PCM.done = nullptr;
+	s_mp3PCM.quit = false;
+	s_mp3PCM.iBytes = 0;
+
+	try
+	{
+		s_mp3PCM.thread = std::thread(S_MP3PCM_Thread);
+		s_mp3PCM.running = true;
+	}
+	catch (const std::system_error&)
+	{
+		Com_Printf(S_COLOR_YELLOW "WARNING: couldn't start the MP3 decode thread, MP3 sounds will decode while mixing\n");
+	}
+}
+
+// anything still attached to an sfx_t should have gone through S_MP3PCM_Free by now (S_FreeAllSFXMem)
+//
+void S_MP3PCM_Shutdown(void)
+{
+	if (!s_mp3PCM.running)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_mp3PCM.mutex);
+		s_mp3PCM.quit = true;
+		s_mp3PCM.cancelCurrent = true;
+	}
+	s_mp3PCM.wake.notify_all();
+	s_mp3PCM.thread.join();
+	s_mp3PCM.running = false;
+
+	for (mp3PCMJob_t* job = s_mp3PCM.queueHead; job;)
+	{
+		mp3PCMJob_t* next = job->next;
+		s_mp3PCM.iBytes -= S_MP3PCM_FreeJob(job);
+		job = next;
+	}
+	for (mp3PCMJob_t* job = s_mp3PCM.done; job;)
+	{
+		mp3PCMJob_t* next = job->next;
+		s_mp3PCM.iBytes -= S_MP3PCM_FreeJob(job);
+		job = next;
+	}
+
+	s_mp3PCM.queueHead = s_mp3PCM.queueTail = nullptr;
+	s_mp3PCM.done = nullptr;
+}
+
+void S_MP3PCM_Queue(sfx_t* sfx)
+{
+	if (!s_mp3PCM.running || sfx->eSoundCompressionMethod != ct_MP3 || !sfx->pMP3StreamHeader || sfx->pDecodedPCM)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_mp3PCM.mutex);
+
+		if (s_mp3PCM.current && s_mp3PCM.current->sfx == sfx)
+		{
+			return;
+		}
+		for (const mp3PCMJob_t* job = s_mp3PCM.queueHead; job; job = job->next)
+		{
+			if (job->sfx == sfx)
+			{
+				return;
+			}
+		}
+		for (const mp3PCMJob_t* job = s_mp3PCM.done; job; job = job->next)
+		{
+			if (job->sfx == sfx)
+			{
+				return;
+			}
+		}
+	}
+
+	// make room, if nothing else can go then this one just stays as an MP3...
+	//
+	const int iBytes = sfx->iSoundLengthInSamples * sizeof(short);
+	const int iMaxBytes = s_mp3CacheMegs->integer * 1024 * 1024;
+	if (iBytes > iMaxBytes)
+	{
+		return;
+	}
+	while (s_mp3PCM.iBytes + iBytes > iMaxBytes)
+	{
+		const int iBytesFreed = SND_FreeOldestDecodedPCM(sfx);
+		if (!iBytesFreed)
+		{
+			return;
+		}
+		s_mp3PCM.iNumDropped++;
+	}
+
+	const auto job = static_cast<mp3PCMJob_t*>(Z_Malloc(sizeof(mp3PCMJob_t), TAG_SND_MP3STREAMHDR, qfalse));
+	job->pcm = static_cast<short*>(Z_Malloc(iBytes, TAG_SND_RAWDATA, qfalse));
+
+	if (!sfx->pMP3StreamHeader)
+	{
+		// z_malloc-fail recovery threw this sound out from under us
+		S_MP3PCM_FreeJob(job);
+		return;
+	}
+
+	job->sfx = sfx;
+	job->iSamples = sfx->iSoundLengthInSamples;
+	memcpy(&job->stream, sfx->pMP3StreamHeader, sizeof job->stream);
+	job->next = nullptr;
+
+	s_mp3PCM.iBytes += Z_Size(job->pcm);
+	s_mp3PCM.iNumQueued++;
+
+	{
+		std::lock_guard<std::mutex> lock(s_mp3PCM.mutex);
+
+		if (s_mp3PCM.queueTail)
+		{
+			s_mp3PCM.queueTail->next = job;
+		}
+		else
+		{
+			s_mp3PCM.queueHead = job;
+		}
+		s_mp3PCM.queueTail = job;
+	}
+	s_mp3PCM.wake.notify_one();
+}
+
+void S_MP3PCM_Update(void)
+{
+	if (!s_mp3PCM.running)
+	{
+		return;
+	}
+
+	mp3PCMJob_t* job;
+	{
+		std::lock_guard<std::mutex> lock(s_mp3PCM.mutex);
+		job = s_mp3PCM.done;
+		s_mp3PCM.done = nullptr;
+	}
+
+	while (job)
+	{
+		mp3PCMJob_t* next = job->next;
+
+		job->sfx->pDecodedPCM = job->pcm;
+		s_mp3PCM.iNumDecoded++;
+		Z_Free(job);
+
+		job = next;
+	}
+}
+
+int S_MP3PCM_Free(sfx_t* sfx)
+{
+	int iBytesFreed = 0;
+
+	if (s_mp3PCM.running)
+	{
+		std::unique_lock<std::mutex> lock(s_mp3PCM.mutex);
+
+		// still waiting its turn?
+		//
+		for (mp3PCMJob_t** ppJob = &s_mp3PCM.queueHead; *ppJob; ppJob = &(*ppJob)->next)
+		{
+			mp3PCMJob_t* job = *ppJob;
+			if (job->sfx == sfx)
+			{
+				*ppJob = job->next;
+				iBytesFreed += S_MP3PCM_FreeJob(job);
+				s_mp3PCM.iNumCancelled++;
+				break;
+			}
+		}
+		s_mp3PCM.queueTail = nullptr;
+		for (mp3PCMJob_t* job = s_mp3PCM.queueHead; job; job = job->next)
+		{
+			s_mp3PCM.queueTail = job;
+		}
+
+		// being decoded right now? Then stop it and wait for it to land in the done list...
+		//
+		if (s_mp3PCM.current && s_mp3PCM.current->sfx == sfx)
+		{
+			s_mp3PCM.cancelCurrent = true;
+			s_mp3PCM.idle.wait(lock, [sfx] { return !s_mp3PCM.current || s_mp3PCM.current->sfx != sfx; });
+			s_mp3PCM.iNumCancelled++;
+		}
+
+		// finished but not handed over yet
+		//
+		for (mp3PCMJob_t** ppJob = &s_mp3PCM.done; *ppJob; ppJob = &(*ppJob)->next)
+		{
+			mp3PCMJob_t* job = *ppJob;
+			if (job->sfx == sfx)
+			{
+				*ppJob = job->next;
+				iBytesFreed += S_MP3PCM_FreeJob(job);
+				break;
+			}
+		}
+	}
+
+	if (sfx->pDecodedPCM)
+	{
+		iBytesFreed += Z_Size(sfx->pDecodedPCM);
+		Z_Free(sfx->pDecodedPCM);
+		sfx->pDecodedPCM = nullptr;
+	}
+
+	s_mp3PCM.iBytes -= iBytesFreed;
+
+	return iBytesFreed;
+}
+
+void S_MP3PCM_Info_f(void)
+{
+	if (!s_mp3PCM.running)
+	{
+		Com_Printf("MP3 decode cache is off (s_mp3CacheMegs 0, or using OpenAL)\n");
+		return;
+	}
+
+	int iPending = 0;
+	{
+		std::lock_guard<std::mutex> lock(s_mp3PCM.mutex);
+
+		for (const mp3PCMJob_t* job = s_mp3PCM.queueHead; job; job = job->next)
+		{
+			iPending++;
+		}
+		if (s_mp3PCM.current)
+		{
+			iPending++;
+		}
+	}
+
+	Com_Printf("%.2fMB of %dMB decoded MP3 data\n", static_cast<float>(s_mp3PCM.iBytes) / 1024.0f / 1024.0f,
+		s_mp3CacheMegs->integer);
+	Com_Printf("%d queued, %d decoded, %d pending, %d cancelled, %d dropped for space\n",
+		s_mp3PCM.iNumQueued, s_mp3PCM.iNumDecoded, iPending, s_mp3PCM.iNumCancelled, s_mp3PCM.iNumDropped);
+	Com_Printf("%dms spent decoding on the worker thread\n", s_mp3PCM.iDecodeMsec.load());
+}
+
 ///////////// eof /////////////
\ No newline at end of file
@@ -72,6 +72,19 @@ qboolean MP3Stream_SeekTo(channel_t* ch, float fTimeToSeekTo);
 qboolean MP3Stream_Rewind(channel_t* ch);
 qboolean MP3Stream_GetSamples(channel_t* ch, int startingSampleNum, int count, short* buf, qboolean bStereo);
 
+// the decoder keeps its working state in globals, so only one thread can be in there at once. The MP3xxx functions
+//	above take this themselves, anything calling the C_MP3xxx ones below directly has to hold one for the duration...
+//
+class CMP3DecoderLock
+{
+public:
+	CMP3DecoderLock();
+	~CMP3DecoderLock();
+
+	CMP3DecoderLock(const CMP3DecoderLock&) = delete;
+	CMP3DecoderLock& operator=(const CMP3DecoderLock&) = delete;
+};
+
 ///////////////////////////////////////
 //
 // the real worker code deep down in the MP3 C code...  (now externalised here so the music streamer can access one)
@@ -65,15 +65,15 @@ or take any AI related factors (for example, the NPC's reaction time) into accou
 
 FIXME do we need fat and thin version of this?
 */
-qboolean CanSee(const gentity_t* ent)
+static qboolean G_CanSee(const gentity_t* self, const gentity_t* ent)
 {
 	trace_t tr;
 	vec3_t eyes, spot;
 
-	CalcEntitySpot(NPCS.NPC, SPOT_HEAD_LEAN, eyes);
+	CalcEntitySpot(self, SPOT_HEAD_LEAN, eyes);
 
 	CalcEntitySpot(ent, SPOT_ORIGIN, spot);
-	trap->Trace(&tr, eyes, NULL, NULL, spot, NPCS.NPC->s.number, MASK_OPAQUE, qfalse, 0, 0);
+	trap->Trace(&tr, eyes, NULL, NULL, spot, self->s.number, MASK_OPAQUE, qfalse, 0, 0);
 	ShotThroughGlass(&tr, ent, spot, MASK_OPAQUE);
 	if (tr.fraction == 1.0)
 	{
@@ -81,7 +81,7 @@ qboolean CanSee(const gentity_t* ent)
 	}
 
 	CalcEntitySpot(ent, SPOT_HEAD, spot);
-	trap->Trace(&tr, eyes, NULL, NULL, spot, NPCS.NPC->s.number, MASK_OPAQUE, qfalse, 0, 0);
+	trap->Trace(&tr, eyes, NULL, NULL, spot, self->s.number, MASK_OPAQUE, qfalse, 0, 0);
 	ShotThroughGlass(&tr, ent, spot, MASK_OPAQUE);
 	if (tr.fraction == 1.0)
 	{
@@ -89,7 +89,7 @@ qboolean CanSee(const gentity_t* ent)
 	}
 
 	CalcEntitySpot(ent, SPOT_LEGS, spot);
-	trap->Trace(&tr, eyes, NULL, NULL, spot, NPCS.NPC->s.number, MASK_OPAQUE, qfalse, 0, 0);
+	trap->Trace(&tr, eyes, NULL, NULL, spot, self->s.number, MASK_OPAQUE, qfalse, 0, 0);
 	ShotThroughGlass(&tr, ent, spot, MASK_OPAQUE);
 	if (tr.fraction == 1.0)
 	{
@@ -99,6 +99,127 @@ qboolean CanSee(const gentity_t* ent)
 	return qfalse;
 }
 
+/*
+-------------------------
+NPC sense phase
+
+G_RunFrame calls NPC_SenseFrame before any entity thinks. Every NPC that
+will run its behavior this frame gets its view of its current enemy
+(PVS, line of sight, clear LOS) worked out against the world as it stands
+at the start of the frame and stored in a per-NPC slot. The think that
+follows (the act phase) reads those answers back from NPC_CheckVisibility
+and G_ClearLOS4 instead of tracing again, so it no longer matters where an
+NPC sits in the entity list relative to what it is looking at.
+
+The traces have to go through the engine, which can't take them from more
+than one thread, so the phase itself runs serially.
+-------------------------
+*/
+
+#define NPCSENSE_PVS		1
+#define NPCSENSE_CANSEE		2
+#define NPCSENSE_CLEARLOS	4
+
+typedef struct npcSense_s
+{
+	int time; // level.time the slot was filled for
+	int enemyNum;
+	int valid; // NPCSENSE_ bits
+	int results; // NPCSENSE_ bits
+} npcSense_t;
+
+static npcSense_t npcSense[MAX_GENTITIES];
+npcSenseStats_t npcSenseStats;
+
+static const npcSense_t* NPC_GetSense(const gentity_t* self, const gentity_t* ent, const int bit)
+{
+	if (!g_npcSense.integer || !self || !ent)
+	{
+		return NULL;
+	}
+
+	const npcSense_t* sense = &npcSense[self->s.number];
+
+	if (sense->time != level.time || sense->enemyNum != ent->s.number || !(sense->valid & bit))
+	{
+		return NULL;
+	}
+
+	npcSenseStats.hits++;
+	return sense;
+}
+
+static void NPC_SenseEnemy(gentity_t* self)
+{
+	npcSense_t* sense = &npcSense[self->s.number];
+	gentity_t* enemy = self->enemy;
+
+	sense->time = level.time;
+	sense->enemyNum = enemy->s.number;
+	sense->valid = NPCSENSE_PVS;
+	sense->results = 0;
+
+	if (!trap->InPVS(enemy->r.currentOrigin, self->r.currentOrigin))
+	{
+		//most likely not going to look any further, let the act phase trace if it does
+		return;
+	}
+	sense->results |= NPCSENSE_PVS;
+
+	if (G_CanSee(self, enemy))
+	{
+		sense->results |= NPCSENSE_CANSEE;
+	}
+	if (G_ClearLOS4(self, enemy))
+	{
+		sense->results |= NPCSENSE_CLEARLOS;
+	}
+	sense->valid |= NPCSENSE_CANSEE | NPCSENSE_CLEARLOS;
+}
+
+void NPC_SenseFrame(void)
+{
+	if (!g_npcSense.integer)
+	{
+		return;
+	}
+
+	gentity_t* ent = g_entities;
+	for (int i = 0; i < level.num_entities; i++, ent++)
+	{
+		if (!ent->inuse || ent->s.eType != ET_NPC || !ent->NPC || !ent->client)
+		{
+			continue;
+		}
+
+		if (ent->health <= 0 || ent->think != NPC_Think || ent->nextthink > level.time
+			|| ent->NPC->nextBStateThink > level.time)
+		{
+			//won't run its behavior this frame
+			continue;
+		}
+
+		if (!ent->enemy || !ent->enemy->inuse || ent->enemy == ent)
+		{
+			continue;
+		}
+
+		NPC_SenseEnemy(ent);
+		npcSenseStats.sensed++;
+	}
+}
+
+qboolean CanSee(const gentity_t* ent)
+{
+	const npcSense_t* sense = NPC_GetSense(NPCS.NPC, ent, NPCSENSE_CANSEE);
+
+	if (sense)
+	{
+		return sense->results & NPCSENSE_CANSEE ? qtrue : qfalse;
+	}
+
+	return G_CanSee(NPCS.NPC, ent);
+}
 qboolean in_front(vec3_t spot, vec3_t from, vec3_t from_angles, const float thresh_hold)
 {
 	vec3_t dir, forward, angles;
@@ -263,7 +384,9 @@ visibility_t NPC_CheckVisibility(const gentity_t* ent, const int flags)
 	// check PVS
 	if (flags & CHECK_PVS)
 	{
-		if (!trap->InPVS(ent->r.currentOrigin, NPCS.NPC->r.currentOrigin))
+		const npcSense_t* sense = NPC_GetSense(NPCS.NPC, ent, NPCSENSE_PVS);
+
+		if (sense ? !(sense->results & NPCSENSE_PVS) : !trap->InPVS(ent->r.currentOrigin, NPCS.NPC->r.currentOrigin))
 		{
 			return VIS_NOT;
 		}
@@ -825,6 +948,12 @@ qboolean G_ClearLOS4(gentity_t* self, gentity_t* ent)
 {
 	vec3_t eyes;
 
+	const npcSense_t* sense = NPC_GetSense(self, ent, NPCSENSE_CLEARLOS);
+	if (sense)
+	{
+		return sense->results & NPCSENSE_CLEARLOS ? qtrue : qfalse;
+	}
+
 	//Calculate my position
 	CalcEntitySpot(self, SPOT_HEAD_LEAN, eyes);
 
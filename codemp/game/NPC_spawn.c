@@ -4734,11 +4734,10 @@ void SP_NPC_Droid_Protocol(gentity_t* self)
 NPC_Spawn_f
 */
 
-gentity_t* NPC_SpawnType(const gentity_t* ent, const char* npc_type, const char* targetname, const qboolean isVehicle)
+static gentity_t* NPC_SpawnTypeAt(const vec3_t origin, const float yaw, const char* npc_type, const char* targetname,
+	const qboolean isVehicle)
 {
 	gentity_t* NPCspawner = G_Spawn();
-	vec3_t forward, end;
-	trace_t trace;
 
 	if (!NPCspawner)
 	{
@@ -4762,28 +4761,11 @@ gentity_t* NPC_SpawnType(const gentity_t* ent, const char* npc_type, const char*
 		return NULL;
 	}
 
-	if (!ent || !ent->client)
-	{
-		//screw you, go away
-		return NULL;
-	}
-
-	//rwwFIXMEFIXME: Care about who is issuing this command/other clients besides 0?
-	//Spawn it at spot of first player
-	//FIXME: will gib them!
-	AngleVectors(ent->client->ps.viewangles, forward, NULL, NULL);
-	VectorNormalize(forward);
-	VectorMA(ent->r.currentOrigin, 128, forward, end);
-	trap->Trace(&trace, ent->r.currentOrigin, NULL, NULL, end, 0, MASK_SOLID, qfalse, 0, 0);
-	VectorCopy(trace.endpos, end);
-	end[2] -= 24;
-	trap->Trace(&trace, trace.endpos, NULL, NULL, end, 0, MASK_SOLID, qfalse, 0, 0);
-	VectorCopy(trace.endpos, end);
-	end[2] += 24;
-	G_SetOrigin(NPCspawner, end);
+	vec3_t spawnOrigin;
+	VectorCopy(origin, spawnOrigin);
+	G_SetOrigin(NPCspawner, spawnOrigin);
 	VectorCopy(NPCspawner->r.currentOrigin, NPCspawner->s.origin);
-	//set the yaw so that they face away from player
-	NPCspawner->s.angles[1] = ent->client->ps.viewangles[1];
+	NPCspawner->s.angles[1] = yaw;
 
 	trap->LinkEntity((sharedEntity_t*)NPCspawner);
 
@@ -4893,6 +4875,217 @@ gentity_t* NPC_SpawnType(const gentity_t* ent, const char* npc_type, const char*
 	return NPC_Spawn_Do(NPCspawner);
 }
 
+// drops a spawn point where a trace from start towards dir ends, standing on the floor below it
+static void NPC_SpawnPoint(const vec3_t start, const vec3_t dir, const float dist, vec3_t out)
+{
+	vec3_t end;
+	trace_t trace;
+
+	VectorMA(start, dist, dir, end);
+	trap->Trace(&trace, start, NULL, NULL, end, 0, MASK_SOLID, qfalse, 0, 0);
+	VectorCopy(trace.endpos, end);
+	end[2] -= 24;
+	trap->Trace(&trace, trace.endpos, NULL, NULL, end, 0, MASK_SOLID, qfalse, 0, 0);
+	VectorCopy(trace.endpos, out);
+	out[2] += 24;
+}
+
+gentity_t* NPC_SpawnType(const gentity_t* ent, const char* npc_type, const char* targetname, const qboolean isVehicle)
+{
+	vec3_t forward, end;
+
+	if (!ent || !ent->client)
+	{
+		//screw you, go away
+		return NULL;
+	}
+
+	//rwwFIXMEFIXME: Care about who is issuing this command/other clients besides 0?
+	//Spawn it at spot of first player
+	//FIXME: will gib them!
+	AngleVectors(ent->client->ps.viewangles, forward, NULL, NULL);
+	VectorNormalize(forward);
+	NPC_SpawnPoint(ent->r.currentOrigin, forward, 128, end);
+
+	//set the yaw so that they face away from player
+	return NPC_SpawnTypeAt(end, ent->client->ps.viewangles[1], npc_type, targetname, isVehicle);
+}
+
+/*
+-------------------------
+NPC_Bench_f
+
+npc bench <count> [type] [frames]
+
+Rings the player with count NPCs of the given type (stormtrooper by
+default), then times the next frames server frames and prints the
+average and worst frame along with the NPC sense phase numbers.
+-------------------------
+*/
+
+npcBench_t npcBench;
+
+#define NPC_BENCH_RESERVE_ENTITIES	64	//left free for whatever else the level spawns
+
+//each bench NPC takes two slots, its spawner (freed the next frame) and the NPC itself
+static int NPC_BenchMaxCount(void)
+{
+	int freeEnts = ENTITYNUM_MAX_NORMAL - level.num_entities;
+
+	for (int i = MAX_CLIENTS; i < level.num_entities; i++)
+	{
+		if (!g_entities[i].inuse)
+		{
+			freeEnts++;
+		}
+	}
+
+	return (freeEnts - NPC_BENCH_RESERVE_ENTITIES) / 2;
+}
+
+static void NPC_Bench_f(const gentity_t* ent)
+{
+	char arg[1024];
+	char npc_type[1024];
+
+	if (npcBench.framesLeft)
+	{
+		Com_Printf("NPC bench already running, %d frames left\n", npcBench.framesLeft);
+		return;
+	}
+
+	const int maxCount = NPC_BenchMaxCount();
+	if (maxCount < 1)
+	{
+		Com_Printf("NPC bench: not enough free entities\n");
+		return;
+	}
+
+	trap->Argv(2, arg, sizeof arg);
+	const int count = Com_Clampi(1, maxCount, atoi(arg));
+
+	trap->Argv(3, npc_type, sizeof npc_type);
+	if (!npc_type[0])
+	{
+		Q_strncpyz(npc_type, "stormtrooper", sizeof npc_type);
+	}
+
+	trap->Argv(4, arg, sizeof arg);
+	const int frames = arg[0] ? Com_Clampi(1, 100000, atoi(arg)) : 300;
+
+	int spawned = 0;
+	for (int i = 0; i < count; i++)
+	{
+		//rings of 16, 64 units apart
+		vec3_t angles, dir, spot;
+
+		VectorSet(angles, 0, ent->client->ps.viewangles[YAW] + i % 16 * (360.0f / 16), 0);
+		AngleVectors(angles, dir, NULL, NULL);
+		NPC_SpawnPoint(ent->r.currentOrigin, dir, 128 + i / 16 * 64, spot);
+
+		if (!NPC_SpawnTypeAt(spot, angles[YAW], npc_type, NULL, qfalse))
+		{
+			break;
+		}
+		spawned++;
+	}
+
+	memset(&npcBench, 0, sizeof npcBench);
+	memset(&npcSenseStats, 0, sizeof npcSenseStats);
+	npcBench.framesLeft = npcBench.frames = frames;
+	npcBench.npcs = spawned;
+
+	Com_Printf("NPC bench: spawned %d %s, timing %d frames\n", spawned, npc_type, frames);
+}
+
+void NPC_BenchFrame(const int frameMsec, const int senseMsec)
+{
+	if (!npcBench.framesLeft)
+	{
+		return;
+	}
+
+	npcBench.totalMsec += frameMsec;
+	npcBench.senseMsec += senseMsec;
+	if (frameMsec > npcBench.maxMsec)
+	{
+		npcBench.maxMsec = frameMsec;
+	}
+
+	if (--npcBench.framesLeft)
+	{
+		return;
+	}
+
+	Com_Printf("NPC bench: %d NPCs, %d frames, %.2f msec avg, %d msec worst\n",
+		npcBench.npcs, npcBench.frames, (float)npcBench.totalMsec / npcBench.frames, npcBench.maxMsec);
+	Com_Printf("  sense phase %.2f msec avg (g_npcSense %d), %d NPCs sensed, %d checks reused\n",
+		(float)npcBench.senseMsec / npcBench.frames, g_npcSense.integer, npcSenseStats.sensed, npcSenseStats.hits);
+}
+
+/*
+-------------------------
+NPC_BenchDefs_f
+
+npc benchdefs
+
+Looks up every NPC and saber definition through the name index, and a
+sample of them by scanning the definition text the way spawns used to,
+and prints the average cost of a lookup each way.
+-------------------------
+*/
+
+#define BENCHDEFS_LINEAR_SAMPLES 64
+
+extern bgDefIndex_t npcDefIndex;
+extern bgDefIndex_t saberDefIndex;
+
+static void NPC_BenchDefIndex(const char* label, const bgDefIndex_t* index)
+{
+	char name[MAX_QPATH];
+	int missed = 0;
+
+	if (!index->numEntries)
+	{
+		Com_Printf("%s: no definitions loaded\n", label);
+		return;
+	}
+
+	int start = trap->Milliseconds();
+	for (int i = 0; BG_DefName(index, i, name, sizeof name); i++)
+	{
+		if (!BG_FindDef(index, name))
+		{
+			missed++;
+		}
+	}
+	const int indexMsec = trap->Milliseconds() - start;
+
+	// scanning is quadratic over the whole set, only sample it
+	const int step = Q_max(1, index->numEntries / BENCHDEFS_LINEAR_SAMPLES);
+	int samples = 0;
+
+	start = trap->Milliseconds();
+	for (int i = 0; BG_DefName(index, i, name, sizeof name); i += step, samples++)
+	{
+		if (!BG_FindDefLinear(index->buffer, name))
+		{
+			missed++;
+		}
+	}
+	const int linearMsec = trap->Milliseconds() - start;
+
+	Com_Printf("%s: %d definitions, indexed %.4f msec per lookup, scanned %.4f msec per lookup (%d samples)%s\n",
+		label, index->numEntries, (float)indexMsec / index->numEntries, (float)linearMsec / samples, samples,
+		missed ? S_COLOR_RED" (lookups failed!)" : "");
+}
+
+static void NPC_BenchDefs_f(void)
+{
+	NPC_BenchDefIndex("NPCs", &npcDefIndex);
+	NPC_BenchDefIndex("sabers", &saberDefIndex);
+}
+
 void NPC_Spawn_f(gentity_t* ent)
 {
 	char npc_type[1024];
@@ -5076,6 +5269,8 @@ void Cmd_NPC_f(gentity_t* ent)
 		Com_Printf(" kill [NPC targetname] or [all(kills all NPCs)] or 'team [teamname]'\n");
 		Com_Printf(" showbounds (draws exact bounding boxes of NPCs)\n");
 		Com_Printf(" score [NPC targetname] (prints number of kills per NPC)\n");
+		Com_Printf(" bench [count] [NPC type] [frames] (spawns count NPCs around you and times the frames after)\n");
+		Com_Printf(" benchdefs (times looking up every NPC and saber definition)\n");
 	}
 	else if (Q_stricmp(cmd, "spawn") == 0)
 	{
@@ -5085,6 +5280,14 @@ void Cmd_NPC_f(gentity_t* ent)
 	{
 		NPC_Kill_f();
 	}
+	else if (Q_stricmp(cmd, "bench") == 0)
+	{
+		NPC_Bench_f(ent);
+	}
+	else if (Q_stricmp(cmd, "benchdefs") == 0)
+	{
+		NPC_BenchDefs_f();
+	}
 	else if (Q_stricmp(cmd, "showbounds") == 0)
 	{
 		//Toggle on and off
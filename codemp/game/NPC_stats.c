@@ -265,7 +265,12 @@ int NPC_ReactionTime(void)
 extern qboolean BG_ParseLiteral(const char** data, const char* string);
 
 #define MAX_NPC_DATA_SIZE 0x100000
-char NPCParms[MAX_NPC_DATA_SIZE];
+static char npcParmsBuffer[MAX_NPC_DATA_SIZE];
+static const char* NPCParms = npcParmsBuffer;
+
+#define MAX_NPC_DEFS 8192
+static bgDefIndexEntry_t npcDefEntries[MAX_NPC_DEFS];
+bgDefIndex_t npcDefIndex;
 
 static rank_t TranslateRankName(const char* name)
 {
@@ -519,24 +524,11 @@ void NPC_Precache(gentity_t* spawner)
 	}
 	strcpy(customSkin, "default");
 
-	p = NPCParms;
 	Com_sprintf(sessionName, sizeof sessionName, "NPC_Precache(%s)", spawner->NPC_type);
 	COM_BeginParseSession(sessionName);
 
 	// look for the right NPC
-	while (p)
-	{
-		token = COM_ParseExt(&p, qtrue);
-		if (token[0] == 0)
-			return;
-
-		if (!Q_stricmp(token, spawner->NPC_type))
-		{
-			break;
-		}
-
-		SkipBracedSection(&p, 0);
-	}
+	p = BG_FindDef(&npcDefIndex, spawner->NPC_type);
 
 	if (!p)
 	{
@@ -911,26 +903,11 @@ qboolean NPC_ParseParms(const char* npc_name, gentity_t* npc)
 		const char* token;
 		int fp;
 
-		p = NPCParms;
 		Com_sprintf(session_name, sizeof session_name, "NPC_ParseParms(%s)", npc_name);
 		COM_BeginParseSession(session_name);
 
 		// look for the right NPC
-		while (p)
-		{
-			token = COM_ParseExt(&p, qtrue);
-			if (token[0] == 0)
-			{
-				return qfalse;
-			}
-
-			if (!Q_stricmp(token, npc_name))
-			{
-				break;
-			}
-
-			SkipBracedSection(&p, 0);
-		}
+		p = BG_FindDef(&npcDefIndex, npc_name);
 		if (!p)
 		{
 			return qfalse;
@@ -3507,9 +3484,18 @@ void NPC_LoadParms(void)
 	fileHandle_t f;
 	int len = 0;
 
+	//the cached copy from before a map restart will do
+	NPCParms = BG_AcquireSharedData("ext_data/mpnpcs/*.npc", 0);
+	if (NPCParms)
+	{
+		BG_BuildDefIndex(&npcDefIndex, NPCParms, npcDefEntries, MAX_NPC_DEFS);
+		return;
+	}
+	NPCParms = npcParmsBuffer;
+
 	//remember where to store the next one
 	int totallen = len;
-	char* marker = NPCParms + totallen;
+	char* marker = npcParmsBuffer + totallen;
 	*marker = 0;
 
 	//now load in the extra .npc extensions
@@ -3547,9 +3533,13 @@ void NPC_LoadParms(void)
 			trap->FS_Close(f);
 
 			totallen += len;
-			marker = NPCParms + totallen;
+			marker = npcParmsBuffer + totallen;
 		}
 	}
+
+	BG_StoreSharedData("ext_data/mpnpcs/*.npc", npcParmsBuffer, strlen(npcParmsBuffer) + 1);
+
+	BG_BuildDefIndex(&npcDefIndex, NPCParms, npcDefEntries, MAX_NPC_DEFS);
 }
 
 extern void npc_shadow_trooper_precache(void);
@@ -3822,6 +3822,68 @@ qboolean BG_OutOfMemory(void)
 	return bg_poolSize >= MAX_POOL_SIZE;
 }
 
+#if defined(_GAME) || defined(_CGAME)
+//Parsed files the engine keeps for game and cgame both. Whichever module loads something first stores what it
+//parsed, after that the other one (or either, after a map restart) acquires the same read-only copy instead of
+//reading the files again. Everything held gets let go in BG_ReleaseSharedData on shutdown.
+#define MAX_BG_SHARED_DATA 256
+static const void* bgSharedData[MAX_BG_SHARED_DATA];
+static int bgNumSharedData = 0;
+
+//size of 0 takes whatever is there, otherwise it has to match or it was built with a different layout
+const void* BG_AcquireSharedData(const char* name, const size_t size)
+{
+	size_t sharedSize = 0;
+
+	if (!trap->SharedData_Acquire || bgNumSharedData >= MAX_BG_SHARED_DATA)
+	{
+		//a legacy syscall build of the module has no entries for the shared store
+		return NULL;
+	}
+
+	const void* data = trap->SharedData_Acquire(name, &sharedSize);
+	if (!data)
+	{
+		return NULL;
+	}
+
+	if (size && sharedSize != size)
+	{
+		trap->SharedData_Release(data);
+		return NULL;
+	}
+
+	bgSharedData[bgNumSharedData++] = data;
+	return data;
+}
+
+//copies data into the store, returns the shared copy or NULL if it couldn't be shared
+const void* BG_StoreSharedData(const char* name, const void* data, const size_t size)
+{
+	if (!trap->SharedData_Store || bgNumSharedData >= MAX_BG_SHARED_DATA)
+	{
+		return NULL;
+	}
+
+	const void* shared = trap->SharedData_Store(name, data, size);
+	if (shared)
+	{
+		bgSharedData[bgNumSharedData++] = shared;
+	}
+	return shared;
+}
+
+//ALWAYS call on game/cgame shutdown
+void BG_ReleaseSharedData(void)
+{
+	for (int i = 0; i < bgNumSharedData; i++)
+	{
+		trap->SharedData_Release(bgSharedData[i]);
+	}
+	bgNumSharedData = 0;
+}
+#endif
+
 qboolean BG_IsWhiteSpace(const char c)
 {
 	//this function simply checks to see if the given character is whitespace.
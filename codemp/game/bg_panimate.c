@@ -4931,10 +4931,6 @@ static animation_t* BG_AnimsetAlloc(void)
 	return bgAllAnims[bgNumAllAnims].anims;
 }
 
-static void BG_AnimsetFree()
-{
-}
-
 #ifdef _CGAME //none of this is actually needed server side. Could just be moved to cgame code but it's here since it used to tie in a lot with the anim loading stuff.
 
 stringID_table_t animEventTypeTable[MAX_ANIM_EVENTS + 1] =
@@ -5697,121 +5693,10 @@ fin:
 }
 #endif
 
-/*
-======================
-BG_ParseAnimationFile
-
-Read a configuration file containing animation counts and rates
-models/players/visor/animation.cfg, etc
-
-======================
-*/
-int bg_parse_animation_file(const char* filename, animation_t* anim_set, const qboolean is_humanoid)
+//fills in anim_set from the text of an animation.cfg
+static void BG_ParseAnimationText(const char* filename, const char* text_p, animation_t* anim_set)
 {
-	char* text_p;
 	int i;
-	int used_index;
-	int next_index = bgNumAllAnims;
-	qboolean dyn_alloc = qfalse;
-	static char bgpa_ftext[120000];
-	fileHandle_t f;
-
-	bgpa_ftext[0] = '\0';
-
-	if (!is_humanoid)
-	{
-		i = 0;
-		while (i < bgNumAllAnims)
-		{
-			//see if it's been loaded already
-			if (!Q_stricmp(bgAllAnims[i].filename, filename))
-			{
-				bgAllAnims[i].anims;
-				return i; //alright, we already have it.
-			}
-			i++;
-		}
-
-		//Looks like it has not yet been loaded. Allocate space for the anim set if we need to, and continue along.
-		if (!anim_set)
-		{
-			if (strstr(filename, "players/_humanoid/"))
-			{
-				//then use the static humanoid set.
-				anim_set = bgHumanoidAnimations;
-				next_index = 0;
-			}
-			else if (strstr(filename, "players/rockettrooper/"))
-			{
-				//rockettrooper always index 1
-				next_index = 1;
-				anim_set = BG_AnimsetAlloc();
-				dyn_alloc = qtrue;
-				//so we know to free this memory in case we have to return early. Don't want any leaks.
-
-				if (!anim_set)
-				{
-					assert(!"Anim set alloc failed!");
-					return -1;
-				}
-			}
-			else
-			{
-				anim_set = BG_AnimsetAlloc();
-				dyn_alloc = qtrue;
-				//so we know to free this memory in case we have to return early. Don't want any leaks.
-
-				if (!anim_set)
-				{
-					assert(!"Anim set alloc failed!");
-					return -1;
-				}
-			}
-		}
-	}
-#ifdef _DEBUG
-	else
-	{
-		assert(anim_set);
-	}
-#endif
-
-	// load the file
-	if (!bgpa_ftext_loaded || !is_humanoid)
-	{
-		//rww - We are always using the same animation config now. So only load it once.
-		const int len = trap->FS_Open(filename, &f, FS_READ);
-		if (len <= 0 || len >= sizeof bgpa_ftext - 1)
-		{
-			trap->FS_Close(f);
-			if (dyn_alloc)
-			{
-				BG_AnimsetFree();
-			}
-			if (len > 0)
-			{
-				Com_Error(ERR_DROP, "%s exceeds the allowed game-side animation buffer!", filename);
-			}
-			return -1;
-		}
-
-		trap->FS_Read(bgpa_ftext, len, f);
-
-		bgpa_ftext[len] = 0;
-		trap->FS_Close(f);
-	}
-	else
-	{
-		if (dyn_alloc)
-		{
-			assert(!"Should not have allocated dynamically for humanoid");
-			BG_AnimsetFree();
-		}
-		return 0; //humanoid index
-	}
-
-	// parse the text
-	text_p = bgpa_ftext;
 
 	//initialize anim array so that from 0 to MAX_ANIMATIONS, set default values of 0 1 0 100
 	for (i = 0; i < MAX_ANIMATIONS; i++)
@@ -5929,6 +5814,130 @@ int bg_parse_animation_file(const char* filename, animation_t* anim_set, const q
 			}
 		}
 	}
+}
+
+static animation_t bgAnimParseScratch[MAX_TOTALANIMATIONS];
+
+/*
+======================
+BG_ParseAnimationFile
+
+Read a configuration file containing animation counts and rates
+models/players/visor/animation.cfg, etc
+
+======================
+*/
+int bg_parse_animation_file(const char* filename, animation_t* anim_set, const qboolean is_humanoid)
+{
+	int i;
+	int used_index;
+	int next_index = bgNumAllAnims;
+	qboolean dyn_alloc = qfalse;
+	static char bgpa_ftext[120000];
+	char shared_name[MAX_QPATH + 16];
+	fileHandle_t f;
+
+	bgpa_ftext[0] = '\0';
+
+	if (!is_humanoid)
+	{
+		i = 0;
+		while (i < bgNumAllAnims)
+		{
+			//see if it's been loaded already
+			if (!Q_stricmp(bgAllAnims[i].filename, filename))
+			{
+				bgAllAnims[i].anims;
+				return i; //alright, we already have it.
+			}
+			i++;
+		}
+
+		//Looks like it has not yet been loaded. Work out where the anim set goes, and continue along.
+		if (!anim_set)
+		{
+			if (strstr(filename, "players/_humanoid/"))
+			{
+				//then use the static humanoid set.
+				anim_set = bgHumanoidAnimations;
+				next_index = 0;
+			}
+			else if (strstr(filename, "players/rockettrooper/"))
+			{
+				//rockettrooper always index 1
+				next_index = 1;
+				dyn_alloc = qtrue;
+				//it gets its memory once we know whether the engine already has it parsed
+			}
+			else
+			{
+				dyn_alloc = qtrue;
+			}
+		}
+	}
+#ifdef _DEBUG
+	else
+	{
+		assert(anim_set);
+	}
+#endif
+
+	if (bgpa_ftext_loaded && is_humanoid)
+	{
+		//rww - We are always using the same animation config now. So only load it once.
+		return 0; //humanoid index
+	}
+
+	//game and cgame parse the same files, so whichever gets here first leaves the result with the engine for the
+	//other one, and for both of them after a map restart
+	Com_sprintf(shared_name, sizeof shared_name, "anims:%s", filename);
+	const animation_t* shared = BG_AcquireSharedData(shared_name, sizeof(animation_t) * MAX_TOTALANIMATIONS);
+
+	if (!shared)
+	{
+		// load the file
+		const int len = trap->FS_Open(filename, &f, FS_READ);
+		if (len <= 0 || len >= sizeof bgpa_ftext - 1)
+		{
+			trap->FS_Close(f);
+			if (len > 0)
+			{
+				Com_Error(ERR_DROP, "%s exceeds the allowed game-side animation buffer!", filename);
+			}
+			return -1;
+		}
+
+		trap->FS_Read(bgpa_ftext, len, f);
+
+		bgpa_ftext[len] = 0;
+		trap->FS_Close(f);
+
+		// parse the text
+		BG_ParseAnimationText(filename, bgpa_ftext, dyn_alloc ? bgAnimParseScratch : anim_set);
+		shared = BG_StoreSharedData(shared_name, dyn_alloc ? bgAnimParseScratch : anim_set,
+			sizeof(animation_t) * MAX_TOTALANIMATIONS);
+
+		if (dyn_alloc && !shared)
+		{
+			anim_set = BG_AnimsetAlloc();
+			if (!anim_set)
+			{
+				assert(!"Anim set alloc failed!");
+				return -1;
+			}
+			memcpy(anim_set, bgAnimParseScratch, sizeof(animation_t) * MAX_TOTALANIMATIONS);
+		}
+	}
+	else if (!dyn_alloc)
+	{
+		memcpy(anim_set, shared, sizeof(animation_t) * MAX_TOTALANIMATIONS);
+	}
+
+	if (dyn_alloc && shared)
+	{
+		//read-only, nothing writes to a loaded anim set
+		anim_set = (animation_t*)shared;
+	}
 
 #ifdef CONVENIENT_ANIMATION_FILE_DEBUG_THING
 	SpewDebugStuffToFile();
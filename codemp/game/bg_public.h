@@ -2060,8 +2060,36 @@ void BG_TempFree(int size);
 char* BG_StringAlloc(const char* source);
 qboolean BG_OutOfMemory();
 
+#if defined(_GAME) || defined(_CGAME)
+const void* BG_AcquireSharedData(const char* name, size_t size);
+const void* BG_StoreSharedData(const char* name, const void* data, size_t size);
+void BG_ReleaseSharedData(void);
+#endif
+
 qboolean BG_IsWhiteSpace(char c);
 
+// name index over a buffer of "name { ... }" definitions (.sab, .npc)
+typedef struct bgDefIndexEntry_s
+{
+	int hash;
+	int nameOfs; // where the parse for the name starts
+	int bodyOfs; // just past the name, where the "{" is expected
+} bgDefIndexEntry_t;
+
+typedef struct bgDefIndex_s
+{
+	const char* buffer;
+	bgDefIndexEntry_t* entries;
+	int numEntries;
+	int maxEntries;
+	int overflowOfs; // -1, or where the names that didn't fit start
+} bgDefIndex_t;
+
+void BG_BuildDefIndex(bgDefIndex_t* index, const char* buffer, bgDefIndexEntry_t* entries, int maxEntries);
+const char* BG_FindDef(const bgDefIndex_t* index, const char* name);
+const char* BG_FindDefLinear(const char* buffer, const char* name);
+qboolean BG_DefName(const bgDefIndex_t* index, int num, char* name, int nameSize);
+
 void BG_BLADE_ActivateTrail(bladeInfo_t* blade, float duration);
 void BG_BLADE_DeactivateTrail(bladeInfo_t* blade, float duration);
 void BG_SI_Activate(saberInfo_t* saber);
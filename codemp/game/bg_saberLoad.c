@@ -61,7 +61,12 @@ static int BG_SoundIndex(const char* sound)
 extern stringID_table_t FPTable[];
 
 #define MAX_SABER_DATA_SIZE (1024*1024*16) // 16mb, was 512kb
-static char saberParms[MAX_SABER_DATA_SIZE];
+static char saberParmsBuffer[MAX_SABER_DATA_SIZE];
+static const char* saberParms = saberParmsBuffer;
+
+#define MAX_SABER_DEFS 16384
+static bgDefIndexEntry_t saberDefEntries[MAX_SABER_DEFS];
+bgDefIndex_t saberDefIndex;
 
 stringID_table_t saberTable[] =
 {
@@ -381,6 +386,165 @@ static qboolean BG_ParseLiteralSilent(const char** data, const char* string)
 	return qfalse;
 }
 
+/*
+===============
+Definition index
+
+The .sab and .npc files are each loaded into one big buffer of
+"name { ... }" blocks. Finding a definition used to mean tokenizing that
+buffer from the top on every spawn or saber change. Instead the buffer is
+walked once after loading and every top level name is recorded with its
+offset, sorted by hash, so a lookup is a binary search plus one token
+compare. Duplicate names resolve to the first one in the buffer as before.
+
+Also used in npc code
+===============
+*/
+
+static int BG_DefHash(const char* name)
+{
+	unsigned int hash = 2166136261u;
+
+	for (; *name; name++)
+	{
+		hash = (hash ^ (unsigned char)tolower(*name)) * 16777619u;
+	}
+
+	return (int)hash;
+}
+
+static int BG_DefIndexCompare(const void* a, const void* b)
+{
+	const bgDefIndexEntry_t* ea = (const bgDefIndexEntry_t*)a;
+	const bgDefIndexEntry_t* eb = (const bgDefIndexEntry_t*)b;
+
+	if (ea->hash != eb->hash)
+	{
+		return ea->hash < eb->hash ? -1 : 1;
+	}
+
+	return ea->nameOfs - eb->nameOfs;
+}
+
+void BG_BuildDefIndex(bgDefIndex_t* index, const char* buffer, bgDefIndexEntry_t* entries, const int maxEntries)
+{
+	const char* p = buffer;
+
+	index->buffer = buffer;
+	index->entries = entries;
+	index->numEntries = 0;
+	index->maxEntries = maxEntries;
+	index->overflowOfs = -1;
+
+	COM_BeginParseSession("BG_BuildDefIndex");
+
+	// same walk the lookups used to do, name then braced section
+	while (p)
+	{
+		const char* start = p;
+		const char* token = COM_ParseExt(&p, qtrue);
+
+		if (!token[0])
+		{
+			break;
+		}
+
+		if (index->numEntries == index->maxEntries)
+		{
+			// the rest gets the old linear scan
+			Com_Printf(S_COLOR_YELLOW"WARNING: BG_BuildDefIndex: more than %d definitions, indexing stopped at '%s'\n",
+				maxEntries, token);
+			index->overflowOfs = start - buffer;
+			break;
+		}
+
+		bgDefIndexEntry_t* entry = &index->entries[index->numEntries++];
+		entry->hash = BG_DefHash(token);
+		entry->nameOfs = start - buffer;
+		entry->bodyOfs = p - buffer;
+
+		SkipBracedSection(&p, 0);
+	}
+
+	qsort(index->entries, index->numEntries, sizeof index->entries[0], BG_DefIndexCompare);
+}
+
+// returns the text just past the definition's name, or NULL
+const char* BG_FindDefLinear(const char* buffer, const char* name)
+{
+	const char* p = buffer;
+
+	while (p)
+	{
+		const char* token = COM_ParseExt(&p, qtrue);
+		if (!token[0])
+		{
+			return NULL;
+		}
+
+		if (!Q_stricmp(token, name))
+		{
+			return p;
+		}
+
+		SkipBracedSection(&p, 0);
+	}
+
+	return NULL;
+}
+
+const char* BG_FindDef(const bgDefIndex_t* index, const char* name)
+{
+	const int hash = BG_DefHash(name);
+	int lo = 0;
+	int hi = index->numEntries;
+
+	// first entry with this hash
+	while (lo < hi)
+	{
+		const int mid = lo + (hi - lo) / 2;
+
+		if (index->entries[mid].hash < hash)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	for (; lo < index->numEntries && index->entries[lo].hash == hash; lo++)
+	{
+		const char* p = index->buffer + index->entries[lo].nameOfs;
+
+		if (!Q_stricmp(COM_ParseExt(&p, qtrue), name))
+		{
+			return index->buffer + index->entries[lo].bodyOfs;
+		}
+	}
+
+	if (index->overflowOfs >= 0)
+	{
+		return BG_FindDefLinear(index->buffer + index->overflowOfs, name);
+	}
+
+	return NULL;
+}
+
+// name of the num'th definition in hash order, for walking all of them
+qboolean BG_DefName(const bgDefIndex_t* index, const int num, char* name, const int nameSize)
+{
+	if (num < 0 || num >= index->numEntries)
+	{
+		return qfalse;
+	}
+
+	const char* p = index->buffer + index->entries[num].nameOfs;
+	Q_strncpyz(name, COM_ParseExt(&p, qtrue), nameSize);
+	return qtrue;
+}
+
 saber_colors_t TranslateSaberColor(const char* name)
 {
 	if (!Q_stricmp(name, "red"))
@@ -2855,31 +3019,15 @@ qboolean WP_SaberParseParms(const char* saberName, saberInfo_t* saber)
 		Q_strncpyz(useSaber, saberName, sizeof useSaber);
 
 	//try to parse it out
-	p = saberParms;
 	COM_BeginParseSession("saberinfo");
 
 	// look for the right saber
-	while (p)
+	p = BG_FindDef(&saberDefIndex, useSaber);
+	if (!p && !triedDefault)
 	{
-		token = COM_ParseExt(&p, qtrue);
-		if (!token[0])
-		{
-			if (!triedDefault)
-			{
-				// fall back to default and restart, should always be there
-				p = saberParms;
-				COM_BeginParseSession("saberinfo");
-				Q_strncpyz(useSaber, DEFAULT_SABER, sizeof useSaber);
-				triedDefault = qtrue;
-			}
-			else
-				return qfalse;
-		}
-
-		if (!Q_stricmp(token, useSaber))
-			break;
-
-		SkipBracedSection(&p, 0);
+		// fall back to default, should always be there
+		Q_strncpyz(useSaber, DEFAULT_SABER, sizeof useSaber);
+		p = BG_FindDef(&saberDefIndex, useSaber);
 	}
 
 	// even the default saber isn't found?
@@ -2933,25 +3081,10 @@ qboolean WP_SaberParseParm(const char* saberName, const char* parmname, char* sa
 	}
 
 	//try to parse it out
-	p = saberParms;
 	COM_BeginParseSession("saberinfo");
 
 	// look for the right saber
-	while (p)
-	{
-		token = COM_ParseExt(&p, qtrue);
-		if (token[0] == 0)
-		{
-			return qfalse;
-		}
-
-		if (!Q_stricmp(token, saberName))
-		{
-			break;
-		}
-
-		SkipBracedSection(&p, 0);
-	}
+	p = BG_FindDef(&saberDefIndex, saberName);
 	if (!p)
 	{
 		return qfalse;
@@ -3086,9 +3219,20 @@ void WP_SaberLoadParms()
 
 	int len = 0;
 
+#if defined(_GAME) || defined(_CGAME)
+	//the other module may have read them all in already
+	saberParms = BG_AcquireSharedData("ext_data/sabers/*.sab", 0);
+	if (saberParms)
+	{
+		BG_BuildDefIndex(&saberDefIndex, saberParms, saberDefEntries, MAX_SABER_DEFS);
+		return;
+	}
+#endif
+	saberParms = saberParmsBuffer;
+
 	//remember where to store the next one
 	int totallen = len;
-	char* marker = saberParms + totallen;
+	char* marker = saberParmsBuffer + totallen;
 	*marker = 0;
 
 	//now load in the extra .sab extensions
@@ -3136,8 +3280,14 @@ void WP_SaberLoadParms()
 		len++;
 
 		totallen += len;
-		marker = saberParms + totallen;
+		marker = saberParmsBuffer + totallen;
 	}
+
+#if defined(_GAME) || defined(_CGAME)
+	BG_StoreSharedData("ext_data/sabers/*.sab", saberParmsBuffer, strlen(saberParmsBuffer) + 1);
+#endif
+
+	BG_BuildDefIndex(&saberDefIndex, saberParms, saberDefEntries, MAX_SABER_DEFS);
 }
 
 #ifdef UI_BUILD
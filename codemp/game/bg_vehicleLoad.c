@@ -42,14 +42,20 @@ extern stringID_table_t animTable[MAX_ANIMATIONS + 1];
 #define MAX_VEH_WEAPON_DATA_SIZE 0x40000
 #define MAX_VEHICLE_DATA_SIZE 0x100000
 
-char VehWeaponParms[MAX_VEH_WEAPON_DATA_SIZE];
-char VehicleParms[MAX_VEHICLE_DATA_SIZE];
+static char vehWeaponParmsBuffer[MAX_VEH_WEAPON_DATA_SIZE];
+static char vehicleParmsBuffer[MAX_VEHICLE_DATA_SIZE];
+
+// the buffers above, or the copies game and cgame share when those were already loaded
+const char* VehWeaponParms = vehWeaponParmsBuffer;
+const char* VehicleParms = vehicleParmsBuffer;
 
 void BG_ClearVehicleParseParms(void)
 {
 	//You can't strcat to these forever without clearing them!
-	VehWeaponParms[0] = 0;
-	VehicleParms[0] = 0;
+	vehWeaponParmsBuffer[0] = 0;
+	vehicleParmsBuffer[0] = 0;
+	VehWeaponParms = vehWeaponParmsBuffer;
+	VehicleParms = vehicleParmsBuffer;
 }
 
 #if defined(_GAME) || defined(_CGAME)
@@ -1251,9 +1257,19 @@ static void BG_VehWeaponLoadParms(void)
 
 	int len = 0;
 
+#if defined(_GAME) || defined(_CGAME)
+	//the other module may have read them all in already
+	VehWeaponParms = BG_AcquireSharedData("ext_data/vehicles/weapons/*.vwp", 0);
+	if (VehWeaponParms)
+	{
+		return;
+	}
+#endif
+	VehWeaponParms = vehWeaponParmsBuffer;
+
 	//remember where to store the next one
 	int totallen = len;
-	char* marker = VehWeaponParms + totallen;
+	char* marker = vehWeaponParmsBuffer + totallen;
 	*marker = 0;
 
 	//now load in the extra .veh extensions
@@ -1299,25 +1315,38 @@ static void BG_VehWeaponLoadParms(void)
 			trap->FS_Close(f);
 
 			totallen += len;
-			marker = VehWeaponParms + totallen;
+			marker = vehWeaponParmsBuffer + totallen;
 		}
 	}
 
 	BG_TempFree(MAX_VEH_WEAPON_DATA_SIZE);
+
+#if defined(_GAME) || defined(_CGAME)
+	BG_StoreSharedData("ext_data/vehicles/weapons/*.vwp", vehWeaponParmsBuffer, strlen(vehWeaponParmsBuffer) + 1);
+#endif
 }
 
-void BG_VehicleLoadParms(void)
+static void BG_VehicleReadParms(void)
 {
-	//HMM... only do this if there's a vehicle on the level?
 	int vehExtFNLen;
 	char vehExtensionListBuf[2048]; //	The list of file names read in
 	fileHandle_t f;
 
 	int len = 0;
 
+#if defined(_GAME) || defined(_CGAME)
+	//the other module may have read them all in already
+	VehicleParms = BG_AcquireSharedData("ext_data/vehicles/*.veh", 0);
+	if (VehicleParms)
+	{
+		return;
+	}
+#endif
+	VehicleParms = vehicleParmsBuffer;
+
 	//remember where to store the next one
 	int totallen = len;
-	char* marker = VehicleParms + totallen;
+	char* marker = vehicleParmsBuffer + totallen;
 	*marker = 0;
 
 	//now load in the extra .veh extensions
@@ -1363,12 +1392,22 @@ void BG_VehicleLoadParms(void)
 			trap->FS_Close(f);
 
 			totallen += len;
-			marker = VehicleParms + totallen;
+			marker = vehicleParmsBuffer + totallen;
 		}
 	}
 
 	BG_TempFree(MAX_VEHICLE_DATA_SIZE);
 
+#if defined(_GAME) || defined(_CGAME)
+	BG_StoreSharedData("ext_data/vehicles/*.veh", vehicleParmsBuffer, strlen(vehicleParmsBuffer) + 1);
+#endif
+}
+
+void BG_VehicleLoadParms(void)
+{
+	//HMM... only do this if there's a vehicle on the level?
+	BG_VehicleReadParms();
+
 	numVehicles = 1; //first one is null/default
 	//set the first vehicle to default data
 	BG_VehicleSetDefaults(&g_vehicleInfo[VEHICLE_BASE]);
@@ -1800,6 +1800,28 @@ extern qboolean G_ClearLOS3(gentity_t* self, const vec3_t start, const gentity_t
 extern qboolean G_ClearLOS4(gentity_t* self, gentity_t* ent);
 extern qboolean G_ClearLOS5(gentity_t* self, const vec3_t end);
 
+typedef struct npcSenseStats_s
+{
+	int sensed; // NPCs run through the sense phase
+	int hits; // act phase checks answered from the sense phase
+} npcSenseStats_t;
+
+extern npcSenseStats_t npcSenseStats;
+extern void NPC_SenseFrame(void);
+
+typedef struct npcBench_s
+{
+	int framesLeft;
+	int frames;
+	int npcs;
+	int totalMsec;
+	int senseMsec;
+	int maxMsec;
+} npcBench_t;
+
+extern npcBench_t npcBench;
+extern void NPC_BenchFrame(int frameMsec, int senseMsec);
+
 //
 // g_bot.c
 //
@@ -1615,6 +1615,7 @@ void G_ShutdownGame(const int restart)
 	G_CleanAllFakeClients(); //get rid of dynamically allocated fake client structs.
 
 	BG_ClearAnimsets(); //free all dynamic allocations made through the engine
+	BG_ReleaseSharedData(); //and let go of the parsed files shared with the other module
 
 	//	Com_Printf("... Gameside GHOUL2 Cleanup\n");
 	while (i < MAX_GENTITIES)
@@ -4320,6 +4321,8 @@ void G_RunFrame(const int levelTime)
 {
 	int i = 0;
 	gentity_t* ent;
+	const int benchStart = npcBench.framesLeft ? trap->Milliseconds() : 0;
+	int senseMsec = 0;
 #ifdef _G_FRAME_PERFANAL
 	int			iTimer_ItemRun = 0;
 	int			iTimer_ROFF = 0;
@@ -4491,6 +4494,19 @@ void G_RunFrame(const int levelTime)
 	// get any cvar changes
 	G_UpdateCvars();
 
+	// NPC sense phase, everyone looks before anyone acts
+	if (npcBench.framesLeft)
+	{
+		const int senseStart = trap->Milliseconds();
+
+		NPC_SenseFrame();
+		senseMsec = trap->Milliseconds() - senseStart;
+	}
+	else
+	{
+		NPC_SenseFrame();
+	}
+
 #ifdef _G_FRAME_PERFANAL
 	trap->PrecisionTimer_Start(&timer_ItemRun);
 #endif
@@ -5061,6 +5077,11 @@ void G_RunFrame(const int levelTime)
 		iTimer_Queues);
 #endif
 
+	if (npcBench.framesLeft)
+	{
+		NPC_BenchFrame(trap->Milliseconds() - benchStart, senseMsec);
+	}
+
 	g_LastFrameTime = level.time;
 }
 
@@ -27,7 +27,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "qcommon/q_shared.h"
 
-#define	GAME_API_VERSION	1
+#define	GAME_API_VERSION	2
 
 // entity->svFlags
 // the server does not know how to interpret most of the values
@@ -1122,6 +1122,11 @@ typedef struct gameImport_s {
 	void		(*G2API_CleanEntAttachments)			();
 	qboolean(*G2API_OverrideServer)					(void* serverInstance);
 	void		(*G2API_GetSurfaceName)					(void* ghoul2, int surfNumber, int modelIndex, char* fillBuf);
+
+	// parsed files shared with cgame, see BG_AcquireSharedData
+	const void* (*SharedData_Acquire)					(const char* name, size_t* size);
+	const void* (*SharedData_Store)						(const char* name, const void* data, size_t size);
+	void		(*SharedData_Release)					(const void* data);
 } gameImport_t;
 
 typedef struct gameExport_s {
@@ -115,6 +115,7 @@ XCVAR_DEF(g_maxHolocronCarry, "3", NULL, CVAR_LATCH, qfalse)
 XCVAR_DEF(g_motd, "", NULL, CVAR_NONE, qfalse)
 XCVAR_DEF(g_needpass, "0", NULL, CVAR_SERVERINFO | CVAR_ROM, qfalse)
 XCVAR_DEF(g_noSpecMove, "0", NULL, CVAR_SERVERINFO, qtrue)
+XCVAR_DEF(g_npcSense, "1", NULL, CVAR_NONE, qfalse)
 XCVAR_DEF(g_npcspskill, "5", NULL, CVAR_ARCHIVE | CVAR_INTERNAL, qfalse)
 XCVAR_DEF(g_password, "", NULL, CVAR_NONE, qfalse)
 XCVAR_DEF(g_powerDuelEndHealth, "90", NULL, CVAR_ARCHIVE, qtrue)
@@ -125,6 +125,7 @@ public:
 			{
 				Array()[i].mBoneCache = nullptr;
 				Array()[i].mTransformedVertsArray = nullptr;
+				Array()[i].mFlags &= ~GHOUL2_ZONETRANSALLOC; // the vert array belongs to the source
 				Array()[i].mSkelFrameNum = 0;
 				Array()[i].mMeshFrameNum = 0;
 			}
@@ -28,6 +28,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "icarus.h"
 
 #include <cstring>
+#include <map>
 #include "blockstream.h"
 
 /*
@@ -43,6 +44,7 @@ CBlockMember::CBlockMember(void)
 	m_id = -1;
 	m_size = -1;
 	m_data = nullptr;
+	m_shared = false;
 }
 
 CBlockMember::~CBlockMember(void)
@@ -60,8 +62,12 @@ void CBlockMember::Free(void)
 {
 	if (m_data != nullptr)
 	{
-		ICARUS_Free(m_data);
+		if (!m_shared)
+		{
+			ICARUS_Free(m_data);
+		}
 		m_data = nullptr;
+		m_shared = false;
 
 		m_id = m_size = -1;
 	}
@@ -98,14 +104,32 @@ void CBlockMember::SetData(vector_t data)
 
 void CBlockMember::SetData(const void* data, const int size)
 {
-	if (m_data)
+	if (m_data && !m_shared)
 		ICARUS_Free(m_data);
 
 	m_data = ICARUS_Malloc(size);
+	m_shared = false;
 	memcpy(m_data, data, size);
 	m_size = size;
 }
 
+/*
+-------------------------
+SetSharedData
+-------------------------
+*/
+
+void CBlockMember::SetSharedData(const int id, const int size, const void* data)
+{
+	if (m_data && !m_shared)
+		ICARUS_Free(m_data);
+
+	m_id = id;
+	m_size = size;
+	m_data = const_cast<void*>(data);
+	m_shared = true;
+}
+
 //	Member I/O functions
 
 /*
@@ -173,6 +197,12 @@ CBlockMember* CBlockMember::Duplicate(void) const
 	if (newblock == nullptr)
 		return nullptr;
 
+	if (m_shared)
+	{
+		newblock->SetSharedData(m_id, m_size, m_data);
+		return newblock;
+	}
+
 	newblock->SetData(m_data, m_size);
 	newblock->SetSize(m_size);
 	newblock->SetID(m_id);
@@ -399,10 +429,144 @@ CBlock* CBlock::Duplicate(void)
 ===================================================================================================
 */
 
+// Scripts are decoded the first time a stream is opened on them and kept until shutdown, keyed
+// by their buffer, which the game keeps cached for the whole level. Blocks read from the stream
+// point their members at the decoded data instead of each making a copy.
+static std::map<const char*, CBlockScript*> blockScripts;
+
+/*
+-------------------------
+FlushScripts
+
+Must be called before the script buffers are freed
+-------------------------
+*/
+
+void CBlockStream::FlushScripts(void)
+{
+	for (const auto& bs : blockScripts)
+	{
+		delete bs.second;
+	}
+
+	blockScripts.clear();
+}
+
+/*
+-------------------------
+ScriptInfo
+-------------------------
+*/
+
+void CBlockStream::ScriptInfo(void)
+{
+	size_t blocks = 0, members = 0, bytes = 0;
+
+	for (const auto& bs : blockScripts)
+	{
+		blocks += bs.second->m_blocks.size();
+		members += bs.second->m_members.size();
+		bytes += bs.second->m_data.size() * sizeof(int);
+	}
+
+	Com_Printf("%i decoded scripts: %i blocks, %i members, %i bytes of member data\n",
+		static_cast<int>(blockScripts.size()), static_cast<int>(blocks), static_cast<int>(members), static_cast<int>(bytes));
+}
+
+/*
+-------------------------
+Decode
+
+Reads every block from the current position to the end of the stream,
+returns NULL if the stream runs out partway through one
+-------------------------
+*/
+
+CBlockScript* CBlockStream::Decode(void)
+{
+	const auto script = new CBlockScript;
+	script->m_bufferSize = m_fileSize;
+
+	while (m_streamPos < m_fileSize)
+	{
+		CBlockScript::block_t block;
+
+		if (m_fileSize - m_streamPos < static_cast<long>(sizeof(int) * 2 + 1))
+			break;
+
+		block.id = GetInteger();
+		block.numMembers = GetInteger();
+		block.flags = static_cast<unsigned char>(GetChar());
+		block.firstMember = static_cast<int>(script->m_members.size());
+
+		if (block.numMembers < 0)
+			break;
+
+		int i;
+		for (i = 0; i < block.numMembers; i++)
+		{
+			CBlockScript::member_t member;
+
+			if (m_fileSize - m_streamPos < static_cast<long>(sizeof(int) * 2))
+				break;
+
+			member.id = LittleLong(GetInteger());
+			member.size = LittleLong(GetInteger());
+
+			if (member.id == ID_RANDOM)
+			{
+				//special case, need to initialize this member's data to Q3_INFINITE so we can randomize the number only the first time random is checked when inside a wait
+				member.size = sizeof(float);
+			}
+
+			if (member.size < 0 || member.size > m_fileSize - m_streamPos)
+				break;
+
+			member.offset = static_cast<int>(script->m_data.size());
+			script->m_data.resize(script->m_data.size() + (member.size + sizeof(int) - 1) / sizeof(int));
+
+			const auto data = script->m_data.data() + member.offset;
+
+			if (member.id == ID_RANDOM)
+			{
+				constexpr float infinite = Q3_INFINITE;
+				memcpy(data, &infinite, member.size);
+			}
+			else
+			{
+				memcpy(data, m_stream + m_streamPos, member.size);
+#ifdef Q3_BIG_ENDIAN
+				// only TK_INT, TK_VECTOR and TK_FLOAT has to be swapped, but just in case
+				if (member.size == 4 && member.id != TK_STRING && member.id != TK_IDENTIFIER && member.id != TK_CHAR)
+					*data = LittleLong(*data);
+#endif
+			}
+			m_streamPos += member.size;
+
+			script->m_members.push_back(member);
+		}
+
+		if (i < block.numMembers)
+			break;
+
+		script->m_blocks.push_back(block);
+	}
+
+	if (m_streamPos < m_fileSize)
+	{
+		delete script;
+		return nullptr;
+	}
+
+	return script;
+}
+
 CBlockStream::CBlockStream(void) : m_fileSize(0), m_fileHandle(nullptr), m_fileName{}
 {
 	m_stream = nullptr;
 	m_streamPos = 0;
+	m_script = nullptr;
+	m_blockNum = 0;
 }
 
 CBlockStream::~CBlockStream(void)
@@ -491,6 +655,8 @@ int CBlockStream::Free(void)
 
 	m_stream = nullptr;
 	m_streamPos = 0;
+	m_script = nullptr;
+	m_blockNum = 0;
 
 	return true;
 }
@@ -534,6 +700,8 @@ int CBlockStream::Init(void)
 
 	m_stream = nullptr;
 	m_streamPos = 0;
+	m_script = nullptr;
+	m_blockNum = 0;
 
 	return true;
 }
@@ -575,6 +743,9 @@ BlockAvailable
 
 int CBlockStream::BlockAvailable(void) const
 {
+	if (m_script)
+		return m_blockNum < static_cast<int>(m_script->m_blocks.size());
+
 	if (m_streamPos >= m_fileSize)
 		return false;
 
@@ -592,6 +763,25 @@ int CBlockStream::ReadBlock(CBlock* get)
 	if (!BlockAvailable())
 		return false;
 
+	if (m_script)
+	{
+		const CBlockScript::block_t& block = m_script->m_blocks[m_blockNum++];
+
+		get->Create(block.id);
+		get->SetFlags(block.flags);
+
+		for (int i = 0; i < block.numMembers; i++)
+		{
+			const CBlockScript::member_t& member = m_script->m_members[block.firstMember + i];
+
+			const auto bMember = new CBlockMember;
+			bMember->SetSharedData(member.id, member.size, m_script->m_data.data() + member.offset);
+			get->AddMember(bMember);
+		}
+
+		return true;
+	}
+
 	const int b_id = GetInteger();
 	int numMembers = GetInteger();
 	const unsigned char flags = static_cast<unsigned char>(GetChar());
@@ -652,5 +842,29 @@ int CBlockStream::Open(char* buffer, const long size)
 		return false;
 	}
 
+	//Decode it the first time it's run, and share that from then on
+	CBlockScript*& script = blockScripts[buffer];
+
+	if (script && script->m_bufferSize != size)
+	{
+		delete script;
+		script = nullptr;
+	}
+
+	if (script == nullptr)
+	{
+		script = Decode();
+
+		if (script == nullptr)
+		{
+			blockScripts.erase(buffer);
+			Free();
+			return false;
+		}
+	}
+
+	m_script = script;
+	m_blockNum = 0;
+
 	return true;
 }
\ No newline at end of file
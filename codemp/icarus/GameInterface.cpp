@@ -199,7 +199,9 @@ void ICARUS_Shutdown(void)
 		}
 	}
 
-	//Clear out all precached scripts
+	//Clear out all precached scripts, and everything decoded from them
+	CBlockStream::FlushScripts();
+
 	for (auto ei = ICARUS_BufferList.begin(); ei != ICARUS_BufferList.end(); ++ei)
 	{
 		//gi.Free( (*ei).second->buffer );
@@ -218,6 +220,8 @@ void ICARUS_Shutdown(void)
 		iICARUS->Delete();
 		iICARUS = nullptr;
 	}
+
+	ICARUS_ReleasePools();
 }
 
 /*
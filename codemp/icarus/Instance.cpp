@@ -43,6 +43,7 @@ CTaskManager* gTaskManagers[MAX_GENTITIES];
 ICARUS_Instance::ICARUS_Instance(void)
 {
 	m_GUID = 0;
+	m_signalCount = 0;
 
 	//to be safe
 	memset(gSequencers, 0, sizeof gSequencers);
@@ -626,6 +627,7 @@ Signal
 void ICARUS_Instance::Signal(const char* identifier)
 {
 	m_signals[identifier] = 1;
+	m_signalCount++;
 }
 
 /*
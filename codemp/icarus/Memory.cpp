@@ -22,12 +22,17 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "icarus.h"
 
+#include <vector>
+
+static int icarusMallocs, icarusFrees;
+
 // leave these two as standard mallocs for the moment, there's something weird happening in ICARUS...
 //
 void* ICARUS_Malloc(const int iSize)
 {
 	//return gi.Malloc(iSize, TAG_ICARUS);
 	//return malloc(iSize);
+	icarusMallocs++;
 	return Z_Malloc(iSize, TAG_ICARUS5, qfalse);
 }
 
@@ -35,5 +40,144 @@ void ICARUS_Free(void* pMem)
 {
 	//gi.Free(pMem);
 	//free(pMem);
+	icarusFrees++;
 	Z_Free(pMem);
-}
\ No newline at end of file
+}
+
+/*
+===================================================================================================
+
+  Pools
+
+  Block members, blocks, tasks and task groups are created and thrown away constantly while
+  scripts run, so they come out of fixed size free lists instead of the zone. Chunks are only
+  handed back to the zone at shutdown.
+
+===================================================================================================
+*/
+
+constexpr int ICARUS_POOL_CHUNK = 256;
+
+using icarusPool_t = struct icarusPool_s
+{
+	const char* name;
+	size_t objectSize;
+	void* freeList;
+	std::vector<void*> chunks;
+	int live;
+	int peak;
+	int allocs;
+};
+
+static icarusPool_t icarusPools[ICARUS_NUM_POOLS] =
+{
+	{ "block members" },
+	{ "blocks" },
+	{ "tasks" },
+	{ "task groups" },
+};
+
+/*
+-------------------------
+ICARUS_PoolAlloc
+-------------------------
+*/
+
+void* ICARUS_PoolAlloc(const int pool, const size_t size)
+{
+	icarusPool_t& p = icarusPools[pool];
+
+	if (!p.objectSize)
+	{
+		// room for the free list link, and keep everything pointer aligned
+		p.objectSize = (Q_max(size, sizeof(void*)) + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	}
+	assert(size <= p.objectSize);
+
+	if (!p.freeList)
+	{
+		const auto chunk = static_cast<char*>(Z_Malloc(p.objectSize * ICARUS_POOL_CHUNK, TAG_ICARUS4, qfalse));
+		p.chunks.push_back(chunk);
+
+		for (int i = ICARUS_POOL_CHUNK - 1; i >= 0; i--)
+		{
+			void* object = chunk + i * p.objectSize;
+			*static_cast<void**>(object) = p.freeList;
+			p.freeList = object;
+		}
+	}
+
+	void* object = p.freeList;
+	p.freeList = *static_cast<void**>(object);
+
+	p.allocs++;
+	if (++p.live > p.peak)
+	{
+		p.peak = p.live;
+	}
+
+	return object;
+}
+
+/*
+-------------------------
+ICARUS_PoolFree
+-------------------------
+*/
+
+void ICARUS_PoolFree(const int pool, void* pMem)
+{
+	if (pMem == nullptr)
+		return;
+
+	icarusPool_t& p = icarusPools[pool];
+
+	*static_cast<void**>(pMem) = p.freeList;
+	p.freeList = pMem;
+	p.live--;
+}
+
+/*
+-------------------------
+ICARUS_ReleasePools
+
+Gives the chunks of every pool with nothing left alive in it back to the zone
+-------------------------
+*/
+
+void ICARUS_ReleasePools(void)
+{
+	for (auto& p : icarusPools)
+	{
+		if (p.live)
+			continue;
+
+		for (const auto chunk : p.chunks)
+		{
+			Z_Free(chunk);
+		}
+
+		p.chunks.clear();
+		p.freeList = nullptr;
+	}
+}
+
+/*
+-------------------------
+ICARUS_MemInfo_f
+-------------------------
+*/
+
+void ICARUS_MemInfo_f(void)
+{
+	Com_Printf("%-14s %7s %7s %7s %10s\n", "pool", "live", "peak", "chunks", "allocs");
+
+	for (const auto& p : icarusPools)
+	{
+		Com_Printf("%-14s %7i %7i %7i %10i\n", p.name, p.live, p.peak, static_cast<int>(p.chunks.size()), p.allocs);
+	}
+
+	Com_Printf("zone: %i allocations, %i frees, %i outstanding\n", icarusMallocs, icarusFrees, icarusMallocs - icarusFrees);
+
+	CBlockStream::ScriptInfo();
+}
@@ -194,6 +194,8 @@ int CTaskManager::Init(CSequencer* owner)
 	m_GUID = 0;
 	m_resident = false;
 
+	Wake();
+
 	return TASK_OK;
 }
 
@@ -223,6 +225,8 @@ int CTaskManager::Free(void)
 	m_taskGroupNameMap.clear();
 	m_taskGroupIDMap.clear();
 
+	Wake();
+
 	return TASK_OK;
 }
 
@@ -257,6 +261,7 @@ CTaskGroup* CTaskManager::AddTaskGroup(const char* name)
 
 		//Clear it and just move on
 		group->Init();
+		Wake();
 
 		return group;
 	}
@@ -329,6 +334,11 @@ int CTaskManager::Update(void)
 	{
 		return TASK_FAILED;
 	}
+
+	//Nothing can have finished the wait we're parked on
+	if (Asleep())
+		return TASK_OK;
+
 	m_count = 0; //Needed for runaway init
 	m_resident = true;
 
@@ -339,6 +349,30 @@ int CTaskManager::Update(void)
 	return returnVal;
 }
 
+/*
+-------------------------
+Asleep
+-------------------------
+*/
+
+bool CTaskManager::Asleep(void) const
+{
+	switch (m_sleep)
+	{
+	case SLEEP_TIME:
+		return !(m_wakeAt < m_owner->GetInterface()->I_GetTime());
+
+	case SLEEP_GROUP:
+		return true;
+
+	case SLEEP_SIGNAL:
+		return m_sleepSignals == m_owner->GetOwner()->GetSignalCount();
+
+	default:
+		return false;
+	}
+}
+
 /*
 -------------------------
 IsRunning
@@ -844,6 +878,7 @@ int CTaskManager::SetCommand(CBlock* command, const int type)
 	}
 
 	PushTask(task, type);
+	Wake();
 
 	return TASK_OK;
 }
@@ -863,6 +898,8 @@ int CTaskManager::MarkTask(const int id, const int operation)
 	if (group == nullptr)
 		return TASK_FAILED;
 
+	Wake();
+
 	if (operation == TASK_START)
 	{
 		//Reset all the completion information
@@ -898,6 +935,8 @@ Completed
 
 int CTaskManager::Completed(const int id)
 {
+	Wake();
+
 	//Mark the task as completed
 	for (auto tgi = m_taskGroups.begin(); tgi != m_taskGroups.end(); ++tgi)
 	{
@@ -992,6 +1031,9 @@ CTask* CTaskManager::PopTask(const int flag)
 	if (m_tasks.empty())
 		return nullptr;
 
+	//Whatever we were waiting on is leaving the queue
+	Wake();
+
 	switch (flag)
 	{
 	case POP_FRONT:
@@ -1073,9 +1115,17 @@ int CTaskManager::Wait(CTask* task, bool& completed)
 		}
 
 		completed = group->Complete();
+
+		//Only Completed(), MarkTask() or a new command can change that
+		if (completed == false)
+			m_sleep = SLEEP_GROUP;
 	}
 	else //Otherwise it's a time completion wait
 	{
+		//Literal and already rolled random durations can't change while we wait,
+		//but a get() has to be looked at again every frame
+		bool fixedTime = true;
+
 		if (Check(ID_RANDOM, block, memberNum))
 		{
 			//get it random only the first time
@@ -1094,6 +1144,8 @@ int CTaskManager::Wait(CTask* task, bool& completed)
 		}
 		else
 		{
+			fixedTime = bm->GetID() == TK_FLOAT || bm->GetID() == TK_INT;
+
 			ICARUS_VALIDATE(GetFloat(m_ownerID, block, memberNum, dwtime));
 		}
 
@@ -1115,6 +1167,11 @@ int CTaskManager::Wait(CTask* task, bool& completed)
 				bm->SetData(&dwtime, sizeof dwtime);
 			}
 		}
+		else if (fixedTime)
+		{
+			m_sleep = SLEEP_TIME;
+			m_wakeAt = task->GetTimeStamp() + dwtime;
+		}
 	}
 
 	return TASK_OK;
@@ -1148,6 +1205,12 @@ int CTaskManager::WaitSignal(CTask* task, bool& completed)
 		completed = true;
 		m_owner->GetOwner()->ClearSignal(sVal);
 	}
+	else
+	{
+		//Only a newly raised signal can let us through
+		m_sleep = SLEEP_SIGNAL;
+		m_sleepSignals = m_owner->GetOwner()->GetSignalCount();
+	}
 
 	return TASK_OK;
 }
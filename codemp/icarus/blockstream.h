@@ -71,6 +71,9 @@ public:
 	void SetData(vector_t);
 	void SetData(const void* data, int size);
 
+	//Points the member at data it doesn't own, which must outlive it
+	void SetSharedData(int id, int size, const void* data);
+
 	int GetID(void) const { return m_id; } //Get ID member variables
 	void* GetData(void) const { return m_data; } //Get data member variable
 	int GetSize(void) const { return m_size; } //Get size member variable
@@ -78,14 +81,14 @@ public:
 	void* operator new(const size_t size)
 	{
 		// Allocate the memory.
-		return Z_Malloc(size, TAG_ICARUS4, qtrue);
+		return ICARUS_PoolAlloc(ICARUS_POOL_MEMBER, size);
 	}
 
 	// Overloaded delete operator.
 	void operator delete(void* pRawData)
 	{
 		// Free the Memory.
-		Z_Free(pRawData);
+		ICARUS_PoolFree(ICARUS_POOL_MEMBER, pRawData);
 	}
 
 	CBlockMember* Duplicate(void) const;
@@ -93,12 +96,13 @@ public:
 	template <class T>
 	void WriteData(T& data)
 	{
-		if (m_data)
+		if (m_data && !m_shared)
 		{
 			ICARUS_Free(m_data);
 		}
 
 		m_data = ICARUS_Malloc(sizeof(T));
+		m_shared = false;
 		*static_cast<T*>(m_data) = data;
 		m_size = sizeof(T);
 	}
@@ -106,12 +110,13 @@ public:
 	template <class T>
 	void WriteDataPointer(const T* data, const int num)
 	{
-		if (m_data)
+		if (m_data && !m_shared)
 		{
 			ICARUS_Free(m_data);
 		}
 
 		m_data = ICARUS_Malloc(num * sizeof(T));
+		m_shared = false;
 		memcpy(m_data, data, num * sizeof(T));
 		m_size = num * sizeof(T);
 	}
@@ -120,6 +125,7 @@ protected:
 	int m_id; //ID of the value contained in data
 	int m_size; //Size of the data member variable
 	void* m_data; //Data for this member
+	bool m_shared; //m_data belongs to a decoded script, not this member
 };
 
 //CBlock
@@ -154,6 +160,16 @@ public:
 
 	CBlock* Duplicate(void);
 
+	void* operator new(const size_t size)
+	{
+		return ICARUS_PoolAlloc(ICARUS_POOL_BLOCK, size);
+	}
+
+	void operator delete(void* pRawData)
+	{
+		ICARUS_PoolFree(ICARUS_POOL_BLOCK, pRawData);
+	}
+
 	int GetBlockID(void) const { return m_id; } //Get the ID for the block
 	int GetNumMembers(void) const { return static_cast<int>(m_members.size()); }
 	//Get the number of member in the block's list
@@ -170,6 +186,34 @@ protected:
 	unsigned char m_flags;
 };
 
+// CBlockScript
+
+// A script decoded once and kept until shutdown, shared by every stream opened on the same buffer
+
+class CBlockScript
+{
+public:
+	struct member_t
+	{
+		int id;
+		int size;
+		int offset; //into m_data
+	};
+
+	struct block_t
+	{
+		int id;
+		int numMembers;
+		int firstMember;
+		unsigned char flags;
+	};
+
+	std::vector<block_t> m_blocks;
+	std::vector<member_t> m_members;
+	std::vector<int> m_data; //member data, each padded out to a whole int
+	long m_bufferSize;
+};
+
 // CBlockStream
 
 class CBlockStream
@@ -178,6 +222,9 @@ public:
 	CBlockStream();
 	~CBlockStream();
 
+	static void FlushScripts(void);
+	static void ScriptInfo(void);
+
 	int Init(void);
 
 	int Create(const char*);
@@ -193,6 +240,7 @@ public:
 	int Open(char*, long); //Open a stream for reading / writing
 
 protected:
+	CBlockScript* Decode(void);
 	unsigned GetUnsignedInteger(void);
 	int GetInteger(void);
 
@@ -206,4 +254,7 @@ protected:
 
 	char* m_stream; //Stream of data to be parsed
 	int m_streamPos;
+
+	const CBlockScript* m_script; //Decoded blocks of m_stream
+	int m_blockNum;
 };
@@ -23,9 +23,25 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 // ICARUS Public Header File
+#include <cstddef>
+
 extern void* ICARUS_Malloc(int iSize);
 extern void ICARUS_Free(void* pMem);
 
+enum
+{
+	ICARUS_POOL_MEMBER,
+	ICARUS_POOL_BLOCK,
+	ICARUS_POOL_TASK,
+	ICARUS_POOL_TASKGROUP,
+	ICARUS_NUM_POOLS
+};
+
+extern void* ICARUS_PoolAlloc(int pool, size_t size);
+extern void ICARUS_PoolFree(int pool, void* pMem);
+extern void ICARUS_ReleasePools(void);
+extern void ICARUS_MemInfo_f(void);
+
 #include "game/g_public.h"
 #define STL_ITERATE( a, b )		for ( a = b.begin(); a != b.end(); ++a )
 #define STL_INSERT( a, b )		a.insert( a.end(), b );
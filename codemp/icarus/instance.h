@@ -59,6 +59,7 @@ public:
 	void Signal(const char* identifier);
 	bool CheckSignal(const char* identifier);
 	void ClearSignal(const char* identifier);
+	int GetSignalCount(void) const { return m_signalCount; } // bumped whenever a signal is raised
 
 protected:
 	virtual int SaveSignals(void);
@@ -82,6 +83,7 @@ protected:
 	sequencer_l m_sequencers;
 
 	signal_m m_signals;
+	int m_signalCount;
 
 #ifdef _DEBUG
 
@@ -71,6 +71,16 @@ public:
 	void SetBlock(CBlock* block) { m_block = block; }
 	void SetGUID(const int id) { m_id = id; }
 
+	void* operator new(const size_t size)
+	{
+		return ICARUS_PoolAlloc(ICARUS_POOL_TASK, size);
+	}
+
+	void operator delete(void* pRawData)
+	{
+		ICARUS_PoolFree(ICARUS_POOL_TASK, pRawData);
+	}
+
 protected:
 	int m_id;
 	unsigned int m_timeStamp;
@@ -101,6 +111,16 @@ public:
 	CTaskGroup* GetParent(void) const { return m_parent; }
 	int GetGUID(void) const { return m_GUID; }
 
+	void* operator new(const size_t size)
+	{
+		return ICARUS_PoolAlloc(ICARUS_POOL_TASKGROUP, size);
+	}
+
+	void operator delete(void* pRawData)
+	{
+		ICARUS_PoolFree(ICARUS_POOL_TASKGROUP, pRawData);
+	}
+
 	//protected:
 
 	taskCallback_m m_completedTasks;
@@ -181,6 +201,19 @@ protected:
 	int Wait(CTask* task, bool& completed);
 	int WaitSignal(CTask* task, bool& completed);
 
+	// A manager whose only pending task is an unfinished wait sleeps until
+	// something that can finish it happens, instead of re-running the wait
+	enum
+	{
+		SLEEP_NONE,
+		SLEEP_TIME, // until m_wakeAt has passed
+		SLEEP_GROUP, // until one of our tasks or task groups changes
+		SLEEP_SIGNAL, // until the instance raises another signal
+	};
+
+	bool Asleep(void) const;
+	void Wake(void) { m_sleep = SLEEP_NONE; }
+
 	int SaveCommand(CBlock* block) const;
 
 	// Variables
@@ -201,5 +234,9 @@ protected:
 
 	bool m_resident;
 
+	int m_sleep = SLEEP_NONE;
+	float m_wakeAt = 0.0f;
+	int m_sleepSignals = 0;
+
 	//CTask	*m_waitTask;		//Global pointer to the current task that is waiting for callback completion
 };
@@ -26,18 +26,20 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "qcommon/qcommon.h"
 
 #define MAX_TOKEN_SIZE	1024
-static char token[MAX_TOKEN_SIZE];
+#define GP_ARENA_BLOCK_SIZE	32768
+static char emptyToken[1];
 
+// Tokens are cut out of the text in place: whatever character ends one is overwritten with a NUL and the pointer
+// returned goes straight into the tree, so nothing gets copied. The character replaced is always one the next call
+// would have skipped anyway.
 static char* GetToken(char** text, const bool allowLineBreaks, const bool readUntilEOL = false)
 {
 	char* pointer = *text;
-	int length = 0;
 	int c;
 
-	token[0] = 0;
 	if (!pointer)
 	{
-		return token;
+		return emptyToken;
 	}
 
 	while (true)
@@ -53,7 +55,7 @@ static char* GetToken(char** text, const bool allowLineBreaks, const bool readUn
 			if (!c)
 			{
 				*text = nullptr;
-				return token;
+				return emptyToken;
 			}
 			if (c == '\n')
 			{
@@ -64,7 +66,7 @@ static char* GetToken(char** text, const bool allowLineBreaks, const bool readUn
 		if (foundLineBreak && !allowLineBreaks)
 		{
 			*text = pointer;
-			return token;
+			return emptyToken;
 		}
 
 		c = *pointer;
@@ -98,85 +100,131 @@ static char* GetToken(char** text, const bool allowLineBreaks, const bool readUn
 		}
 	}
 
+	char* start;
+	char* end;
+
 	if (c == '\"')
 	{
-		// handle a string
+		// handle a string, the closing quote becomes the terminator
 		pointer++;
-		while (true)
+		start = pointer;
+		while (*pointer && *pointer != '\"')
 		{
-			c = *pointer++;
-			if (c == '\"')
-			{
-				//				token[length++] = c;
-				break;
-			}
-			if (!c)
-			{
-				break;
-			}
-			if (length < MAX_TOKEN_SIZE)
-			{
-				token[length++] = c;
-			}
+			pointer++;
+		}
+		end = pointer;
+		if (*pointer)
+		{
+			pointer++;
 		}
 	}
 	else if (readUntilEOL)
 	{
 		// absorb all characters until EOL
-		while (c != '\n' && c != '\r')
+		start = pointer;
+		while (c && c != '\n' && c != '\r')
 		{
 			if (c == '/' && (*(pointer + 1) == '/' || *(pointer + 1) == '*'))
 			{
 				break;
 			}
-
-			if (length < MAX_TOKEN_SIZE)
-			{
-				token[length++] = c;
-			}
 			pointer++;
 			c = *pointer;
 		}
+		end = pointer;
+
 		// remove trailing white space
-		while (length && token[length - 1] < ' ')
+		while (end > start && end[-1] < ' ')
 		{
-			length--;
+			end--;
+		}
+
+		// stopped on a comment - get past it now, as its first character may be about to become the terminator
+		if (c == '/')
+		{
+			if (pointer[1] == '/')
+			{
+				while (*pointer && *pointer != '\n')
+				{
+					pointer++;
+				}
+			}
+			else
+			{
+				pointer += 2;
+				while (*pointer && (*pointer != '*' || pointer[1] != '/'))
+				{
+					pointer++;
+				}
+				if (*pointer)
+				{
+					pointer += 2;
+				}
+			}
 		}
 	}
 	else
 	{
+		start = pointer;
 		while (c > ' ')
 		{
-			if (length < MAX_TOKEN_SIZE)
-			{
-				token[length++] = c;
-			}
 			pointer++;
 			c = *pointer;
 		}
+		end = pointer;
 	}
 
-	if (token[0] == '\"')
+	if (end - start >= MAX_TOKEN_SIZE)
 	{
-		// remove start quote
-		length--;
-		memmove(token, token + 1, length);
-
-		if (length && token[length - 1] == '\"')
-		{
-			// remove end quote
-			length--;
-		}
+		*text = pointer;
+		return emptyToken;
 	}
 
-	if (length >= MAX_TOKEN_SIZE)
+	if (end == pointer && *pointer)
 	{
-		length = 0;
+		// the terminator is going over the white space we stopped on
+		pointer++;
 	}
-	token[length] = 0;
+	*end = 0;
 	*text = pointer;
 
-	return token;
+	return start;
+}
+
+void* CGPArena::Alloc(size_t size)
+{
+	constexpr size_t align = sizeof(void*);
+	constexpr size_t headerSize = (sizeof(SBlock) + align - 1) & ~(align - 1);
+
+	size = (size + align - 1) & ~(align - 1);
+
+	if (!mBlocks || mBlocks->mUsed + size > mBlocks->mSize)
+	{
+		const size_t blockSize = size > GP_ARENA_BLOCK_SIZE ? size : GP_ARENA_BLOCK_SIZE;
+		const auto block = static_cast<SBlock*>(Z_Malloc(static_cast<int>(headerSize + blockSize), TAG_TEXTPOOL, qfalse));
+
+		block->mNext = mBlocks;
+		block->mSize = blockSize;
+		block->mUsed = 0;
+		mBlocks = block;
+	}
+
+	void* mem = reinterpret_cast<char*>(mBlocks) + headerSize + mBlocks->mUsed;
+	mBlocks->mUsed += size;
+	mUsed += size;
+
+	return mem;
+}
+
+void CGPArena::Clean(void)
+{
+	while (mBlocks)
+	{
+		SBlock* next = mBlocks->mNext;
+		Z_Free(mBlocks);
+		mBlocks = next;
+	}
+	mUsed = 0;
 }
 
 CTextPool::CTextPool(const int initSize) :
@@ -232,10 +280,24 @@ CGPObject::CGPObject(const char* initName) :
 	mName(initName),
 	mNext(nullptr),
 	mInOrderNext(nullptr),
-	mInOrderPrevious(nullptr)
+	mInOrderPrevious(nullptr),
+	mInArena(false)
 {
 }
 
+void CGPObject::Destroy(CGPObject* object)
+{
+	if (object->mInArena)
+	{
+		// the memory goes back with the rest of the arena
+		object->~CGPObject();
+	}
+	else
+	{
+		delete object;
+	}
+}
+
 bool CGPObject::WriteText(CTextPool** textPool, const char* text) const
 {
 	if (strchr(text, ' ') || !text[0])
@@ -267,7 +329,7 @@ CGPValue::~CGPValue(void)
 	while (mList)
 	{
 		CGPObject* next = mList->GetNext();
-		delete mList;
+		Destroy(mList);
 		mList = next;
 	}
 }
@@ -343,7 +405,23 @@ void CGPValue::AddValue(const char* newValue, CTextPool** textPool)
 	}
 }
 
-bool CGPValue::Parse(char** dataPtr, CTextPool** textPool)
+void CGPValue::AddValue(const char* newValue, CGPArena* arena)
+{
+	CGPObject* object = arena->New<CGPObject>(newValue);
+
+	if (mList == nullptr)
+	{
+		mList = object;
+		mList->SetInOrderNext(mList);
+	}
+	else
+	{
+		mList->GetInOrderNext()->SetNext(object);
+		mList->SetInOrderNext(object);
+	}
+}
+
+bool CGPValue::Parse(char** dataPtr, CGPArena* arena)
 {
 	while (true)
 	{
@@ -360,8 +438,7 @@ bool CGPValue::Parse(char** dataPtr, CTextPool** textPool)
 			break;
 		}
 
-		const char* value = (*textPool)->AllocText(token, true, textPool);
-		AddValue(value);
+		AddValue(token, arena);
 	}
 
 	return true;
@@ -471,14 +548,14 @@ void CGPGroup::Clean(void)
 	while (mPairs)
 	{
 		mCurrentPair = mPairs->GetNext();
-		delete mPairs;
+		Destroy(mPairs);
 		mPairs = mCurrentPair;
 	}
 
 	while (mSubGroups)
 	{
 		mCurrentSubGroup = mSubGroups->GetNext();
-		delete mSubGroups;
+		Destroy(mSubGroups);
 		mSubGroups = mCurrentSubGroup;
 	}
 
@@ -625,14 +702,13 @@ CGPGroup* CGPGroup::FindSubGroup(const char* name) const
 	return nullptr;
 }
 
-bool CGPGroup::Parse(char** dataPtr, CTextPool** textPool)
+bool CGPGroup::Parse(char** dataPtr, CGPArena* arena)
 {
 	while (true)
 	{
-		char lastToken[MAX_TOKEN_SIZE];
-		const char* token = GetToken(dataPtr, true);
+		const char* name = GetToken(dataPtr, true);
 
-		if (!token[0])
+		if (!name[0])
 		{
 			// end of data - error!
 			if (mParent)
@@ -641,22 +717,21 @@ bool CGPGroup::Parse(char** dataPtr, CTextPool** textPool)
 			}
 			break;
 		}
-		if (Q_stricmp(token, "}") == 0)
+		if (Q_stricmp(name, "}") == 0)
 		{
 			// ending brace for this group
 			break;
 		}
 
-		strcpy(lastToken, token);
-
 		// read ahead to see what we are doing
-		token = GetToken(dataPtr, true, true);
+		const char* token = GetToken(dataPtr, true, true);
 		if (Q_stricmp(token, "{") == 0)
 		{
 			// new sub group
-			CGPGroup* newSubGroup = AddGroup(lastToken, textPool);
+			CGPGroup* newSubGroup = arena->New<CGPGroup>(name, this);
+			AddGroup(newSubGroup);
 			newSubGroup->SetWriteable(mWriteable);
-			if (!newSubGroup->Parse(dataPtr, textPool))
+			if (!newSubGroup->Parse(dataPtr, arena))
 			{
 				return false;
 			}
@@ -664,8 +739,9 @@ bool CGPGroup::Parse(char** dataPtr, CTextPool** textPool)
 		else if (Q_stricmp(token, "[") == 0)
 		{
 			// new pair list
-			CGPValue* newPair = AddPair(lastToken, nullptr, textPool);
-			if (!newPair->Parse(dataPtr, textPool))
+			CGPValue* newPair = arena->New<CGPValue>(name);
+			AddPair(newPair);
+			if (!newPair->Parse(dataPtr, arena))
 			{
 				return false;
 			}
@@ -673,7 +749,9 @@ bool CGPGroup::Parse(char** dataPtr, CTextPool** textPool)
 		else
 		{
 			// new pair
-			AddPair(lastToken, token, textPool);
+			CGPValue* newPair = arena->New<CGPValue>(name);
+			newPair->AddValue(token, arena);
+			AddPair(newPair);
 		}
 	}
 
@@ -790,7 +868,6 @@ const char* CGPGroup::FindPairValue(const char* key, const char* defaultVal) con
 }
 
 CGenericParser2::CGenericParser2(void) :
-	mTextPool(nullptr),
 	mWriteable(false)
 {
 }
@@ -802,32 +879,22 @@ CGenericParser2::~CGenericParser2(void)
 
 bool CGenericParser2::Parse(char** dataPtr, const bool cleanFirst, const bool writeable)
 {
-	CTextPool* topPool;
-
 	if (cleanFirst)
 	{
 		Clean();
 	}
 
-	if (!mTextPool)
-	{
-		mTextPool = new CTextPool;
-	}
-
 	SetWriteable(writeable);
 	mTopLevel.SetWriteable(writeable);
-	topPool = mTextPool;
-	const bool ret = mTopLevel.Parse(dataPtr, &topPool);
 
-	return ret;
+	return mTopLevel.Parse(dataPtr, &mArena);
 }
 
 void CGenericParser2::Clean(void)
 {
+	// the tree has to be torn down before the arena it sits in
 	mTopLevel.Clean();
-
-	CleanTextPool(mTextPool);
-	mTextPool = nullptr;
+	mArena.Clean();
 }
 
 bool CGenericParser2::Write(CTextPool* textPool) const
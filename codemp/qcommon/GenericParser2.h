@@ -38,6 +38,10 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #endif
 
+#include <cstddef>
+#include <new>
+#include <utility>
+
 class CTextPool;
 class CGPObject;
 
@@ -62,11 +66,46 @@ public:
 
 void CleanTextPool(CTextPool* pool);
 
+// Bump allocator a parse builds its tree in, so a whole file's worth of groups, pairs and values comes out of a
+// handful of big blocks rather than a new apiece. Everything in it goes in one go with Clean().
+class CGPArena
+{
+private:
+	struct SBlock
+	{
+		SBlock* mNext;
+		size_t mSize, mUsed;
+	};
+
+	SBlock* mBlocks; // newest first, only the head has room in it
+	size_t mUsed;
+
+public:
+	CGPArena(void) : mBlocks(nullptr), mUsed(0) {}
+	~CGPArena(void) { Clean(); }
+
+	CGPArena(const CGPArena&) = delete;
+	CGPArena& operator=(const CGPArena&) = delete;
+
+	void* Alloc(size_t size);
+	void Clean(void);
+	size_t GetUsed(void) const { return mUsed; }
+
+	template <typename T, typename... Args>
+	T* New(Args&&... args)
+	{
+		T* object = new(Alloc(sizeof(T))) T(std::forward<Args>(args)...);
+		object->SetInArena();
+		return object;
+	}
+};
+
 class CGPObject
 {
 protected:
 	const char* mName;
 	CGPObject* mNext, * mInOrderNext, * mInOrderPrevious;
+	bool mInArena;
 
 public:
 	CGPObject(const char* initName);
@@ -75,6 +114,10 @@ public:
 	{
 	}
 
+	// use instead of delete, since parsed objects live in their parser's arena
+	static void Destroy(CGPObject* object);
+	void SetInArena(void) { mInArena = true; }
+
 	const char* GetName(void) const { return mName; }
 
 	CGPObject* GetNext(void) const { return mNext; }
@@ -104,8 +147,9 @@ public:
 	const char* GetTopValue(void) const;
 	CGPObject* GetList(void) const { return mList; }
 	void AddValue(const char* newValue, CTextPool** textPool = nullptr);
+	void AddValue(const char* newValue, CGPArena* arena);
 
-	bool Parse(char** dataPtr, CTextPool** textPool);
+	bool Parse(char** dataPtr, CGPArena* arena);
 
 	bool Write(CTextPool** textPool, int depth) const;
 };
@@ -146,18 +190,21 @@ public:
 	CGPGroup* AddGroup(const char* name, CTextPool** textPool = nullptr);
 	void AddGroup(CGPGroup* NewGroup);
 	CGPGroup* FindSubGroup(const char* name) const;
-	bool Parse(char** dataPtr, CTextPool** textPool);
+	bool Parse(char** dataPtr, CGPArena* arena);
 	bool Write(CTextPool** textPool, int depth) const;
 
 	CGPValue* FindPair(const char* key) const;
 	const char* FindPairValue(const char* key, const char* defaultVal = nullptr) const;
 };
 
+// Parsing works in place: each token is cut out of the buffer by writing a NUL over whatever ends it, and the tree
+// points straight at it. So the buffer handed to Parse() gets modified and has to stay around as long as the tree is
+// being read.
 class CGenericParser2
 {
 private:
 	CGPGroup mTopLevel;
-	CTextPool* mTextPool;
+	CGPArena mArena;
 	bool mWriteable;
 
 public:
@@ -177,6 +224,8 @@ public:
 	void Clean(void);
 
 	bool Write(CTextPool* textPool) const;
+
+	size_t GetArenaUsed(void) const { return mArena.GetUsed(); }
 };
 
 // The following groups of routines are used for a C interface into GP2.
@@ -62,6 +62,7 @@ byte* cmod_base;
 cvar_t* cm_noAreas;
 cvar_t* cm_noCurves;
 cvar_t* cm_playerCurveClip;
+cvar_t* cm_patchCache;
 cvar_t* cm_extraVerbose;
 #endif
 
@@ -314,6 +315,74 @@ void CMod_LoadBrushes(const lump_t* l, clipMap_t& cm)
 	}
 }
 
+/*
+=================
+CM_PackBrushSides
+
+Copies a brush's side planes into its side blocks
+=================
+*/
+void CM_PackBrushSides(cbrush_t* b)
+{
+	for (int i = 0; i < (b->numsides + BRUSH_SIDE_BLOCK - 1) / BRUSH_SIDE_BLOCK * BRUSH_SIDE_BLOCK; i++)
+	{
+		cbrushSideBlock_t* block = &b->sideBlocks[i / BRUSH_SIDE_BLOCK];
+		const int lane = i % BRUSH_SIDE_BLOCK;
+
+		if (i >= b->numsides)
+		{
+			// a zero normal and a huge distance puts everything behind the padding
+			for (int j = 0; j < 3; j++)
+			{
+				block->normal[j][lane] = 0.0f;
+				block->signMask[j][lane] = 0;
+			}
+			block->dist[lane] = FLT_MAX;
+			continue;
+		}
+
+		const cplane_t* plane = b->sides[i].plane;
+		for (int j = 0; j < 3; j++)
+		{
+			block->normal[j][lane] = plane->normal[j];
+			block->signMask[j][lane] = plane->signbits & 1 << j ? ~0 : 0;
+		}
+		block->dist[lane] = plane->dist;
+	}
+}
+
+/*
+=================
+CMod_PackBrushSides
+
+Builds the side blocks the brush clip kernels in cm_trace.cpp work on,
+leaving room at the end for the box brush
+=================
+*/
+static void CMod_PackBrushSides(clipMap_t& cm)
+{
+	int count = 0;
+
+	for (int i = 0; i < cm.numBrushes; i++)
+	{
+		count += (cm.brushes[i].numsides + BRUSH_SIDE_BLOCK - 1) / BRUSH_SIDE_BLOCK;
+	}
+
+	cm.sideBlocks = static_cast<cbrushSideBlock_t*>(Hunk_Alloc(
+		(count + (BOX_SIDES + BRUSH_SIDE_BLOCK - 1) / BRUSH_SIDE_BLOCK) * sizeof * cm.sideBlocks, h_high));
+	cm.numSideBlocks = count;
+
+	cbrushSideBlock_t* blocks = cm.sideBlocks;
+	for (int i = 0; i < cm.numBrushes; i++)
+	{
+		cbrush_t* b = &cm.brushes[i];
+
+		b->sideBlocks = blocks;
+		CM_PackBrushSides(b);
+		blocks += (b->numsides + BRUSH_SIDE_BLOCK - 1) / BRUSH_SIDE_BLOCK;
+	}
+}
+
 /*
 =================
 CMod_LoadLeafs
@@ -532,7 +601,7 @@ CMod_LoadPatches
 */
 #define	MAX_PATCH_VERTS		1024
 
-static void CMod_LoadPatches(const lump_t* surfs, const lump_t* verts, clipMap_t& cm)
+static void CMod_LoadPatches(const lump_t* surfs, const lump_t* verts, clipMap_t& cm, const char* name, const int checksum)
 {
 	int count;
 	cPatch_t* patch;
@@ -548,6 +617,20 @@ static void CMod_LoadPatches(const lump_t* surfs, const lump_t* verts, clipMap_t
 	if (verts->filelen % sizeof * dv)
 		Com_Error(ERR_DROP, "MOD_LoadBmodel: funny lump size");
 
+#ifndef BSPC
+	// the collision for every patch may already be cached from a previous load of this bsp
+	int numPatches = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (LittleLong in[i].surfaceType == MST_PATCH)
+		{
+			numPatches++;
+		}
+	}
+
+	const qboolean cached = CM_OpenPatchCache(name, checksum, numPatches);
+#endif
+
 	// scan through all the surfaces, but only load patches,
 	// not planar faces
 	for (int i = 0; i < count; i++, in++)
@@ -582,8 +665,25 @@ static void CMod_LoadPatches(const lump_t* surfs, const lump_t* verts, clipMap_t
 		patch->surfaceFlags = cm.shaders[shader_num].surfaceFlags;
 
 		// create the internal facet structure
-		patch->pc = CM_GeneratePatchCollide(width, height, points);
+		patch->pc = nullptr;
+#ifndef BSPC
+		if (cached)
+		{
+			patch->pc = CM_ReadCachedPatchCollide();
+		}
+#endif
+		if (!patch->pc)
+		{
+			patch->pc = CM_GeneratePatchCollide(width, height, points);
+		}
+	}
+
+#ifndef BSPC
+	if (!CM_ClosePatchCache() && numPatches)
+	{
+		CM_WritePatchCache(name, checksum, cm.surfaces, cm.numSurfaces);
 	}
+#endif
 }
 
 //==================================================================
@@ -646,6 +746,7 @@ static void CM_LoadMap_Actual(const char* name, const qboolean clientload, int*
 	cm_noAreas = Cvar_Get("cm_noAreas", "0", CVAR_CHEAT);
 	cm_noCurves = Cvar_Get("cm_noCurves", "0", CVAR_CHEAT);
 	cm_playerCurveClip = Cvar_Get("cm_playerCurveClip", "1", CVAR_ARCHIVE_ND | CVAR_CHEAT);
+	cm_patchCache = Cvar_Get("cm_patchCache", "1", CVAR_ARCHIVE_ND);
 	cm_extraVerbose = Cvar_Get("cm_extraVerbose", "0", CVAR_TEMP);
 #endif
 	Com_DPrintf("CM_LoadMap( %s, %i )\n", name, clientload);
@@ -755,11 +856,12 @@ static void CM_LoadMap_Actual(const char* name, const qboolean clientload, int*
 	CMod_LoadPlanes(&header.lumps[LUMP_PLANES], cm);
 	CMod_LoadBrushSides(&header.lumps[LUMP_BRUSHSIDES], cm);
 	CMod_LoadBrushes(&header.lumps[LUMP_BRUSHES], cm);
+	CMod_PackBrushSides(cm);
 	CMod_LoadSubmodels(&header.lumps[LUMP_MODELS], cm);
 	CMod_LoadNodes(&header.lumps[LUMP_NODES], cm);
 	CMod_LoadEntityString(&header.lumps[LUMP_ENTITIES], cm, name);
 	CMod_LoadVisibility(&header.lumps[LUMP_VISIBILITY], cm);
-	CMod_LoadPatches(&header.lumps[LUMP_SURFACES], &header.lumps[LUMP_DRAWVERTS], cm);
+	CMod_LoadPatches(&header.lumps[LUMP_SURFACES], &header.lumps[LUMP_DRAWVERTS], cm, orig_name, last_checksum);
 
 	TotalSubModels += cm.numSubModels;
 
@@ -944,6 +1046,7 @@ void CM_InitBoxHull()
 	box_brush = &cmg.brushes[cmg.numBrushes];
 	box_brush->numsides = 6;
 	box_brush->sides = cmg.brushsides + cmg.numBrushSides;
+	box_brush->sideBlocks = cmg.sideBlocks + cmg.numSideBlocks;
 	box_brush->contents = CONTENTS_BODY;
 
 	box_model.firstNode = -1;
@@ -976,6 +1079,8 @@ void CM_InitBoxHull()
 
 		SetPlaneSignbits(p);
 	}
+
+	CM_PackBrushSides(box_brush);
 }
 
 /*
@@ -1010,6 +1115,12 @@ clip_handle_t CM_TempBoxModel(const vec3_t mins, const vec3_t maxs, const int ca
 	box_planes[10].dist = mins[2];
 	box_planes[11].dist = -mins[2];
 
+	// only the distances move, keep the packed copy in step
+	for (int i = 0; i < BOX_SIDES; i++)
+	{
+		box_brush->sideBlocks[i / BRUSH_SIDE_BLOCK].dist[i % BRUSH_SIDE_BLOCK] = box_brush->sides[i].plane->dist;
+	}
+
 	VectorCopy(mins, box_brush->bounds[0]);
 	VectorCopy(maxs, box_brush->bounds[1]);
 
@@ -67,12 +67,24 @@ using cbrushside_t = struct cbrushside_s
 	int shader_num;
 };
 
+// brush sides repacked four at a time so the clip kernels can test a whole
+// block of planes at once, padded out with planes nothing is ever in front of
+#define BRUSH_SIDE_BLOCK		4
+
+using cbrushSideBlock_t = struct cbrushSideBlock_s
+{
+	float normal[3][BRUSH_SIDE_BLOCK];
+	float dist[BRUSH_SIDE_BLOCK];
+	int signMask[3][BRUSH_SIDE_BLOCK]; // ~0 where the normal component is negative
+};
+
 using cbrush_t = struct cbrush_s
 {
 	int shader_num; // the shader that determined the contents
 	int contents;
 	vec3_t bounds[2];
 	cbrushside_t* sides;
+	cbrushSideBlock_t* sideBlocks; // ( numsides + 3 ) / 4 of them
 	unsigned short numsides;
 	unsigned short checkcount; // to avoid repeated testings
 };
@@ -139,6 +151,9 @@ using clipMap_t = struct clipMap_s
 	int numBrushes;
 	cbrush_t* brushes;
 
+	int numSideBlocks;
+	cbrushSideBlock_t* sideBlocks;
+
 	int numClusters;
 	int clusterBytes;
 	byte* visibility;
@@ -168,6 +183,7 @@ extern int c_traces, c_brush_traces, c_patch_traces;
 extern cvar_t* cm_noAreas;
 extern cvar_t* cm_noCurves;
 extern cvar_t* cm_playerCurveClip;
+extern cvar_t* cm_patchCache;
 extern cvar_t* cm_extraVerbose;
 
 // cm_test.c
@@ -235,6 +251,10 @@ void CM_TraceThroughPatchCollide(traceWork_t* tw, trace_t& trace, const struct p
 qboolean CM_PositionTestInPatchCollide(traceWork_t* tw, const struct patchCollide_s* pc);
 void CM_ClearLevelPatches(void);
 void CM_ClearLevelPatches(void);
+qboolean CM_OpenPatchCache(const char* mapName, int checksum, int numPatches);
+struct patchCollide_s* CM_ReadCachedPatchCollide(void);
+qboolean CM_ClosePatchCache(void);
+void CM_WritePatchCache(const char* mapName, int checksum, const cPatch_t* const* surfaces, int numSurfaces);
 
 // cm_load.cpp
 void CM_GetWorldBounds(vec3_t mins, vec3_t maxs);
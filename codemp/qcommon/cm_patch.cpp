@@ -25,6 +25,8 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "cm_patch.h"
 #include "qcommon/qcommon.h"
 
+#include <algorithm>
+
 /*
 
 This file does not reference any globals, and has these entry points:
@@ -770,9 +772,12 @@ static qboolean CM_ValidateFacet(const facet_t* facet) {
 /*
 ==================
 CM_AddFacetBevels
+
+Also returns the bounds of the facet's winding, which the axial bevels keep
+the whole facet inside.  They're left cleared if there is no winding
 ==================
 */
-static void CM_AddFacetBevels(facet_t* facet) {
+static void CM_AddFacetBevels(facet_t* facet, vec3_t bounds[2]) {
 	int i, j, l;
 	int axis, dir, flipped;
 	float plane[4], newplane[4];
@@ -798,6 +803,8 @@ static void CM_AddFacetBevels(facet_t* facet) {
 	}
 
 	WindingBounds(w, mins, maxs);
+	VectorCopy(mins, bounds[0]);
+	VectorCopy(maxs, bounds[1]);
 
 	// add the axial planes
 	int order = 0;
@@ -939,6 +946,136 @@ using edgeName_t = enum {
 	EN_LEFT
 };
 
+/*
+==================
+CM_BuildPatchBVHNode
+
+Splits the facets at the median of their centers along the longest axis
+==================
+*/
+static void CM_BuildPatchBVHNode(patchBVHNode_t* nodes, const int nodeNum, int* numNodes, int* facetOrder,
+	const int first, const int count, const vec3_t(*facetBounds)[2]) {
+	patchBVHNode_t* node = &nodes[nodeNum];
+	vec3_t centerMins, centerMaxs;
+	int i;
+
+	ClearBounds(node->bounds[0], node->bounds[1]);
+	ClearBounds(centerMins, centerMaxs);
+	for (i = first; i < first + count; i++) {
+		vec3_t center;
+		AddPointToBounds(facetBounds[facetOrder[i]][0], node->bounds[0], node->bounds[1]);
+		AddPointToBounds(facetBounds[facetOrder[i]][1], node->bounds[0], node->bounds[1]);
+		VectorAdd(facetBounds[facetOrder[i]][0], facetBounds[facetOrder[i]][1], center);
+		AddPointToBounds(center, centerMins, centerMaxs);
+	}
+
+	if (count <= PATCH_BVH_LEAF_FACETS) {
+		node->first = first;
+		node->numFacets = count;
+		return;
+	}
+
+	int axis = 0;
+	for (i = 1; i < 3; i++) {
+		if (centerMaxs[i] - centerMins[i] > centerMaxs[axis] - centerMins[axis]) {
+			axis = i;
+		}
+	}
+
+	const int half = count / 2;
+	std::nth_element(facetOrder + first, facetOrder + first + half, facetOrder + first + count,
+		[facetBounds, axis](const int a, const int b) {
+			return facetBounds[a][0][axis] + facetBounds[a][1][axis] < facetBounds[b][0][axis] + facetBounds[b][1][axis];
+		});
+
+	node->first = *numNodes;
+	node->numFacets = 0;
+	*numNodes += 2;
+
+	CM_BuildPatchBVHNode(nodes, node->first, numNodes, facetOrder, first, half, facetBounds);
+	CM_BuildPatchBVHNode(nodes, node->first + 1, numNodes, facetOrder, first + half, count - half, facetBounds);
+}
+
+/*
+==================
+CM_BuildPatchBVH
+==================
+*/
+static void CM_BuildPatchBVH(patchCollide_t* pf, const vec3_t(*facetBounds)[2]) {
+	pf->numNodes = 0;
+	pf->nodes = nullptr;
+	pf->facetOrder = nullptr;
+
+	if (pf->numFacets <= PATCH_BVH_LEAF_FACETS) {
+		return;
+	}
+
+	pf->facetOrder = static_cast<int*>(Hunk_Alloc(pf->numFacets * sizeof * pf->facetOrder, h_high));
+	for (int i = 0; i < pf->numFacets; i++) {
+		pf->facetOrder[i] = i;
+	}
+
+	// every leaf holds at least one facet, so there can't be more than this many nodes
+	const auto nodes = static_cast<patchBVHNode_t*>(Z_Malloc(2 * pf->numFacets * sizeof(patchBVHNode_t), TAG_TEMP_WORKSPACE, qfalse, 4));
+	int numNodes = 1;
+
+	CM_BuildPatchBVHNode(nodes, 0, &numNodes, pf->facetOrder, 0, pf->numFacets, facetBounds);
+
+	pf->numNodes = numNodes;
+	pf->nodes = static_cast<patchBVHNode_t*>(Hunk_Alloc(numNodes * sizeof * pf->nodes, h_high));
+	Com_Memcpy(pf->nodes, nodes, numNodes * sizeof * pf->nodes);
+
+	Z_Free(nodes);
+}
+
+/*
+==================
+CM_PatchFacetsInBounds
+
+Collects the facets whose bounds touch the given box, in their original
+order so overlapping hits resolve exactly as they would testing every facet
+==================
+*/
+static int CM_PatchFacetsInBounds(const patchCollide_t* pc, const vec3_t bounds[2], int* list) {
+	int numFacets = 0;
+
+	if (!pc->numNodes) {
+		for (; numFacets < pc->numFacets; numFacets++) {
+			list[numFacets] = numFacets;
+		}
+		return numFacets;
+	}
+
+	int stack[64];
+	int stackDepth = 0;
+
+	stack[stackDepth++] = 0;
+	while (stackDepth) {
+		const patchBVHNode_t* node = &pc->nodes[stack[--stackDepth]];
+
+		if (bounds[0][0] > node->bounds[1][0] || bounds[1][0] < node->bounds[0][0]
+			|| bounds[0][1] > node->bounds[1][1] || bounds[1][1] < node->bounds[0][1]
+			|| bounds[0][2] > node->bounds[1][2] || bounds[1][2] < node->bounds[0][2]) {
+			continue;
+		}
+
+		if (node->numFacets) {
+			for (int i = 0; i < node->numFacets; i++) {
+				list[numFacets++] = pc->facetOrder[node->first + i];
+			}
+		}
+		else {
+			// median splits keep the depth near log2 of the facet count, well inside the stack
+			stack[stackDepth++] = node->first + 1;
+			stack[stackDepth++] = node->first;
+		}
+	}
+
+	std::sort(list, list + numFacets);
+
+	return numFacets;
+}
+
 /*
 ==================
 CM_PatchCollideFromGrid
@@ -951,6 +1088,10 @@ static void CM_PatchCollideFromGrid(cGrid_t* grid, patchCollide_t* pf) {
 	int				noAdjust[4]{};
 
 	facets = static_cast<facet_t*>(Z_Malloc(MAX_FACETS * sizeof(facet_t), TAG_TEMP_WORKSPACE, qfalse, 4));
+	const auto facetBounds = static_cast<vec3_t(*)[2]>(Z_Malloc(MAX_FACETS * sizeof(vec3_t[2]), TAG_TEMP_WORKSPACE, qfalse, 4));
+	for (i = 0; i < MAX_FACETS; i++) {
+		ClearBounds(facetBounds[i][0], facetBounds[i][1]);
+	}
 
 	num_planes = 0;
 	int numFacets = 0;
@@ -1043,7 +1184,7 @@ static void CM_PatchCollideFromGrid(cGrid_t* grid, patchCollide_t* pf) {
 				facet->borderNoAdjust[3] = static_cast<qboolean>(noAdjust[EN_LEFT]);
 				CM_SetBorderInward(facet, grid, gridPlanes, i, j, -1);
 				if (CM_ValidateFacet(facet)) {
-					CM_AddFacetBevels(facet);
+					CM_AddFacetBevels(facet, facetBounds[numFacets]);
 					numFacets++;
 				}
 			}
@@ -1064,7 +1205,7 @@ static void CM_PatchCollideFromGrid(cGrid_t* grid, patchCollide_t* pf) {
 				}
 				CM_SetBorderInward(facet, grid, gridPlanes, i, j, 0);
 				if (CM_ValidateFacet(facet)) {
-					CM_AddFacetBevels(facet);
+					CM_AddFacetBevels(facet, facetBounds[numFacets]);
 					numFacets++;
 				}
 
@@ -1089,7 +1230,7 @@ static void CM_PatchCollideFromGrid(cGrid_t* grid, patchCollide_t* pf) {
 				}
 				CM_SetBorderInward(facet, grid, gridPlanes, i, j, 1);
 				if (CM_ValidateFacet(facet)) {
-					CM_AddFacetBevels(facet);
+					CM_AddFacetBevels(facet, facetBounds[numFacets]);
 					numFacets++;
 				}
 			}
@@ -1111,6 +1252,20 @@ static void CM_PatchCollideFromGrid(cGrid_t* grid, patchCollide_t* pf) {
 	pf->planes = static_cast<patchPlane_t*>(Hunk_Alloc(num_planes * sizeof * pf->planes, h_high));
 	Com_Memcpy(pf->planes, planes, num_planes * sizeof * pf->planes);
 
+	// facets without a winding never got bevels, so they could reach anywhere in the patch
+	for (i = 0; i < numFacets; i++) {
+		if (facetBounds[i][0][0] > facetBounds[i][1][0]) {
+			VectorCopy(pf->bounds[0], facetBounds[i][0]);
+			VectorCopy(pf->bounds[1], facetBounds[i][1]);
+		}
+		for (j = 0; j < 3; j++) {
+			facetBounds[i][0][j] -= 1;
+			facetBounds[i][1][j] += 1;
+		}
+	}
+	CM_BuildPatchBVH(pf, facetBounds);
+
+	Z_Free(facetBounds);
 	Z_Free(facets);
 }
 
@@ -1191,6 +1346,309 @@ patchCollide_s* CM_GeneratePatchCollide(int width, int height, vec3_t* points) {
 	return pf;
 }
 
+#ifndef BSPC
+/*
+================================================================================
+
+COLLISION CACHE
+
+Generating the facets is most of the work of loading a map with a lot of
+curved surfaces, so the result is written to patchcache/<map>.pcc and read
+straight back on the next load of the same bsp
+
+================================================================================
+*/
+
+#define	PATCHCACHE_IDENT	(('C'<<24)+('C'<<16)+('P'<<8)+'P')
+#define	PATCHCACHE_VERSION	1
+#define	PATCHCACHE_MAX_DEPTH	32
+
+using patchCacheHeader_t = struct patchCacheHeader_s
+{
+	int ident;
+	int version;
+	int checksum; // of the bsp the patches came from
+	int numPatches;
+	int facetSize; // catch struct layout changes between builds
+	int nodeSize;
+};
+
+using patchCacheRecord_t = struct patchCacheRecord_s
+{
+	vec3_t bounds[2];
+	int num_planes;
+	int numFacets;
+	int numNodes;
+};
+
+static byte* patchCacheBuffer;
+static int patchCacheLength;
+static int patchCacheOffset;
+static int patchCacheRemaining;
+static qboolean patchCacheFailed;
+
+static void CM_PatchCachePath(const char* mapName, char* path, const int pathSize) {
+	char baseName[MAX_QPATH];
+
+	COM_StripExtension(mapName, baseName, sizeof baseName);
+	Com_sprintf(path, pathSize, "patchcache/%s.pcc", baseName);
+}
+
+/*
+==================
+CM_OpenPatchCache
+
+Returns qtrue if there's a cache for this exact bsp to read the patches from
+==================
+*/
+qboolean CM_OpenPatchCache(const char* mapName, const int checksum, const int numPatches) {
+	char path[MAX_QPATH];
+	void* buffer;
+
+	patchCacheBuffer = nullptr;
+	patchCacheFailed = qtrue;
+
+	if (!cm_patchCache || !cm_patchCache->integer || !numPatches) {
+		return qfalse;
+	}
+
+	CM_PatchCachePath(mapName, path, sizeof path);
+	const long length = FS_ReadFile(path, &buffer);
+	if (!buffer) {
+		return qfalse;
+	}
+
+	const auto header = static_cast<const patchCacheHeader_t*>(buffer);
+	if (length < static_cast<long>(sizeof * header)
+		|| header->ident != PATCHCACHE_IDENT
+		|| header->version != PATCHCACHE_VERSION
+		|| header->checksum != checksum
+		|| header->numPatches != numPatches
+		|| header->facetSize != static_cast<int>(sizeof(facet_t))
+		|| header->nodeSize != static_cast<int>(sizeof(patchBVHNode_t))) {
+		FS_FreeFile(buffer);
+		return qfalse;
+	}
+
+	patchCacheBuffer = static_cast<byte*>(buffer);
+	patchCacheLength = length;
+	patchCacheOffset = sizeof * header;
+	patchCacheRemaining = numPatches;
+	patchCacheFailed = qfalse;
+
+	return qtrue;
+}
+
+static const void* CM_PatchCacheRead(const int size) {
+	if (size < 0 || patchCacheLength - patchCacheOffset < size) {
+		patchCacheFailed = qtrue;
+		return nullptr;
+	}
+
+	const void* data = patchCacheBuffer + patchCacheOffset;
+	patchCacheOffset += size;
+	return data;
+}
+
+/*
+==================
+CM_ValidateCachedPatch
+
+Everything that indexes something else has to stay in range, and the tree
+has to be shallow enough for CM_PatchFacetsInBounds
+==================
+*/
+static qboolean CM_ValidateCachedPatch(const patchCacheRecord_t* record, const facet_t* facets,
+	const patchBVHNode_t* nodes, const int* facetOrder) {
+	int i, j;
+
+	for (i = 0; i < record->numFacets; i++) {
+		const facet_t* facet = &facets[i];
+		if (facet->surfacePlane < 0 || facet->surfacePlane >= record->num_planes
+			|| facet->numBorders < 0 || facet->numBorders > static_cast<int>(ARRAY_LEN(facet->borderPlanes))) {
+			return qfalse;
+		}
+		for (j = 0; j < facet->numBorders; j++) {
+			if (facet->borderPlanes[j] < 0 || facet->borderPlanes[j] >= record->num_planes) {
+				return qfalse;
+			}
+		}
+	}
+
+	if (!record->numNodes) {
+		return qtrue;
+	}
+
+	for (i = 0; i < record->numFacets; i++) {
+		if (facetOrder[i] < 0 || facetOrder[i] >= record->numFacets) {
+			return qfalse;
+		}
+	}
+
+	byte depth[2 * MAX_FACETS]{};
+	for (i = 0; i < record->numNodes; i++) {
+		const patchBVHNode_t* node = &nodes[i];
+		if (node->numFacets) {
+			if (node->numFacets < 0 || node->first < 0 || node->first + node->numFacets > record->numFacets) {
+				return qfalse;
+			}
+			continue;
+		}
+		// children always come after their parent, so this can't loop
+		if (node->first <= i || node->first + 1 >= record->numNodes || depth[i] >= PATCHCACHE_MAX_DEPTH) {
+			return qfalse;
+		}
+		depth[node->first] = depth[node->first + 1] = depth[i] + 1;
+	}
+
+	return qtrue;
+}
+
+/*
+==================
+CM_ReadCachedPatchCollide
+
+Returns the next patch from the open cache, or NULL if it has to be generated
+==================
+*/
+patchCollide_s* CM_ReadCachedPatchCollide(void) {
+	if (patchCacheFailed || !patchCacheRemaining) {
+		patchCacheFailed = qtrue;
+		return nullptr;
+	}
+
+	const auto record = static_cast<const patchCacheRecord_t*>(CM_PatchCacheRead(sizeof(patchCacheRecord_t)));
+	if (!record
+		|| record->num_planes < 0 || record->num_planes > MAX_PATCH_PLANES
+		|| record->numFacets < 0 || record->numFacets > MAX_FACETS
+		|| record->numNodes < 0 || record->numNodes > 2 * record->numFacets) {
+		patchCacheFailed = qtrue;
+		return nullptr;
+	}
+
+	const auto planes = static_cast<const patchPlane_t*>(CM_PatchCacheRead(record->num_planes * sizeof(patchPlane_t)));
+	const auto facets = static_cast<const facet_t*>(CM_PatchCacheRead(record->numFacets * sizeof(facet_t)));
+	const auto nodes = static_cast<const patchBVHNode_t*>(CM_PatchCacheRead(record->numNodes * sizeof(patchBVHNode_t)));
+	const auto facetOrder = static_cast<const int*>(CM_PatchCacheRead((record->numNodes ? record->numFacets : 0) * sizeof(int)));
+
+	if (patchCacheFailed || !CM_ValidateCachedPatch(record, facets, nodes, facetOrder)) {
+		patchCacheFailed = qtrue;
+		return nullptr;
+	}
+
+	patchCollide_t* pf = static_cast<patchCollide_s*>(Hunk_Alloc(sizeof * pf, h_high));
+	VectorCopy(record->bounds[0], pf->bounds[0]);
+	VectorCopy(record->bounds[1], pf->bounds[1]);
+
+	pf->num_planes = record->num_planes;
+	pf->planes = static_cast<patchPlane_t*>(Hunk_Alloc(pf->num_planes * sizeof * pf->planes, h_high));
+	Com_Memcpy(pf->planes, planes, pf->num_planes * sizeof * pf->planes);
+
+	pf->numFacets = record->numFacets;
+	pf->facets = nullptr;
+	if (pf->numFacets) {
+		pf->facets = static_cast<facet_t*>(Hunk_Alloc(pf->numFacets * sizeof * pf->facets, h_high));
+		Com_Memcpy(pf->facets, facets, pf->numFacets * sizeof * pf->facets);
+	}
+
+	pf->numNodes = record->numNodes;
+	pf->nodes = nullptr;
+	pf->facetOrder = nullptr;
+	if (pf->numNodes) {
+		pf->nodes = static_cast<patchBVHNode_t*>(Hunk_Alloc(pf->numNodes * sizeof * pf->nodes, h_high));
+		Com_Memcpy(pf->nodes, nodes, pf->numNodes * sizeof * pf->nodes);
+		pf->facetOrder = static_cast<int*>(Hunk_Alloc(pf->numFacets * sizeof * pf->facetOrder, h_high));
+		Com_Memcpy(pf->facetOrder, facetOrder, pf->numFacets * sizeof * pf->facetOrder);
+	}
+
+	patchCacheRemaining--;
+
+	return pf;
+}
+
+/*
+==================
+CM_ClosePatchCache
+
+Returns qtrue if every patch came from the cache
+==================
+*/
+qboolean CM_ClosePatchCache(void) {
+	const qboolean complete = static_cast<qboolean>(!patchCacheFailed && !patchCacheRemaining);
+
+	if (patchCacheBuffer) {
+		FS_FreeFile(patchCacheBuffer);
+		patchCacheBuffer = nullptr;
+	}
+	patchCacheFailed = qtrue;
+
+	return complete;
+}
+
+/*
+==================
+CM_WritePatchCache
+==================
+*/
+void CM_WritePatchCache(const char* mapName, const int checksum, const cPatch_t* const* surfaces, const int numSurfaces) {
+	char path[MAX_QPATH];
+	patchCacheHeader_t header;
+	int i;
+
+	if (!cm_patchCache || !cm_patchCache->integer) {
+		return;
+	}
+
+	header.ident = PATCHCACHE_IDENT;
+	header.version = PATCHCACHE_VERSION;
+	header.checksum = checksum;
+	header.numPatches = 0;
+	header.facetSize = sizeof(facet_t);
+	header.nodeSize = sizeof(patchBVHNode_t);
+
+	for (i = 0; i < numSurfaces; i++) {
+		if (surfaces[i]) {
+			header.numPatches++;
+		}
+	}
+
+	CM_PatchCachePath(mapName, path, sizeof path);
+	const fileHandle_t f = FS_FOpenFileWrite(path);
+	if (!f) {
+		return;
+	}
+
+	FS_Write(&header, sizeof header, f);
+
+	for (i = 0; i < numSurfaces; i++) {
+		if (!surfaces[i]) {
+			continue;
+		}
+
+		const patchCollide_t* pc = surfaces[i]->pc;
+		patchCacheRecord_t record;
+
+		VectorCopy(pc->bounds[0], record.bounds[0]);
+		VectorCopy(pc->bounds[1], record.bounds[1]);
+		record.num_planes = pc->num_planes;
+		record.numFacets = pc->numFacets;
+		record.numNodes = pc->numNodes;
+
+		FS_Write(&record, sizeof record, f);
+		FS_Write(pc->planes, pc->num_planes * sizeof * pc->planes, f);
+		FS_Write(pc->facets, pc->numFacets * sizeof * pc->facets, f);
+		if (pc->numNodes) {
+			FS_Write(pc->nodes, pc->numNodes * sizeof * pc->nodes, f);
+			FS_Write(pc->facetOrder, pc->numFacets * sizeof * pc->facetOrder, f);
+		}
+	}
+
+	FS_FCloseFile(f);
+
+	Com_DPrintf("Wrote curve collision for %i patches to %s\n", header.numPatches, path);
+}
+#endif // BSPC
+
 /*
 ================================================================================
 
@@ -1208,8 +1666,9 @@ CM_TracePointThroughPatchCollide
 */
 static void CM_TracePointThroughPatchCollide(traceWork_t* tw, trace_t& trace, const patchCollide_s* pc)
 {
-	qboolean	frontFacing[MAX_PATCH_PLANES]{};
-	float		intersection[MAX_PATCH_PLANES]{};
+	qboolean	frontFacing[MAX_PATCH_PLANES];
+	float		intersection[MAX_PATCH_PLANES];
+	int			facetList[MAX_FACETS];
 	float		intersect;
 	const patchPlane_t* planes;
 	const facet_t* facet;
@@ -1226,6 +1685,11 @@ static void CM_TracePointThroughPatchCollide(traceWork_t* tw, trace_t& trace, co
 	}
 #endif
 
+	const int numFacets = CM_PatchFacetsInBounds(pc, tw->bounds, facetList);
+	if (!numFacets) {
+		return;
+	}
+
 	// determine the trace's relationship to all planes
 	planes = pc->planes;
 	for (i = 0; i < pc->num_planes; i++, planes++) {
@@ -1250,8 +1714,8 @@ static void CM_TracePointThroughPatchCollide(traceWork_t* tw, trace_t& trace, co
 	}
 
 	// see if any of the surface planes are intersected
-	facet = pc->facets;
-	for (i = 0; i < pc->numFacets; i++, facet++) {
+	for (i = 0; i < numFacets; i++) {
+		facet = &pc->facets[facetList[i]];
 		if (!frontFacing[facet->surfacePlane]) {
 			continue;
 		}
@@ -1363,6 +1827,7 @@ void CM_TraceThroughPatchCollide(traceWork_t* tw, trace_t& trace, const patchCol
 	patchPlane_t* planes;
 	facet_t* facet;
 	float plane[4] = { 0.0f }, bestplane[4] = { 0.0f };
+	int facetList[MAX_FACETS];
 #ifndef BSPC
 	static cvar_t* cv;
 #endif //BSPC
@@ -1384,8 +1849,9 @@ void CM_TraceThroughPatchCollide(traceWork_t* tw, trace_t& trace, const patchCol
 		return;
 	}
 	//
-	facet = pc->facets;
-	for (i = 0; i < pc->numFacets; i++, facet++) {
+	const int numFacets = CM_PatchFacetsInBounds(pc, tw->bounds, facetList);
+	for (i = 0; i < numFacets; i++) {
+		facet = &pc->facets[facetList[i]];
 		vec3_t endp;
 		vec3_t startp;
 		enterFrac = -1.0;
@@ -1514,12 +1980,15 @@ qboolean CM_PositionTestInPatchCollide(traceWork_t* tw, const patchCollide_s* pc
 	float offset, t;
 	float plane[4];
 
+	int facetList[MAX_FACETS];
+
 	if (tw->isPoint) {
 		return qfalse;
 	}
 	//
-	facet_t* facet = pc->facets;
-	for (int i = 0; i < pc->numFacets; i++, facet++) {
+	const int numFacets = CM_PatchFacetsInBounds(pc, tw->bounds, facetList);
+	for (int i = 0; i < numFacets; i++) {
+		const facet_t* facet = &pc->facets[facetList[i]];
 		vec3_t startp;
 		const patchPlane_t* planes = &pc->planes[facet->surfacePlane];
 		VectorCopy(planes->plane, plane);
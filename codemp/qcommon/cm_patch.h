@@ -78,6 +78,17 @@ using facet_t = struct facet_s
 	qboolean borderNoAdjust[4 + 6 + 16];
 };
 
+// bounding volume hierarchy over a patch's facets, so traces only look at the
+// facets near them.  children of a node are always stored next to each other
+#define	PATCH_BVH_LEAF_FACETS	4
+
+using patchBVHNode_t = struct patchBVHNode_s
+{
+	vec3_t bounds[2];
+	int first; // interior: index of the first child, leaf: first entry in facetOrder
+	int numFacets; // 0 for interior nodes
+};
+
 using patchCollide_t = struct patchCollide_s
 {
 	vec3_t bounds[2];
@@ -85,6 +96,9 @@ using patchCollide_t = struct patchCollide_s
 	patchPlane_t* planes;
 	int numFacets;
 	facet_t* facets;
+	int numNodes; // 0 if the patch is small enough to just test every facet
+	patchBVHNode_t* nodes;
+	int* facetOrder;
 };
 
 #define	MAX_GRID_SIZE	129
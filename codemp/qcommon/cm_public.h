@@ -69,6 +69,9 @@ int CM_WriteAreaBits(byte* buffer, int area);
 bool CM_GenericBoxCollide(const vec3pair_t abounds, const vec3pair_t bbounds);
 void CM_CalcExtents(const vec3_t start, const vec3_t end, const struct traceWork_s* tw, vec3pair_t bounds);
 
+// cm_trace.cpp
+void CM_ClipTest_f(void);
+
 // cm_tag.c
 int CM_LerpTag(orientation_t* tag, clip_handle_t model, int startFrame, int endFrame,
 	float frac, const char* tagName);
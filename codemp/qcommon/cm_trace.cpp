@@ -23,6 +23,13 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "cm_local.h"
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CM_CLIP_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <vector>
+
 // always use bbox vs. bbox collision and never capsule vs. bbox or vice versa
 //#define ALWAYS_BBOX_VS_BBOX
 // always use capsule vs. capsule collision and never capsule vs. bbox or vice versa
@@ -131,6 +138,100 @@ POSITION TESTING
 ===============================================================================
 */
 
+/*
+================
+CM_BoxOutsideBrushSides_Scalar
+
+True if the box is completely in front of one of the non-axial sides
+================
+*/
+static bool CM_BoxOutsideBrushSides_Scalar(const traceWork_t* tw, const cbrush_t* brush)
+{
+	// the first six planes are the axial planes, so we only
+	// need to test the remainder
+	for (int i = 6; i < brush->numsides; i++)
+	{
+		const cplane_t* plane = brush->sides[i].plane;
+
+		// adjust the plane distance appropriately for mins/maxs
+		const float dist = plane->dist - DotProduct(tw->offsets[plane->signbits], plane->normal);
+
+		const float d1 = DotProduct(tw->start, plane->normal) - dist;
+
+		// if completely in front of face, no intersection
+		if (d1 > 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+#ifdef CM_CLIP_SSE2
+/*
+================
+CM_SideBlockDistances
+
+Start and end distances to a block of sides, with the plane distances
+adjusted for mins/maxs. The sums run in the same order as DotProduct so
+the results match the scalar path bit for bit.
+================
+*/
+static inline void CM_SideBlockDistances(const traceWork_t* tw, const cbrushSideBlock_t* block, __m128& d1, __m128& d2)
+{
+	__m128 normal[3], offset = _mm_setzero_ps();
+
+	for (int j = 0; j < 3; j++)
+	{
+		normal[j] = _mm_loadu_ps(block->normal[j]);
+
+		const __m128 negative = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block->signMask[j])));
+		const __m128 size = _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(tw->size[1][j])),
+			_mm_andnot_ps(negative, _mm_set1_ps(tw->size[0][j])));
+
+		offset = j ? _mm_add_ps(offset, _mm_mul_ps(size, normal[j])) : _mm_mul_ps(size, normal[j]);
+	}
+
+	const __m128 dist = _mm_sub_ps(_mm_loadu_ps(block->dist), offset);
+
+	__m128 start = _mm_mul_ps(_mm_set1_ps(tw->start[0]), normal[0]);
+	__m128 end = _mm_mul_ps(_mm_set1_ps(tw->end[0]), normal[0]);
+	for (int j = 1; j < 3; j++)
+	{
+		start = _mm_add_ps(start, _mm_mul_ps(_mm_set1_ps(tw->start[j]), normal[j]));
+		end = _mm_add_ps(end, _mm_mul_ps(_mm_set1_ps(tw->end[j]), normal[j]));
+	}
+
+	d1 = _mm_sub_ps(start, dist);
+	d2 = _mm_sub_ps(end, dist);
+}
+
+/*
+================
+CM_BoxOutsideBrushSides
+================
+*/
+static bool CM_BoxOutsideBrushSides(const traceWork_t* tw, const cbrush_t* brush)
+{
+	// skip the six axial sides, which start two lanes into the second block
+	int skip = 6 % BRUSH_SIDE_BLOCK;
+
+	for (int first = 6 - skip; first < brush->numsides; first += BRUSH_SIDE_BLOCK, skip = 0)
+	{
+		__m128 d1, d2;
+		CM_SideBlockDistances(tw, &brush->sideBlocks[first / BRUSH_SIDE_BLOCK], d1, d2);
+
+		if (_mm_movemask_ps(_mm_cmpgt_ps(d1, _mm_setzero_ps())) >> skip)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+#else
+#define CM_BoxOutsideBrushSides CM_BoxOutsideBrushSides_Scalar
+#endif
+
 /*
 ================
 CM_TestBoxInBrush
@@ -191,26 +292,9 @@ void CM_TestBoxInBrush(traceWork_t* tw, trace_t& trace, cbrush_t* brush)
 			}
 		}
 	}
-	else
+	else if (CM_BoxOutsideBrushSides(tw, brush))
 	{
-		// the first six planes are the axial planes, so we only
-		// need to test the remainder
-		for (i = 6; i < brush->numsides; i++)
-		{
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// adjust the plane distance appropriately for mins/maxs
-			dist = plane->dist - DotProduct(tw->offsets[plane->signbits], plane->normal);
-
-			d1 = DotProduct(tw->start, plane->normal) - dist;
-
-			// if completely in front of face, no intersection
-			if (d1 > 0)
-			{
-				return;
-			}
-		}
+		return;
 	}
 
 	// inside this brush
@@ -477,24 +561,19 @@ void CM_TraceThroughPatch(traceWork_t * tw, trace_t & trace, cPatch_t * patch)
 
 /*
 ================
-CM_PlaneCollision
+CM_ClipToSide
 
+  Takes the start and end distances to one side of the brush.
   Returns false for a quick getout
 ================
 */
 
-bool CM_PlaneCollision(traceWork_t * tw, cbrushside_t * side)
+static inline bool CM_ClipToSide(traceWork_t * tw, cbrushside_t * side, const float d1, const float d2)
 {
 	float f;
 
 	cplane_t* plane = side->plane;
 
-	// adjust the plane distance appropriately for mins/maxs
-	const float dist = plane->dist - DotProduct(tw->offsets[plane->signbits], plane->normal);
-
-	const float d1 = DotProduct(tw->start, plane->normal) - dist;
-	const float d2 = DotProduct(tw->end, plane->normal) - dist;
-
 	if (d2 > 0.0f)
 	{
 		// endpoint is not in solid
@@ -559,6 +638,100 @@ bool CM_PlaneCollision(traceWork_t * tw, cbrushside_t * side)
 	return true;
 }
 
+/*
+================
+CM_PlaneCollision
+
+  Returns false for a quick getout
+================
+*/
+
+bool CM_PlaneCollision(traceWork_t * tw, cbrushside_t * side)
+{
+	const cplane_t* plane = side->plane;
+
+	// adjust the plane distance appropriately for mins/maxs
+	const float dist = plane->dist - DotProduct(tw->offsets[plane->signbits], plane->normal);
+
+	const float d1 = DotProduct(tw->start, plane->normal) - dist;
+	const float d2 = DotProduct(tw->end, plane->normal) - dist;
+
+	return CM_ClipToSide(tw, side, d1, d2);
+}
+
+/*
+================
+CM_ClipBrushSides_Scalar
+
+  Runs the trace against every side of the brush in order.
+  Returns false if the trace is completely outside the brush
+================
+*/
+static bool CM_ClipBrushSides_Scalar(traceWork_t * tw, const cbrush_t * brush)
+{
+	for (int i = 0; i < brush->numsides; i++)
+	{
+		if (!CM_PlaneCollision(tw, brush->sides + i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifdef CM_CLIP_SSE2
+/*
+================
+CM_ClipBrushSides
+
+  Same as CM_ClipBrushSides_Scalar, a block of sides at a time. Any side
+  the trace is completely in front of rejects the whole brush no matter
+  where it comes in the order, and sides the trace doesn't cross change
+  nothing, so only the crossed ones go through CM_ClipToSide, still in
+  side order so ties resolve the same way.
+================
+*/
+static bool CM_ClipBrushSides(traceWork_t * tw, const cbrush_t * brush)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 epsilon = _mm_set1_ps(SURFACE_CLIP_EPSILON);
+
+	for (int first = 0; first < brush->numsides; first += BRUSH_SIDE_BLOCK)
+	{
+		__m128 d1, d2;
+		CM_SideBlockDistances(tw, &brush->sideBlocks[first / BRUSH_SIDE_BLOCK], d1, d2);
+
+		const __m128 startOut = _mm_cmpgt_ps(d1, zero);
+		const __m128 front = _mm_and_ps(startOut, _mm_or_ps(_mm_cmpge_ps(d2, epsilon), _mm_cmpge_ps(d2, d1)));
+		if (_mm_movemask_ps(front))
+		{
+			return false;
+		}
+
+		int crossed = _mm_movemask_ps(_mm_or_ps(startOut, _mm_cmpgt_ps(d2, zero)));
+		if (!crossed)
+		{
+			continue;
+		}
+
+		float start[BRUSH_SIDE_BLOCK], end[BRUSH_SIDE_BLOCK];
+		_mm_storeu_ps(start, d1);
+		_mm_storeu_ps(end, d2);
+
+		for (int lane = 0; crossed; lane++, crossed >>= 1)
+		{
+			if (crossed & 1)
+			{
+				CM_ClipToSide(tw, brush->sides + first + lane, start[lane], end[lane]);
+			}
+		}
+	}
+	return true;
+}
+#else
+#define CM_ClipBrushSides CM_ClipBrushSides_Scalar
+#endif
+
 /*
 ================
 CM_TraceThroughBrush
@@ -598,14 +771,9 @@ void CM_TraceThroughBrush(traceWork_t * tw, trace_t & trace, cbrush_t * brush, c
 	// find the latest time the trace crosses a plane towards the interior
 	// and the earliest time the trace crosses a plane towards the exterior
 	//
-	for (int i = 0; i < brush->numsides; i++)
+	if (!CM_ClipBrushSides(tw, brush))
 	{
-		cbrushside_t* side = brush->sides + i;
-
-		if (!CM_PlaneCollision(tw, side))
-		{
-			return;
-		}
+		return;
 	}
 
 	//
@@ -1723,4 +1891,114 @@ bool CM_CullWorldBox(const cplane_t * frustum, const vec3pair_t bounds)
 	}
 
 	return CM_CullBox(frustum, transformed);
-}
\ No newline at end of file
+}
+#ifndef BSPC
+/*
+=================
+CM_ClipTest_f
+
+Runs random traces around brushes of the loaded map through the brush
+clip kernels and their scalar versions, and checks they agree exactly
+=================
+*/
+void CM_ClipTest_f(void)
+{
+	if (cmg.numBrushes <= 0)
+	{
+		Com_Printf("cm_clipTest: no map loaded\n");
+		return;
+	}
+
+	const int count = Cmd_Argc() > 1 ? Q_max(1, atoi(Cmd_Argv(1))) : 100000;
+
+	std::vector<traceWork_t> cases(count);
+	std::vector<const cbrush_t*> brushes(count);
+
+	for (int n = 0; n < count; n++)
+	{
+		traceWork_t& tw = cases[n];
+		const cbrush_t* brush;
+		do
+		{
+			brush = &cmg.brushes[irand(0, cmg.numBrushes - 1)];
+		} while (!brush->numsides);
+		brushes[n] = brush;
+
+		Com_Memset(&tw, 0, sizeof tw);
+
+		// points, small boxes and player sized ones
+		const int kind = irand(0, 2);
+		for (int i = 0; i < 3; i++)
+		{
+			const float half = kind == 0 ? 0.0f : kind == 1 ? flrand(1.0f, 8.0f) : i == 2 ? 24.0f : 15.0f;
+			tw.size[0][i] = -half;
+			tw.size[1][i] = half;
+			tw.start[i] = flrand(brush->bounds[0][i] - 64.0f, brush->bounds[1][i] + 64.0f);
+			tw.end[i] = irand(0, 3) ? flrand(brush->bounds[0][i] - 64.0f, brush->bounds[1][i] + 64.0f) : tw.start[i];
+		}
+		tw.isPoint = static_cast<qboolean>(kind == 0);
+
+		for (int i = 0; i < 8; i++)
+		{
+			tw.offsets[i][0] = tw.size[i & 1][0];
+			tw.offsets[i][1] = tw.size[i >> 1 & 1][1];
+			tw.offsets[i][2] = tw.size[i >> 2 & 1][2];
+		}
+	}
+
+	int mismatches = 0, hits = 0, inside = 0;
+	for (int n = 0; n < count; n++)
+	{
+		traceWork_t scalar = cases[n];
+		traceWork_t vec = cases[n];
+
+		scalar.enterFrac = vec.enterFrac = -1.0f;
+		scalar.leaveFrac = vec.leaveFrac = 1.0f;
+
+		const bool scalarClip = CM_ClipBrushSides_Scalar(&scalar, brushes[n]);
+		const bool vecClip = CM_ClipBrushSides(&vec, brushes[n]);
+
+		// when the brush is rejected nothing past the answer is used
+		if (scalarClip != vecClip
+			|| (scalarClip && (memcmp(&scalar.enterFrac, &vec.enterFrac, sizeof(float))
+				|| memcmp(&scalar.leaveFrac, &vec.leaveFrac, sizeof(float))
+				|| scalar.clipplane != vec.clipplane
+				|| scalar.leadside != vec.leadside
+				|| scalar.startout != vec.startout
+				|| scalar.getout != vec.getout)))
+		{
+			mismatches++;
+		}
+		hits += scalarClip && scalar.clipplane;
+
+		const bool scalarOut = CM_BoxOutsideBrushSides_Scalar(&cases[n], brushes[n]);
+		if (scalarOut != CM_BoxOutsideBrushSides(&cases[n], brushes[n]))
+		{
+			mismatches++;
+		}
+		inside += !scalarOut;
+	}
+
+	int msec = Sys_Milliseconds();
+	for (int n = 0; n < count; n++)
+	{
+		cases[n].enterFrac = -1.0f;
+		cases[n].leaveFrac = 1.0f;
+		CM_ClipBrushSides_Scalar(&cases[n], brushes[n]);
+	}
+	const int scalarMsec = Sys_Milliseconds() - msec;
+
+	msec = Sys_Milliseconds();
+	for (int n = 0; n < count; n++)
+	{
+		cases[n].enterFrac = -1.0f;
+		cases[n].leaveFrac = 1.0f;
+		CM_ClipBrushSides(&cases[n], brushes[n]);
+	}
+	const int vecMsec = Sys_Milliseconds() - msec;
+
+	Com_Printf("brush clip kernels: %s" S_COLOR_WHITE " (%i mismatches)\n", mismatches ? S_COLOR_RED "MISMATCH" : "match", mismatches);
+	Com_Printf("%i traces, %i clipped, %i boxes not outside the extra sides\n", count, hits, inside);
+	Com_Printf("scalar %i msec, vector %i msec\n", scalarMsec, vecMsec);
+}
+#endif
@@ -1291,6 +1291,7 @@ void Com_Init(char* commandLine)
 #endif
 		Cmd_AddCommand("writeconfig", Com_WriteConfig_f, "Write the configuration to file");
 		Cmd_SetCommandCompletionFunc("writeconfig", Cmd_CompleteCfgName);
+		Cmd_AddCommand("cm_clipTest", CM_ClipTest_f, "Check the brush clip kernels against the scalar path");
 
 		Com_ExecuteCfg();
 
@@ -1357,6 +1358,8 @@ void Com_Init(char* commandLine)
 
 		com_bootlogo = Cvar_Get("com_bootlogo", "1", CVAR_ARCHIVE_ND, "Show intro movies");
 
+		SD_Init();
+
 		s = va("%s %s %s", JK_VERSION_OLD, PLATFORM_STRING, SOURCE_DATE);
 		com_version = Cvar_Get("version", s, CVAR_ROM | CVAR_SERVERINFO);
 
@@ -297,6 +297,9 @@ static char		fs_temporaryFileNames[8][MAX_OSPATH];
 char lastValidBase[MAX_OSPATH];
 char lastValidGame[MAX_OSPATH];
 
+// paks the shared data store was filled from
+static uint32_t sharedDataPakSignature;
+
 #ifdef FS_MISSING
 FILE* missingFiles = NULL;
 #endif
@@ -1750,7 +1753,7 @@ CONVENIENCE FUNCTIONS FOR ENTIRE FILES
 ======================================================================================
 */
 
-int	FS_FileIsInPAK(const char* filename, int* pChecksum) {
+static const pack_t* FS_FindFileInPAK(const char* filename) {
 	long			hash = 0;
 
 	FS_AssertInitialised();
@@ -1768,7 +1771,7 @@ int	FS_FileIsInPAK(const char* filename, int* pChecksum) {
 	// The searchpaths do guarantee that something will always
 	// be prepended, so we don't need to worry about "c:" or "//limbo"
 	if (strstr(filename, "..") || strstr(filename, "::")) {
-		return -1;
+		return nullptr;
 	}
 
 	//
@@ -1793,16 +1796,45 @@ int	FS_FileIsInPAK(const char* filename, int* pChecksum) {
 			do {
 				// case and separator insensitive comparisons
 				if (!FS_FilenameCompare(pakFile->name, filename)) {
-					if (pChecksum) {
-						*pChecksum = pak->pure_checksum;
-					}
-					return 1;
+					return pak;
 				}
 				pakFile = pakFile->next;
 			} while (pakFile != nullptr);
 		}
 	}
-	return -1;
+	return nullptr;
+}
+
+int	FS_FileIsInPAK(const char* filename, int* pChecksum) {
+	const pack_t* pak = FS_FindFileInPAK(filename);
+
+	if (!pak) {
+		return -1;
+	}
+	if (pChecksum) {
+		*pChecksum = pak->pure_checksum;
+	}
+	return 1;
+}
+
+/*
+================
+FS_FilePakChecksum
+
+Same as FS_FileIsInPAK, but hands back the pak's own checksum, which unlike the
+pure checksum isn't salted with fs_checksumFeed and so stays the same between maps
+================
+*/
+int	FS_FilePakChecksum(const char* filename, int* pChecksum) {
+	const pack_t* pak = FS_FindFileInPAK(filename);
+
+	if (!pak) {
+		return -1;
+	}
+	if (pChecksum) {
+		*pChecksum = pak->checksum;
+	}
+	return 1;
 }
 
 /*
@@ -3710,6 +3742,15 @@ void FS_Restart(int checksumFeed) {
 		Com_Error(ERR_FATAL, "Couldn't load MD-MP-default.cfg");
 	}
 
+	// parsed files kept for game and cgame only hold for the paks they were read from
+	const char* paks = FS_LoadedPakChecksums();
+	const uint32_t pakSignature = Com_BlockChecksum(paks, strlen(paks)) ^
+		Com_BlockChecksum(fs_gamedirvar->string, strlen(fs_gamedirvar->string));
+	if (pakSignature != sharedDataPakSignature) {
+		SD_Flush();
+		sharedDataPakSignature = pakSignature;
+	}
+
 	if (Q_stricmp(fs_gamedirvar->string, lastValidGame)) {
 		// skip the MovieDuels-mpconfig.cfg if "safe" is on the command line
 		if (!Com_SafeMode()) {
@@ -91,4 +91,168 @@ const void* PD_Load(const char* name, size_t* size)
 	store->size = 0;
 
 	return data;
-}
\ No newline at end of file
+}
+/*
+Shared data store
+
+Parsed config files that game and cgame both load (animation.cfg, .sab, .veh, ...). The first module to get to one
+parses it and hands the result over with SD_Store; after that SD_Acquire gives out the same read-only copy, to the
+other module or to either of them after a map restart. Each acquire or store holds a reference until SD_Release.
+Unreferenced entries are kept around for the next map and only go when the loaded paks change.
+*/
+
+using sharedData_t = struct sharedData_t
+{
+	sharedData_t* next;
+	size_t size;
+	int refCount;
+	bool stale; // files changed under it, hand out no more references
+
+	char name[MAX_QPATH * 2];
+	// data follows
+};
+
+static sharedData_t* sharedData;
+static cvar_t* com_sharedData;
+
+static void* SD_Data(sharedData_t* entry)
+{
+	return reinterpret_cast<byte*>(entry) + ((sizeof(sharedData_t) + 15) & ~15);
+}
+
+static void SD_Free(sharedData_t* entry)
+{
+	for (sharedData_t** link = &sharedData; *link; link = &(*link)->next)
+	{
+		if (*link == entry)
+		{
+			*link = entry->next;
+			Z_Free(entry);
+			return;
+		}
+	}
+}
+
+static sharedData_t* SD_FindLive(const char* name)
+{
+	for (sharedData_t* entry = sharedData; entry; entry = entry->next)
+	{
+		if (!entry->stale && Q_stricmp(entry->name, name) == 0)
+		{
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+const void* SD_Acquire(const char* name, size_t* size)
+{
+	if (!com_sharedData || !com_sharedData->integer)
+	{
+		return nullptr;
+	}
+
+	sharedData_t* entry = SD_FindLive(name);
+	if (entry == nullptr)
+	{
+		return nullptr;
+	}
+
+	entry->refCount++;
+	if (size != nullptr)
+	{
+		*size = entry->size;
+	}
+
+	return SD_Data(entry);
+}
+
+const void* SD_Store(const char* name, const void* data, const size_t size)
+{
+	if (!com_sharedData || !com_sharedData->integer || strlen(name) >= sizeof sharedData->name)
+	{
+		return nullptr;
+	}
+
+	if (sharedData_t* old = SD_FindLive(name))
+	{
+		// a module parsed it again anyway, the newer copy wins
+		old->stale = true;
+		if (!old->refCount)
+		{
+			SD_Free(old);
+		}
+	}
+
+	const auto entry = static_cast<sharedData_t*>(Z_Malloc(static_cast<int>(((sizeof(sharedData_t) + 15) & ~15) + size),
+		TAG_SHARED_DATA, qfalse));
+	entry->size = size;
+	entry->refCount = 1;
+	entry->stale = false;
+	Q_strncpyz(entry->name, name, sizeof entry->name);
+	memcpy(SD_Data(entry), data, size);
+
+	entry->next = sharedData;
+	sharedData = entry;
+
+	return SD_Data(entry);
+}
+
+void SD_Release(const void* data)
+{
+	for (sharedData_t* entry = sharedData; entry; entry = entry->next)
+	{
+		if (SD_Data(entry) == data)
+		{
+			assert(entry->refCount > 0);
+			entry->refCount--;
+			if (!entry->refCount && entry->stale)
+			{
+				SD_Free(entry);
+			}
+			return;
+		}
+	}
+
+	assert(!"SD_Release: not shared data");
+}
+
+void SD_Flush(void)
+{
+	sharedData_t* entry = sharedData;
+	while (entry)
+	{
+		sharedData_t* next = entry->next;
+
+		entry->stale = true;
+		if (!entry->refCount)
+		{
+			SD_Free(entry);
+		}
+		entry = next;
+	}
+}
+
+static void SD_List_f(void)
+{
+	size_t total = 0;
+	int count = 0;
+
+	for (const sharedData_t* entry = sharedData; entry; entry = entry->next)
+	{
+		Com_Printf("%8i %2i%s %s\n", static_cast<int>(entry->size), entry->refCount, entry->stale ? "*" : " ",
+			entry->name);
+		total += entry->size;
+		count++;
+	}
+	Com_Printf("%i entries, %.1fKB (* = stale, goes once released)\n", count, total / 1024.0f);
+}
+
+void SD_Init(void)
+{
+	com_sharedData = Cvar_Get("com_sharedData", "1", CVAR_ARCHIVE_ND,
+		"Share parsed animation, saber, vehicle and NPC files between game and cgame and across maps");
+	Cmd_AddCommand("sharedDataList", SD_List_f, "List parsed files shared between game and cgame");
+	Cmd_AddCommand("sharedDataFlush", SD_Flush, "Drop parsed files shared between game and cgame");
+}
@@ -636,6 +636,9 @@ long FS_FOpenFileRead(const char* filename, fileHandle_t* file, qboolean uniqueF
 int FS_FileIsInPAK(const char* filename, int* pChecksum);
 // returns 1 if a file is in the PAK file, otherwise -1
 
+int FS_FilePakChecksum(const char* filename, int* pChecksum);
+// like FS_FileIsInPAK, but the checksum doesn't change with the map's checksum feed
+
 qboolean FS_FindPureDLL(const char* name);
 
 int FS_Write(const void* buffer, int len, fileHandle_t h);
@@ -1051,6 +1054,13 @@ inline int Round(const float value)
 bool PD_Store(const char* name, const void* data, size_t size);
 const void* PD_Load(const char* name, size_t* size);
 
+// Shared data store, parsed files game and cgame can both use
+void SD_Init(void);
+const void* SD_Acquire(const char* name, size_t* size);
+const void* SD_Store(const char* name, const void* data, size_t size);
+void SD_Release(const void* data);
+void SD_Flush(void);
+
 uint32_t ConvertUTF8ToUTF32(char* utf8CurrentChar, char** utf8NextChar);
 
 #include "sys/sys_public.h"
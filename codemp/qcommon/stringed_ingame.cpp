@@ -62,18 +62,28 @@ cvar_t* sp_leet = nullptr; // kept as 'sp_' for JK2 compat.
 
 using SE_Entry_t = struct SE_Entry_s
 {
+	std::string m_strReference; // eg "OBJECTIVES_GUARD_GOOD_TO_SEE_YOU"
 	std::string m_strString;
 	std::string m_strDebug;
 	// english and/or "#same", used for debugging only. Also prefixed by "SE:" to show which strings go through StringEd (ie aren't hardwired)
 	int m_iFlags;
+	SE_BOOL m_bLoaded; // SE_FALSE for a reference someone asked for a handle to that the current language doesn't have
+	int m_iHashNext; // next handle in the same hash bucket, 0 for none
 
 	SE_Entry_s()
 	{
 		m_iFlags = 0;
+		m_bLoaded = SE_FALSE;
+		m_iHashNext = 0;
 	}
 };
 
-using mapStringEntries_t = std::map<std::string, SE_Entry_t>;
+// entries are interned, so a reference keeps the same handle (its index + 1) for the life of the package,
+//	and a language change just empties them in place, leaving any handles the game is holding still good...
+//
+using vStringEntries_t = std::vector<SE_Entry_t>;
+
+#define iSE_MIN_HASH_BUCKETS	4096	// power of two, a full language is ~3000 references
 
 class CStringEdPackage
 {
@@ -96,7 +106,8 @@ public:
 		Clear(SE_FALSE);
 	}
 
-	mapStringEntries_t m_StringEntries; // needs to be in public space now
+	vStringEntries_t m_vEntries; // needs to be in public space now
+	vInts_t m_vHashBuckets; // ""
 	SE_BOOL m_bLoadDebug; // ""
 	//
 	// flag stuff...
@@ -110,6 +121,8 @@ public:
 	const char* ParseLine(const char* psLine);
 	int GetFlagMask(const char* psFlagName);
 	const char* ExtractLanguageFromPath(const char* psFileName) const;
+	int FindHandle(const char* psReference) const;
+	int InternHandle(const char* psReference);
 	SE_BOOL EndMarkerFoundDuringParse(void) const
 	{
 		return m_bEndMarkerFound_ParseOnly;
@@ -117,6 +130,8 @@ public:
 
 private:
 	void AddEntry(const char* psLocalReference);
+	static unsigned int HashReference(const char* psReference);
+	void Rehash(size_t iNumBuckets);
 	void SetString(const char* psLocalReference, const char* psNewString, SE_BOOL bEnglishDebug);
 	SE_BOOL SetReference(int iIndex, const char* psNewString);
 	void AddFlagReference(const char* psLocalReference, const char* psFlagName);
@@ -134,7 +149,23 @@ CStringEdPackage TheStringPackage;
 
 void CStringEdPackage::Clear(SE_BOOL bChangingLanguages)
 {
-	m_StringEntries.clear();
+	if (bChangingLanguages)
+	{
+		// keep every reference (and so every handle) and just empty the text, the new language fills them back in...
+		//
+		for (auto& Entry : m_vEntries)
+		{
+			Entry.m_strString.clear();
+			Entry.m_strDebug.clear();
+			Entry.m_iFlags = 0;
+			Entry.m_bLoaded = SE_FALSE;
+		}
+	}
+	else
+	{
+		m_vEntries.clear();
+		m_vHashBuckets.clear();
+	}
 
 	if (!bChangingLanguages)
 	{
@@ -461,10 +492,10 @@ void CStringEdPackage::AddFlagReference(const char* psLocalReference, const char
 	//
 	// then add the reference to this flag to the currently-parsed reference...
 	//
-	const auto itEntry = m_StringEntries.find(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
-	if (itEntry != m_StringEntries.end())
+	const int iHandle = FindHandle(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
+	if (iHandle)
 	{
-		SE_Entry_t& Entry = (*itEntry).second;
+		SE_Entry_t& Entry = m_vEntries[iHandle - 1];
 		Entry.m_iFlags |= iMask;
 	}
 }
@@ -731,16 +762,84 @@ const char* CStringEdPackage::GetCurrentReference_ParseOnly(void) const
 //
 void CStringEdPackage::AddEntry(const char* psLocalReference)
 {
-	// the reason I don't just assign it anyway is because the optional .STE override files don't contain flags,
+	// the reason I don't just reset it anyway is because the optional .STE override files don't contain flags,
 	//	and therefore would wipe out the parsed flags of the .STR file...
 	//
-	const auto itEntry = m_StringEntries.find(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
-	if (itEntry == m_StringEntries.end())
+	const int iHandle = InternHandle(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
+	m_vEntries[iHandle - 1].m_bLoaded = SE_TRUE;
+	m_strCurrentEntryRef_ParseOnly = psLocalReference;
+}
+
+// FNV-1a, case-sensitive just like the old std::map was...
+//
+unsigned int CStringEdPackage::HashReference(const char* psReference)
+{
+	unsigned int iHash = 2166136261u;
+	while (*psReference)
 	{
-		const SE_Entry_t SE_Entry;
-		m_StringEntries[va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference)] = SE_Entry;
+		iHash ^= static_cast<unsigned char>(*psReference++);
+		iHash *= 16777619u;
 	}
-	m_strCurrentEntryRef_ParseOnly = psLocalReference;
+	return iHash;
+}
+
+void CStringEdPackage::Rehash(const size_t iNumBuckets)
+{
+	m_vHashBuckets.assign(iNumBuckets, 0);
+	for (size_t i = 0; i < m_vEntries.size(); i++)
+	{
+		SE_Entry_t& Entry = m_vEntries[i];
+		int& iBucket = m_vHashBuckets[HashReference(Entry.m_strReference.c_str()) & (iNumBuckets - 1)];
+		Entry.m_iHashNext = iBucket;
+		iBucket = static_cast<int>(i) + 1;
+	}
+}
+
+// returns handle of reference, else 0 for not found...
+//
+int CStringEdPackage::FindHandle(const char* psReference) const
+{
+	if (m_vHashBuckets.empty())
+	{
+		return 0;
+	}
+
+	int iHandle = m_vHashBuckets[HashReference(psReference) & (m_vHashBuckets.size() - 1)];
+	while (iHandle)
+	{
+		const SE_Entry_t& Entry = m_vEntries[iHandle - 1];
+		if (!strcmp(Entry.m_strReference.c_str(), psReference))
+		{
+			break;
+		}
+		iHandle = Entry.m_iHashNext;
+	}
+	return iHandle;
+}
+
+// returns handle of reference, adding an (unloaded) entry for it first if it's not known yet...
+//
+int CStringEdPackage::InternHandle(const char* psReference)
+{
+	int iHandle = FindHandle(psReference);
+	if (!iHandle)
+	{
+		m_vEntries.emplace_back();
+		m_vEntries.back().m_strReference = psReference;
+		iHandle = static_cast<int>(m_vEntries.size());
+
+		if (m_vEntries.size() > m_vHashBuckets.size())
+		{
+			Rehash(m_vHashBuckets.empty() ? iSE_MIN_HASH_BUCKETS : m_vHashBuckets.size() * 2);
+		}
+		else
+		{
+			int& iBucket = m_vHashBuckets[HashReference(psReference) & (m_vHashBuckets.size() - 1)];
+			m_vEntries.back().m_iHashNext = iBucket;
+			iBucket = iHandle;
+		}
+	}
+	return iHandle;
 }
 
 const char* Leetify(const char* psString)
@@ -769,10 +868,10 @@ const char* Leetify(const char* psString)
 
 void CStringEdPackage::SetString(const char* psLocalReference, const char* psNewString, SE_BOOL bEnglishDebug)
 {
-	const auto itEntry = m_StringEntries.find(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
-	if (itEntry != m_StringEntries.end())
+	const int iHandle = FindHandle(va("%s_%s", m_strCurrentFileRef_ParseOnly.c_str(), psLocalReference));
+	if (iHandle)
 	{
-		SE_Entry_t& Entry = (*itEntry).second;
+		SE_Entry_t& Entry = m_vEntries[iHandle - 1];
 
 		if (bEnglishDebug || m_bLoadingEnglish_ParseOnly)
 		{
@@ -977,12 +1076,37 @@ const char* SE_GetString(const char* psPackageAndStringReference)
 	Q_strncpyz(sReference, psPackageAndStringReference, sizeof sReference);
 	Q_strupr(sReference);
 
-	const auto itEntry = TheStringPackage.m_StringEntries.find(sReference);
-	if (itEntry != TheStringPackage.m_StringEntries.end())
+	// (no interning here, people probe for references that may well not exist, eg debug-friendly key binds)
+	//
+	return SE_GetStringFromHandle(TheStringPackage.FindHandle(sReference));
+}
+
+// resolves a reference to a handle once so that anything asking for it every frame can skip the string work,
+//	handles stay good for the rest of the session, including across language changes. Returns 0 only for an empty
+//	reference, an unknown one is interned anyway and reads back as "" until a language that has it is loaded.
+//
+int SE_GetStringHandle(const char* psPackageAndStringReference)
+{
+	if (!psPackageAndStringReference || !psPackageAndStringReference[0])
 	{
-		const SE_Entry_t& Entry = (*itEntry).second;
+		return 0;
+	}
 
-		if (se_debug->integer && TheStringPackage.m_bLoadDebug)
+	char sReference[256]; // will always be enough, I've never seen one more than about 30 chars long
+	assert(strlen(psPackageAndStringReference) < sizeof sReference);
+	Q_strncpyz(sReference, psPackageAndStringReference, sizeof sReference);
+	Q_strupr(sReference);
+
+	return TheStringPackage.InternHandle(sReference);
+}
+
+const char* SE_GetStringFromHandle(const int iHandle)
+{
+	if (iHandle > 0 && iHandle <= static_cast<int>(TheStringPackage.m_vEntries.size()))
+	{
+		const SE_Entry_t& Entry = TheStringPackage.m_vEntries[iHandle - 1];
+
+		if (se_debug->integer && TheStringPackage.m_bLoadDebug && Entry.m_bLoaded)
 		{
 			return Entry.m_strDebug.c_str();
 		}
@@ -1008,12 +1132,18 @@ int SE_GetFlags(const char* psPackageReference, const char* psStringReference)
 
 int SE_GetFlags(const char* psPackageAndStringReference)
 {
-	const auto itEntry = TheStringPackage.m_StringEntries.find(psPackageAndStringReference);
-	if (itEntry != TheStringPackage.m_StringEntries.end())
-	{
-		const SE_Entry_t& Entry = (*itEntry).second;
+	return SE_GetFlagsFromHandle(TheStringPackage.FindHandle(psPackageAndStringReference));
+}
 
-		return Entry.m_iFlags;
+int SE_GetFlagsFromHandle(const int iHandle)
+{
+	if (iHandle > 0 && iHandle <= static_cast<int>(TheStringPackage.m_vEntries.size()))
+	{
+		const SE_Entry_t& Entry = TheStringPackage.m_vEntries[iHandle - 1];
+		if (Entry.m_bLoaded)
+		{
+			return Entry.m_iFlags;
+		}
 	}
 
 	// should never get here, but fall back anyway...
@@ -77,6 +77,14 @@ const char* SE_GetString(const char* psPackageAndStringReference);
 int SE_GetFlags(const char* psPackageReference, const char* psStringReference);
 int SE_GetFlags(const char* psPackageAndStringReference);
 //
+// interned versions of the above, resolve a reference once then look it up by handle every frame after that.
+//	Handles stay good for the whole session, language changes included. Only an empty reference gets 0, one that
+//	no language has still gets a handle, and that just reads back as "" (no flags) until a language has it...
+//
+int SE_GetStringHandle(const char* psPackageAndStringReference);
+const char* SE_GetStringFromHandle(int iHandle);
+int SE_GetFlagsFromHandle(int iHandle);
+//
 // general flag functions... (SEP_GetFlagMask() return should be used with SEP_GetFlags() return)
 //
 int SE_GetNumFlags(void);
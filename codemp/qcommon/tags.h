@@ -82,6 +82,7 @@ TAGDEF(VM_ALLOCATED),				// allocated by game or cgame via memory shifting
 TAGDEF(TEMP_HUNKALLOC),
 TAGDEF(AVI),
 TAGDEF(MINIZIP),
+TAGDEF(SHARED_DATA),				// parsed files shared between game and cgame, see SD_Store
 TAGDEF(COUNT)
 
 //////////////// eof //////////////
@@ -80,6 +80,12 @@ using zoneStats_t = struct zoneStats_s
 	//
 	int i_sizesPerTag[TAG_COUNT];
 	int iCountsPerTag[TAG_COUNT];
+
+	// running totals of Z_Malloc/Z_Free calls per tag, so allocation churn shows
+	//	up even when the number of live blocks stays flat...
+	//
+	int iAllocsPerTag[TAG_COUNT];
+	int iFreesPerTag[TAG_COUNT];
 };
 
 using zone_t = struct zone_s
@@ -300,6 +306,7 @@ void* Z_Malloc(const int iSize, const memtag_t eTag, const qboolean bZeroit, con
 	TheZone.Stats.iCount++;
 	TheZone.Stats.i_sizesPerTag[eTag] += iSize;
 	TheZone.Stats.iCountsPerTag[eTag]++;
+	TheZone.Stats.iAllocsPerTag[eTag]++;
 
 	if (TheZone.Stats.iCurrent > TheZone.Stats.iPeak)
 	{
@@ -373,6 +380,7 @@ static void Zone_FreeBlock(zoneHeader_t* pMemory)
 		TheZone.Stats.iCurrent -= pMemory->iSize;
 		TheZone.Stats.i_sizesPerTag[pMemory->eTag] -= pMemory->iSize;
 		TheZone.Stats.iCountsPerTag[pMemory->eTag]--;
+		TheZone.Stats.iFreesPerTag[pMemory->eTag]++;
 
 		// Sanity checks...
 		//
@@ -534,6 +542,19 @@ static void Z_Stats_f(void)
 		TheZone.Stats.iPeak,
 		static_cast<float>(TheZone.Stats.iPeak) / 1024.0f / 1024.0f
 	);
+
+	Com_Printf("%20s %9s %9s\n", "Zone Tag", "Allocs", "Frees");
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		if (TheZone.Stats.iAllocsPerTag[i] || TheZone.Stats.iFreesPerTag[i])
+		{
+			Com_Printf("%20s %9d %9d\n",
+				psTagStrings[i],
+				TheZone.Stats.iAllocsPerTag[i],
+				TheZone.Stats.iFreesPerTag[i]
+			);
+		}
+	}
 }
 
 // Gives a detailed breakdown of the memory blocks in the zone
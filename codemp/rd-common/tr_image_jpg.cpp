@@ -33,6 +33,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
  */
 
 #include <jpeglib.h>
+#include <csetjmp>
 
 static void R_JPGErrorExit(const j_common_ptr cinfo)
 {
@@ -269,12 +270,9 @@ static void init_destination(const j_compress_ptr cinfo)
 
 static boolean empty_output_buffer(const j_compress_ptr cinfo)
 {
-	const auto dest = reinterpret_cast<my_dest_ptr>(cinfo->dest);
-
-	jpeg_destroy_compress(cinfo);
-
-	// Make crash fatal or we would probably leak memory.
-	Com_Error(ERR_FATAL, "Output buffer for encoded JPEG image has insufficient size of %d bytes", dest->size);
+	// the buffer was sized for the whole image, so bail out of the encode (see R_JPGCompressErrorExit)
+	(*cinfo->err->error_exit)(reinterpret_cast<j_common_ptr>(cinfo));
+	return FALSE;
 }
 
 /*
@@ -317,19 +315,43 @@ static void jpegDest(const j_compress_ptr cinfo, byte* outfile, const int size)
 	dest->size = size;
 }
 
+/*
+* Compression errors unwind back to RE_SaveJPGToBuffer instead of calling
+* Com_Error, which isn't safe from the client's AVI encoder threads.
+*/
+
+typedef struct my_compress_error_mgr_s {
+	jpeg_error_mgr pub;	/* public fields */
+
+	jmp_buf setjmp_buffer;	/* for return to caller */
+} my_compress_error_mgr;
+
+static void R_JPGCompressErrorExit(const j_common_ptr cinfo)
+{
+	const auto err = reinterpret_cast<my_compress_error_mgr*>(cinfo->err);
+
+	longjmp(err->setjmp_buffer, 1);
+}
+
+static void R_JPGCompressOutputMessage(j_common_ptr cinfo)
+{
+	// compression warnings are dropped, printing isn't thread safe either
+}
+
 /*
 =================
 SaveJPGToBuffer
 
 Encodes JPEG from image in image_buffer and writes to buffer.
-Expects RGB input data
+Expects RGB input data. Returns 0 if the image couldn't be encoded,
+eg because it didn't fit in bufSize
 =================
 */
 size_t RE_SaveJPGToBuffer(byte* buffer, size_t bufSize, int quality,
 	int image_width, int image_height, byte* image_buffer, int padding)
 {
 	jpeg_compress_struct cinfo{};
-	jpeg_error_mgr jerr;
+	my_compress_error_mgr jerr;
 	JSAMPROW row_pointer[1]{};	/* pointer to JSAMPLE row[s] */
 	my_dest_ptr dest;
 	int row_stride;		/* physical row width in image buffer */
@@ -337,9 +359,15 @@ size_t RE_SaveJPGToBuffer(byte* buffer, size_t bufSize, int quality,
 
 	/* Step 1: allocate and initialize JPEG compression object */
 
-	cinfo.err = jpeg_std_error(&jerr);
-	cinfo.err->error_exit = R_JPGErrorExit;
-	cinfo.err->output_message = R_JPGOutputMessage;
+	cinfo.err = jpeg_std_error(&jerr.pub);
+	cinfo.err->error_exit = R_JPGCompressErrorExit;
+	cinfo.err->output_message = R_JPGCompressOutputMessage;
+
+	if (setjmp(jerr.setjmp_buffer)) {
+		/* the encode failed part way, clean up and report nothing written */
+		jpeg_destroy_compress(&cinfo);
+		return 0;
+	}
 
 	/* Now we can initialize the JPEG compression object. */
 	jpeg_create_compress(&cinfo);
@@ -400,7 +428,14 @@ void RE_SaveJPG(const char* filename, const int quality, const int image_width,
 	const auto out = static_cast<byte*>(Hunk_AllocateTempMemory(bufSize));
 
 	bufSize = RE_SaveJPGToBuffer(out, bufSize, quality, image_width, image_height, image_buffer, padding);
-	ri->FS_WriteFile(filename, out, bufSize);
+	if (bufSize)
+	{
+		ri->FS_WriteFile(filename, out, bufSize);
+	}
+	else
+	{
+		ri->Printf(PRINT_WARNING, "RE_SaveJPG: couldn't encode %s\n", filename);
+	}
 
 	Hunk_FreeTempMemory(out);
 }
\ No newline at end of file
@@ -30,7 +30,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "../qcommon/qcommon.h"
 #include "../ghoul2/ghoul2_shared.h"
 
-constexpr auto REF_API_VERSION = 20;
+constexpr auto REF_API_VERSION = 22;
 
 //
 // these are the functions exported by the refresh module
@@ -148,6 +148,8 @@ using refexport_t = struct refexport_s
 
 	// AVI recording
 	void (*TakeVideoFrame)(int h, int w, byte* captureBuffer, byte* encodeBuffer, qboolean motionJpeg);
+	size_t (*SaveJPGToBuffer)(byte* buffer, size_t bufSize, int quality, int image_width, int image_height,
+		byte* image_buffer, int padding); // safe to call from the client's capture threads, returns 0 if it fails
 
 	// G2 stuff
 	void (*InitSkins)(void);
@@ -332,6 +334,7 @@ using refimport_t = struct refimport_s
 	int (*FS_FOpenFileByMode)(const char* qpath, fileHandle_t* f, fsMode_t mode);
 	qboolean(*FS_FileExists)(const char* file);
 	int (*FS_FileIsInPAK)(const char* filename, int* pChecksum);
+	int (*FS_FilePakChecksum)(const char* filename, int* pChecksum); // not salted by the map's checksum feed
 	char** (*FS_ListFiles)(const char* directory, const char* extension, int* numfiles);
 	int (*FS_Write)(const void* buffer, int len, fileHandle_t f);
 	void (*FS_WriteFile)(const char* qpath, const void* buffer, int size);
@@ -351,6 +354,7 @@ using refimport_t = struct refimport_s
 	int (*CIN_PlayCinematic)(const char* arg0, int xpos, int ypos, int width, int height, int bits);
 	void (*CIN_UploadCinematic)(int handle);
 	void (*CL_WriteAVIVideoFrame)(const byte* imageBuffer, int size);
+	qboolean(*CL_QueueAVIVideoFrame)(const byte* pixels, int padding); // qfalse: encode it and CL_WriteAVIVideoFrame
 
 	// g2 data access
 	char* (*GetSharedMemory)(void); // cl.mSharedMemory
@@ -8,6 +8,7 @@
 //rww - RAGDOLL_END
 
 #include <set>
+#include <unordered_map>
 
 #ifdef _MSC_VER
 #pragma warning (push, 3)	//go back down to 3 for the stl include
@@ -219,6 +220,10 @@ void G2API_CleanEntAttachments(void)
 void CopyBoneCache(CBoneCache* to, CBoneCache* from);
 #endif
 
+#ifdef _G2_LISTEN_SERVER_OPT
+static void G2_ReleaseTransformedVerts(CGhoul2Info& info);
+#endif
+
 qboolean G2API_OverrideServerWithClientData(CGhoul2Info_v& ghoul2, int modelIndex)
 {
 #ifndef _G2_LISTEN_SERVER_OPT
@@ -262,6 +267,8 @@ qboolean G2API_OverrideServerWithClientData(CGhoul2Info_v& ghoul2, int modelInde
 	serverInstance->mModel = clientInstance->mModel;
 	serverInstance->mmodel_index = clientInstance->mmodel_index;
 	serverInstance->mSurfaceRoot = clientInstance->mSurfaceRoot;
+	//the client instance still owns its vert array, give back any the server had and borrow it without the flag
+	G2_ReleaseTransformedVerts(*serverInstance);
 	serverInstance->mTransformedVertsArray = clientInstance->mTransformedVertsArray;
 
 	if (!serverInstance->mBoneCache)
@@ -378,6 +385,187 @@ static size_t DeserializeGhoul2Info(const char* buffer, CGhoul2Info& g2Info) //r
 	return static_cast<size_t>(buffer - base);
 }
 
+// Recycles what a ghoul2 model instance allocates when it is set up, so NPC
+// spawns, thrown sabers and dismemberment reuse the bone/bolt/surface lists
+// and collision vert arrays of instances that went away instead of going to
+// the allocator each time. Lists are kept per model, vert arrays per surface
+// count, both with a fixed number of spares.
+#define G2_POOL_MAX_LISTS	64
+#define G2_POOL_MAX_VERTS	64
+
+class CGhoul2InfoPool
+{
+	struct lists_t
+	{
+		surfaceInfo_v	mSlist;
+		boltInfo_v		mBltlist;
+		boneInfo_v		mBlist;
+	};
+
+	std::unordered_map<qhandle_t, std::vector<lists_t>>	m_lists_;
+	std::unordered_map<int, std::vector<size_t*>>		m_transformedVerts_;
+
+public:
+	int		listsAllocated;
+	int		listsReused;
+	int		vertsAllocated;
+	int		vertsReused;
+
+	CGhoul2InfoPool() :
+		listsAllocated(0),
+		listsReused(0),
+		vertsAllocated(0),
+		vertsReused(0)
+	{
+	}
+
+	// takes back the collision vert array of an instance, only if it owns it (has GHOUL2_ZONETRANSALLOC), anything
+	// copied from another instance drops the flag so the array is only ever returned once
+	void ReleaseTransformedVerts(CGhoul2Info& info)
+	{
+		if ((info.mFlags & GHOUL2_ZONETRANSALLOC) && info.mTransformedVertsArray)
+		{
+			const int numSurfaces = info.currentModel && info.currentModel->data.glm ?
+				info.currentModel->data.glm->header->numSurfaces : 0;
+			std::vector<size_t*>& spares = m_transformedVerts_[numSurfaces];
+
+			if (numSurfaces && spares.size() < G2_POOL_MAX_VERTS)
+			{
+				spares.push_back(info.mTransformedVertsArray);
+			}
+			else
+			{
+				Z_Free(info.mTransformedVertsArray);
+			}
+		}
+		info.mTransformedVertsArray = nullptr;
+		info.mFlags &= ~GHOUL2_ZONETRANSALLOC;
+	}
+
+	// hands the lists of an instance that is going away back to the pool
+	void Release(CGhoul2Info& info)
+	{
+		ReleaseTransformedVerts(info);
+
+		if (!info.mModel || !info.mBlist.capacity())
+		{
+			info.mSlist.clear();
+			info.mBltlist.clear();
+			info.mBlist.clear();
+			return;
+		}
+
+		std::vector<lists_t>& spares = m_lists_[info.mModel];
+		if (spares.size() >= G2_POOL_MAX_LISTS)
+		{
+			info.mSlist.clear();
+			info.mBltlist.clear();
+			info.mBlist.clear();
+			return;
+		}
+
+		spares.emplace_back();
+		lists_t& lists = spares.back();
+
+		lists.mSlist.swap(info.mSlist);
+		lists.mBltlist.swap(info.mBltlist);
+		lists.mBlist.swap(info.mBlist);
+		lists.mSlist.clear();
+		lists.mBltlist.clear();
+		lists.mBlist.clear();
+	}
+
+	// gives a freshly set up model the lists of a previous instance of it
+	void Acquire(CGhoul2Info& info)
+	{
+		auto it = m_lists_.find(info.mModel);
+		if (it == m_lists_.end() || it->second.empty())
+		{
+			listsAllocated++;
+			return;
+		}
+
+		lists_t& lists = it->second.back();
+
+		info.mSlist.swap(lists.mSlist);
+		info.mBltlist.swap(lists.mBltlist);
+		info.mBlist.swap(lists.mBlist);
+		it->second.pop_back();
+
+		listsReused++;
+	}
+
+	size_t* AcquireTransformedVerts(const int numSurfaces)
+	{
+		auto it = m_transformedVerts_.find(numSurfaces);
+		if (it != m_transformedVerts_.end() && !it->second.empty())
+		{
+			size_t* verts = it->second.back();
+			it->second.pop_back();
+			memset(verts, 0, numSurfaces * sizeof(size_t));
+
+			vertsReused++;
+			return verts;
+		}
+
+		vertsAllocated++;
+		return static_cast<size_t*>(Z_Malloc(numSurfaces * sizeof(size_t), TAG_GHOUL2, qtrue));
+	}
+
+	void Clear()
+	{
+		for (auto& spares : m_transformedVerts_)
+		{
+			for (size_t* verts : spares.second)
+			{
+				Z_Free(verts);
+			}
+		}
+
+		m_transformedVerts_.clear();
+		m_lists_.clear();
+	}
+
+	void Print() const
+	{
+		size_t numLists = 0;
+		size_t numVerts = 0;
+
+		for (const auto& spares : m_lists_)
+		{
+			numLists += spares.second.size();
+		}
+		for (const auto& spares : m_transformedVerts_)
+		{
+			numVerts += spares.second.size();
+		}
+
+		Com_Printf("ghoul2 lists:       %6d reused %6d allocated %6d spare for %d models\n",
+			listsReused, listsAllocated, (int)numLists, (int)m_lists_.size());
+		Com_Printf("ghoul2 trans verts: %6d reused %6d allocated %6d spare\n",
+			vertsReused, vertsAllocated, (int)numVerts);
+	}
+};
+
+static CGhoul2InfoPool g2InfoPool;
+
+void G2_ShutdownInfoPool(void)
+{
+	g2InfoPool.Clear();
+}
+
+void G2_PoolInfo_f(void)
+{
+	g2InfoPool.Print();
+}
+
+#ifdef _G2_LISTEN_SERVER_OPT
+static void G2_ReleaseTransformedVerts(CGhoul2Info& info)
+{
+	g2InfoPool.ReleaseTransformedVerts(info);
+}
+#endif
+
 class Ghoul2InfoArray : public IGhoul2InfoArray
 {
 	std::vector<CGhoul2Info>	m_infos_[MAX_G2_MODELS];
@@ -392,6 +580,8 @@ class Ghoul2InfoArray : public IGhoul2InfoArray
 				RemoveBoneCache(m_infos_[idx][model].mBoneCache);
 				m_infos_[idx][model].mBoneCache = 0;
 			}
+
+			g2InfoPool.Release(m_infos_[idx][model]);
 		}
 
 		m_infos_[idx].clear();
@@ -832,6 +1022,7 @@ int G2API_InitGhoul2Model(CGhoul2Info_v** ghoul2Ptr, const char* file_name, cons
 	}
 	else
 	{
+		g2InfoPool.Acquire(ghoul2[model]);
 		G2_Init_Bone_List(ghoul2[model].mBlist, ghoul2[model].aHeader->numBones);
 		G2_Init_Bolt_List(ghoul2[model].mBltlist);
 		ghoul2[model].mCustomShader = customShader;
@@ -1006,9 +1197,7 @@ qboolean G2API_RemoveGhoul2Model(CGhoul2Info_v** ghlRemove, const int modelIndex
 		}
 
 		// clear out the vectors this model used.
-		ghlInfo[modelIndex].mBlist.clear();
-		ghlInfo[modelIndex].mBltlist.clear();
-		ghlInfo[modelIndex].mSlist.clear();
+		g2InfoPool.Release(ghlInfo[modelIndex]);
 
 		// set us to be the 'not active' state
 		ghlInfo[modelIndex].mmodel_index = -1;
@@ -2212,10 +2401,8 @@ void G2API_CollisionDetectCache(CollisionRecord_t* collRecMap, CGhoul2Info_v& gh
 					// reworked so we only alloc once!  if we have a pointer,
 					// but not a ghoul2_zonetransalloc flag, then that means it
 					// is a miniheap pointer. Just stomp over it.
-					int iSize =
-						g2.currentModel->data.glm->header->numSurfaces * 4;
-					g2.mTransformedVertsArray =
-						(size_t*)Z_Malloc(iSize, TAG_GHOUL2, qtrue);
+					g2.mTransformedVertsArray = g2InfoPool.AcquireTransformedVerts(
+						g2.currentModel->data.glm->header->numSurfaces);
 				}
 
 				g2.mFlags |= GHOUL2_ZONETRANSALLOC;
@@ -2480,7 +2667,11 @@ void G2API_CopySpecificG2Model(CGhoul2Info_v& ghoul2From, const int modelFrom, C
 				ghoul2To[modelTo].mBoneCache = 0;
 			}
 }
+		g2InfoPool.ReleaseTransformedVerts(ghoul2To[modelTo]);
 		ghoul2To[modelTo] = ghoul2From[modelFrom];
+		//the vert array still belongs to the source instance
+		ghoul2To[modelTo].mTransformedVertsArray = nullptr;
+		ghoul2To[modelTo].mFlags &= ~GHOUL2_ZONETRANSALLOC;
 
 #if 0
 		if (forceReconstruct)
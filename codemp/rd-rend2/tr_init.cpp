@@ -277,6 +277,10 @@ cvar_t* r_weather;
 
 cvar_t* r_patchStitching;
 
+cvar_t* r_shaderTextIndex;
+cvar_t* r_frontEndJobs;
+cvar_t* r_frontEndBench;
+
 extern void	RB_SetGL2D(void);
 static void R_Splash()
 {
@@ -1162,6 +1166,12 @@ const void* RB_TakeVideoFrameCmd(const void* data)
 	if (glConfig.deviceSupportsGamma)
 		R_GammaCorrect(cBuf, memcount);
 
+	// the client's capture threads encode it if it's queueing frames
+	if (ri->CL_QueueAVIVideoFrame(cBuf, padlen))
+	{
+		return (const void*)(cmd + 1);
+	}
+
 	if (cmd->motionJpeg)
 	{
 		memcount = RE_SaveJPGToBuffer(cmd->encodeBuffer, linelen * cmd->height,
@@ -1446,6 +1456,7 @@ static consoleCommand_t	commands[] = {
 	{ "gfxmeminfo",			GfxMemInfo_f },
 	{ "r_we",				R_WorldEffect_f },
 	{ "model_list",			R_model_list_f },
+	{ "g2poolinfo",			G2_PoolInfo_f },
 	{ "vbolist",			R_VBOList_f },
 	{ "capframes",			R_CaptureFrameData_f },
 	{ "r_weather",			R_WeatherEffect_f },
@@ -1689,6 +1700,10 @@ static void R_Register(void)
 	r_weather = ri->Cvar_Get("r_weather", "0", CVAR_ARCHIVE, "");
 
 	r_patchStitching = ri->Cvar_Get("r_patchStitching", "1", CVAR_ARCHIVE, "Enable stitching of neighbouring patch surfaces");
+
+	r_shaderTextIndex = ri->Cvar_Get("r_shaderTextIndex", "1", CVAR_ARCHIVE | CVAR_LATCH, "Save the shader name index between runs so unchanged pk3s are not rescanned");
+	r_frontEndJobs = ri->Cvar_Get("r_frontEndJobs", "1", CVAR_ARCHIVE | CVAR_LATCH, "Walk the world for every view of a scene on worker threads, 1 uses all cores, higher values set the thread count");
+	r_frontEndBench = ri->Cvar_Get("r_frontEndBench", "0", CVAR_CHEAT, "Time the world traversal of the next scene this many times, serial against view jobs");
 	/*
 	Ghoul2 Insert End
 	*/
@@ -2096,6 +2111,10 @@ void RE_Shutdown(const qboolean destroyWindow, const qboolean restarting)
 
 	R_IssuePendingRenderCommands();
 
+	R_ShutdownViewJobs();
+
+	G2_ShutdownInfoPool();
+
 	R_ShutdownBackEndFrameData();
 
 	R_ShutdownWeatherSystem();
@@ -2317,6 +2336,7 @@ extern "C" {
 		re.RegisterModels_LevelLoadEnd = C_Models_LevelLoadEnd;
 
 		re.TakeVideoFrame = RE_TakeVideoFrame;
+		re.SaveJPGToBuffer = RE_SaveJPGToBuffer;
 
 		re.InitSkins = R_InitSkins;
 		re.InitShaders = R_InitShaders;
@@ -254,6 +254,9 @@ extern int		max_polyverts;
 extern	cvar_t* r_aspectCorrectFonts;
 
 extern cvar_t* r_patchStitching;
+extern cvar_t* r_shaderTextIndex;
+extern cvar_t* r_frontEndJobs;
+extern cvar_t* r_frontEndBench;
 
 /*
 Ghoul2 Insert Start
@@ -2146,6 +2149,8 @@ int			R_LerpTag(orientation_t* tag, const qhandle_t handle, const int startFrame
 void		R_ModelBounds(qhandle_t handle, vec3_t mins, vec3_t maxs);
 
 void		R_model_list_f(void);
+void		G2_PoolInfo_f(void);
+void		G2_ShutdownInfoPool(void);
 
 //====================================================
 constexpr auto MAX_SKINS = 1024;
@@ -2822,6 +2827,7 @@ void R_AddPolygonSurfaces(const trRefdef_t* refdef);
 void R_DecomposeSort(uint32_t sort, int* entityNum, shader_t** shader, int* cubemap, int* postRender);
 uint32_t R_CreateSortKey(int entityNum, int sortedShaderIndex, int cubemapIndex, int postRender);
 void R_AddDrawSurf(surfaceType_t* surface, int entityNum, const shader_t* shader, int fogIndex, const int dlightMap, int postRender, int cubemap);
+qboolean R_FillDrawSurf(drawSurf_t* drawSurf, int viewFlags, int rdflags, surfaceType_t* surface, int entityNum, const shader_t* shader, int fogIndex, int dlightMap, int postRender, int cubemap);
 bool R_IsPostRenderEntity(const trRefEntity_t* refEntity);
 
 void R_CalcMikkTSpaceBSPSurface(int numSurfaces, packedVertex_t* vertices, glIndex_t* indices);
@@ -2838,6 +2844,7 @@ qboolean R_CalcTangentVectors(srfVert_t* dv[3]);
 #define	CULL_OUT	2		// completely outside the clipping planes
 void R_LocalNormalToWorld(const vec3_t local, vec3_t world);
 void R_LocalPointToWorld(const vec3_t local, vec3_t world);
+int R_CullBoxEx(vec3_t bounds[2], const cplane_t* frustum, int num_planes);
 int R_CullBox(vec3_t bounds[2]);
 int R_CullLocalBox(vec3_t bounds[2]);
 int R_CullPointAndRadiusEx(const vec3_t origin, float radius, const cplane_t* frustum, int num_planes);
@@ -3074,6 +3081,71 @@ qboolean R_inPVS(const vec3_t p1, const vec3_t p2, const byte* mask);
 /*
 ============================================================
 
+VIEW JOBS
+
+The world traversal of every view gathered by R_GatherFrameViews
+is independent work, so it is run up front on worker threads.
+Each job culls into its own drawsurf list which is merged into
+tr.refdef.drawSurfs when R_RenderView reaches that view, before
+the sort. Entities, polys and weather are still added serially.
+
+============================================================
+*/
+
+#define MAX_VIEWJOB_THREADS		8
+
+// surface light bits are written back on the main thread at merge time,
+// the backend reads them from the surface itself
+#define VJS_DLIGHTS		1
+#define VJS_PSHADOWS	2
+
+typedef struct viewJobSurface_s {
+	msurface_t* surf;
+	int				flags;
+	int				dlightBits;
+	int				pshadowBits;
+} viewJobSurface_t;
+
+typedef struct viewJob_s {
+	viewParms_t		viewParms;
+	int				visIndex;
+	int				visCount;
+	int				stamp;
+	int				planeBits;
+	int				dlightBits;
+	int				pshadowBits;
+	qboolean		pending;
+
+	int				c_leafs;
+	int				c_dlightSurfaces;
+	int				c_dlightSurfacesCulled;
+
+	std::vector<drawSurf_t>			drawSurfs;
+	std::vector<viewJobSurface_t>	litSurfaces;
+} viewJob_t;
+
+// per thread surface marks, stamped with viewJob_t::stamp
+typedef struct viewJobMarks_s {
+	std::vector<int>	surfacesViewCount;
+	std::vector<int>	surfacesDlightBits;
+	std::vector<int>	surfacesPshadowBits;
+	std::vector<int>	mergedSurfacesViewCount;
+	std::vector<int>	mergedSurfacesDlightBits;
+	std::vector<int>	mergedSurfacesPshadowBits;
+} viewJobMarks_t;
+
+void R_RunWorldViewJob(viewJob_t* job, viewJobMarks_t* marks);
+void R_MergeWorldViewJob(viewJob_t* job, viewParms_t* viewParms, trRefdef_t* refdef);
+
+void R_DispatchViewJobs(trRefdef_t* refdef);
+viewJob_t* R_GetViewJob(const viewParms_t* viewParms);
+void R_FinishViewJobs(void);
+void R_FrontEndBench(trRefdef_t* refdef, int iterations);
+void R_ShutdownViewJobs(void);
+
+/*
+============================================================
+
 FLARES
 
 ============================================================
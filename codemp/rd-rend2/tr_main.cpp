@@ -486,24 +486,22 @@ int R_CullLocalBox(vec3_t localBounds[2]) {
 
 /*
 =================
-R_CullBox
+R_CullBoxEx
 
 Returns CULL_IN, CULL_CLIP, or CULL_OUT
 =================
 */
-int R_CullBox(vec3_t worldBounds[2]) {
+int R_CullBoxEx(vec3_t worldBounds[2], const cplane_t* frustum, int num_planes) {
 	int             i;
-	cplane_t* frust;
+	const cplane_t* frust;
 	qboolean        anyClip;
-	int             r, num_planes;
-
-	num_planes = (tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 5 : 4;
+	int             r;
 
 	// check against frustum planes
 	anyClip = qfalse;
 	for (i = 0; i < num_planes; i++)
 	{
-		frust = &tr.viewParms.frustum[i];
+		frust = &frustum[i];
 
 		r = BoxOnPlaneSide(worldBounds[0], worldBounds[1], frust);
 
@@ -528,6 +526,17 @@ int R_CullBox(vec3_t worldBounds[2]) {
 	return CULL_CLIP;
 }
 
+/*
+=================
+R_CullBox
+
+Returns CULL_IN, CULL_CLIP, or CULL_OUT
+=================
+*/
+int R_CullBox(vec3_t worldBounds[2]) {
+	return R_CullBoxEx(worldBounds, tr.viewParms.frustum, (tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 5 : 4);
+}
+
 /*
 ** R_CullLocalPointAndRadius
 */
@@ -1771,50 +1780,68 @@ uint32_t R_CreateSortKey(int entityNum, int sortedShaderIndex, int cubemapIndex,
 
 /*
 =================
-R_AddDrawSurf
+R_FillDrawSurf
+
+Builds the drawsurf for a surface as seen from a view with the given
+flags. Returns qfalse if the surface is not drawn in that view.
+Only touches the passed in drawsurf, so view jobs can call it.
 =================
 */
-void R_AddDrawSurf(surfaceType_t* surface, int entityNum, const shader_t* shader, int fogIndex, const int dlightMap, int postRender, int cubemap)
+qboolean R_FillDrawSurf(drawSurf_t* drawSurf, int viewFlags, int rdflags, surfaceType_t* surface, int entityNum, const shader_t* shader, int fogIndex, int dlightMap, int postRender, int cubemap)
 {
-	int index;
-	drawSurf_t* surf;
-
-	if (tr.refdef.rdflags & RDF_NOFOG)
+	if (rdflags & RDF_NOFOG)
 	{
 		fogIndex = 0;
 	}
 
-	if ((shader->surfaceFlags & SURF_FORCESIGHT) && !(tr.refdef.rdflags & RDF_ForceSightOn))
+	if ((shader->surfaceFlags & SURF_FORCESIGHT) && !(rdflags & RDF_ForceSightOn))
 	{	//if shader is only seen with ForceSight and we don't have ForceSight on, then don't draw
-		return;
+		return qfalse;
 	}
 
-	if (tr.viewParms.flags & VPF_DEPTHSHADOW &&
+	if (viewFlags & VPF_DEPTHSHADOW &&
 		(postRender == qtrue || shader->sort != SS_OPAQUE))
 	{
-		return;
+		return qfalse;
 	}
 
-	// instead of checking for overflow, we just mask the index
-	// so it wraps around
-	index = tr.refdef.numDrawSurfs & DRAWSURF_MASK;
-	surf = tr.refdef.drawSurfs + index;
-	surf->surface = surface;
+	drawSurf->surface = surface;
 
-	if (tr.viewParms.flags & VPF_DEPTHSHADOW &&
+	if (viewFlags & VPF_DEPTHSHADOW &&
 		shader->useSimpleDepthShader == qtrue)
 	{
-		surf->sort = R_CreateSortKey(entityNum, tr.defaultShader->sortedIndex, 0, 0);
-		surf->dlightBits = 0;
-		surf->fogIndex = 0;
+		drawSurf->sort = R_CreateSortKey(entityNum, tr.defaultShader->sortedIndex, 0, 0);
+		drawSurf->dlightBits = 0;
+		drawSurf->fogIndex = 0;
 	}
 	else
 	{
-		surf->sort = R_CreateSortKey(entityNum, shader->sortedIndex, cubemap, postRender);
-		surf->dlightBits = dlightMap;
-		surf->fogIndex = fogIndex;
+		drawSurf->sort = R_CreateSortKey(entityNum, shader->sortedIndex, cubemap, postRender);
+		drawSurf->dlightBits = dlightMap;
+		drawSurf->fogIndex = fogIndex;
+	}
+
+	return qtrue;
+}
+
+/*
+=================
+R_AddDrawSurf
+=================
+*/
+void R_AddDrawSurf(surfaceType_t* surface, int entityNum, const shader_t* shader, int fogIndex, const int dlightMap, int postRender, int cubemap)
+{
+	drawSurf_t drawSurf;
+
+	if (!R_FillDrawSurf(&drawSurf, tr.viewParms.flags, tr.refdef.rdflags,
+		surface, entityNum, shader, fogIndex, dlightMap, postRender, cubemap))
+	{
+		return;
 	}
 
+	// instead of checking for overflow, we just mask the index
+	// so it wraps around
+	tr.refdef.drawSurfs[tr.refdef.numDrawSurfs & DRAWSURF_MASK] = drawSurf;
 	tr.refdef.numDrawSurfs++;
 }
 
@@ -567,6 +567,15 @@ void RE_RenderScene(const refdef_t* fd)
 		return;
 	}
 
+	if (r_frontEndBench->integer > 0)
+	{
+		R_FrontEndBench(&tr.refdef, r_frontEndBench->integer);
+		ri->Cvar_Set("r_frontEndBench", "0");
+	}
+
+	// walk the world for all the passes up front
+	R_DispatchViewJobs(&tr.refdef);
+
 	// Render all the passes
 	for (int i = 0; i < tr.numCachedViewParms; i++)
 	{
@@ -577,6 +586,8 @@ void RE_RenderScene(const refdef_t* fd)
 		R_EndTimedBlockCmd(timer);
 	}
 
+	R_FinishViewJobs();
+
 	if (!(fd->rdflags & RDF_NOWORLDMODEL))
 	{
 		qhandle_t timer = R_BeginTimedBlockCmd("Post processing");
@@ -21,6 +21,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 #include "tr_local.h"
 
+#include <atomic>
+#include <system_error>
+#include <thread>
+
 // tr_shader.c -- this file deals with the parsing and definition of shaders
 
 static char* s_shaderText;
@@ -4879,28 +4883,491 @@ void	R_ShaderList_f(void) {
 	ri->Printf(PRINT_ALL, "------------------\n");
 }
 
+/*
+====================
+Shader text index
+
+Every shader definition found in the .shader files is recorded as a
+(file, name offset, name hash) entry.  The files are validated and indexed
+on worker threads, which is why they use ShaderText_ParseToken below rather
+than COM_ParseExt (the latter keeps its state in globals).
+
+The index is saved to SHADERTEXT_INDEX_FILE so that on the next launch any
+file coming from an unchanged pk3 can skip the scan entirely.  Loose files
+have no checksum to key on, so they are always rescanned.
+====================
+*/
+#define SHADERTEXT_INDEX_FILE		"shadertext.idx"
+#define SHADERTEXT_INDEX_IDENT		(('X'<<24)+('D'<<16)+('I'<<8)+'S')
+#define SHADERTEXT_INDEX_VERSION	2
+
+constexpr auto MAX_SHADER_FILES = 8192;
+constexpr auto MAX_SHADERTEXT_THREADS = 8;
+
+struct shaderTextDef_t
+{
+	int		nameOffset;		// offset of the shader name token within its file
+	int		hash;			// generateHashValue( name, MAX_SHADERTEXT_HASH )
+};
+
+struct shaderTextFile_t
+{
+	char		filename[MAX_QPATH];
+	char*		buffer;
+	int			length;
+	int			pakChecksum;
+	qboolean	inPak;
+	qboolean	needsScan;
+	qboolean	valid;
+	std::string	messages;		// warnings raised by the scan, printed on the main thread
+	std::vector<shaderTextDef_t> defs;
+};
+
+struct shaderTextIndexHeader_t
+{
+	int		ident;
+	int		version;
+	int		hashSize;
+	int		numFiles;
+};
+
+struct shaderTextIndexFile_t
+{
+	char	filename[MAX_QPATH];
+	int		pakChecksum;
+	int		length;
+	int		numDefs;
+};
+
+/*
+====================
+ShaderText_ParseToken
+
+Reentrant equivalent of COM_ParseExt( data_p, qtrue ).  Returns NULL once the
+end of the data is reached, and tokenStart is set to the first character of
+the token (including the opening quote of a quoted string).
+====================
+*/
+static const char* ShaderText_ParseToken(const char* data, char* token, const int tokenSize, int* line, const char** tokenStart)
+{
+	int len = 0;
+
+	token[0] = '\0';
+
+	if (!data)
+	{
+		return NULL;
+	}
+
+	while (1)
+	{
+		// skip whitespace
+		while (*data <= ' ')
+		{
+			if (!*data)
+			{
+				return NULL;
+			}
+			if (*data == '\n')
+			{
+				(*line)++;
+			}
+			data++;
+		}
+
+		// skip double slash comments
+		if (data[0] == '/' && data[1] == '/')
+		{
+			data += 2;
+			while (*data && *data != '\n')
+			{
+				data++;
+			}
+		}
+		// skip /* */ comments
+		else if (data[0] == '/' && data[1] == '*')
+		{
+			data += 2;
+			while (*data && (*data != '*' || data[1] != '/'))
+			{
+				if (*data == '\n')
+				{
+					(*line)++;
+				}
+				data++;
+			}
+			if (*data)
+			{
+				data += 2;
+			}
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	*tokenStart = data;
+
+	// handle quoted strings
+	if (*data == '\"')
+	{
+		data++;
+		while (*data && *data != '\"')
+		{
+			if (*data == '\n')
+			{
+				(*line)++;
+			}
+			if (len < tokenSize - 1)
+			{
+				token[len++] = *data;
+			}
+			data++;
+		}
+		if (*data)
+		{
+			data++;
+		}
+		token[len] = '\0';
+		return data;
+	}
+
+	// parse a regular word
+	do
+	{
+		if (len < tokenSize - 1)
+		{
+			token[len++] = *data;
+		}
+		data++;
+	} while (*data > 32);
+
+	token[len] = '\0';
+	return data;
+}
+
+/*
+====================
+ShaderText_ScanFile
+
+Same structural check the single threaded loader used to do, so that one bad
+shader file cannot break all the others, while recording every definition.
+Runs on a worker thread: must not call into the engine.
+====================
+*/
+static void ShaderText_ScanFile(shaderTextFile_t* file)
+{
+	char token[MAX_TOKEN_CHARS];
+	char shader_name[MAX_QPATH];
+	char message[MAX_TOKEN_CHARS + MAX_QPATH * 2];
+	const char* p = file->buffer;
+	const char* tokenStart;
+	int line = 1;
+
+	file->valid = qtrue;
+	file->defs.clear();
+
+	while (1)
+	{
+		p = ShaderText_ParseToken(p, token, sizeof(token), &line, &tokenStart);
+		if (!token[0])
+		{
+			break;
+		}
+
+		Q_strncpyz(shader_name, token, sizeof(shader_name));
+		const int shaderLine = line;
+
+		if (token[0] == '#')
+		{
+			Com_sprintf(message, sizeof(message), "WARNING: Deprecated shader comment \"%s\" on line %d in file %s.  Ignoring line.\n",
+				shader_name, shaderLine, file->filename);
+			file->messages += message;
+			while (*p && *p != '\n')
+			{
+				p++;
+			}
+			continue;
+		}
+
+		shaderTextDef_t def;
+		def.nameOffset = tokenStart - file->buffer;
+		def.hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
+
+		p = ShaderText_ParseToken(p, token, sizeof(token), &line, &tokenStart);
+		if (token[0] != '{' || token[1] != '\0')
+		{
+			Com_sprintf(message, sizeof(message), "WARNING: Ignoring shader file %s. Shader \"%s\" on line %d missing opening brace",
+				file->filename, shader_name, shaderLine);
+			file->messages += message;
+			if (token[0])
+			{
+				Com_sprintf(message, sizeof(message), " (found \"%s\" on line %d)", token, line);
+				file->messages += message;
+			}
+			file->messages += ".\n";
+			file->valid = qfalse;
+			break;
+		}
+
+		int depth = 1;
+		do
+		{
+			p = ShaderText_ParseToken(p, token, sizeof(token), &line, &tokenStart);
+			if (token[0] && token[1] == '\0')
+			{
+				if (token[0] == '{')
+				{
+					depth++;
+				}
+				else if (token[0] == '}')
+				{
+					depth--;
+				}
+			}
+		} while (depth && p);
+
+		if (depth)
+		{
+			Com_sprintf(message, sizeof(message), "WARNING: Ignoring shader file %s. Shader \"%s\" on line %d missing closing brace.\n",
+				file->filename, shader_name, shaderLine);
+			file->messages += message;
+			file->valid = qfalse;
+			break;
+		}
+
+		file->defs.push_back(def);
+	}
+
+	if (!file->valid)
+	{
+		file->defs.clear();
+	}
+}
+
+/*
+====================
+ShaderText_ScanFiles
+
+Scans every file flagged as needing it, spread over up to
+MAX_SHADERTEXT_THREADS threads including the calling one.
+====================
+*/
+static void ShaderText_ScanFiles(shaderTextFile_t* files, const int numFiles)
+{
+	std::vector<shaderTextFile_t*> work;
+	for (int i = 0; i < numFiles; i++)
+	{
+		if (files[i].buffer && files[i].needsScan)
+		{
+			work.push_back(&files[i]);
+		}
+	}
+
+	if (work.empty())
+	{
+		return;
+	}
+
+	std::atomic<size_t> nextFile(0);
+	auto worker = [&work, &nextFile]()
+	{
+		size_t i;
+		while ((i = nextFile++) < work.size())
+		{
+			ShaderText_ScanFile(work[i]);
+		}
+	};
+
+	int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+	numThreads = Com_Clampi(1, MAX_SHADERTEXT_THREADS, numThreads);
+	numThreads = Q_min(numThreads, static_cast<int>(work.size()));
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < numThreads; i++)
+	{
+		try
+		{
+			threads.emplace_back(worker);
+		}
+		catch (const std::system_error&)
+		{
+			// whatever is left gets picked up by the threads we did get
+			break;
+		}
+	}
+
+	worker();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/*
+====================
+ShaderText_LoadIndex
+
+Reuses the saved definitions of every file that is still in the same pk3.
+====================
+*/
+static void ShaderText_LoadIndex(shaderTextFile_t* files, const int numFiles)
+{
+	byte* buffer;
+	const int length = ri->FS_ReadFile(SHADERTEXT_INDEX_FILE, (void**)&buffer);
+
+	if (!buffer)
+	{
+		return;
+	}
+
+	const byte* p = buffer;
+	const byte* end = buffer + length;
+	const auto* header = reinterpret_cast<const shaderTextIndexHeader_t*>(p);
+
+	if (length < static_cast<int>(sizeof(*header)) ||
+		header->ident != SHADERTEXT_INDEX_IDENT ||
+		header->version != SHADERTEXT_INDEX_VERSION ||
+		header->hashSize != MAX_SHADERTEXT_HASH)
+	{
+		ri->FS_FreeFile(buffer);
+		return;
+	}
+
+	p += sizeof(*header);
+
+	int matched = 0;
+	int cursor = 0;
+	for (int i = 0; i < header->numFiles; i++)
+	{
+		const auto* record = reinterpret_cast<const shaderTextIndexFile_t*>(p);
+		if (p + sizeof(*record) > end || record->numDefs < 0 ||
+			p + sizeof(*record) + record->numDefs * sizeof(shaderTextDef_t) > end)
+		{
+			break;
+		}
+
+		const auto* defs = reinterpret_cast<const shaderTextDef_t*>(p + sizeof(*record));
+		p += sizeof(*record) + record->numDefs * sizeof(shaderTextDef_t);
+
+		// both lists come out of FS_ListFiles, so they are normally in the same order
+		shaderTextFile_t* file = NULL;
+		for (int j = 0; j < numFiles; j++)
+		{
+			shaderTextFile_t* candidate = &files[(cursor + j) % numFiles];
+			if (!Q_stricmp(candidate->filename, record->filename))
+			{
+				file = candidate;
+				cursor = (cursor + j + 1) % numFiles;
+				break;
+			}
+		}
+
+		if (!file || !file->buffer || !file->inPak ||
+			file->pakChecksum != record->pakChecksum ||
+			file->length != record->length)
+		{
+			continue;
+		}
+
+		qboolean inRange = qtrue;
+		for (int j = 0; j < record->numDefs; j++)
+		{
+			if (defs[j].nameOffset < 0 || defs[j].nameOffset >= file->length ||
+				defs[j].hash < 0 || defs[j].hash >= MAX_SHADERTEXT_HASH)
+			{
+				inRange = qfalse;
+				break;
+			}
+		}
+
+		if (!inRange)
+		{
+			continue;
+		}
+
+		file->defs.assign(defs, defs + record->numDefs);
+		file->needsScan = qfalse;
+		file->valid = qtrue;
+		matched++;
+	}
+
+	ri->FS_FreeFile(buffer);
+
+	ri->Printf(PRINT_DEVELOPER, "...reused shader index for %d of %d files\n", matched, numFiles);
+}
+
+/*
+====================
+ShaderText_SaveIndex
+
+Only files from pk3s are written, since loose files are always rescanned.
+====================
+*/
+static void ShaderText_SaveIndex(const shaderTextFile_t* files, const int numFiles)
+{
+	std::vector<byte> out;
+	shaderTextIndexHeader_t header;
+
+	header.ident = SHADERTEXT_INDEX_IDENT;
+	header.version = SHADERTEXT_INDEX_VERSION;
+	header.hashSize = MAX_SHADERTEXT_HASH;
+	header.numFiles = 0;
+
+	out.resize(sizeof(header));
+
+	for (int i = 0; i < numFiles; i++)
+	{
+		const shaderTextFile_t* file = &files[i];
+		if (!file->buffer || !file->valid || !file->inPak)
+		{
+			continue;
+		}
+
+		shaderTextIndexFile_t record;
+		Com_Memset(&record, 0, sizeof(record));
+		Q_strncpyz(record.filename, file->filename, sizeof(record.filename));
+		record.pakChecksum = file->pakChecksum;
+		record.length = file->length;
+		record.numDefs = static_cast<int>(file->defs.size());
+
+		const byte* recordBytes = reinterpret_cast<const byte*>(&record);
+		out.insert(out.end(), recordBytes, recordBytes + sizeof(record));
+
+		if (!file->defs.empty())
+		{
+			const byte* defBytes = reinterpret_cast<const byte*>(file->defs.data());
+			out.insert(out.end(), defBytes, defBytes + file->defs.size() * sizeof(shaderTextDef_t));
+		}
+
+		header.numFiles++;
+	}
+
+	Com_Memcpy(out.data(), &header, sizeof(header));
+	ri->FS_WriteFile(SHADERTEXT_INDEX_FILE, out.data(), static_cast<int>(out.size()));
+}
+
 /*
 ====================
 ScanAndLoadShaderFiles
 
 Finds and loads all .shader files, combining them into
-a single large text block that can be scanned for shader names
+a single large text block, and indexes every shader name in it
 =====================
 */
-constexpr auto MAX_SHADER_FILES = 8192;
 static void ScanAndLoadShaderFiles()
 {
 	char** shader_files;
-	char* buffers[MAX_SHADER_FILES];
-	const char* p;
 	int numShaderFiles;
 	int i;
-	char* oldp, * token, * hashMem, * textEnd;
-	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], hash, size;
-	char shader_name[MAX_QPATH];
-	int shaderLine;
+	char* textEnd;
+	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], size;
+
+	long sum = 0;
+	const int startTime = ri->Milliseconds();
 
-	long sum = 0, summand;
 	// scan for shader files
 	shader_files = ri->FS_ListFiles("shaders", ".shader", &numShaderFiles);
 
@@ -4914,80 +5381,72 @@ static void ScanAndLoadShaderFiles()
 		numShaderFiles = MAX_SHADER_FILES;
 	}
 
-	// load and parse shader files
+	std::vector<shaderTextFile_t> files(numShaderFiles);
+
+	// load shader files, the filesystem is not thread safe
 	for (i = 0; i < numShaderFiles; i++)
 	{
-		char filename[MAX_QPATH];
+		shaderTextFile_t* file = &files[i];
 
 		// look for a .mtr file first
 		{
 			char* ext;
-			Com_sprintf(filename, sizeof(filename), "shaders/%s", shader_files[i]);
-			if ((ext = strrchr(filename, '.')))
+			Com_sprintf(file->filename, sizeof(file->filename), "shaders/%s", shader_files[i]);
+			if ((ext = strrchr(file->filename, '.')))
 			{
 				strcpy(ext, ".mtr");
 			}
 
-			if (ri->FS_ReadFile(filename, NULL) <= 0)
+			if (ri->FS_ReadFile(file->filename, NULL) <= 0)
 			{
-				Com_sprintf(filename, sizeof(filename), "shaders/%s", shader_files[i]);
+				Com_sprintf(file->filename, sizeof(file->filename), "shaders/%s", shader_files[i]);
 			}
 		}
 
-		ri->Printf(PRINT_DEVELOPER, "...loading '%s'\n", filename);
-		summand = ri->FS_ReadFile(filename, (void**)&buffers[i]);
+		ri->Printf(PRINT_DEVELOPER, "...loading '%s'\n", file->filename);
+		file->length = ri->FS_ReadFile(file->filename, (void**)&file->buffer);
 
-		if (!buffers[i])
-			ri->Error(ERR_DROP, "Couldn't load %s", filename);
+		if (!file->buffer)
+			ri->Error(ERR_DROP, "Couldn't load %s", file->filename);
 
-		// Do a simple check on the shader structure in that file to make sure one bad shader file cannot fuck up all other shaders.
-		p = buffers[i];
-		COM_BeginParseSession(filename);
-		while (1)
-		{
-			token = COM_ParseExt(&p, qtrue);
+		file->pakChecksum = 0;
+		file->inPak = (qboolean)(ri->FS_FilePakChecksum(file->filename, &file->pakChecksum) == 1);
+		file->needsScan = qtrue;
+		file->valid = qfalse;
+	}
 
-			if (!*token)
-				break;
+	// free up memory
+	ri->FS_FreeFileList(shader_files);
 
-			Q_strncpyz(shader_name, token, sizeof(shader_name));
-			shaderLine = COM_GetCurrentParseLine();
+	if (r_shaderTextIndex->integer)
+	{
+		ShaderText_LoadIndex(files.data(), numShaderFiles);
+	}
 
-			if (token[0] == '#')
-			{
-				ri->Printf(PRINT_WARNING, "WARNING: Deprecated shader comment \"%s\" on line %d in file %s.  Ignoring line.\n",
-					shader_name, shaderLine, filename);
-				SkipRestOfLine(&p);
-				continue;
-			}
+	int numScanned = 0;
+	for (i = 0; i < numShaderFiles; i++)
+	{
+		numScanned += files[i].needsScan ? 1 : 0;
+	}
 
-			token = COM_ParseExt(&p, qtrue);
-			if (token[0] != '{' || token[1] != '\0')
-			{
-				ri->Printf(PRINT_WARNING, "WARNING: Ignoring shader file %s. Shader \"%s\" on line %d missing opening brace",
-					filename, shader_name, shaderLine);
-				if (token[0])
-				{
-					ri->Printf(PRINT_WARNING, " (found \"%s\" on line %d)", token, COM_GetCurrentParseLine());
-				}
-				ri->Printf(PRINT_WARNING, ".\n");
-				ri->FS_FreeFile(buffers[i]);
-				buffers[i] = NULL;
-				break;
-			}
+	ShaderText_ScanFiles(files.data(), numShaderFiles);
 
-			if (!SkipBracedSection(&p, 1))
-			{
-				ri->Printf(PRINT_WARNING, "WARNING: Ignoring shader file %s. Shader \"%s\" on line %d missing closing brace.\n",
-					filename, shader_name, shaderLine);
-				ri->FS_FreeFile(buffers[i]);
-				buffers[i] = NULL;
-				break;
-			}
+	for (i = 0; i < numShaderFiles; i++)
+	{
+		shaderTextFile_t* file = &files[i];
+
+		if (!file->messages.empty())
+		{
+			ri->Printf(PRINT_WARNING, "%s", file->messages.c_str());
 		}
 
-		if (buffers[i])
-			sum += summand;
+		if (file->valid)
+			sum += file->length;
+	}
+
+	if (r_shaderTextIndex->integer && numScanned)
+	{
+		ShaderText_SaveIndex(files.data(), numShaderFiles);
 	}
 
 	// build single large buffer
@@ -4995,43 +5454,37 @@ static void ScanAndLoadShaderFiles()
 	s_shaderText[0] = '\0';
 	textEnd = s_shaderText;
 
-	// free in reverse order, so the temp files are all dumped
+	Com_Memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
+	size = 0;
+
+	// later files override earlier ones, so they go first
+	std::vector<char*> fileText(numShaderFiles, nullptr);
 	for (i = numShaderFiles - 1; i >= 0; i--)
 	{
-		if (!buffers[i])
-			continue;
+		shaderTextFile_t* file = &files[i];
 
-		strcat(textEnd, buffers[i]);
-		strcat(textEnd, "\n");
-		textEnd += strlen(textEnd);
-		ri->FS_FreeFile(buffers[i]);
-	}
-
-	COM_Compress(s_shaderText);
-
-	// free up memory
-	ri->FS_FreeFileList(shader_files);
-
-	Com_Memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
-	size = 0;
+		if (file->valid)
+		{
+			fileText[i] = textEnd;
+			Com_Memcpy(textEnd, file->buffer, file->length);
+			textEnd += file->length;
+			*textEnd++ = '\n';
+			*textEnd = '\0';
 
-	p = s_shaderText;
-	// look for shader names
-	while (1) {
-		token = COM_ParseExt(&p, qtrue);
-		if (token[0] == 0) {
-			break;
+			for (const auto& def : file->defs)
+			{
+				shaderTextHashTableSizes[def.hash]++;
+				size++;
+			}
 		}
 
-		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
-		shaderTextHashTableSizes[hash]++;
-		size++;
-		SkipBracedSection(&p, 0);
+		ri->FS_FreeFile(file->buffer);
+		file->buffer = NULL;
 	}
 
 	size += MAX_SHADERTEXT_HASH;
 
-	hashMem = (char*)ri->Hunk_Alloc(size * sizeof(char*), h_low);
+	char* hashMem = (char*)ri->Hunk_Alloc(size * sizeof(char*), h_low);
 
 	for (i = 0; i < MAX_SHADERTEXT_HASH; i++) {
 		shaderTextHashTable[i] = (char**)hashMem;
@@ -5040,22 +5493,21 @@ static void ScanAndLoadShaderFiles()
 
 	Com_Memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
 
-	p = s_shaderText;
-	// look for shader names
-	while (1) {
-		oldp = (char*)p;
-		token = COM_ParseExt(&p, qtrue);
-		if (token[0] == 0) {
-			break;
+	for (i = numShaderFiles - 1; i >= 0; i--)
+	{
+		if (!fileText[i])
+		{
+			continue;
 		}
 
-		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
-		shaderTextHashTable[hash][shaderTextHashTableSizes[hash]++] = oldp;
-
-		SkipBracedSection(&p, 0);
+		for (const auto& def : files[i].defs)
+		{
+			shaderTextHashTable[def.hash][shaderTextHashTableSizes[def.hash]++] = fileText[i] + def.nameOffset;
+		}
 	}
 
-	return;
+	ri->Printf(PRINT_DEVELOPER, "...indexed %d shaders from %d files (%d scanned) in %d msec\n",
+		size - MAX_SHADERTEXT_HASH, numShaderFiles, numScanned, ri->Milliseconds() - startTime);
 }
 
 shader_t* R_CreateShaderFromTextureBundle(
@@ -0,0 +1,535 @@
+/*
+===========================================================================
+Copyright (C) 1999 - 2005, Id Software, Inc.
+Copyright (C) 2000 - 2013, Raven Software, Inc.
+Copyright (C) 2001 - 2013, Activision, Inc.
+Copyright (C) 2013 - 2015, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// tr_viewjobs.cpp -- runs the world traversal of every view gathered for
+// a scene on worker threads before the views are rendered
+
+#include "tr_local.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+static viewJob_t		viewJobs[ARRAY_LEN(tr.cachedViewParms)];
+static viewJobMarks_t	viewJobMarks[MAX_VIEWJOB_THREADS];
+static int				numViewJobs;
+static qboolean			viewJobsActive;
+static int				viewJobStamp;
+
+static struct viewJobPool_s {
+	std::thread				threads[MAX_VIEWJOB_THREADS - 1];
+	int						numThreads;
+	qboolean				started;
+
+	std::mutex				mutex;
+	std::condition_variable	wake;
+	std::condition_variable	done;
+	int						generation;
+	int						busy;
+	bool					quit;
+
+	std::atomic<int>		nextJob;
+} viewJobPool;
+
+/*
+====================
+R_RunViewJobs
+
+Pulls views off the shared counter until all of them are taken
+====================
+*/
+static void R_RunViewJobs(viewJobMarks_t* marks)
+{
+	for (;;)
+	{
+		const int i = viewJobPool.nextJob++;
+		if (i >= numViewJobs)
+		{
+			break;
+		}
+
+		if (viewJobs[i].pending)
+		{
+			R_RunWorldViewJob(&viewJobs[i], marks);
+		}
+	}
+}
+
+static void R_ViewJobThread(int threadNum, int generation)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(viewJobPool.mutex);
+			viewJobPool.wake.wait(lock, [generation] {
+				return viewJobPool.quit || viewJobPool.generation != generation;
+			});
+
+			if (viewJobPool.quit)
+			{
+				return;
+			}
+
+			generation = viewJobPool.generation;
+		}
+
+		R_RunViewJobs(&viewJobMarks[threadNum]);
+
+		{
+			std::lock_guard<std::mutex> lock(viewJobPool.mutex);
+			if (--viewJobPool.busy == 0)
+			{
+				viewJobPool.done.notify_one();
+			}
+		}
+	}
+}
+
+/*
+====================
+R_StartViewJobThreads
+
+r_frontEndJobs 1 uses one thread per core, higher values
+give the thread count including the main thread
+====================
+*/
+static void R_StartViewJobThreads(void)
+{
+	int numThreads = r_frontEndJobs->integer;
+
+	viewJobPool.started = qtrue;
+	viewJobPool.numThreads = 0;
+	viewJobPool.quit = false;
+
+	if (numThreads == 1)
+	{
+		numThreads = (int)std::thread::hardware_concurrency();
+	}
+	numThreads = Com_Clampi(1, MAX_VIEWJOB_THREADS, numThreads);
+
+	for (int i = 1; i < numThreads; i++)
+	{
+		try
+		{
+			viewJobPool.threads[i - 1] = std::thread(R_ViewJobThread, i, viewJobPool.generation);
+		}
+		catch (const std::system_error&)
+		{
+			break;
+		}
+		viewJobPool.numThreads++;
+	}
+
+	ri->Printf(PRINT_DEVELOPER, "Front end view jobs using %i threads\n", viewJobPool.numThreads + 1);
+}
+
+/*
+====================
+R_ShutdownViewJobs
+====================
+*/
+void R_ShutdownViewJobs(void)
+{
+	if (!viewJobPool.started)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(viewJobPool.mutex);
+		viewJobPool.quit = true;
+	}
+	viewJobPool.wake.notify_all();
+
+	for (int i = 0; i < viewJobPool.numThreads; i++)
+	{
+		viewJobPool.threads[i].join();
+	}
+
+	viewJobPool.numThreads = 0;
+	viewJobPool.started = qfalse;
+	viewJobsActive = qfalse;
+	numViewJobs = 0;
+
+	for (int i = 0; i < MAX_VIEWJOB_THREADS; i++)
+	{
+		viewJobMarks[i] = viewJobMarks_t();
+	}
+
+	for (int i = 0; i < (int)ARRAY_LEN(viewJobs); i++)
+	{
+		viewJobs[i].drawSurfs = std::vector<drawSurf_t>();
+		viewJobs[i].litSurfaces = std::vector<viewJobSurface_t>();
+	}
+}
+
+/*
+====================
+R_SizeViewJobMarks
+
+The marks are stamped with a per view number, so they only need
+clearing when the stamp wraps
+====================
+*/
+static void R_SizeViewJobMarks(const world_t* world, qboolean clear)
+{
+	for (int i = 0; i <= viewJobPool.numThreads; i++)
+	{
+		viewJobMarks_t* marks = &viewJobMarks[i];
+
+		if (clear)
+		{
+			std::fill(marks->surfacesViewCount.begin(), marks->surfacesViewCount.end(), 0);
+			std::fill(marks->mergedSurfacesViewCount.begin(), marks->mergedSurfacesViewCount.end(), 0);
+		}
+
+		if ((int)marks->surfacesViewCount.size() < world->numsurfaces)
+		{
+			marks->surfacesViewCount.resize(world->numsurfaces, 0);
+			marks->surfacesDlightBits.resize(world->numsurfaces, 0);
+			marks->surfacesPshadowBits.resize(world->numsurfaces, 0);
+		}
+
+		if ((int)marks->mergedSurfacesViewCount.size() < world->numMergedSurfaces)
+		{
+			marks->mergedSurfacesViewCount.resize(world->numMergedSurfaces, 0);
+			marks->mergedSurfacesDlightBits.resize(world->numMergedSurfaces, 0);
+			marks->mergedSurfacesPshadowBits.resize(world->numMergedSurfaces, 0);
+		}
+	}
+}
+
+/*
+====================
+R_DispatchViewJobs
+
+Sets up a job for every cached view of the scene and runs the world
+traversals across the thread pool. Returns once all of them are done,
+R_RenderView then merges each job when it gets to that view.
+====================
+*/
+void R_DispatchViewJobs(trRefdef_t* refdef)
+{
+	viewJobsActive = qfalse;
+	numViewJobs = 0;
+
+	if (!r_frontEndJobs->integer || !r_drawworld->integer || !tr.world ||
+		(refdef->rdflags & RDF_NOWORLDMODEL))
+	{
+		return;
+	}
+
+	if (!viewJobPool.started)
+	{
+		R_StartViewJobThreads();
+	}
+
+	// same clamps as R_AddWorldSurfaces, before anything reads them
+	refdef->num_dlights = Q_min(refdef->num_dlights, 32);
+	refdef->num_pshadows = Q_min(refdef->num_pshadows, 32);
+
+	qboolean clearMarks = qfalse;
+	if (viewJobStamp > INT_MAX - (int)ARRAY_LEN(viewJobs))
+	{
+		viewJobStamp = 0;
+		clearMarks = qtrue;
+	}
+	R_SizeViewJobMarks(tr.world, clearMarks);
+
+	// the PVS marking has to happen in view order on this thread,
+	// each view keeps the vis slot it ended up with
+	const viewParms_t savedViewParms = tr.viewParms;
+	for (int i = 0; i < tr.numCachedViewParms; i++)
+	{
+		const viewParms_t* parms = &tr.cachedViewParms[i];
+		viewJob_t* job = &viewJobs[i];
+
+		job->pending = qfalse;
+
+		if (parms->viewportWidth <= 0 || parms->viewportHeight <= 0)
+			continue;
+
+		// player shadows only draw their entity
+		if (parms->viewParmType == VPT_PLAYER_SHADOWS)
+			continue;
+
+		job->viewParms = *parms;
+		job->stamp = ++viewJobStamp;
+		job->planeBits = (parms->flags & VPF_FARPLANEFRUSTUM) ? 31 : 15;
+
+		if (parms->flags & VPF_DEPTHSHADOW)
+		{
+			job->dlightBits = 0;
+			job->pshadowBits = 0;
+		}
+		else
+		{
+			tr.viewParms = *parms;
+			R_MarkLeaves();
+
+			job->dlightBits = (1 << refdef->num_dlights) - 1;
+			if (r_shadows->integer == 4)
+				job->pshadowBits = (1 << refdef->num_pshadows) - 1;
+			else
+				job->pshadowBits = 0;
+		}
+
+		job->visIndex = tr.visIndex;
+		job->visCount = tr.visCounts[tr.visIndex];
+		job->pending = qtrue;
+	}
+	tr.viewParms = savedViewParms;
+
+	// with more distinct clusters than vis slots a later view can
+	// reuse the slot of an earlier one, leave those scenes serial
+	for (int i = 0; i < tr.numCachedViewParms; i++)
+	{
+		const viewJob_t* job = &viewJobs[i];
+
+		if (job->pending && !(job->viewParms.flags & VPF_DEPTHSHADOW) &&
+			tr.visCounts[job->visIndex] != job->visCount)
+		{
+			for (int j = 0; j < tr.numCachedViewParms; j++)
+			{
+				viewJobs[j].pending = qfalse;
+			}
+			return;
+		}
+	}
+
+	numViewJobs = tr.numCachedViewParms;
+	viewJobPool.nextJob = 0;
+
+	if (viewJobPool.numThreads)
+	{
+		{
+			std::lock_guard<std::mutex> lock(viewJobPool.mutex);
+			viewJobPool.busy = viewJobPool.numThreads;
+			viewJobPool.generation++;
+		}
+		viewJobPool.wake.notify_all();
+	}
+
+	R_RunViewJobs(&viewJobMarks[0]);
+
+	if (viewJobPool.numThreads)
+	{
+		std::unique_lock<std::mutex> lock(viewJobPool.mutex);
+		viewJobPool.done.wait(lock, [] { return viewJobPool.busy == 0; });
+	}
+
+	viewJobsActive = qtrue;
+}
+
+/*
+====================
+R_GetViewJob
+
+Returns the finished traversal for a cached view, or NULL if the
+view has to be walked by R_AddWorldSurfaces itself
+====================
+*/
+viewJob_t* R_GetViewJob(const viewParms_t* viewParms)
+{
+	if (!viewJobsActive)
+	{
+		return NULL;
+	}
+
+	const int i = viewParms->currentViewParm;
+	if (i < 0 || i >= numViewJobs)
+	{
+		return NULL;
+	}
+
+	viewJob_t* job = &viewJobs[i];
+	if (!job->pending ||
+		job->viewParms.flags != viewParms->flags ||
+		!VectorCompare(job->viewParms.ori.origin, viewParms->ori.origin))
+	{
+		return NULL;
+	}
+
+	return job;
+}
+
+/*
+====================
+R_FinishViewJobs
+====================
+*/
+void R_FinishViewJobs(void)
+{
+	for (int i = 0; i < numViewJobs; i++)
+	{
+		viewJobs[i].pending = qfalse;
+	}
+
+	viewJobsActive = qfalse;
+	numViewJobs = 0;
+}
+
+static uint32_t R_HashDrawSurfs(const drawSurf_t* drawSurfs, int numDrawSurfs)
+{
+	uint32_t hash = 2166136261u;
+
+	for (int i = 0; i < numDrawSurfs; i++)
+	{
+		const drawSurf_t* drawSurf = drawSurfs + (i & DRAWSURF_MASK);
+		const uint32_t values[4] = {
+			drawSurf->sort,
+			drawSurf->dlightBits,
+			(uint32_t)(intptr_t)drawSurf->surface,
+			(uint32_t)drawSurf->fogIndex };
+
+		for (int j = 0; j < 4; j++)
+		{
+			hash = (hash ^ values[j]) * 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+/*
+====================
+R_FrontEndBench
+
+Set r_frontEndBench to a number of iterations to time the world
+traversal of the next scene, serial against the view jobs, and check
+both produce the same drawsurfs. Nothing is submitted to the backend,
+with r_skipBackEnd 1 as well the GPU does no work for the frame.
+====================
+*/
+void R_FrontEndBench(trRefdef_t* refdef, int iterations)
+{
+	if (!tr.world || (refdef->rdflags & RDF_NOWORLDMODEL))
+	{
+		ri->Printf(PRINT_ALL, "r_frontEndBench: no world in this scene\n");
+		return;
+	}
+
+	const int numViews = tr.numCachedViewParms;
+	std::vector<drawSurf_t> scratch(MAX_DRAWSURFS);
+	std::vector<int> serialCounts(numViews, -1);
+	std::vector<uint32_t> serialHashes(numViews, 0);
+	std::vector<int> jobCounts(numViews, -1);
+	std::vector<uint32_t> jobHashes(numViews, 0);
+
+	drawSurf_t* savedDrawSurfs = refdef->drawSurfs;
+	const int savedNumDrawSurfs = refdef->numDrawSurfs;
+	const viewParms_t savedViewParms = tr.viewParms;
+	const orientationr_t savedOri = tr.ori;
+
+	refdef->drawSurfs = scratch.data();
+
+	int startTime = ri->Milliseconds();
+	for (int iter = 0; iter < iterations; iter++)
+	{
+		for (int i = 0; i < numViews; i++)
+		{
+			const viewParms_t* parms = &tr.cachedViewParms[i];
+
+			if (parms->viewportWidth <= 0 || parms->viewportHeight <= 0 ||
+				parms->viewParmType == VPT_PLAYER_SHADOWS)
+				continue;
+
+			tr.viewCount++;
+			tr.viewParms = *parms;
+			refdef->numDrawSurfs = 0;
+			R_AddWorldSurfaces(&tr.viewParms, refdef);
+
+			serialCounts[i] = refdef->numDrawSurfs;
+			serialHashes[i] = R_HashDrawSurfs(refdef->drawSurfs, refdef->numDrawSurfs);
+		}
+	}
+	const int serialMsec = ri->Milliseconds() - startTime;
+
+	startTime = ri->Milliseconds();
+	for (int iter = 0; iter < iterations; iter++)
+	{
+		R_DispatchViewJobs(refdef);
+
+		for (int i = 0; i < numViews; i++)
+		{
+			viewJob_t* job = R_GetViewJob(&tr.cachedViewParms[i]);
+			if (!job)
+				continue;
+
+			tr.viewParms = tr.cachedViewParms[i];
+			refdef->numDrawSurfs = 0;
+			R_MergeWorldViewJob(job, &tr.viewParms, refdef);
+
+			jobCounts[i] = refdef->numDrawSurfs;
+			jobHashes[i] = R_HashDrawSurfs(refdef->drawSurfs, refdef->numDrawSurfs);
+		}
+
+		R_FinishViewJobs();
+	}
+	const int jobMsec = ri->Milliseconds() - startTime;
+
+	int numMismatched = 0;
+	int numSurfs = 0;
+	for (int i = 0; i < numViews; i++)
+	{
+		if (serialCounts[i] < 0)
+			continue;
+
+		numSurfs += serialCounts[i];
+
+		// not run as a job, see R_DispatchViewJobs
+		if (jobCounts[i] < 0)
+			continue;
+
+		if (jobCounts[i] != serialCounts[i] || jobHashes[i] != serialHashes[i])
+		{
+			ri->Printf(PRINT_ALL, S_COLOR_RED "view %i: %i drawsurfs serial, %i from view job\n",
+				i, serialCounts[i], jobCounts[i]);
+			numMismatched++;
+		}
+	}
+
+	ri->Printf(PRINT_ALL, "%i views, %i world drawsurfs, %i iterations\n", numViews, numSurfs, iterations);
+	ri->Printf(PRINT_ALL, "serial:    %5i msec\n", serialMsec);
+	if (r_frontEndJobs->integer)
+	{
+		ri->Printf(PRINT_ALL, "view jobs: %5i msec on %i threads\n", jobMsec, viewJobPool.numThreads + 1);
+	}
+	else
+	{
+		ri->Printf(PRINT_ALL, "view jobs: disabled by r_frontEndJobs 0\n");
+	}
+	if (numMismatched)
+	{
+		ri->Printf(PRINT_ALL, S_COLOR_RED "%i views differ between serial and view jobs\n", numMismatched);
+	}
+
+	refdef->drawSurfs = savedDrawSurfs;
+	refdef->numDrawSurfs = savedNumDrawSurfs;
+	tr.viewParms = savedViewParms;
+	tr.ori = savedOri;
+}
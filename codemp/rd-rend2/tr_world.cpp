@@ -35,13 +35,16 @@ world_t* R_GetWorld(int worldIndex)
 
 /*
 ================
-R_CullSurface
+R_CullSurfaceEx
 
 Tries to cull surfaces before they are lighted or
 added to the sorting list.
+
+World surfaces only read the passed in view, bmodel
+surfaces are still culled in local space through tr.ori.
 ================
 */
-static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
+static qboolean	R_CullSurfaceEx(msurface_t* surf, int entityNum, const viewParms_t* viewParms, const orientationr_t* ori) {
 	if (r_nocull->integer || surf->cullinfo.type == CULLINFO_NONE) {
 		return qfalse;
 	}
@@ -67,7 +70,7 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 			return qfalse;
 		}
 
-		if (tr.viewParms.flags & (VPF_DEPTHSHADOW) && tr.viewParms.flags & (VPF_SHADOWCASCADES))
+		if (viewParms->flags & (VPF_DEPTHSHADOW) && viewParms->flags & (VPF_SHADOWCASCADES))
 		{
 			if (ct == CT_FRONT_SIDED)
 			{
@@ -80,8 +83,8 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 		}
 
 		// do proper cull for orthographic projection
-		if (tr.viewParms.flags & VPF_ORTHOGRAPHIC) {
-			d = DotProduct(tr.viewParms.ori.axis[0], surf->cullinfo.plane.normal);
+		if (viewParms->flags & VPF_ORTHOGRAPHIC) {
+			d = DotProduct(viewParms->ori.axis[0], surf->cullinfo.plane.normal);
 			if (ct == CT_FRONT_SIDED) {
 				if (d > 0)
 					return qtrue;
@@ -93,7 +96,7 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 			return qfalse;
 		}
 
-		d = DotProduct(tr.ori.viewOrigin, surf->cullinfo.plane.normal);
+		d = DotProduct(ori->viewOrigin, surf->cullinfo.plane.normal);
 
 		// don't cull exactly on the plane, because there are levels of rounding
 		// through the BSP, ICD, and hardware that may cause pixel gaps if an
@@ -120,7 +123,8 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 			sphereCull = R_CullLocalPointAndRadius(surf->cullinfo.localOrigin, surf->cullinfo.radius);
 		}
 		else {
-			sphereCull = R_CullPointAndRadius(surf->cullinfo.localOrigin, surf->cullinfo.radius);
+			sphereCull = R_CullPointAndRadiusEx(surf->cullinfo.localOrigin, surf->cullinfo.radius,
+				viewParms->frustum, (viewParms->flags & VPF_FARPLANEFRUSTUM) ? 5 : 4);
 		}
 
 		if (sphereCull == CULL_OUT)
@@ -137,7 +141,8 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 			boxCull = R_CullLocalBox(surf->cullinfo.bounds);
 		}
 		else {
-			boxCull = R_CullBox(surf->cullinfo.bounds);
+			boxCull = R_CullBoxEx(surf->cullinfo.bounds,
+				viewParms->frustum, (viewParms->flags & VPF_FARPLANEFRUSTUM) ? 5 : 4);
 		}
 
 		if (boxCull == CULL_OUT)
@@ -149,6 +154,10 @@ static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
 	return qfalse;
 }
 
+static qboolean	R_CullSurface(msurface_t* surf, int entityNum) {
+	return R_CullSurfaceEx(surf, entityNum, &tr.viewParms, &tr.ori);
+}
+
 /*
 ====================
 R_DlightSurface
@@ -156,20 +165,23 @@ R_DlightSurface
 The given surface is going to be drawn, and it touches a leaf
 that is touched by one or more dlights, so try to throw out
 more dlights if possible.
+
+R_DlightSurfaceBits only computes the bits, R_DlightSurface also
+stores them on the surface for the backend.
 ====================
 */
-static int R_DlightSurface(msurface_t* surf, int dlightBits) {
+static int R_DlightSurfaceBits(msurface_t* surf, int dlightBits, const trRefdef_t* refdef) {
 	float       d;
 	int         i;
 	dlight_t* dl;
 
 	if (surf->cullinfo.type & CULLINFO_PLANE)
 	{
-		for (i = 0; i < tr.refdef.num_dlights; i++) {
+		for (i = 0; i < refdef->num_dlights; i++) {
 			if (!(dlightBits & (1 << i))) {
 				continue;
 			}
-			dl = &tr.refdef.dlights[i];
+			dl = &refdef->dlights[i];
 			d = DotProduct(dl->origin, surf->cullinfo.plane.normal) - surf->cullinfo.plane.dist;
 			if (d < -dl->radius || d > dl->radius) {
 				// dlight doesn't reach the plane
@@ -180,11 +192,11 @@ static int R_DlightSurface(msurface_t* surf, int dlightBits) {
 
 	if (surf->cullinfo.type & CULLINFO_BOX)
 	{
-		for (i = 0; i < tr.refdef.num_dlights; i++) {
+		for (i = 0; i < refdef->num_dlights; i++) {
 			if (!(dlightBits & (1 << i))) {
 				continue;
 			}
-			dl = &tr.refdef.dlights[i];
+			dl = &refdef->dlights[i];
 			if (dl->origin[0] - dl->radius > surf->cullinfo.bounds[1][0]
 				|| dl->origin[0] + dl->radius < surf->cullinfo.bounds[0][0]
 				|| dl->origin[1] - dl->radius > surf->cullinfo.bounds[1][1]
@@ -199,11 +211,11 @@ static int R_DlightSurface(msurface_t* surf, int dlightBits) {
 
 	if (surf->cullinfo.type & CULLINFO_SPHERE)
 	{
-		for (i = 0; i < tr.refdef.num_dlights; i++) {
+		for (i = 0; i < refdef->num_dlights; i++) {
 			if (!(dlightBits & (1 << i))) {
 				continue;
 			}
-			dl = &tr.refdef.dlights[i];
+			dl = &refdef->dlights[i];
 			if (!SpheresIntersect(dl->origin, dl->radius, surf->cullinfo.localOrigin, surf->cullinfo.radius))
 			{
 				// dlight doesn't reach the bounds
@@ -218,7 +230,6 @@ static int R_DlightSurface(msurface_t* surf, int dlightBits) {
 	case SF_GRID:
 	case SF_TRIANGLES:
 	case SF_VBO_MESH:
-		((srfBspSurface_t*)surf->data)->dlightBits = dlightBits;
 		break;
 
 	default:
@@ -226,6 +237,28 @@ static int R_DlightSurface(msurface_t* surf, int dlightBits) {
 		break;
 	}
 
+	return dlightBits;
+}
+
+static void R_SetSurfaceDlightBits(msurface_t* surf, int dlightBits) {
+	switch (*surf->data)
+	{
+	case SF_FACE:
+	case SF_GRID:
+	case SF_TRIANGLES:
+	case SF_VBO_MESH:
+		((srfBspSurface_t*)surf->data)->dlightBits = dlightBits;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static int R_DlightSurface(msurface_t* surf, int dlightBits) {
+	dlightBits = R_DlightSurfaceBits(surf, dlightBits, &tr.refdef);
+	R_SetSurfaceDlightBits(surf, dlightBits);
+
 	if (dlightBits) {
 		tr.pc.c_dlightSurfaces++;
 	}
@@ -243,18 +276,18 @@ R_PshadowSurface
 Just like R_DlightSurface, cull any we can
 ====================
 */
-static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
+static int R_PshadowSurfaceBits(msurface_t* surf, int pshadowBits, const trRefdef_t* refdef) {
 	float       d;
 	int         i;
 	pshadow_t* ps;
 
 	if (surf->cullinfo.type & CULLINFO_PLANE)
 	{
-		for (i = 0; i < tr.refdef.num_pshadows; i++) {
+		for (i = 0; i < refdef->num_pshadows; i++) {
 			if (!(pshadowBits & (1 << i))) {
 				continue;
 			}
-			ps = &tr.refdef.pshadows[i];
+			ps = &refdef->pshadows[i];
 			d = DotProduct(ps->lightOrigin, surf->cullinfo.plane.normal) - surf->cullinfo.plane.dist;
 			if (d < -ps->lightRadius || d > ps->lightRadius) {
 				// pshadow doesn't reach the plane
@@ -265,11 +298,11 @@ static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
 
 	if (surf->cullinfo.type & CULLINFO_BOX)
 	{
-		for (i = 0; i < tr.refdef.num_pshadows; i++) {
+		for (i = 0; i < refdef->num_pshadows; i++) {
 			if (!(pshadowBits & (1 << i))) {
 				continue;
 			}
-			ps = &tr.refdef.pshadows[i];
+			ps = &refdef->pshadows[i];
 			if (ps->lightOrigin[0] - ps->lightRadius > surf->cullinfo.bounds[1][0]
 				|| ps->lightOrigin[0] + ps->lightRadius < surf->cullinfo.bounds[0][0]
 				|| ps->lightOrigin[1] - ps->lightRadius > surf->cullinfo.bounds[1][1]
@@ -285,11 +318,11 @@ static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
 
 	if (surf->cullinfo.type & CULLINFO_SPHERE)
 	{
-		for (i = 0; i < tr.refdef.num_pshadows; i++) {
+		for (i = 0; i < refdef->num_pshadows; i++) {
 			if (!(pshadowBits & (1 << i))) {
 				continue;
 			}
-			ps = &tr.refdef.pshadows[i];
+			ps = &refdef->pshadows[i];
 			if (!SpheresIntersect(ps->viewOrigin, ps->viewRadius, surf->cullinfo.localOrigin, surf->cullinfo.radius)
 				|| DotProduct(surf->cullinfo.localOrigin, ps->cullPlane.normal) - ps->cullPlane.dist < -surf->cullinfo.radius)
 			{
@@ -305,7 +338,6 @@ static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
 	case SF_GRID:
 	case SF_TRIANGLES:
 	case SF_VBO_MESH:
-		((srfBspSurface_t*)surf->data)->pshadowBits = pshadowBits;
 		break;
 
 	default:
@@ -313,9 +345,27 @@ static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
 		break;
 	}
 
-	if (pshadowBits) {
-		//tr.pc.c_dlightSurfaces++;
+	return pshadowBits;
+}
+
+static void R_SetSurfacePshadowBits(msurface_t* surf, int pshadowBits) {
+	switch (*surf->data)
+	{
+	case SF_FACE:
+	case SF_GRID:
+	case SF_TRIANGLES:
+	case SF_VBO_MESH:
+		((srfBspSurface_t*)surf->data)->pshadowBits = pshadowBits;
+		break;
+
+	default:
+		break;
 	}
+}
+
+static int R_PshadowSurface(msurface_t* surf, int pshadowBits) {
+	pshadowBits = R_PshadowSurfaceBits(surf, pshadowBits, &tr.refdef);
+	R_SetSurfacePshadowBits(surf, pshadowBits);
 
 	return pshadowBits;
 }
@@ -515,12 +565,34 @@ void RE_SetRangedFog(float range)
 =============================================================
 */
 
+// everything R_RecursiveWorldNodeEx reads from the view and writes to
+typedef struct worldCull_s {
+	const viewParms_t* viewParms;
+	const trRefdef_t* refdef;
+	int				visIndex;
+	int				visCount;
+	int				viewCount;
+
+	int* surfacesViewCount;
+	int* surfacesDlightBits;
+	int* surfacesPshadowBits;
+	int* mergedSurfacesViewCount;
+	int* mergedSurfacesDlightBits;
+	int* mergedSurfacesPshadowBits;
+
+	vec3_t* visBounds;
+	int				c_leafs;
+} worldCull_t;
+
 /*
 ================
-R_RecursiveWorldNode
+R_RecursiveWorldNodeEx
+
+Only writes to the cull context, so view jobs can
+walk the tree for several views at once.
 ================
 */
-void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int pshadowBits)
+static void R_RecursiveWorldNodeEx(worldCull_t* cull, mnode_t* node, int planeBits, int dlightBits, int pshadowBits)
 {
 	do {
 		int			newDlights[2]{};
@@ -528,8 +600,8 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 
 		// if the node wasn't marked as potentially visible, exit
 		// pvs is skipped for depth shadows
-		if (!(tr.viewParms.flags & VPF_DEPTHSHADOW) &&
-			node->visCounts[tr.visIndex] != tr.visCounts[tr.visIndex]) {
+		if (!(cull->viewParms->flags & VPF_DEPTHSHADOW) &&
+			node->visCounts[cull->visIndex] != cull->visCount) {
 			return;
 		}
 
@@ -540,7 +612,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			int		r;
 
 			if (planeBits & 1) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[0]);
+				r = BoxOnPlaneSide(node->mins, node->maxs, &cull->viewParms->frustum[0]);
 				if (r == 2) {
 					return;						// culled
 				}
@@ -550,7 +622,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			}
 
 			if (planeBits & 2) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[1]);
+				r = BoxOnPlaneSide(node->mins, node->maxs, &cull->viewParms->frustum[1]);
 				if (r == 2) {
 					return;						// culled
 				}
@@ -560,7 +632,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			}
 
 			if (planeBits & 4) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[2]);
+				r = BoxOnPlaneSide(node->mins, node->maxs, &cull->viewParms->frustum[2]);
 				if (r == 2) {
 					return;						// culled
 				}
@@ -570,7 +642,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			}
 
 			if (planeBits & 8) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[3]);
+				r = BoxOnPlaneSide(node->mins, node->maxs, &cull->viewParms->frustum[3]);
 				if (r == 2) {
 					return;						// culled
 				}
@@ -580,7 +652,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			}
 
 			if (planeBits & 16) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[4]);
+				r = BoxOnPlaneSide(node->mins, node->maxs, &cull->viewParms->frustum[4]);
 				if (r == 2) {
 					return;						// culled
 				}
@@ -601,12 +673,12 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 		newDlights[0] = 0;
 		newDlights[1] = 0;
 		if (dlightBits) {
-			for (int i = 0; i < tr.refdef.num_dlights; i++) {
+			for (int i = 0; i < cull->refdef->num_dlights; i++) {
 				if (!(dlightBits & (1 << i))) {
 					continue;
 				}
 
-				dlight_t* dl = &tr.refdef.dlights[i];
+				dlight_t* dl = &cull->refdef->dlights[i];
 				float dist = DotProduct(dl->origin, node->plane->normal) - node->plane->dist;
 
 				if (dist > -dl->radius) {
@@ -621,12 +693,12 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 		newPShadows[0] = 0;
 		newPShadows[1] = 0;
 		if (pshadowBits) {
-			for (int i = 0; i < tr.refdef.num_pshadows; i++) {
+			for (int i = 0; i < cull->refdef->num_pshadows; i++) {
 				if (!(pshadowBits & (1 << i))) {
 					continue;
 				}
 
-				pshadow_t* shadow = &tr.refdef.pshadows[i];
+				pshadow_t* shadow = &cull->refdef->pshadows[i];
 				float dist = DotProduct(shadow->lightOrigin, node->plane->normal) - node->plane->dist;
 
 				if (dist > -shadow->lightRadius) {
@@ -640,7 +712,7 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 		}
 
 		// recurse down the children, front side first
-		R_RecursiveWorldNode(node->children[0], planeBits, newDlights[0], newPShadows[0]);
+		R_RecursiveWorldNodeEx(cull, node->children[0], planeBits, newDlights[0], newPShadows[0]);
 
 		// tail recurse
 		node = node->children[1];
@@ -653,16 +725,16 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 		int			c;
 		int surf, * view;
 
-		tr.pc.c_leafs++;
+		cull->c_leafs++;
 
 		// add to z buffer bounds
-		tr.viewParms.visBounds[0][0] = MIN(node->mins[0], tr.viewParms.visBounds[0][0]);
-		tr.viewParms.visBounds[0][1] = MIN(node->mins[1], tr.viewParms.visBounds[0][1]);
-		tr.viewParms.visBounds[0][2] = MIN(node->mins[2], tr.viewParms.visBounds[0][2]);
+		cull->visBounds[0][0] = MIN(node->mins[0], cull->visBounds[0][0]);
+		cull->visBounds[0][1] = MIN(node->mins[1], cull->visBounds[0][1]);
+		cull->visBounds[0][2] = MIN(node->mins[2], cull->visBounds[0][2]);
 
-		tr.viewParms.visBounds[1][0] = MAX(node->maxs[0], tr.viewParms.visBounds[1][0]);
-		tr.viewParms.visBounds[1][1] = MAX(node->maxs[1], tr.viewParms.visBounds[1][1]);
-		tr.viewParms.visBounds[1][2] = MAX(node->maxs[2], tr.viewParms.visBounds[1][2]);
+		cull->visBounds[1][0] = MAX(node->maxs[0], cull->visBounds[1][0]);
+		cull->visBounds[1][1] = MAX(node->maxs[1], cull->visBounds[1][1]);
+		cull->visBounds[1][2] = MAX(node->maxs[2], cull->visBounds[1][2]);
 
 		// add merged and unmerged surfaces
 		if (tr.world->viewSurfaces && !r_nocurves->integer)
@@ -676,30 +748,30 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 			surf = *view;
 			if (surf < 0)
 			{
-				if (tr.world->mergedSurfacesViewCount[-surf - 1] != tr.viewCount)
+				if (cull->mergedSurfacesViewCount[-surf - 1] != cull->viewCount)
 				{
-					tr.world->mergedSurfacesViewCount[-surf - 1] = tr.viewCount;
-					tr.world->mergedSurfacesDlightBits[-surf - 1] = dlightBits;
-					tr.world->mergedSurfacesPshadowBits[-surf - 1] = pshadowBits;
+					cull->mergedSurfacesViewCount[-surf - 1] = cull->viewCount;
+					cull->mergedSurfacesDlightBits[-surf - 1] = dlightBits;
+					cull->mergedSurfacesPshadowBits[-surf - 1] = pshadowBits;
 				}
 				else
 				{
-					tr.world->mergedSurfacesDlightBits[-surf - 1] |= dlightBits;
-					tr.world->mergedSurfacesPshadowBits[-surf - 1] |= pshadowBits;
+					cull->mergedSurfacesDlightBits[-surf - 1] |= dlightBits;
+					cull->mergedSurfacesPshadowBits[-surf - 1] |= pshadowBits;
 				}
 			}
 			else
 			{
-				if (tr.world->surfacesViewCount[surf] != tr.viewCount)
+				if (cull->surfacesViewCount[surf] != cull->viewCount)
 				{
-					tr.world->surfacesViewCount[surf] = tr.viewCount;
-					tr.world->surfacesDlightBits[surf] = dlightBits;
-					tr.world->surfacesPshadowBits[surf] = pshadowBits;
+					cull->surfacesViewCount[surf] = cull->viewCount;
+					cull->surfacesDlightBits[surf] = dlightBits;
+					cull->surfacesPshadowBits[surf] = pshadowBits;
 				}
 				else
 				{
-					tr.world->surfacesDlightBits[surf] |= dlightBits;
-					tr.world->surfacesPshadowBits[surf] |= pshadowBits;
+					cull->surfacesDlightBits[surf] |= dlightBits;
+					cull->surfacesPshadowBits[surf] |= pshadowBits;
 				}
 			}
 			view++;
@@ -707,6 +779,34 @@ void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int psha
 	}
 }
 
+/*
+================
+R_RecursiveWorldNode
+================
+*/
+void R_RecursiveWorldNode(mnode_t* node, int planeBits, int dlightBits, int pshadowBits)
+{
+	worldCull_t cull;
+
+	cull.viewParms = &tr.viewParms;
+	cull.refdef = &tr.refdef;
+	cull.visIndex = tr.visIndex;
+	cull.visCount = tr.visCounts[tr.visIndex];
+	cull.viewCount = tr.viewCount;
+	cull.surfacesViewCount = tr.world->surfacesViewCount;
+	cull.surfacesDlightBits = tr.world->surfacesDlightBits;
+	cull.surfacesPshadowBits = tr.world->surfacesPshadowBits;
+	cull.mergedSurfacesViewCount = tr.world->mergedSurfacesViewCount;
+	cull.mergedSurfacesDlightBits = tr.world->mergedSurfacesDlightBits;
+	cull.mergedSurfacesPshadowBits = tr.world->mergedSurfacesPshadowBits;
+	cull.visBounds = tr.viewParms.visBounds;
+	cull.c_leafs = 0;
+
+	R_RecursiveWorldNodeEx(&cull, node, planeBits, dlightBits, pshadowBits);
+
+	tr.pc.c_leafs += cull.c_leafs;
+}
+
 /*
 ===============
 R_PointInLeaf
@@ -880,6 +980,13 @@ void R_AddWorldSurfaces(viewParms_t* viewParms, trRefdef_t* refdef) {
 		return;
 	}
 
+	// the traversal may already have been done by a view job
+	viewJob_t* job = R_GetViewJob(viewParms);
+	if (job) {
+		R_MergeWorldViewJob(job, viewParms, refdef);
+		return;
+	}
+
 	// determine which leaves are in the PVS / areamask
 	if (!(viewParms->flags & VPF_DEPTHSHADOW)) {
 		R_MarkLeaves();
@@ -938,4 +1045,175 @@ void R_AddWorldSurfaces(viewParms_t* viewParms, trRefdef_t* refdef) {
 			tr.world->mergedSurfacesDlightBits[i],
 			tr.world->mergedSurfacesPshadowBits[i]);
 	}
-}
\ No newline at end of file
+}
+
+/*
+=============================================================
+
+	VIEW JOBS
+
+=============================================================
+*/
+
+/*
+======================
+R_AddWorldSurfaceToViewJob
+
+Same as R_AddWorldSurface for the world entity, but the drawsurf
+goes to the job and the light bits are stored at merge time.
+======================
+*/
+static void R_AddWorldSurfaceToViewJob(viewJob_t* job, msurface_t* surf, int dlightBits, int pshadowBits)
+{
+	drawSurf_t drawSurf;
+	int flags = 0;
+
+	if (R_CullSurfaceEx(surf, REFENTITYNUM_WORLD, &job->viewParms, &job->viewParms.world)) {
+		return;
+	}
+
+	if (dlightBits) {
+		dlightBits = R_DlightSurfaceBits(surf, dlightBits, &tr.refdef);
+		flags |= VJS_DLIGHTS;
+
+		if (dlightBits) {
+			job->c_dlightSurfaces++;
+		}
+		else {
+			job->c_dlightSurfacesCulled++;
+		}
+	}
+
+	if (pshadowBits) {
+		pshadowBits = R_PshadowSurfaceBits(surf, pshadowBits, &tr.refdef);
+		flags |= VJS_PSHADOWS;
+	}
+
+	if (flags) {
+		viewJobSurface_t lit;
+
+		lit.surf = surf;
+		lit.flags = flags;
+		lit.dlightBits = dlightBits;
+		lit.pshadowBits = pshadowBits;
+		job->litSurfaces.push_back(lit);
+	}
+
+	if (R_FillDrawSurf(&drawSurf, job->viewParms.flags, tr.refdef.rdflags, surf->data,
+		REFENTITYNUM_WORLD, surf->shader, surf->fogIndex, dlightBits, qfalse, surf->cubemapIndex))
+	{
+		job->drawSurfs.push_back(drawSurf);
+	}
+
+	for (int i = 0, numSprites = surf->numSurfaceSprites;
+		i < numSprites; ++i)
+	{
+		srfSprites_t* sprites = surf->surfaceSprites + i;
+		if (R_FillDrawSurf(&drawSurf, job->viewParms.flags, tr.refdef.rdflags, (surfaceType_t*)sprites,
+			REFENTITYNUM_WORLD, sprites->shader, surf->fogIndex, dlightBits, qfalse, 0))
+		{
+			job->drawSurfs.push_back(drawSurf);
+		}
+	}
+}
+
+/*
+=============
+R_RunWorldViewJob
+
+Walks the world for one view and culls the visible surfaces into
+the job. Runs on any thread, tr.world and tr.refdef are only read.
+=============
+*/
+void R_RunWorldViewJob(viewJob_t* job, viewJobMarks_t* marks)
+{
+	const world_t* world = tr.world;
+	worldCull_t cull;
+
+	job->drawSurfs.clear();
+	job->litSurfaces.clear();
+	job->c_dlightSurfaces = 0;
+	job->c_dlightSurfacesCulled = 0;
+
+	ClearBounds(job->viewParms.visBounds[0], job->viewParms.visBounds[1]);
+
+	cull.viewParms = &job->viewParms;
+	cull.refdef = &tr.refdef;
+	cull.visIndex = job->visIndex;
+	cull.visCount = job->visCount;
+	cull.viewCount = job->stamp;
+	cull.surfacesViewCount = marks->surfacesViewCount.data();
+	cull.surfacesDlightBits = marks->surfacesDlightBits.data();
+	cull.surfacesPshadowBits = marks->surfacesPshadowBits.data();
+	cull.mergedSurfacesViewCount = marks->mergedSurfacesViewCount.data();
+	cull.mergedSurfacesDlightBits = marks->mergedSurfacesDlightBits.data();
+	cull.mergedSurfacesPshadowBits = marks->mergedSurfacesPshadowBits.data();
+	cull.visBounds = job->viewParms.visBounds;
+	cull.c_leafs = 0;
+
+	R_RecursiveWorldNodeEx(&cull, world->nodes, job->planeBits, job->dlightBits, job->pshadowBits);
+
+	job->c_leafs = cull.c_leafs;
+
+	// same order as R_AddWorldSurfaces so the sorted result is identical
+	for (int i = 0; i < world->numWorldSurfaces; i++)
+	{
+		if (cull.surfacesViewCount[i] != job->stamp)
+			continue;
+
+		R_AddWorldSurfaceToViewJob(
+			job,
+			world->surfaces + i,
+			cull.surfacesDlightBits[i],
+			cull.surfacesPshadowBits[i]);
+	}
+
+	for (int i = 0; i < world->numMergedSurfaces; i++)
+	{
+		if (cull.mergedSurfacesViewCount[i] != job->stamp)
+			continue;
+
+		R_AddWorldSurfaceToViewJob(
+			job,
+			world->mergedSurfaces + i,
+			cull.mergedSurfacesDlightBits[i],
+			cull.mergedSurfacesPshadowBits[i]);
+	}
+}
+
+/*
+=============
+R_MergeWorldViewJob
+
+Called from R_AddWorldSurfaces on the main thread in place of the
+traversal, appends the job's drawsurfs to the refdef.
+=============
+*/
+void R_MergeWorldViewJob(viewJob_t* job, viewParms_t* viewParms, trRefdef_t* refdef)
+{
+	for (const viewJobSurface_t& lit : job->litSurfaces)
+	{
+		if (lit.flags & VJS_DLIGHTS)
+			R_SetSurfaceDlightBits(lit.surf, lit.dlightBits);
+		if (lit.flags & VJS_PSHADOWS)
+			R_SetSurfacePshadowBits(lit.surf, lit.pshadowBits);
+	}
+
+	for (const drawSurf_t& drawSurf : job->drawSurfs)
+	{
+		refdef->drawSurfs[refdef->numDrawSurfs & DRAWSURF_MASK] = drawSurf;
+		refdef->numDrawSurfs++;
+	}
+
+	VectorCopy(job->viewParms.visBounds[0], viewParms->visBounds[0]);
+	VectorCopy(job->viewParms.visBounds[1], viewParms->visBounds[1]);
+
+	tr.pc.c_leafs += job->c_leafs;
+	tr.pc.c_dlightSurfaces += job->c_dlightSurfaces;
+	tr.pc.c_dlightSurfacesCulled += job->c_dlightSurfacesCulled;
+
+	// leave tr.ori where the serial path would
+	R_RotateForEntity(&tr.worldEntity, viewParms, &tr.ori);
+
+	job->pending = qfalse;
+}
@@ -232,6 +232,8 @@ cvar_t* r_screenshotJpegQuality;
 
 cvar_t* r_patchStitching;
 
+cvar_t* r_simd;
+
 #if !defined(__APPLE__)
 PFNGLSTENCILOPSEPARATEPROC qglStencilOpSeparate;
 #endif
@@ -1274,6 +1276,12 @@ const void* RB_TakeVideoFrameCmd(const void* data)
 	if (glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders)
 		R_GammaCorrect(c_buf, memcount);
 
+	// the client's capture threads encode it if it's queueing frames
+	if (ri->CL_QueueAVIVideoFrame(c_buf, padlen))
+	{
+		return cmd + 1;
+	}
+
 	if (cmd->motionJpeg)
 	{
 		memcount = RE_SaveJPGToBuffer(cmd->encodeBuffer, linelen * cmd->height,
@@ -1555,6 +1563,7 @@ static consoleCommand_t	commands[] = {
 	{ "modelcacheinfo",		RE_RegisterModels_Info_f },
 	{ "weather",			R_SetWeatherEffect_f },
 	{ "r_weather",			R_WeatherEffect_f },
+	{ "tesskernelbench",	R_TessKernelBench_f },
 };
 
 #ifdef _DEBUG
@@ -1730,6 +1739,8 @@ void R_Register()
 
 	r_patchStitching = ri->Cvar_Get("r_patchStitching", "1", CVAR_ARCHIVE, "Enable stitching of neighbouring patch surfaces");
 
+	r_simd = ri->Cvar_Get("r_simd", "2", CVAR_ARCHIVE | CVAR_LATCH, "Highest instruction set for the tess kernels: 0 = scalar, 1 = SSE2, 2 = AVX2");
+
 	for (const auto& command : commands)
 		ri->Cmd_AddCommand(command.cmd, command.func, "");
 }
@@ -1789,6 +1800,7 @@ void R_Init()
 	R_ImageLoader_Init();
 	R_NoiseInit();
 	R_Register();
+	R_InitTessKernels();
 
 	max_polys = Q_min(r_maxpolys->integer, DEFAULT_MAX_POLYS);
 	max_polyverts = Q_min(r_maxpolyverts->integer, DEFAULT_MAX_POLYVERTS);
@@ -2083,6 +2095,7 @@ extern "C" {
 
 		// AVI recording
 		re.TakeVideoFrame = RE_TakeVideoFrame;
+		re.SaveJPGToBuffer = RE_SaveJPGToBuffer;
 
 		// G2 stuff
 		re.InitSkins = R_InitSkins;
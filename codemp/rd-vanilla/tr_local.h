@@ -1221,6 +1221,7 @@ extern	cvar_t* r_marksOnTriangleMeshes;
 extern	cvar_t* r_aspectCorrectFonts;
 
 extern	cvar_t* r_patchStitching;
+extern	cvar_t* r_simd;
 
 /*
 Ghoul2 Insert Start
@@ -1688,6 +1689,29 @@ void	RB_CalcDiffuseColor(unsigned char* colors);
 void	RB_CalcDiffuseEntityColor(unsigned char* colors);
 void	RB_CalcDisintegrateVertDeform(void);
 
+/*
+** per vertex loops used by the functions above, see tr_shade_kernels.cpp
+*/
+using tessKernels_t = struct tessKernels_s {
+	const char* name;
+	void	(*deformByScale)(float* xyz, const float* normal, int num_vertexes, float scale);
+	void	(*deformByWave)(float* xyz, const float* normal, int num_vertexes, const float* table,
+		float base, float amplitude, float phase, float spread, float time);
+	void	(*bulgeByTexCoord)(float* xyz, const float* normal, const float* st, int st_stride, int num_vertexes,
+		float width, float now, float height);
+	void	(*normalizeNormals)(float* normal, int num_vertexes);
+	void	(*turbulentTexCoords)(float* st, const float* xyz, int num_vertexes, float now, float amplitude);
+	void	(*scrollTexCoords)(float* st, int num_vertexes, float scroll_s, float scroll_t);
+	void	(*diffuseColor)(byte* colors, const float* normal, int num_vertexes,
+		const vec3_t ambient_light, const vec3_t directed_light, const vec3_t light_dir, int ambient_light_int);
+	void	(*modulateRGBAsByFog)(byte* colors, const float* fog_tex_coords, int num_vertexes);
+};
+
+extern	tessKernels_t	tessKernels;
+
+void	R_InitTessKernels(void);
+void	R_TessKernelBench_f(void);
+
 /*
 =============================================================
 
@@ -124,44 +124,25 @@ RB_CalcDeformVertexes
 */
 void RB_CalcDeformVertexes(const deformStage_t* ds)
 {
-	int i;
-	vec3_t	offset;
-	float	scale;
 	float* xyz = (float*)tess.xyz;
 	float* normal = (float*)tess.normal;
 
 	if (ds->deformationWave.frequency == 0)
 	{
-		scale = EvalWaveForm(&ds->deformationWave);
-
-		for (i = 0; i < tess.num_vertexes; i++, xyz += 4, normal += 4)
-		{
-			VectorScale(normal, scale, offset);
+		const float scale = EvalWaveForm(&ds->deformationWave);
 
-			xyz[0] += offset[0];
-			xyz[1] += offset[1];
-			xyz[2] += offset[2];
-		}
+		tessKernels.deformByScale(xyz, normal, tess.num_vertexes, scale);
 	}
 	else
 	{
 		const float* table = table_for_func(ds->deformationWave.func);
 
-		for (i = 0; i < tess.num_vertexes; i++, xyz += 4, normal += 4)
-		{
-			const float off = (xyz[0] + xyz[1] + xyz[2]) * ds->deformationSpread;
-
-			scale = WAVEVALUE(table, ds->deformationWave.base,
-				ds->deformationWave.amplitude,
-				ds->deformationWave.phase + off,
-				ds->deformationWave.frequency);
-
-			VectorScale(normal, scale, offset);
-
-			xyz[0] += offset[0];
-			xyz[1] += offset[1];
-			xyz[2] += offset[2];
-		}
+		tessKernels.deformByWave(xyz, normal, tess.num_vertexes, table,
+			ds->deformationWave.base,
+			ds->deformationWave.amplitude,
+			ds->deformationWave.phase,
+			ds->deformationSpread,
+			tess.shaderTime * ds->deformationWave.frequency);
 	}
 }
 
@@ -192,9 +173,9 @@ void RB_CalcDeformNormals(const deformStage_t* ds)
 		scale = R_NoiseGet4f(200 + xyz[0] * scale, xyz[1] * scale, xyz[2] * scale,
 			tess.shaderTime * ds->deformationWave.frequency);
 		normal[2] += ds->deformationWave.amplitude * scale;
-
-		VectorNormalizeFast(normal);
 	}
+
+	tessKernels.normalizeNormals((float*)tess.normal, tess.num_vertexes);
 }
 
 /*
@@ -229,19 +210,13 @@ void RB_CalcBulgeVertexes(const deformStage_t* ds)
 	}
 	*/
 
-	int		i;
 	float* xyz = (float*)tess.xyz;
 	float* normal = (float*)tess.normal;
 
 	if (ds->bulgeSpeed == 0.0f && ds->bulgeWidth == 0.0f)
 	{
 		// We don't have a speed and width, so just use height to expand uniformly
-		for (i = 0; i < tess.num_vertexes; i++, xyz += 4, normal += 4)
-		{
-			xyz[0] += normal[0] * ds->bulgeHeight;
-			xyz[1] += normal[1] * ds->bulgeHeight;
-			xyz[2] += normal[2] * ds->bulgeHeight;
-		}
+		tessKernels.deformByScale(xyz, normal, tess.num_vertexes, ds->bulgeHeight);
 	}
 	else
 	{
@@ -251,16 +226,8 @@ void RB_CalcBulgeVertexes(const deformStage_t* ds)
 
 		const float now = backEnd.refdef.time * ds->bulgeSpeed * 0.001f;
 
-		for (i = 0; i < tess.num_vertexes; i++, xyz += 4, st += 2 * NUM_TEX_COORDS, normal += 4)
-		{
-			const int off = FUNCTABLE_SIZE / (M_PI * 2) * (st[0] * ds->bulgeWidth + now);
-
-			const float scale = tr.sinTable[off & FUNCTABLE_MASK] * ds->bulgeHeight;
-
-			xyz[0] += normal[0] * scale;
-			xyz[1] += normal[1] * scale;
-			xyz[2] += normal[2] * scale;
-		}
+		tessKernels.bulgeByTexCoord(xyz, normal, st, 2 * NUM_TEX_COORDS, tess.num_vertexes,
+			ds->bulgeWidth, now, ds->bulgeHeight);
 	}
 }
 
@@ -788,13 +755,7 @@ void RB_CalcModulateRGBAsByFog(unsigned char* dst_colors)
 	// been previously called if the surface was opaque
 	RB_CalcFogTexCoords(tex_coords[0]);
 
-	for (int i = 0; i < tess.num_vertexes; i++, dst_colors += 4) {
-		const float f = 1.0 - R_FogFactor(tex_coords[i][0], tex_coords[i][1]);
-		dst_colors[0] *= f;
-		dst_colors[1] *= f;
-		dst_colors[2] *= f;
-		dst_colors[3] *= f;
-	}
+	tessKernels.modulateRGBAsByFog(dst_colors, tex_coords[0], tess.num_vertexes);
 }
 
 /*
@@ -932,14 +893,7 @@ void RB_CalcTurbulentTexCoords(const waveForm_t* wf, float* dst_tex_coords)
 {
 	const float now = wf->phase + tess.shaderTime * wf->frequency;
 
-	for (int i = 0; i < tess.num_vertexes; i++, dst_tex_coords += 2)
-	{
-		const float s = dst_tex_coords[0];
-		const float t = dst_tex_coords[1];
-
-		dst_tex_coords[0] = s + tr.sinTable[static_cast<int>(((tess.xyz[i][0] + tess.xyz[i][2]) * 1.0 / 128 * 0.125 + now) * FUNCTABLE_SIZE) & FUNCTABLE_MASK] * wf->amplitude;
-		dst_tex_coords[1] = t + tr.sinTable[static_cast<int>((tess.xyz[i][1] * 1.0 / 128 * 0.125 + now) * FUNCTABLE_SIZE) & FUNCTABLE_MASK] * wf->amplitude;
-	}
+	tessKernels.turbulentTexCoords(dst_tex_coords, tess.xyz[0], tess.num_vertexes, now, wf->amplitude);
 }
 
 /*
@@ -969,11 +923,7 @@ void RB_CalcScrollTexCoords(const float scroll_speed[2], float* dst_tex_coords)
 	adjusted_scroll_s = adjusted_scroll_s - floor(adjusted_scroll_s);
 	adjusted_scroll_t = adjusted_scroll_t - floor(adjusted_scroll_t);
 
-	for (int i = 0; i < tess.num_vertexes; i++, dst_tex_coords += 2)
-	{
-		dst_tex_coords[0] += adjusted_scroll_s;
-		dst_tex_coords[1] += adjusted_scroll_t;
-	}
+	tessKernels.scrollTexCoords(dst_tex_coords, tess.num_vertexes, adjusted_scroll_s, adjusted_scroll_t);
 }
 
 /*
@@ -1093,36 +1043,8 @@ void RB_CalcDiffuseColor(unsigned char* colors)
 	VectorCopy(ent->directedLight, directed_light);
 	VectorCopy(ent->lightDir, lightDir);
 
-	float* v = tess.xyz[0];
-	float* normal = tess.normal[0];
-
-	const int num_vertexes = tess.num_vertexes;
-	for (int i = 0; i < num_vertexes; i++, v += 4, normal += 4) {
-		const float incoming = DotProduct(normal, lightDir);
-		if (incoming <= 0) {
-			*reinterpret_cast<int*>(&colors[i * 4]) = ambient_light_int;
-			continue;
-		}
-		int j = Q_ftol(ambient_light[0] + incoming * directed_light[0]);
-		if (j > 255) {
-			j = 255;
-		}
-		colors[i * 4 + 0] = j;
-
-		j = Q_ftol(ambient_light[1] + incoming * directed_light[1]);
-		if (j > 255) {
-			j = 255;
-		}
-		colors[i * 4 + 1] = j;
-
-		j = Q_ftol(ambient_light[2] + incoming * directed_light[2]);
-		if (j > 255) {
-			j = 255;
-		}
-		colors[i * 4 + 2] = j;
-
-		colors[i * 4 + 3] = 255;
-	}
+	tessKernels.diffuseColor(colors, tess.normal[0], tess.num_vertexes,
+		ambient_light, directed_light, lightDir, ambient_light_int);
 }
 
 /*
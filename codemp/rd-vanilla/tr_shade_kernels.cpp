@@ -0,0 +1,960 @@
+/*
+===========================================================================
+Copyright (C) 1999 - 2005, Id Software, Inc.
+Copyright (C) 2000 - 2013, Raven Software, Inc.
+Copyright (C) 2001 - 2013, Activision, Inc.
+Copyright (C) 2013 - 2015, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// tr_shade_kernels.cpp -- per vertex loops behind the tess deforms and
+// texcoord/colour generators, with SSE2 and AVX2 versions picked at startup
+
+#include "tr_local.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TESS_KERNELS_SSE2
+#define TESS_KERNELS_AVX2
+#endif
+
+#ifdef TESS_KERNELS_SSE2
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TESS_AVX2_FUNC __attribute__((target("avx2")))
+#else
+#define TESS_AVX2_FUNC
+#endif
+
+tessKernels_t tessKernels;
+
+/*
+====================================================================
+
+SCALAR
+
+These are the reference implementations, every other version must
+give the same results (bit for bit, other than NormalizeNormals which
+is allowed Q_rsqrt's error).
+
+====================================================================
+*/
+
+static void DeformByScale_Scalar(float* xyz, const float* normal, const int num_vertexes, const float scale)
+{
+	vec3_t offset;
+
+	for (int i = 0; i < num_vertexes; i++, xyz += 4, normal += 4)
+	{
+		VectorScale(normal, scale, offset);
+
+		xyz[0] += offset[0];
+		xyz[1] += offset[1];
+		xyz[2] += offset[2];
+	}
+}
+
+static void DeformByWave_Scalar(float* xyz, const float* normal, const int num_vertexes, const float* table,
+	const float base, const float amplitude, const float phase, const float spread, const float time)
+{
+	vec3_t offset;
+
+	for (int i = 0; i < num_vertexes; i++, xyz += 4, normal += 4)
+	{
+		const float off = (xyz[0] + xyz[1] + xyz[2]) * spread;
+		const float scale = base + table[Q_ftol((phase + off + time) * FUNCTABLE_SIZE) & FUNCTABLE_MASK] * amplitude;
+
+		VectorScale(normal, scale, offset);
+
+		xyz[0] += offset[0];
+		xyz[1] += offset[1];
+		xyz[2] += offset[2];
+	}
+}
+
+static void BulgeByTexCoord_Scalar(float* xyz, const float* normal, const float* st, const int st_stride, const int num_vertexes,
+	const float width, const float now, const float height)
+{
+	for (int i = 0; i < num_vertexes; i++, xyz += 4, st += st_stride, normal += 4)
+	{
+		const int off = FUNCTABLE_SIZE / (M_PI * 2) * (st[0] * width + now);
+
+		const float scale = tr.sinTable[off & FUNCTABLE_MASK] * height;
+
+		xyz[0] += normal[0] * scale;
+		xyz[1] += normal[1] * scale;
+		xyz[2] += normal[2] * scale;
+	}
+}
+
+static void NormalizeNormals_Scalar(float* normal, const int num_vertexes)
+{
+	for (int i = 0; i < num_vertexes; i++, normal += 4)
+	{
+		VectorNormalizeFast(normal);
+	}
+}
+
+static void TurbulentTexCoords_Scalar(float* st, const float* xyz, const int num_vertexes, const float now, const float amplitude)
+{
+	for (int i = 0; i < num_vertexes; i++, st += 2, xyz += 4)
+	{
+		const float s = st[0];
+		const float t = st[1];
+
+		st[0] = s + tr.sinTable[static_cast<int>(((xyz[0] + xyz[2]) * 1.0 / 128 * 0.125 + now) * FUNCTABLE_SIZE) & FUNCTABLE_MASK] * amplitude;
+		st[1] = t + tr.sinTable[static_cast<int>((xyz[1] * 1.0 / 128 * 0.125 + now) * FUNCTABLE_SIZE) & FUNCTABLE_MASK] * amplitude;
+	}
+}
+
+static void ScrollTexCoords_Scalar(float* st, const int num_vertexes, const float scroll_s, const float scroll_t)
+{
+	for (int i = 0; i < num_vertexes; i++, st += 2)
+	{
+		st[0] += scroll_s;
+		st[1] += scroll_t;
+	}
+}
+
+static void DiffuseColor_Scalar(byte* colors, const float* normal, const int num_vertexes,
+	const vec3_t ambient_light, const vec3_t directed_light, const vec3_t light_dir, const int ambient_light_int)
+{
+	for (int i = 0; i < num_vertexes; i++, normal += 4) {
+		const float incoming = DotProduct(normal, light_dir);
+		if (incoming <= 0) {
+			*reinterpret_cast<int*>(&colors[i * 4]) = ambient_light_int;
+			continue;
+		}
+		int j = Q_ftol(ambient_light[0] + incoming * directed_light[0]);
+		if (j > 255) {
+			j = 255;
+		}
+		colors[i * 4 + 0] = j;
+
+		j = Q_ftol(ambient_light[1] + incoming * directed_light[1]);
+		if (j > 255) {
+			j = 255;
+		}
+		colors[i * 4 + 1] = j;
+
+		j = Q_ftol(ambient_light[2] + incoming * directed_light[2]);
+		if (j > 255) {
+			j = 255;
+		}
+		colors[i * 4 + 2] = j;
+
+		colors[i * 4 + 3] = 255;
+	}
+}
+
+static void ModulateRGBAsByFog_Scalar(byte* colors, const float* fog_tex_coords, const int num_vertexes)
+{
+	for (int i = 0; i < num_vertexes; i++, colors += 4, fog_tex_coords += 2) {
+		const float f = 1.0 - R_FogFactor(fog_tex_coords[0], fog_tex_coords[1]);
+		colors[0] *= f;
+		colors[1] *= f;
+		colors[2] *= f;
+		colors[3] *= f;
+	}
+}
+
+static const tessKernels_t tessKernelsScalar = {
+	"scalar",
+	DeformByScale_Scalar,
+	DeformByWave_Scalar,
+	BulgeByTexCoord_Scalar,
+	NormalizeNormals_Scalar,
+	TurbulentTexCoords_Scalar,
+	ScrollTexCoords_Scalar,
+	DiffuseColor_Scalar,
+	ModulateRGBAsByFog_Scalar
+};
+
+#ifdef TESS_KERNELS_SSE2
+/*
+====================================================================
+
+SSE2
+
+Vertices are handled four at a time (two for the texcoord kernels),
+any remainder goes through the scalar version.
+
+====================================================================
+*/
+
+// keeps x, y and z of a vec4_t, drops w
+static QINLINE __m128 XYZMask_SSE2()
+{
+	return _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+}
+
+static QINLINE __m128 Splat_SSE2(const __m128 v, const int lane)
+{
+	switch (lane)
+	{
+	case 0:
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+	case 1:
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+	case 2:
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+	default:
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+	}
+}
+
+// xyz[k] += normal[k] * scale[k] for four vertices
+static QINLINE void AddScaledNormals4_SSE2(float* xyz, const float* normal, const __m128 scale)
+{
+	const __m128 mask = XYZMask_SSE2();
+
+	for (int k = 0; k < 4; k++)
+	{
+		const __m128 offset = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(normal + k * 4), Splat_SSE2(scale, k)), mask);
+		_mm_storeu_ps(xyz + k * 4, _mm_add_ps(_mm_loadu_ps(xyz + k * 4), offset));
+	}
+}
+
+static QINLINE __m128 GatherTable4_SSE2(const float* table, const __m128i index)
+{
+	int lanes[4];
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), index);
+
+	return _mm_set_ps(table[lanes[3]], table[lanes[2]], table[lanes[1]], table[lanes[0]]);
+}
+
+static void DeformByScale_SSE2(float* xyz, const float* normal, const int num_vertexes, const float scale)
+{
+	const __m128 v_scale = _mm_and_ps(_mm_set1_ps(scale), XYZMask_SSE2());
+
+	for (int i = 0; i < num_vertexes; i++, xyz += 4, normal += 4)
+	{
+		_mm_storeu_ps(xyz, _mm_add_ps(_mm_loadu_ps(xyz), _mm_mul_ps(_mm_loadu_ps(normal), v_scale)));
+	}
+}
+
+static void DeformByWave_SSE2(float* xyz, const float* normal, const int num_vertexes, const float* table,
+	const float base, const float amplitude, const float phase, const float spread, const float time)
+{
+	const __m128 v_spread = _mm_set1_ps(spread);
+	const __m128 v_phase = _mm_set1_ps(phase);
+	const __m128 v_time = _mm_set1_ps(time);
+	const __m128 v_size = _mm_set1_ps(static_cast<float>(FUNCTABLE_SIZE));
+	const __m128 v_base = _mm_set1_ps(base);
+	const __m128 v_amplitude = _mm_set1_ps(amplitude);
+	const __m128i v_mask = _mm_set1_epi32(FUNCTABLE_MASK);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, xyz += 16, normal += 16)
+	{
+		__m128 x = _mm_loadu_ps(xyz);
+		__m128 y = _mm_loadu_ps(xyz + 4);
+		__m128 z = _mm_loadu_ps(xyz + 8);
+		__m128 w = _mm_loadu_ps(xyz + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		const __m128 off = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), v_spread);
+		const __m128 arg = _mm_mul_ps(_mm_add_ps(_mm_add_ps(v_phase, off), v_time), v_size);
+		const __m128i index = _mm_and_si128(_mm_cvttps_epi32(arg), v_mask);
+		const __m128 scale = _mm_add_ps(v_base, _mm_mul_ps(GatherTable4_SSE2(table, index), v_amplitude));
+
+		AddScaledNormals4_SSE2(xyz, normal, scale);
+	}
+
+	DeformByWave_Scalar(xyz, normal, num_vertexes - i, table, base, amplitude, phase, spread, time);
+}
+
+static void BulgeByTexCoord_SSE2(float* xyz, const float* normal, const float* st, const int st_stride, const int num_vertexes,
+	const float width, const float now, const float height)
+{
+	const __m128 v_width = _mm_set1_ps(width);
+	const __m128 v_now = _mm_set1_ps(now);
+	const __m128 v_height = _mm_set1_ps(height);
+	const __m128d v_period = _mm_set1_pd(FUNCTABLE_SIZE / (M_PI * 2));
+	const __m128i v_mask = _mm_set1_epi32(FUNCTABLE_MASK);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, xyz += 16, normal += 16, st += st_stride * 4)
+	{
+		const __m128 s = _mm_set_ps(st[st_stride * 3], st[st_stride * 2], st[st_stride], st[0]);
+		const __m128 a = _mm_add_ps(_mm_mul_ps(s, v_width), v_now);
+
+		// the scalar code does this step in double precision
+		const __m128i lo = _mm_cvttpd_epi32(_mm_mul_pd(v_period, _mm_cvtps_pd(a)));
+		const __m128i hi = _mm_cvttpd_epi32(_mm_mul_pd(v_period, _mm_cvtps_pd(_mm_movehl_ps(a, a))));
+		const __m128i index = _mm_and_si128(_mm_unpacklo_epi64(lo, hi), v_mask);
+
+		const __m128 scale = _mm_mul_ps(GatherTable4_SSE2(tr.sinTable, index), v_height);
+
+		AddScaledNormals4_SSE2(xyz, normal, scale);
+	}
+
+	BulgeByTexCoord_Scalar(xyz, normal, st, st_stride, num_vertexes - i, width, now, height);
+}
+
+static void NormalizeNormals_SSE2(float* normal, const int num_vertexes)
+{
+	const __m128 v_threehalfs = _mm_set1_ps(1.5f);
+	const __m128 v_half = _mm_set1_ps(0.5f);
+	const __m128i v_magic = _mm_set1_epi32(0x5f3759df);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, normal += 16)
+	{
+		__m128 x = _mm_loadu_ps(normal);
+		__m128 y = _mm_loadu_ps(normal + 4);
+		__m128 z = _mm_loadu_ps(normal + 8);
+		__m128 w = _mm_loadu_ps(normal + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		// same bit trick and single newton step as Q_rsqrt
+		const __m128 number = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		const __m128 x2 = _mm_mul_ps(number, v_half);
+		__m128 r = _mm_castsi128_ps(_mm_sub_epi32(v_magic, _mm_srai_epi32(_mm_castps_si128(number), 1)));
+		r = _mm_mul_ps(r, _mm_sub_ps(v_threehalfs, _mm_mul_ps(_mm_mul_ps(x2, r), r)));
+
+		x = _mm_mul_ps(x, r);
+		y = _mm_mul_ps(y, r);
+		z = _mm_mul_ps(z, r);
+
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(normal, x);
+		_mm_storeu_ps(normal + 4, y);
+		_mm_storeu_ps(normal + 8, z);
+		_mm_storeu_ps(normal + 12, w);
+	}
+
+	NormalizeNormals_Scalar(normal, num_vertexes - i);
+}
+
+static void TurbulentTexCoords_SSE2(float* st, const float* xyz, const int num_vertexes, const float now, const float amplitude)
+{
+	// the scalar code does the index maths in double precision, so do we
+	const __m128d v_scale = _mm_set1_pd(1.0 / 128 * 0.125);
+	const __m128d v_now = _mm_set1_pd(now);
+	const __m128d v_size = _mm_set1_pd(FUNCTABLE_SIZE);
+	const __m128 v_amplitude = _mm_set1_ps(amplitude);
+	const __m128i v_mask = _mm_set1_epi32(FUNCTABLE_MASK);
+	int i = 0;
+
+	for (; i + 2 <= num_vertexes; i += 2, st += 4, xyz += 8)
+	{
+		const __m128d a = _mm_set_pd(xyz[1], xyz[0] + xyz[2]);
+		const __m128d b = _mm_set_pd(xyz[5], xyz[4] + xyz[6]);
+
+		const __m128i lo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(a, v_scale), v_now), v_size));
+		const __m128i hi = _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(b, v_scale), v_now), v_size));
+		const __m128i index = _mm_and_si128(_mm_unpacklo_epi64(lo, hi), v_mask);
+
+		const __m128 turb = _mm_mul_ps(GatherTable4_SSE2(tr.sinTable, index), v_amplitude);
+		_mm_storeu_ps(st, _mm_add_ps(_mm_loadu_ps(st), turb));
+	}
+
+	TurbulentTexCoords_Scalar(st, xyz, num_vertexes - i, now, amplitude);
+}
+
+static void ScrollTexCoords_SSE2(float* st, const int num_vertexes, const float scroll_s, const float scroll_t)
+{
+	const __m128 v_scroll = _mm_set_ps(scroll_t, scroll_s, scroll_t, scroll_s);
+	int i = 0;
+
+	for (; i + 2 <= num_vertexes; i += 2, st += 4)
+	{
+		_mm_storeu_ps(st, _mm_add_ps(_mm_loadu_ps(st), v_scroll));
+	}
+
+	ScrollTexCoords_Scalar(st, num_vertexes - i, scroll_s, scroll_t);
+}
+
+static void DiffuseColor_SSE2(byte* colors, const float* normal, const int num_vertexes,
+	const vec3_t ambient_light, const vec3_t directed_light, const vec3_t light_dir, const int ambient_light_int)
+{
+	const __m128 v_light_x = _mm_set1_ps(light_dir[0]);
+	const __m128 v_light_y = _mm_set1_ps(light_dir[1]);
+	const __m128 v_light_z = _mm_set1_ps(light_dir[2]);
+	const __m128i v_ambient_int = _mm_set1_epi32(ambient_light_int);
+	const __m128i v_alpha = _mm_set1_epi32(255);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, normal += 16)
+	{
+		__m128 x = _mm_loadu_ps(normal);
+		__m128 y = _mm_loadu_ps(normal + 4);
+		__m128 z = _mm_loadu_ps(normal + 8);
+		__m128 w = _mm_loadu_ps(normal + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		const __m128 incoming = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, v_light_x), _mm_mul_ps(y, v_light_y)), _mm_mul_ps(z, v_light_z));
+		const __m128i unlit = _mm_castps_si128(_mm_cmple_ps(incoming, _mm_setzero_ps()));
+
+		const __m128i r = _mm_cvttps_epi32(_mm_add_ps(_mm_set1_ps(ambient_light[0]), _mm_mul_ps(incoming, _mm_set1_ps(directed_light[0]))));
+		const __m128i g = _mm_cvttps_epi32(_mm_add_ps(_mm_set1_ps(ambient_light[1]), _mm_mul_ps(incoming, _mm_set1_ps(directed_light[1]))));
+		const __m128i b = _mm_cvttps_epi32(_mm_add_ps(_mm_set1_ps(ambient_light[2]), _mm_mul_ps(incoming, _mm_set1_ps(directed_light[2]))));
+
+		// saturating packs clamp to 255: r0..r3 g0..g3 b0..b3 a0..a3, then interleave into rgba
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(r, g), _mm_packs_epi32(b, v_alpha));
+		packed = _mm_unpacklo_epi8(packed, _mm_srli_si128(packed, 8));
+		packed = _mm_unpacklo_epi8(packed, _mm_srli_si128(packed, 8));
+
+		packed = _mm_or_si128(_mm_and_si128(unlit, v_ambient_int), _mm_andnot_si128(unlit, packed));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(colors + i * 4), packed);
+	}
+
+	DiffuseColor_Scalar(colors + i * 4, normal, num_vertexes - i, ambient_light, directed_light, light_dir, ambient_light_int);
+}
+
+// R_FogFactor for four vertices
+static QINLINE __m128 FogFactor4_SSE2(__m128 s, const __m128 t)
+{
+	const __m128 v_zero = _mm_setzero_ps();
+
+	s = _mm_sub_ps(s, _mm_set1_ps(1.0f / 512));
+
+	const __m128 outside = _mm_or_ps(_mm_cmplt_ps(s, v_zero), _mm_cmplt_ps(t, _mm_set1_ps(1.0f / 32)));
+	const __m128 partial = _mm_cmplt_ps(t, _mm_set1_ps(31.0f / 32));
+	const __m128 clipped = _mm_mul_ps(s, _mm_div_ps(_mm_sub_ps(t, _mm_set1_ps(1.0f / 32.0f)), _mm_set1_ps(30.0f / 32.0f)));
+	s = _mm_or_ps(_mm_and_ps(partial, clipped), _mm_andnot_ps(partial, s));
+
+	s = _mm_mul_ps(s, _mm_set1_ps(8.0f));
+	s = _mm_min_ps(s, _mm_set1_ps(1.0f));
+
+	const __m128i index = _mm_andnot_si128(_mm_castps_si128(outside),
+		_mm_cvttps_epi32(_mm_mul_ps(s, _mm_set1_ps(static_cast<float>(FOG_TABLE_SIZE - 1)))));
+
+	return _mm_andnot_ps(outside, GatherTable4_SSE2(tr.fogTable, index));
+}
+
+// colors[k] *= f[k] for the four rgba bytes of four vertices
+static QINLINE void ModulateRGBA4_SSE2(byte* colors, const __m128 f)
+{
+	const __m128i v_zero = _mm_setzero_si128();
+	const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors));
+	const __m128i c_lo = _mm_unpacklo_epi8(c, v_zero);
+	const __m128i c_hi = _mm_unpackhi_epi8(c, v_zero);
+
+	const __m128i v0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c_lo, v_zero)), Splat_SSE2(f, 0)));
+	const __m128i v1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(c_lo, v_zero)), Splat_SSE2(f, 1)));
+	const __m128i v2 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c_hi, v_zero)), Splat_SSE2(f, 2)));
+	const __m128i v3 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(c_hi, v_zero)), Splat_SSE2(f, 3)));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(colors), _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3)));
+}
+
+static void ModulateRGBAsByFog_SSE2(byte* colors, const float* fog_tex_coords, const int num_vertexes)
+{
+	const __m128 v_one = _mm_set1_ps(1.0f);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, colors += 16, fog_tex_coords += 8)
+	{
+		const __m128 a = _mm_loadu_ps(fog_tex_coords);
+		const __m128 b = _mm_loadu_ps(fog_tex_coords + 4);
+		const __m128 s = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 t = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+		ModulateRGBA4_SSE2(colors, _mm_sub_ps(v_one, FogFactor4_SSE2(s, t)));
+	}
+
+	ModulateRGBAsByFog_Scalar(colors, fog_tex_coords, num_vertexes - i);
+}
+
+static const tessKernels_t tessKernelsSSE2 = {
+	"SSE2",
+	DeformByScale_SSE2,
+	DeformByWave_SSE2,
+	BulgeByTexCoord_SSE2,
+	NormalizeNormals_SSE2,
+	TurbulentTexCoords_SSE2,
+	ScrollTexCoords_SSE2,
+	DiffuseColor_SSE2,
+	ModulateRGBAsByFog_SSE2
+};
+#endif // TESS_KERNELS_SSE2
+
+#ifdef TESS_KERNELS_AVX2
+/*
+====================================================================
+
+AVX2
+
+Only the kernels that gain from the wider registers or from hardware
+gathers have their own version, the rest use the SSE2 ones.
+
+====================================================================
+*/
+
+TESS_AVX2_FUNC static void DeformByScale_AVX2(float* xyz, const float* normal, const int num_vertexes, const float scale)
+{
+	const __m256 v_scale = _mm256_set_ps(0.0f, scale, scale, scale, 0.0f, scale, scale, scale);
+	int i = 0;
+
+	for (; i + 2 <= num_vertexes; i += 2, xyz += 8, normal += 8)
+	{
+		_mm256_storeu_ps(xyz, _mm256_add_ps(_mm256_loadu_ps(xyz), _mm256_mul_ps(_mm256_loadu_ps(normal), v_scale)));
+	}
+
+	DeformByScale_SSE2(xyz, normal, num_vertexes - i, scale);
+}
+
+TESS_AVX2_FUNC static void DeformByWave_AVX2(float* xyz, const float* normal, const int num_vertexes, const float* table,
+	const float base, const float amplitude, const float phase, const float spread, const float time)
+{
+	const __m128 v_spread = _mm_set1_ps(spread);
+	const __m128 v_phase = _mm_set1_ps(phase);
+	const __m128 v_time = _mm_set1_ps(time);
+	const __m128 v_size = _mm_set1_ps(static_cast<float>(FUNCTABLE_SIZE));
+	const __m128 v_base = _mm_set1_ps(base);
+	const __m128 v_amplitude = _mm_set1_ps(amplitude);
+	const __m128i v_mask = _mm_set1_epi32(FUNCTABLE_MASK);
+	const __m256 xyz_mask = _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1));
+	const __m256i lanes01 = _mm256_set_epi32(1, 1, 1, 1, 0, 0, 0, 0);
+	const __m256i lanes23 = _mm256_set_epi32(3, 3, 3, 3, 2, 2, 2, 2);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, xyz += 16, normal += 16)
+	{
+		__m128 x = _mm_loadu_ps(xyz);
+		__m128 y = _mm_loadu_ps(xyz + 4);
+		__m128 z = _mm_loadu_ps(xyz + 8);
+		__m128 w = _mm_loadu_ps(xyz + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		const __m128 off = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), v_spread);
+		const __m128 arg = _mm_mul_ps(_mm_add_ps(_mm_add_ps(v_phase, off), v_time), v_size);
+		const __m128i index = _mm_and_si128(_mm_cvttps_epi32(arg), v_mask);
+		const __m128 scale4 = _mm_add_ps(v_base, _mm_mul_ps(_mm_i32gather_ps(table, index, 4), v_amplitude));
+		const __m256 scale8 = _mm256_castps128_ps256(scale4);
+
+		const __m256 offset01 = _mm256_and_ps(_mm256_mul_ps(_mm256_loadu_ps(normal), _mm256_permutevar8x32_ps(scale8, lanes01)), xyz_mask);
+		const __m256 offset23 = _mm256_and_ps(_mm256_mul_ps(_mm256_loadu_ps(normal + 8), _mm256_permutevar8x32_ps(scale8, lanes23)), xyz_mask);
+
+		_mm256_storeu_ps(xyz, _mm256_add_ps(_mm256_loadu_ps(xyz), offset01));
+		_mm256_storeu_ps(xyz + 8, _mm256_add_ps(_mm256_loadu_ps(xyz + 8), offset23));
+	}
+
+	DeformByWave_SSE2(xyz, normal, num_vertexes - i, table, base, amplitude, phase, spread, time);
+}
+
+TESS_AVX2_FUNC static void TurbulentTexCoords_AVX2(float* st, const float* xyz, const int num_vertexes, const float now, const float amplitude)
+{
+	const __m256d v_scale = _mm256_set1_pd(1.0 / 128 * 0.125);
+	const __m256d v_now = _mm256_set1_pd(now);
+	const __m256d v_size = _mm256_set1_pd(FUNCTABLE_SIZE);
+	const __m128 v_amplitude = _mm_set1_ps(amplitude);
+	const __m128i v_mask = _mm_set1_epi32(FUNCTABLE_MASK);
+	int i = 0;
+
+	for (; i + 2 <= num_vertexes; i += 2, st += 4, xyz += 8)
+	{
+		const __m128 v0 = _mm_loadu_ps(xyz);
+		const __m128 v1 = _mm_loadu_ps(xyz + 4);
+
+		// x0 x1 y0 y1 + z0 z1 w0 w1, then pick (x0 + z0, y0, x1 + z1, y1)
+		const __m128 xy = _mm_unpacklo_ps(v0, v1);
+		const __m128 xz = _mm_add_ps(xy, _mm_unpackhi_ps(v0, v1));
+		__m128 args = _mm_shuffle_ps(xz, xy, _MM_SHUFFLE(3, 2, 1, 0));
+		args = _mm_shuffle_ps(args, args, _MM_SHUFFLE(3, 1, 2, 0));
+
+		const __m256d d = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(args), v_scale), v_now), v_size);
+		const __m128i index = _mm_and_si128(_mm256_cvttpd_epi32(d), v_mask);
+
+		const __m128 turb = _mm_mul_ps(_mm_i32gather_ps(tr.sinTable, index, 4), v_amplitude);
+		_mm_storeu_ps(st, _mm_add_ps(_mm_loadu_ps(st), turb));
+	}
+
+	TurbulentTexCoords_Scalar(st, xyz, num_vertexes - i, now, amplitude);
+}
+
+TESS_AVX2_FUNC static void ScrollTexCoords_AVX2(float* st, const int num_vertexes, const float scroll_s, const float scroll_t)
+{
+	const __m256 v_scroll = _mm256_set_ps(scroll_t, scroll_s, scroll_t, scroll_s, scroll_t, scroll_s, scroll_t, scroll_s);
+	int i = 0;
+
+	for (; i + 4 <= num_vertexes; i += 4, st += 8)
+	{
+		_mm256_storeu_ps(st, _mm256_add_ps(_mm256_loadu_ps(st), v_scroll));
+	}
+
+	ScrollTexCoords_SSE2(st, num_vertexes - i, scroll_s, scroll_t);
+}
+
+// colors[k] *= f[k] for the four rgba bytes of eight vertices, kept in AVX
+// code so there is no SSE/AVX transition in the loop
+TESS_AVX2_FUNC static QINLINE void ModulateRGBA8_AVX2(byte* colors, const __m256 f)
+{
+	__m256i v[4];
+
+	for (int k = 0; k < 4; k++)
+	{
+		const __m256i c = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(colors + k * 8)));
+		const __m256 fk = _mm256_permutevar8x32_ps(f, _mm256_set_epi32(k * 2 + 1, k * 2 + 1, k * 2 + 1, k * 2 + 1, k * 2, k * 2, k * 2, k * 2));
+		v[k] = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(c), fk));
+	}
+
+	// packs work per 128 bit lane: even vertices end up in the low lane, odd ones in the high lane
+	const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(v[0], v[1]), _mm256_packs_epi32(v[2], v[3]));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors), _mm256_permutevar8x32_epi32(packed, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0)));
+}
+
+TESS_AVX2_FUNC static void ModulateRGBAsByFog_AVX2(byte* colors, const float* fog_tex_coords, const int num_vertexes)
+{
+	const __m256 v_zero = _mm256_setzero_ps();
+	const __m256 v_one = _mm256_set1_ps(1.0f);
+	int i = 0;
+
+	for (; i + 8 <= num_vertexes; i += 8, colors += 32, fog_tex_coords += 16)
+	{
+		const __m256 a = _mm256_loadu_ps(fog_tex_coords);
+		const __m256 b = _mm256_loadu_ps(fog_tex_coords + 8);
+
+		// shuffles work per 128 bit lane, put the halves back in vertex order
+		__m256 s = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 t = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+		s = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(s), _MM_SHUFFLE(3, 1, 2, 0)));
+		t = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(t), _MM_SHUFFLE(3, 1, 2, 0)));
+
+		s = _mm256_sub_ps(s, _mm256_set1_ps(1.0f / 512));
+
+		const __m256 outside = _mm256_or_ps(_mm256_cmp_ps(s, v_zero, _CMP_LT_OQ), _mm256_cmp_ps(t, _mm256_set1_ps(1.0f / 32), _CMP_LT_OQ));
+		const __m256 partial = _mm256_cmp_ps(t, _mm256_set1_ps(31.0f / 32), _CMP_LT_OQ);
+		const __m256 clipped = _mm256_mul_ps(s, _mm256_div_ps(_mm256_sub_ps(t, _mm256_set1_ps(1.0f / 32.0f)), _mm256_set1_ps(30.0f / 32.0f)));
+		s = _mm256_blendv_ps(s, clipped, partial);
+
+		s = _mm256_mul_ps(s, _mm256_set1_ps(8.0f));
+		s = _mm256_min_ps(s, v_one);
+
+		const __m256i index = _mm256_andnot_si256(_mm256_castps_si256(outside),
+			_mm256_cvttps_epi32(_mm256_mul_ps(s, _mm256_set1_ps(static_cast<float>(FOG_TABLE_SIZE - 1)))));
+		const __m256 fog = _mm256_andnot_ps(outside, _mm256_i32gather_ps(tr.fogTable, index, 4));
+		const __m256 f = _mm256_sub_ps(v_one, fog);
+
+		ModulateRGBA8_AVX2(colors, f);
+	}
+
+	ModulateRGBAsByFog_SSE2(colors, fog_tex_coords, num_vertexes - i);
+}
+
+static const tessKernels_t tessKernelsAVX2 = {
+	"AVX2",
+	DeformByScale_AVX2,
+	DeformByWave_AVX2,
+	BulgeByTexCoord_SSE2,
+	NormalizeNormals_SSE2,
+	TurbulentTexCoords_AVX2,
+	ScrollTexCoords_AVX2,
+	DiffuseColor_SSE2,
+	ModulateRGBAsByFog_AVX2
+};
+
+static qboolean R_CPUSupportsAVX2()
+{
+#if defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return qfalse;
+	}
+
+	// the OS has to save the ymm registers too
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)))
+	{
+		return qfalse;
+	}
+	if ((_xgetbv(0) & 6) != 6)
+	{
+		return qfalse;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) ? qtrue : qfalse;
+#elif defined(__GNUC__) || defined(__clang__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? qtrue : qfalse;
+#else
+	return qfalse;
+#endif
+}
+#endif // TESS_KERNELS_AVX2
+
+/*
+====================
+R_InitTessKernels
+
+r_simd is the highest instruction set allowed: 0 = scalar, 1 = SSE2, 2 = AVX2
+====================
+*/
+void R_InitTessKernels()
+{
+	tessKernels = tessKernelsScalar;
+
+#ifdef TESS_KERNELS_SSE2
+	if (r_simd->integer >= 1)
+	{
+		tessKernels = tessKernelsSSE2;
+	}
+#endif
+
+#ifdef TESS_KERNELS_AVX2
+	if (r_simd->integer >= 2 && R_CPUSupportsAVX2())
+	{
+		tessKernels = tessKernelsAVX2;
+	}
+#endif
+
+	ri->Printf(PRINT_ALL, "Using %s tess kernels\n", tessKernels.name);
+}
+
+/*
+====================================================================
+
+BENCHMARK
+
+Runs every kernel of the active set against the scalar reference on
+the same synthetic shaderCommands_t batch, reporting the largest
+difference and the time taken by each.
+
+====================================================================
+*/
+
+#define TESS_BENCH_ITERATIONS	2000
+
+static unsigned int tessBenchSeed;
+
+static float TessBench_Random(const float min, const float max)
+{
+	tessBenchSeed = tessBenchSeed * 1664525u + 1013904223u;
+	return min + (max - min) * static_cast<float>(tessBenchSeed >> 8) / static_cast<float>(1 << 24);
+}
+
+static void TessBench_Fill(shaderCommands_t* input)
+{
+	tessBenchSeed = 0x2f6b5a31;
+
+	input->num_vertexes = SHADER_MAX_VERTEXES - 3;	// leave a remainder for the tail loops
+
+	for (int i = 0; i < input->num_vertexes; i++)
+	{
+		vec3_t n;
+
+		VectorSet(input->xyz[i], TessBench_Random(-4096, 4096), TessBench_Random(-4096, 4096), TessBench_Random(-4096, 4096));
+		input->xyz[i][3] = 1.0f;
+
+		VectorSet(n, TessBench_Random(-1, 1), TessBench_Random(-1, 1), TessBench_Random(-1, 1));
+		VectorNormalize(n);
+		VectorCopy(n, input->normal[i]);
+		input->normal[i][3] = 0.0f;
+
+		for (int j = 0; j < NUM_TEX_COORDS; j++)
+		{
+			input->texCoords[i][j][0] = TessBench_Random(-4, 4);
+			input->texCoords[i][j][1] = TessBench_Random(-4, 4);
+		}
+
+		// svars texcoords double as fog texcoords, they cover every branch of R_FogFactor
+		input->svars.texcoords[0][i][0] = TessBench_Random(-4, 4);
+		input->svars.texcoords[0][i][1] = TessBench_Random(-4, 4);
+		input->svars.texcoords[1][i][0] = TessBench_Random(-0.1f, 0.5f);
+		input->svars.texcoords[1][i][1] = TessBench_Random(0.0f, 1.0f);
+
+		for (int j = 0; j < 4; j++)
+		{
+			input->svars.colors[i][j] = static_cast<byte>(TessBench_Random(0, 255.99f));
+		}
+	}
+}
+
+static float TessBench_Compare(const float* a, const float* b, const int count)
+{
+	float worst = 0.0f;
+
+	for (int i = 0; i < count; i++)
+	{
+		const float delta = fabsf(a[i] - b[i]);
+		if (delta > worst || Q_isnan(delta))
+		{
+			worst = delta;
+		}
+	}
+
+	return worst;
+}
+
+static float TessBench_CompareBytes(const byte* a, const byte* b, const int count)
+{
+	int worst = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		worst = Q_max(worst, abs(a[i] - b[i]));
+	}
+
+	return worst;
+}
+
+enum tessBenchKernel_t
+{
+	TBK_DEFORM_SCALE,
+	TBK_DEFORM_WAVE,
+	TBK_BULGE,
+	TBK_NORMALIZE,
+	TBK_TURBULENT,
+	TBK_SCROLL,
+	TBK_DIFFUSE,
+	TBK_FOG,
+	TBK_NUM
+};
+
+static const char* tessBenchKernelNames[TBK_NUM] = {
+	"deform (scale)",
+	"deform (wave)",
+	"bulge",
+	"normalize",
+	"turbulent st",
+	"scroll st",
+	"diffuse",
+	"fog rgba"
+};
+
+static void TessBench_Run(const tessKernels_t* kernels, const int kernel, shaderCommands_t* input)
+{
+	const int n = input->num_vertexes;
+	const vec3_t ambient = { 48.0f, 40.0f, 32.0f };
+	const vec3_t directed = { 180.0f, 200.0f, 220.0f };
+	const vec3_t light_dir = { 0.267f, 0.534f, 0.801f };
+	const int ambient_int = 0xff203028;
+
+	switch (kernel)
+	{
+	case TBK_DEFORM_SCALE:
+		kernels->deformByScale(input->xyz[0], input->normal[0], n, 0.75f);
+		break;
+	case TBK_DEFORM_WAVE:
+		kernels->deformByWave(input->xyz[0], input->normal[0], n, tr.sinTable, 0.5f, 2.0f, 0.25f, 0.01f, 13.37f);
+		break;
+	case TBK_BULGE:
+		kernels->bulgeByTexCoord(input->xyz[0], input->normal[0], input->texCoords[0][0], 2 * NUM_TEX_COORDS, n, 3.0f, 1.7f, 2.0f);
+		break;
+	case TBK_NORMALIZE:
+		kernels->normalizeNormals(input->normal[0], n);
+		break;
+	case TBK_TURBULENT:
+		kernels->turbulentTexCoords(input->svars.texcoords[0][0], input->xyz[0], n, 7.125f, 0.05f);
+		break;
+	case TBK_SCROLL:
+		kernels->scrollTexCoords(input->svars.texcoords[0][0], n, 0.125f, 0.375f);
+		break;
+	case TBK_DIFFUSE:
+		kernels->diffuseColor(input->svars.colors[0], input->normal[0], n, ambient, directed, light_dir, ambient_int);
+		break;
+	case TBK_FOG:
+		kernels->modulateRGBAsByFog(input->svars.colors[0], input->svars.texcoords[1][0], n);
+		break;
+	default:
+		break;
+	}
+}
+
+static float TessBench_Check(const int kernel, const shaderCommands_t* reference, const shaderCommands_t* test)
+{
+	const int n = reference->num_vertexes;
+
+	switch (kernel)
+	{
+	case TBK_DEFORM_SCALE:
+	case TBK_DEFORM_WAVE:
+	case TBK_BULGE:
+		return TessBench_Compare(reference->xyz[0], test->xyz[0], n * 4);
+	case TBK_NORMALIZE:
+		return TessBench_Compare(reference->normal[0], test->normal[0], n * 4);
+	case TBK_TURBULENT:
+	case TBK_SCROLL:
+		return TessBench_Compare(reference->svars.texcoords[0][0], test->svars.texcoords[0][0], n * 2);
+	case TBK_DIFFUSE:
+	case TBK_FOG:
+		return TessBench_CompareBytes(reference->svars.colors[0], test->svars.colors[0], n * 4);
+	default:
+		return 0.0f;
+	}
+}
+
+static int TessBench_Time(const tessKernels_t* kernels, const int kernel, shaderCommands_t* input)
+{
+	const int start = ri->Milliseconds();
+
+	for (int i = 0; i < TESS_BENCH_ITERATIONS; i++)
+	{
+		// undo the normal scaling each pass so the input stays in range
+		if (kernel == TBK_DEFORM_SCALE)
+		{
+			kernels->deformByScale(input->xyz[0], input->normal[0], input->num_vertexes, (i & 1) ? -0.75f : 0.75f);
+			continue;
+		}
+		TessBench_Run(kernels, kernel, input);
+	}
+
+	return ri->Milliseconds() - start;
+}
+
+void R_TessKernelBench_f()
+{
+	const auto reference = static_cast<shaderCommands_t*>(ri->Z_Malloc(sizeof(shaderCommands_t), TAG_TEMP_WORKSPACE, qtrue, 16));
+	const auto test = static_cast<shaderCommands_t*>(ri->Z_Malloc(sizeof(shaderCommands_t), TAG_TEMP_WORKSPACE, qtrue, 16));
+	qboolean failed = qfalse;
+
+	ri->Printf(PRINT_ALL, "tess kernels: scalar vs %s, %d vertexes x %d iterations\n",
+		tessKernels.name, SHADER_MAX_VERTEXES - 3, TESS_BENCH_ITERATIONS);
+	ri->Printf(PRINT_ALL, "kernel           scalar   active   max error\n");
+
+	for (int kernel = 0; kernel < TBK_NUM; kernel++)
+	{
+		TessBench_Fill(reference);
+		TessBench_Fill(test);
+		TessBench_Run(&tessKernelsScalar, kernel, reference);
+		TessBench_Run(&tessKernels, kernel, test);
+
+		const float error = TessBench_Check(kernel, reference, test);
+
+		// Q_rsqrt is only good to ~0.2%, the rest have to match exactly
+		const float tolerance = (kernel == TBK_NORMALIZE) ? 0.005f : 0.0f;
+		if (!(error <= tolerance))
+		{
+			failed = qtrue;
+		}
+
+		TessBench_Fill(reference);
+		TessBench_Fill(test);
+		const int scalar_msec = TessBench_Time(&tessKernelsScalar, kernel, reference);
+		const int active_msec = TessBench_Time(&tessKernels, kernel, test);
+
+		ri->Printf(PRINT_ALL, "%-16s %5dms  %5dms   %g%s\n", tessBenchKernelNames[kernel],
+			scalar_msec, active_msec, error, error <= tolerance ? "" : " ^1MISMATCH");
+	}
+
+	ri->Z_Free(reference);
+	ri->Z_Free(test);
+
+	ri->Printf(PRINT_ALL, failed ? "^1tess kernels do not match the scalar reference\n" : "tess kernels match the scalar reference\n");
+}
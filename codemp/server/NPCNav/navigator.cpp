@@ -102,15 +102,11 @@ CNode::CNode(void)
 {
 	m_numEdges = 0;
 	m_radius = 0;
-	m_ranks = nullptr;
 }
 
 CNode::~CNode(void)
 {
 	m_edges.clear();
-
-	if (m_ranks)
-		delete[] m_ranks;
 }
 
 /*
@@ -204,19 +200,6 @@ int CNode::GetEdgeNumToNode(const int ID)
 	return -1;
 }
 
-/*
--------------------------
-AddRank
--------------------------
-*/
-
-void CNode::AddRank(const int ID, const int rank) const
-{
-	assert(m_ranks);
-
-	m_ranks[ID] = rank;
-}
-
 /*
 -------------------------
 Draw
@@ -342,75 +325,28 @@ void CNode::SetEdgeFlags(const int edgeNum, const int newFlags)
 	}
 }
 
-/*
--------------------------
-InitRanks
--------------------------
-*/
-
-void CNode::InitRanks(const int size)
-{
-	//Clear it if it's already allocated
-	if (m_ranks != nullptr)
-	{
-		delete[] m_ranks;
-		m_ranks = nullptr;
-	}
-
-	m_ranks = new int[size];
-
-	memset(m_ranks, -1, sizeof(int) * size);
-}
-
-/*
--------------------------
-GetRank
--------------------------
-*/
-
-int CNode::GetRank(const int ID) const
-{
-	assert(m_ranks);
-
-	return m_ranks[ID];
-}
-
 /*
 -------------------------
 Save
 -------------------------
 */
 
-int CNode::Save(const int numNodes, const fileHandle_t file)
+int CNode::Save(const fileHandle_t file)
 {
-	//Write out the header
-	constexpr auto header = NODE_HEADER_ID;
-	FS_Write(&header, sizeof header, file);
-
-	//Write out the basic information
-	int i;
-	for (i = 0; i < 3; i++)
-		FS_Write(&m_position[i], sizeof(float), file);
-
+	//Write out the basic information, the ID is implied by the node's place in the file
+	FS_Write(m_position, sizeof(vec3_t), file);
 	FS_Write(&m_flags, sizeof m_flags, file);
-	FS_Write(&m_ID, sizeof m_ID, file);
 	FS_Write(&m_radius, sizeof m_radius, file);
 
 	//Write out the edge information
-	FS_Write(&m_numEdges, sizeof m_numEdges, file);
-
-	edge_v::iterator ei;
-	STL_ITERATE(ei, m_edges)
-	{
-		FS_Write(&*ei, sizeof(edge_t), file);
-	}
+	const byte numEdges = m_numEdges;
+	FS_Write(&numEdges, sizeof numEdges, file);
 
-	//Write out the node ranks
-	FS_Write(&numNodes, sizeof numNodes, file);
-
-	for (i = 0; i < numNodes; i++)
+	for (const auto& edge : m_edges)
 	{
-		FS_Write(&m_ranks[i], sizeof(int), file);
+		FS_Write(&edge.ID, sizeof edge.ID, file);
+		FS_Write(&edge.cost, sizeof edge.cost, file);
+		FS_Write(&edge.flags, sizeof edge.flags, file);
 	}
 
 	return true;
@@ -422,49 +358,32 @@ Load
 -------------------------
 */
 
-int CNode::Load(int numNodes, const fileHandle_t file)
+int CNode::Load(const int ID, const fileHandle_t file)
 {
-	unsigned int header;
-	FS_Read(&header, sizeof header, file);
-
-	//Validate the header
-	if (header != NODE_HEADER_ID)
-		return false;
-
 	//Get the basic information
-	int i;
-	for (i = 0; i < 3; i++)
-		FS_Read(&m_position[i], sizeof(float), file);
-
+	FS_Read(m_position, sizeof(vec3_t), file);
 	FS_Read(&m_flags, sizeof m_flags, file);
-	FS_Read(&m_ID, sizeof m_ID, file);
 	FS_Read(&m_radius, sizeof m_radius, file);
+	m_ID = ID;
 
 	//Get the edge information
-	FS_Read(&m_numEdges, sizeof m_numEdges, file);
+	byte numEdges;
+	FS_Read(&numEdges, sizeof numEdges, file);
+
+	m_edges.clear();
+	m_numEdges = numEdges;
 
-	for (i = 0; i < m_numEdges; i++)
+	for (int i = 0; i < m_numEdges; i++)
 	{
 		edge_t edge;
 
-		FS_Read(&edge, sizeof(edge_t), file);
+		FS_Read(&edge.ID, sizeof edge.ID, file);
+		FS_Read(&edge.cost, sizeof edge.cost, file);
+		FS_Read(&edge.flags, sizeof edge.flags, file);
 
 		STL_INSERT(m_edges, edge);
 	}
 
-	//Read the node ranks
-	int numRanks;
-
-	FS_Read(&numRanks, sizeof numRanks, file);
-
-	//Allocate the memory
-	InitRanks(numRanks);
-
-	for (i = 0; i < numRanks; i++)
-	{
-		FS_Read(&m_ranks[i], sizeof(int), file);
-	}
-
 	return true;
 }
 
@@ -596,6 +515,13 @@ void CNavigator::Free(void)
 
 	m_nodes.clear();
 	m_edgeLookupMap.clear();
+
+	m_nodeRegions.clear();
+	m_regionCosts.clear();
+	m_numRegions = 0;
+	m_heuristicScale = 0.0f;
+
+	ResetSearches();
 }
 
 /*
@@ -637,18 +563,65 @@ bool CNavigator::Load(const char* filename, const int checksum)
 	}
 
 	const int numNodes = GetInt(file);
+	const int numRegions = GetInt(file);
+
+	if (numNodes < 0 || numRegions < 0 || numRegions > numNodes)
+	{
+		FS_FCloseFile(file);
+		return false;
+	}
 
 	for (int i = 0; i < numNodes; i++)
 	{
 		CNode* node = CNode::Create();
 
-		if (node->Load(numNodes, file) == false)
+		STL_INSERT(m_nodes, node);
+
+		if (node->Load(i, file) == false)
 		{
 			FS_FCloseFile(file);
+			Free();
 			return false;
 		}
 
-		STL_INSERT(m_nodes, node);
+		for (int j = 0; j < node->GetNumEdges(); j++)
+		{
+			if (node->GetEdge(j) < 0 || node->GetEdge(j) >= numNodes)
+			{
+				FS_FCloseFile(file);
+				Free();
+				return false;
+			}
+		}
+	}
+
+	//Read in the region hierarchy, the cost table is symmetric so only half of it is stored
+	m_heuristicScale = GetFloat(file);
+	m_numRegions = numRegions;
+	m_nodeRegions.resize(numRegions ? numNodes : 0);
+	m_regionCosts.resize(numRegions * numRegions);
+
+	for (int i = 0; i < static_cast<int>(m_nodeRegions.size()); i++)
+	{
+		unsigned short region;
+		FS_Read(&region, sizeof region, file);
+
+		if (region >= numRegions)
+		{
+			FS_FCloseFile(file);
+			Free();
+			return false;
+		}
+
+		m_nodeRegions[i] = region;
+	}
+
+	for (int i = 0; i < numRegions; i++)
+	{
+		for (int j = i; j < numRegions; j++)
+		{
+			m_regionCosts[i * numRegions + j] = m_regionCosts[j * numRegions + i] = GetInt(file);
+		}
 	}
 
 	//read in the failed edges
@@ -689,15 +662,33 @@ bool CNavigator::Save(const char* filename, const int checksum)
 
 	const int numNodes = m_nodes.size();
 
-	//Write out the number of nodes to follow
+	//Write out the number of nodes and regions to follow
 	FS_Write(&numNodes, sizeof numNodes, file);
+	FS_Write(&m_numRegions, sizeof m_numRegions, file);
 
 	//Write out all the nodes
 	node_v::iterator ni;
 
 	STL_ITERATE(ni, m_nodes)
 	{
-		(*ni)->Save(numNodes, file);
+		(*ni)->Save(file);
+	}
+
+	//Write out the region hierarchy
+	FS_Write(&m_heuristicScale, sizeof m_heuristicScale, file);
+
+	for (const int nodeRegion : m_nodeRegions)
+	{
+		const unsigned short region = nodeRegion;
+		FS_Write(&region, sizeof region, file);
+	}
+
+	for (int i = 0; i < m_numRegions; i++)
+	{
+		for (int j = i; j < m_numRegions; j++)
+		{
+			FS_Write(&m_regionCosts[i * m_numRegions + j], sizeof(int), file);
+		}
 	}
 
 	//write out failed edges
@@ -782,9 +773,15 @@ void CNavigator::SetEdgeCost(const int ID1, const int ID2, int cost) const
 		cost = Distance(pos1, pos2);
 	}
 
+	const int edgeNum = node1->GetEdgeNumToNode(ID2);
+	const int oldCost = edgeNum != -1 ? node1->GetEdgeCost(edgeNum) : INT_MAX;
+
 	//set it
 	node1->AddEdge(ID2, cost);
 	node2->AddEdge(ID1, cost);
+
+	//fix up the searches that went through this edge
+	RepairSearches(ID1, ID2, oldCost, cost);
 }
 
 /*
@@ -813,70 +810,458 @@ void CNavigator::AddNodeEdges(CNode* node, const int addDist, edge_l& edgeList,
 	}
 }
 
+/* ===================== NAVIGATION HIERARCHY ===================== */
+
 /*
 -------------------------
-CalculatePath
+BuildRegions
+
+Groups the nodes into connected regions of at most NAV_REGION_SIZE nodes and
+finds the cheapest cost between every pair of regions.  Failed edges are
+costed at their plain length, so the table stays a lower bound (and a
+connectivity map) while edges fail and clear during play
 -------------------------
 */
 
-void CNavigator::CalculatePath(CNode* node) const
+void CNavigator::BuildRegions(void)
 {
-	int curRank = 0;
+	const int numNodes = m_nodes.size();
 
-	const auto pathList = new CPriorityQueue();
+	m_nodeRegions.assign(numNodes, -1);
+	m_numRegions = 0;
+	m_heuristicScale = 1.0f;
+
+	if (!numNodes)
+	{
+		m_regionCosts.clear();
+		m_nodeRegions.clear();
+		return;
+	}
 
-	//Init the completion table
-	const auto checked = new byte[m_nodes.size()];
-	memset(checked, 0, m_nodes.size());
+	std::vector<int> frontier;
+	std::vector<int> baseCosts;
+	std::vector<int> edgeStart(numNodes + 1);
 
-	//Mark this node as checked
-	checked[node->GetID()] = true;
-	node->AddRank(node->GetID(), curRank++);
+	frontier.reserve(numNodes);
 
-	//Add all initial nodes
-	int i;
-	for (i = 0; i < node->GetNumEdges(); i++)
+	//Flatten the edges and work out how far the heuristic can trust straight line distance
+	for (int i = 0; i < numNodes; i++)
 	{
-		const CNode* nextNode = m_nodes[node->GetEdge(i)];
-		assert(nextNode);
+		CNode* node = m_nodes[i];
+		vec3_t pos;
+
+		node->GetPosition(pos);
+		edgeStart[i] = baseCosts.size();
+
+		for (int j = 0; j < node->GetNumEdges(); j++)
+		{
+			vec3_t pos2;
+			int cost = node->GetEdgeCost(j);
+
+			m_nodes[node->GetEdge(j)]->GetPosition(pos2);
+			const float dist = Distance(pos, pos2);
+
+			if (cost >= Q3_INFINITE)
+			{
+				cost = dist;
+			}
+
+			if (dist > 1.0f && cost < dist * m_heuristicScale)
+			{
+				m_heuristicScale = cost / dist;
+			}
+
+			baseCosts.push_back(cost);
+		}
+	}
+
+	edgeStart[numNodes] = baseCosts.size();
+
+	//Grow each region breadth first from the lowest unassigned node
+	for (int i = 0; i < numNodes; i++)
+	{
+		if (m_nodeRegions[i] != -1)
+			continue;
+
+		frontier.clear();
+		frontier.push_back(i);
+		m_nodeRegions[i] = m_numRegions;
+
+		for (size_t head = 0; head < frontier.size() && frontier.size() < NAV_REGION_SIZE; head++)
+		{
+			CNode* node = m_nodes[frontier[head]];
+
+			for (int j = 0; j < node->GetNumEdges() && frontier.size() < NAV_REGION_SIZE; j++)
+			{
+				const int edgeID = node->GetEdge(j);
+
+				if (m_nodeRegions[edgeID] != -1)
+					continue;
+
+				m_nodeRegions[edgeID] = m_numRegions;
+				frontier.push_back(edgeID);
+			}
+		}
+
+		m_numRegions++;
+	}
+
+	//Flood out from every region at once to find its cost to all the others
+	m_regionCosts.assign(m_numRegions * m_numRegions, NODE_NONE);
+
+	std::vector<int> dist(numNodes);
+	navHeap_v open;
+
+	for (int region = 0; region < m_numRegions; region++)
+	{
+		int* regionCosts = &m_regionCosts[region * m_numRegions];
+
+		std::fill(dist.begin(), dist.end(), INT_MAX);
+		open.clear();
+
+		for (int i = 0; i < numNodes; i++)
+		{
+			if (m_nodeRegions[i] == region)
+			{
+				dist[i] = 0;
+				open.push_back({ 0, 0, i });
+			}
+		}
+
+		while (!open.empty())
+		{
+			const navHeapNode_t top = open.front();
+			std::pop_heap(open.begin(), open.end(), navHeapNode_t::Greater);
+			open.pop_back();
+
+			if (top.cost != dist[top.nodeID])
+				continue;
+
+			int& regionCost = regionCosts[m_nodeRegions[top.nodeID]];
+
+			if (regionCost == NODE_NONE || top.cost < regionCost)
+			{
+				regionCost = top.cost;
+			}
+
+			for (int j = edgeStart[top.nodeID]; j < edgeStart[top.nodeID + 1]; j++)
+			{
+				const int edgeID = m_nodes[top.nodeID]->GetEdge(j - edgeStart[top.nodeID]);
+				const int newDist = top.cost + baseCosts[j];
+
+				if (newDist < dist[edgeID])
+				{
+					dist[edgeID] = newDist;
+					open.push_back({ newDist, newDist, edgeID });
+					std::push_heap(open.begin(), open.end(), navHeapNode_t::Greater);
+				}
+			}
+		}
+	}
+}
+
+/*
+-------------------------
+Reachable
+-------------------------
+*/
+
+bool CNavigator::Reachable(const int startID, const int endID) const
+{
+	if (m_numRegions)
+	{
+		return m_regionCosts[m_nodeRegions[startID] * m_numRegions + m_nodeRegions[endID]] != NODE_NONE;
+	}
+
+	return PathCostToGoal(startID, endID) != NODE_NONE;
+}
+
+/*
+-------------------------
+ResetSearches
+-------------------------
+*/
+
+void CNavigator::ResetSearches(void) const
+{
+	for (auto& search : m_searches)
+	{
+		search.goalID = NODE_NONE;
+		search.open.clear();
+	}
+}
+
+/*
+-------------------------
+GetSearch
 
-		checked[nextNode->GetID()] = true;
+Finds the search rooted at goalID, or recycles the least recently used one for it
+-------------------------
+*/
+
+CNavigator::navSearch_t* CNavigator::GetSearch(const int goalID, const int aimID) const
+{
+	navSearch_t* oldest = &m_searches[0];
+
+	m_searchFrame++;
+
+	for (auto& search : m_searches)
+	{
+		if (search.goalID == goalID)
+		{
+			search.lastUsed = m_searchFrame;
+			return &search;
+		}
 
-		pathList->Push(new CEdge(nextNode->GetID(), nextNode->GetID(), node->GetEdgeCost(i)));
+		if (search.goalID == NODE_NONE || (oldest->goalID != NODE_NONE && search.lastUsed < oldest->lastUsed))
+		{
+			oldest = &search;
+		}
 	}
 
-	//Now flood fill all the others
-	while (!pathList->Empty())
+	const int numNodes = m_nodes.size();
+
+	oldest->goalID = goalID;
+	oldest->aimID = aimID;
+	oldest->lastUsed = m_searchFrame;
+	oldest->cost.assign(numNodes, INT_MAX);
+	oldest->parent.assign(numNodes, NODE_NONE);
+	oldest->closed.assign(numNodes, 0);
+	oldest->open.clear();
+
+	oldest->cost[goalID] = 0;
+	oldest->open.push_back({ 0, 0, goalID });
+
+	return oldest;
+}
+
+/*
+-------------------------
+ResolvePathCost
+
+Expands the search until nodeID's cost to the goal is known.  The heuristic is
+a scaled straight line distance to the node the search was started for, which
+never overestimates an edge, so every closed node already has its final cost
+and later queries for other nodes can simply carry on from where it stopped
+-------------------------
+*/
+
+int CNavigator::ResolvePathCost(navSearch_t* search, const int nodeID) const
+{
+	vec3_t aimPos;
+
+	m_nodes[search->aimID]->GetPosition(aimPos);
+
+	while (!search->closed[nodeID] && !search->open.empty())
 	{
-		//minDist = Q3_INFINITE;
-		const CEdge* test = pathList->Pop();
+		const navHeapNode_t top = search->open.front();
+		std::pop_heap(search->open.begin(), search->open.end(), navHeapNode_t::Greater);
+		search->open.pop_back();
+
+		const int topID = top.nodeID;
+
+		//Skip anything that has been settled or re-costed since it was queued
+		if (search->closed[topID] || top.cost != search->cost[topID])
+			continue;
 
-		CNode* testNode = m_nodes[(*test).m_first];
-		assert(testNode);
+		CNode* node = m_nodes[topID];
+		const int topCost = search->cost[topID];
 
-		node->AddRank(testNode->GetID(), curRank++);
+		search->closed[topID] = 1;
 
-		//Add in all the new edges
-		for (i = 0; i < testNode->GetNumEdges(); i++)
+		for (int i = 0; i < node->GetNumEdges(); i++)
 		{
-			const CNode* addNode = m_nodes[testNode->GetEdge(i)];
-			assert(addNode);
+			const int edgeID = node->GetEdge(i);
+			const int newCost = topCost + node->GetEdgeCost(i);
 
-			if (checked[addNode->GetID()])
+			if (search->closed[edgeID] || newCost >= search->cost[edgeID])
 				continue;
 
-			const int newDist = (*test).m_cost + testNode->GetEdgeCost(i);
-			pathList->Push(new CEdge(addNode->GetID(), (*test).m_second, newDist));
+			vec3_t pos;
+			m_nodes[edgeID]->GetPosition(pos);
 
-			checked[addNode->GetID()] = true;
+			search->cost[edgeID] = newCost;
+			search->parent[edgeID] = topID;
+			search->open.push_back({ newCost + static_cast<int>(Distance(pos, aimPos) * m_heuristicScale), newCost, edgeID });
+			std::push_heap(search->open.begin(), search->open.end(), navHeapNode_t::Greater);
 		}
-		delete test;
 	}
 
-	node->RemoveFlag(NF_RECALC);
+	return search->closed[nodeID] ? search->cost[nodeID] : NODE_NONE;
+}
+
+/*
+-------------------------
+PathCostToGoal
+-------------------------
+*/
+
+int CNavigator::PathCostToGoal(const int nodeID, const int goalID) const
+{
+	if (nodeID == goalID)
+		return 0;
 
-	delete pathList;
-	delete[] checked;
+	//Don't flood a whole island looking for a node that isn't on it
+	if (m_numRegions && !Reachable(nodeID, goalID))
+		return NODE_NONE;
+
+	return ResolvePathCost(GetSearch(goalID, nodeID), nodeID);
+}
+
+/*
+-------------------------
+InvalidateSubtree
+
+Reopens every node whose best route to the goal runs through rootID, then
+seeds them again from their settled neighbours
+-------------------------
+*/
+
+void CNavigator::InvalidateSubtree(navSearch_t* search, const int rootID) const
+{
+	enum { MARK_UNKNOWN, MARK_INSIDE, MARK_OUTSIDE };
+
+	const int numNodes = m_nodes.size();
+
+	m_subtreeMarks.assign(numNodes, MARK_UNKNOWN);
+	m_subtreeMarks[rootID] = MARK_INSIDE;
+
+	//Walk up from every reached node until we know which side of the root it's on
+	for (int i = 0; i < numNodes; i++)
+	{
+		int walkID = i;
+
+		m_subtreeStack.clear();
+
+		while (m_subtreeMarks[walkID] == MARK_UNKNOWN)
+		{
+			m_subtreeStack.push_back(walkID);
+
+			if (search->parent[walkID] == NODE_NONE)
+			{
+				m_subtreeMarks[walkID] = MARK_OUTSIDE;
+				break;
+			}
+
+			walkID = search->parent[walkID];
+		}
+
+		for (const int stackID : m_subtreeStack)
+		{
+			m_subtreeMarks[stackID] = m_subtreeMarks[walkID];
+		}
+	}
+
+	for (int i = 0; i < numNodes; i++)
+	{
+		if (m_subtreeMarks[i] != MARK_INSIDE)
+			continue;
+
+		search->cost[i] = INT_MAX;
+		search->parent[i] = NODE_NONE;
+		search->closed[i] = 0;
+	}
+
+	vec3_t aimPos;
+
+	m_nodes[search->aimID]->GetPosition(aimPos);
+
+	for (int i = 0; i < numNodes; i++)
+	{
+		if (m_subtreeMarks[i] != MARK_INSIDE)
+			continue;
+
+		CNode* node = m_nodes[i];
+
+		for (int j = 0; j < node->GetNumEdges(); j++)
+		{
+			const int edgeID = node->GetEdge(j);
+
+			if (!search->closed[edgeID])
+				continue;
+
+			const int newCost = search->cost[edgeID] + node->GetEdgeCost(j);
+
+			if (newCost < search->cost[i])
+			{
+				search->cost[i] = newCost;
+				search->parent[i] = edgeID;
+			}
+		}
+
+		if (search->parent[i] != NODE_NONE)
+		{
+			vec3_t pos;
+			node->GetPosition(pos);
+
+			search->open.push_back({ search->cost[i] + static_cast<int>(Distance(pos, aimPos) * m_heuristicScale), search->cost[i], i });
+			std::push_heap(search->open.begin(), search->open.end(), navHeapNode_t::Greater);
+		}
+	}
+}
+
+/*
+-------------------------
+RepairSearches
+
+Called whenever an edge's cost changes, so the live searches stay exact
+without being thrown away every time an NPC fails or clears an edge
+-------------------------
+*/
+
+void CNavigator::RepairSearches(const int ID1, const int ID2, const int oldCost, const int newCost) const
+{
+	if (newCost == oldCost)
+		return;
+
+	for (auto& search : m_searches)
+	{
+		if (search.goalID == NODE_NONE)
+			continue;
+
+		if (newCost > oldCost)
+		{
+			//Only routes that used this edge can get worse
+			if (search.parent[ID2] == ID1)
+			{
+				InvalidateSubtree(&search, ID2);
+			}
+			else if (search.parent[ID1] == ID2)
+			{
+				InvalidateSubtree(&search, ID1);
+			}
+			continue;
+		}
+
+		//Cheaper now, see if either end can be reached more cheaply through the other
+		const int ends[2][2] = { { ID1, ID2 }, { ID2, ID1 } };
+
+		for (const auto& end : ends)
+		{
+			const int fromID = end[0];
+			const int toID = end[1];
+
+			if (!search.closed[fromID] || search.cost[fromID] + newCost >= search.cost[toID])
+				continue;
+
+			if (search.closed[toID])
+			{
+				//A settled node got cheaper, which can ripple anywhere, so start over
+				search.goalID = NODE_NONE;
+				search.open.clear();
+				break;
+			}
+
+			vec3_t pos, aimPos;
+			m_nodes[toID]->GetPosition(pos);
+			m_nodes[search.aimID]->GetPosition(aimPos);
+
+			search.cost[toID] = search.cost[fromID] + newCost;
+			search.parent[toID] = fromID;
+			search.open.push_back({ search.cost[toID] + static_cast<int>(Distance(pos, aimPos) * m_heuristicScale), search.cost[toID], toID });
+			std::push_heap(search.open.begin(), search.open.end(), navHeapNode_t::Greater);
+		}
+	}
 }
 
 /*
@@ -890,16 +1275,11 @@ void CNavigator::CalculatePaths(const qboolean recalc)
 #else
 #endif
 
-	for (const auto& node : m_nodes)
-	{
-		//Allocate the needed memory
-		node->InitRanks(m_nodes.size());
-	}
+	//Build the region hierarchy, actual routes are searched for as they're asked for
+	BuildRegions();
+	ResetSearches();
 
-	for (const auto& node : m_nodes)
-	{
-		CalculatePath(node);
-	}
+	Com_DPrintf("Navigation: %d nodes in %d regions\n", static_cast<int>(m_nodes.size()), m_numRegions);
 
 	if (!recalc) //Mike says doesn't need to happen on recalc
 	{
@@ -1103,7 +1483,7 @@ HardConnect
 -------------------------
 */
 
-void CNavigator::HardConnect(const int first, const int second) const
+void CNavigator::HardConnect(const int first, const int second)
 {
 	CNode* start = m_nodes[first];
 	CNode* end = m_nodes[second];
@@ -1129,6 +1509,13 @@ void CNavigator::HardConnect(const int first, const int second) const
 
 	start->AddEdge(second, cost, flags);
 	end->AddEdge(first, cost, flags);
+
+	//The hierarchy no longer matches the graph until CalculatePaths runs again
+	m_nodeRegions.clear();
+	m_regionCosts.clear();
+	m_numRegions = 0;
+	m_heuristicScale = 0.0f;
+	ResetSearches();
 }
 
 #endif
@@ -1327,7 +1714,6 @@ int CNavigator::GetBestPathBetweenEnts(sharedEntity_t* ent, sharedEntity_t* goal
 	int radius;
 	int pathCost, bestCost = Q3_INFINITE;
 	int nextNode = NODE_NONE, bestNode = NODE_NONE;
-	int nodeFlags;
 	//	bool				recalc = false;
 
 	ent->waypoint = NODE_NONE;
@@ -1393,32 +1779,11 @@ int CNavigator::GetBestPathBetweenEnts(sharedEntity_t* ent, sharedEntity_t* goal
 			SetCheckedNode(nodeNum, ent->s.number, CHECKED_PASSED);
 		}
 
-		if (d_altRoutes->integer)
-		{
-			//calc the paths for this node if they're out of date
-			nodeFlags = node->GetFlags();
-			if (nodeFlags & NF_RECALC)
-			{
-				//Com_Printf( S_COLOR_CYAN"%d recalcing paths from node %d\n", svs.time, nodeNum );
-				CalculatePath(node);
-			}
-		}
-
 		STL_ITERATE(nci2, nodeChain2)
 		{
 			vec3_t position2;
 			CNode* node2 = m_nodes[(*nci2).nodeID];
 			const int nodeNum2 = (*nci2).nodeID;
-			if (d_altRoutes->integer)
-			{
-				//calc the paths for this node if they're out of date
-				nodeFlags = node2->GetFlags();
-				if (nodeFlags & NF_RECALC)
-				{
-					//Com_Printf( S_COLOR_CYAN"%d recalcing paths from node %d\n", svs.time, nodeNum2 );
-					CalculatePath(node2);
-				}
-			}
 
 			node2->GetPosition(position2);
 			//Okay, first get the entire path cost, including distance to first node from ents' positions
@@ -2037,13 +2402,10 @@ void CNavigator::AddFailedEdge(int ent_id, int startID, int endID)
 
 			//stuff the index to this one in our lookup map
 
-			//now recalc all the paths!
+			//now reroute around it, the searches repair themselves as the cost changes
 			if (pathsCalculated)
 			{
-				//reconnect the nodes and mark every node's flag NF_RECALC
-				//Com_Printf( S_COLOR_CYAN"%d marking all nodes for recalc\n", svs.time );
 				SetEdgeCost(startID, endID, Q3_INFINITE);
-				FlagAllNodes(NF_RECALC);
 			}
 			return;
 		}
@@ -2146,35 +2508,19 @@ qboolean CNavigator::CheckFailedEdge(failedEdge_t* failedEdge) const
 
 void CNavigator::CheckAllFailedEdges(void)
 {
-	qboolean clearedAny = qfalse;
-
 	//Must have nodes
 	if (m_nodes.size() == 0)
 		return;
 
+	//Cleared edges get their cost back through ClearFailedEdge, which repairs the searches
 	for (auto& j : failedEdges)
 	{
-		failedEdge_t* failedEdge = &j;
-
-		clearedAny = CheckFailedEdge(failedEdge) ? qtrue : clearedAny;
-	}
-	if (clearedAny)
-	{
-		//need to recalc the paths
-		if (pathsCalculated)
-		{
-			//reconnect the nodes and mark every node's flag NF_RECALC
-			//Com_Printf( S_COLOR_CYAN"%d marking all nodes for recalc\n", svs.time );
-			FlagAllNodes(NF_RECALC);
-		}
+		CheckFailedEdge(&j);
 	}
 }
 
 qboolean CNavigator::RouteBlocked(const int startID, const int testEdgeID, const int endID, const int rejectRank)
 {
-	int bestNextID = NODE_NONE;
-	int bestRank = rejectRank;
-
 	if (EdgeFailed(startID, testEdgeID) != -1)
 	{
 		return qtrue;
@@ -2186,70 +2532,15 @@ qboolean CNavigator::RouteBlocked(const int startID, const int testEdgeID, const
 		return qfalse;
 	}
 
-	//Okay, first edge is clear, now check rest of route!
-	const CNode* end = m_nodes[endID];
-	int nextID = testEdgeID;
-	int lastID = startID;
+	//Failed edges cost Q3_INFINITE, so the best route only costs that much if it can't get around one
+	const int cost = PathCostToGoal(testEdgeID, endID);
 
-	while (true)
+	if (cost == NODE_NONE || cost >= Q3_INFINITE || cost >= rejectRank)
 	{
-		CNode* next = m_nodes[nextID];
-		qboolean allEdgesFailed = qtrue;
-
-		for (int i = 0; i < next->GetNumEdges(); i++)
-		{
-			const int edgeID = next->GetEdge(i);
-
-			if (edgeID == lastID)
-			{
-				//Don't backtrack
-				continue;
-			}
-
-			if (edgeID == startID)
-			{
-				//Don't loop around
-				continue;
-			}
-
-			if (EdgeFailed(nextID, edgeID) != -1)
-			{
-				//This edge blocked, check next
-				continue;
-			}
-
-			if (edgeID == endID)
-			{
-				//We got there all clear!
-				return qfalse;
-			}
-
-			//Still going...
-			const int testRank = end->GetRank(edgeID);
-
-			if (testRank < 0)
-			{
-				//No route this way
-				continue;
-			}
-
-			//Is the rank good enough?
-			if (testRank < bestRank)
-			{
-				bestNextID = edgeID;
-				bestRank = testRank;
-				allEdgesFailed = qfalse;
-			}
-		}
-
-		if (allEdgesFailed)
-		{
-			//This route has no clear way of getting to end
-			return qtrue;
-		}
-		lastID = nextID;
-		nextID = bestNextID;
+		return qtrue;
 	}
+
+	return qfalse;
 }
 
 /*
@@ -2385,11 +2676,10 @@ int CNavigator::GetBestNode(const int startID, const int endID, const int reject
 		return startID;
 
 	CNode* start = m_nodes[startID];
-	const CNode* end = m_nodes[endID];
 
 	int bestNode = -1;
-	int bestRank = Q3_INFINITE;
-	int rejectRank = 0;
+	int bestCost = INT_MAX;
+	int rejectCost = 0;
 
 	if (rejectID != WAYPOINT_NONE)
 	{
@@ -2397,7 +2687,7 @@ int CNavigator::GetBestNode(const int startID, const int endID, const int reject
 		{
 			if (start->GetEdge(i) == rejectID)
 			{
-				rejectRank = end->GetRank(start->GetEdge(i));
+				rejectCost = PathCostToGoal(rejectID, endID);
 				break;
 			}
 		}
@@ -2411,21 +2701,21 @@ int CNavigator::GetBestNode(const int startID, const int endID, const int reject
 		if (edgeID == endID)
 			return edgeID;
 
-		const int testRank = end->GetRank(edgeID);
+		const int testCost = PathCostToGoal(edgeID, endID);
 
 		//Found one
-		if (testRank <= rejectRank)
+		if (testCost <= rejectCost)
 			continue;
 
 		//No possible connection
-		if (testRank == NODE_NONE)
+		if (testCost == NODE_NONE)
 			return NODE_NONE;
 
 		//Found a better one
-		if (testRank < bestRank)
+		if (testCost + start->GetEdgeCost(i) < bestCost)
 		{
 			bestNode = edgeID;
-			bestRank = testRank;
+			bestCost = testCost + start->GetEdgeCost(i);
 		}
 	}
 
@@ -2506,22 +2796,11 @@ bool CNavigator::Connected(const int startID, const int endID) const
 	if (startID == endID)
 		return true;
 
-	CNode* start = m_nodes[startID];
-	const CNode* end = m_nodes[endID];
-
-	for (int i = 0; i < start->GetNumEdges(); i++)
-	{
-		const int edgeID = start->GetEdge(i);
-
-		//Found one
-		if (edgeID == endID)
-			return true;
-
-		if (end->GetRank(edgeID) != NODE_NONE)
-			return true;
-	}
+	//Solitary waypoints don't lead anywhere
+	if (!m_nodes[startID]->GetNumEdges())
+		return false;
 
-	return false;
+	return Reachable(startID, endID);
 }
 
 /*
@@ -2540,67 +2819,17 @@ unsigned int CNavigator::GetPathCost(const int startID, const int endID) const
 	if (endID < 0 || endID >= static_cast<int>(m_nodes.size()))
 		return Q3_INFINITE; // return 0;
 
-	CNode* startNode = m_nodes[startID];
-
-	if (!startNode->GetNumEdges())
+	if (!m_nodes[startID]->GetNumEdges())
 	{
 		//WTF?  Solitary waypoint!  Bad designer!
 		return Q3_INFINITE; // return 0;
 	}
 
-	const CNode* endNode = m_nodes[endID];
-
-	CNode* moveNode = startNode;
-
-	int pathCost = 0;
+	const int pathCost = PathCostToGoal(startID, endID);
 
-	int dontScrewUp = 0;
-
-	//Draw out our path
-	while (moveNode != endNode)
+	if (pathCost == NODE_NONE)
 	{
-		int bestRank = WORLD_SIZE;
-		int bestNode = -1;
-		int bestCost = 0;
-
-		for (int i = 0; i < moveNode->GetNumEdges(); i++)
-		{
-			const int edgeID = moveNode->GetEdge(i);
-
-			//Done
-			if (edgeID == endID)
-			{
-				return pathCost + moveNode->GetEdgeCost(i);
-			}
-
-			const int testRank = endNode->GetRank(edgeID);
-
-			//No possible connection
-			if (testRank == NODE_NONE)
-			{
-				return Q3_INFINITE; // return 0;
-			}
-
-			//Found a better one
-			if (testRank < bestRank)
-			{
-				bestNode = edgeID;
-				bestRank = testRank;
-				bestCost = moveNode->GetEdgeCost(i);
-			}
-		}
-
-		pathCost += bestCost;
-
-		//Take a new best node
-		moveNode = m_nodes[bestNode];
-		dontScrewUp++;
-
-		if (dontScrewUp > 40000)
-		{
-			//ok, I think something probably screwed up.
-			break;
-		}
+		return Q3_INFINITE; // return 0;
 	}
 
 	return pathCost;
@@ -2678,100 +2907,3 @@ int CNavigator::GetProjectedNode(vec3_t origin, const int nodeID) const
 
 	return bestNode;
 }
-
-// This is the PriorityQueue stuff for lists of connections
-// better than linear		(1/21/02 BJG)
-//////////////////////////////////////////////////////////////////
-// Helper pop_mHeap algorithm class
-//////////////////////////////////////////////////////////////////
-class NodeTotalGreater
-{
-public:
-	bool operator()(CEdge* first, CEdge* second) const
-	{
-		return first->m_cost > second->m_cost;
-	}
-};
-
-//////////////////////////////////////////////////////////////////
-// Destructor - Deallocate any remaining pointers in the queue
-//////////////////////////////////////////////////////////////////
-CPriorityQueue::~CPriorityQueue()
-{
-	while (!Empty())
-	{
-		delete Pop();
-	}
-}
-
-//////////////////////////////////////////////////////////////////
-// Standard Iterative Search
-//////////////////////////////////////////////////////////////////
-CEdge* CPriorityQueue::Find(const int npNum) const
-{
-	for (const auto& HeapIter : mHeap)
-	{
-		if (HeapIter->m_first == npNum)
-		{
-			return HeapIter;
-		}
-	}
-	return nullptr;
-}
-
-//////////////////////////////////////////////////////////////////
-// Remove Node And Resort
-//////////////////////////////////////////////////////////////////
-CEdge* CPriorityQueue::Pop()
-{
-	CEdge* edge = mHeap.front();
-
-	//pop_mHeap will move the node at the front to the position N
-	//and then sort the mHeap to make positions 1 through N-1 correct
-	//(STL makes no assumptions about your data and doesn't want to change
-	//the size of the container.)
-	std::pop_heap(mHeap.begin(), mHeap.end(), NodeTotalGreater());
-
-	//pop_back() will actually remove the last element from the mHeap
-	//now the mHeap is sorted for positions 1 through N
-	mHeap.pop_back();
-
-	return edge;
-}
-
-//////////////////////////////////////////////////////////////////
-// Add New Node And Resort
-//////////////////////////////////////////////////////////////////
-void CPriorityQueue::Push(CEdge* theEdge)
-{
-	//Pushes the node onto the back of the mHeap
-	mHeap.push_back(theEdge);
-
-	//Sorts the new element into the mHeap
-	std::push_heap(mHeap.begin(), mHeap.end(), NodeTotalGreater());
-}
-
-//////////////////////////////////////////////////////////////////
-// Find The Node In Question And Resort mHeap Around It
-//////////////////////////////////////////////////////////////////
-void CPriorityQueue::Update(CEdge* edge)
-{
-	for (auto i = mHeap.begin(); i != mHeap.end(); ++i)
-	{
-		if ((*i)->m_first == edge->m_first)
-		{
-			//Found node - resort from this position in the mHeap
-			//(its total value was changed before this function was called)
-			std::push_heap(mHeap.begin(), i + 1, NodeTotalGreater());
-			return;
-		}
-	}
-}
-
-//////////////////////////////////////////////////////////////////
-// Just a wrapper for stl empty function.
-//////////////////////////////////////////////////////////////////
-bool CPriorityQueue::Empty() const
-{
-	return mHeap.empty();
-};
\ No newline at end of file
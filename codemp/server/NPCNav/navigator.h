@@ -45,8 +45,12 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 //Miscellaneous defines
 #define	NODE_NONE		-1
-#define	NAV_HEADER_ID	INT_ID('J','N','V','5')
-#define	NODE_HEADER_ID	INT_ID('N','O','D','E')
+#define	NAV_HEADER_ID	INT_ID('J','N','V','6')
+
+//Nodes are grouped into connected regions of at most this many nodes
+#define	NAV_REGION_SIZE		32
+//Number of goal rooted searches kept alive between queries
+#define	NAV_MAX_SEARCHES	16
 
 using EdgeMultimap = std::multimap<int, int>;
 using EdgeMultimapIt = EdgeMultimap::iterator;
@@ -97,7 +101,6 @@ public:
 	static CNode* Create(void);
 
 	void AddEdge(int ID, int cost, int flags = EFLAG_NONE);
-	void AddRank(int ID, int rank) const;
 
 	static void Draw(qboolean showRadius);
 
@@ -112,15 +115,12 @@ public:
 	void SetEdgeFlags(int edgeNum, int newFlags);
 	int GetRadius(void) const { return m_radius; }
 
-	void InitRanks(int size);
-	int GetRank(int ID) const;
-
 	int GetFlags(void) const { return m_flags; }
 	void AddFlag(const int newFlag) { m_flags |= newFlag; }
 	void RemoveFlag(const int oldFlag) { m_flags &= ~oldFlag; }
 
-	int Save(int numNodes, fileHandle_t file);
-	int Load(int numNodes, fileHandle_t file);
+	int Save(fileHandle_t file);
+	int Load(int ID, fileHandle_t file);
 
 protected:
 	vec3_t m_position;
@@ -130,7 +130,6 @@ protected:
 
 	edge_v m_edges;
 
-	int* m_ranks;
 	int m_numEdges;
 };
 
@@ -158,6 +157,32 @@ class CNavigator
 
 #endif	//__NEWCOLLECT
 
+	//Binary heap entry for the path searches
+	struct navHeapNode_t
+	{
+		int key; //cost so far plus the heuristic
+		int cost;
+		int nodeID;
+
+		static bool Greater(const navHeapNode_t& first, const navHeapNode_t& second) { return first.key > second.key; }
+	};
+
+	using navHeap_v = std::vector<navHeapNode_t>;
+
+	//A* search rooted at a goal node.  Other nodes ask it for their cost to the goal,
+	//and it is only expanded as far as needed to answer them
+	struct navSearch_t
+	{
+		int goalID;
+		int aimID; //node the heuristic steers toward
+		int lastUsed;
+
+		std::vector<int> cost;
+		std::vector<int> parent;
+		std::vector<byte> closed;
+		navHeap_v open;
+	};
+
 public:
 	CNavigator(void);
 	~CNavigator(void);
@@ -173,7 +198,7 @@ public:
 
 #if _HARD_CONNECT
 
-	void HardConnect(int first, int second) const;
+	void HardConnect(int first, int second);
 
 #endif
 
@@ -244,7 +269,15 @@ protected:
 	static int GetEdgeCost(CNode* first, CNode* second);
 	void AddNodeEdges(CNode* node, int addDist, edge_l& edgeList, bool* checkedNodes) const;
 
-	void CalculatePath(CNode* node) const;
+	void BuildRegions(void);
+	bool Reachable(int startID, int endID) const;
+
+	void ResetSearches(void) const;
+	navSearch_t* GetSearch(int goalID, int aimID) const;
+	int ResolvePathCost(navSearch_t* search, int nodeID) const;
+	int PathCostToGoal(int nodeID, int goalID) const;
+	void RepairSearches(int ID1, int ID2, int oldCost, int newCost) const;
+	void InvalidateSubtree(navSearch_t* search, int rootID) const;
 
 	//rww - made failedEdges private as it doesn't seem to need to be public.
 	//And I'd rather shoot myself than have to devise a way of setting/accessing this
@@ -253,32 +286,20 @@ protected:
 
 	node_v m_nodes;
 	EdgeMultimap m_edgeLookupMap;
-};
 
-//////////////////////////////////////////////////////////////////////
-// class Priority Queue
-//////////////////////////////////////////////////////////////////////
-class CPriorityQueue
-{
-	// CONSTRUCTION /DESTRUCTION
-	//--------------------------------------------------------------
-public:
-	CPriorityQueue() = default;;
-	~CPriorityQueue();
+	//Hierarchy built by CalculatePaths: every node's region, and the cheapest
+	//known cost between any two regions (NODE_NONE if they aren't connected)
+	std::vector<int> m_nodeRegions;
+	std::vector<int> m_regionCosts;
+	int m_numRegions = 0;
 
-	// Functionality
-	//--------------------------------------------------------------
-public:
-	CEdge* Pop();
-	CEdge* Find(int npNum) const;
-	void Push(CEdge* theEdge);
-	void Update(CEdge* edge);
-	bool Empty() const;
-
-	// DATA
-	//--------------------------------------------------------------
-private:
-	std::vector<CEdge*> mHeap;
+	//Scale on straight line distance that never overestimates an edge's cost
+	float m_heuristicScale = 0.0f;
+
+	mutable navSearch_t m_searches[NAV_MAX_SEARCHES];
+	mutable int m_searchFrame = 0;
+	mutable std::vector<byte> m_subtreeMarks;
+	mutable std::vector<int> m_subtreeStack;
 };
 
 extern CNavigator navigator;
@@ -285,6 +285,7 @@ extern cvar_t* sv_autoDemoBots;
 extern cvar_t* sv_autoDemoMaxMaps;
 extern cvar_t* sv_legacyFixes;
 extern cvar_t* sv_banFile;
+extern cvar_t* sv_traceCache;
 
 extern serverBan_t serverBans[SERVER_MAXBANS];
 extern int serverBansCount;
@@ -406,6 +407,8 @@ int SV_BotAllocateClient(void);
 void SV_BotFreeClient(int clientNum);
 
 void SV_BotInitCvars(void);
+void SV_BotMemInfo_f(void);
+void SV_BotAASBench_f(void);
 int SV_BotGetSnapshotEntity(int client, int sequence);
 int SV_BotGetConsoleMessage(int client, char* buf, int size);
 
@@ -437,6 +440,8 @@ void SV_LinkEntity(sharedEntity_t* g_ent);
 clip_handle_t SV_clip_handleForEntity(const sharedEntity_t* ent);
 
 void SV_SectorList_f(void);
+void SV_TraceCacheInfo_f(void);
+void SV_TraceCacheClear(void);
 
 int SV_AreaEntities(const vec3_t mins, const vec3_t maxs, int* entity_list, int maxcount);
 // fills in a table of entity numbers with entities that have bounding boxes
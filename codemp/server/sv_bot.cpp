@@ -663,6 +663,38 @@ static int SV_BotLibShutdown(void)
 	return botlib_export->BotLibShutdown();
 }
 
+/*
+==================
+SV_BotMemInfo_f
+==================
+*/
+void SV_BotMemInfo_f(void)
+{
+	if (!botlib_export)
+	{
+		Com_Printf("Bot library is not loaded\n");
+		return;
+	}
+
+	botlib_export->BotLibMemoryInfo();
+}
+
+/*
+==================
+SV_BotAASBench_f
+==================
+*/
+void SV_BotAASBench_f(void)
+{
+	if (!botlib_export)
+	{
+		Com_Printf("Bot library is not loaded\n");
+		return;
+	}
+
+	botlib_export->AASBenchmark(Cmd_Argc() > 1 ? atoi(Cmd_Argv(1)) : 0);
+}
+
 /*
 ==================
 SV_BotInitCvars
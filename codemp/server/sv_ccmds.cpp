@@ -2116,6 +2116,10 @@ void SV_AddOperatorCommands(void)
 	Cmd_AddCommand("dumpuser", SV_DumpUser_f, "Prints the userinfo for a given userid");
 	Cmd_AddCommand("map_restart", SV_MapRestart_f, "Restart the current map");
 	Cmd_AddCommand("sectorlist", SV_SectorList_f);
+	Cmd_AddCommand("tracecacheinfo", SV_TraceCacheInfo_f, "Prints sv_traceCache hit rates since the last call");
+	Cmd_AddCommand("icarus_meminfo", ICARUS_MemInfo_f, "Prints ICARUS pool use and decoded script sizes");
+	Cmd_AddCommand("bot_meminfo", SV_BotMemInfo_f, "Prints botlib memory pool use");
+	Cmd_AddCommand("bot_aasbench", SV_BotAASBench_f, "Compares and times AAS point lookups and traces on the current map");
 	Cmd_AddCommand("map", SV_Map_f, "Load a new map with cheats disabled");
 	Cmd_SetCommandCompletionFunc("map", SV_CompleteMapName);
 	Cmd_AddCommand("devmap", SV_Map_f, "Load a new map with cheats enabled");
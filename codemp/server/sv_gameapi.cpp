@@ -133,6 +133,8 @@ void GVM_ClientThink(const int clientNum, usercmd_t* ucmd)
 
 void GVM_RunFrame(const int levelTime)
 {
+	SV_TraceCacheClear();
+
 	if (gvm->isLegacy)
 	{
 		VM_Call(gvm, GAME_RUN_FRAME, levelTime);
@@ -3700,6 +3702,10 @@ void SV_BindGame(void)
 		gi.G2API_OverrideServer = SV_G2API_OverrideServer;
 		gi.G2API_GetSurfaceName = SV_G2API_GetSurfaceName;
 
+		gi.SharedData_Acquire = SD_Acquire;
+		gi.SharedData_Store = SD_Store;
+		gi.SharedData_Release = SD_Release;
+
 		const auto GetGameAPI = reinterpret_cast<GetGameAPI_t>(gvm->GetModuleAPI);
 		gameExport_t* ret = GetGameAPI(GAME_API_VERSION, &gi);
 		if (!ret)
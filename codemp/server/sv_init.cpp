@@ -907,6 +907,7 @@ static void SV_InitRef(void)
 	ri.FS_FOpenFileByMode = FS_FOpenFileByMode;
 	ri.FS_FileExists = FS_FileExists;
 	ri.FS_FileIsInPAK = FS_FileIsInPAK;
+	ri.FS_FilePakChecksum = FS_FilePakChecksum;
 	ri.FS_ListFiles = FS_ListFiles;
 	ri.FS_Write = FS_Write;
 	ri.FS_WriteFile = FS_WriteFile;
@@ -1054,6 +1055,9 @@ void SV_Init(void)
 
 	sv_banFile = Cvar_Get("sv_banFile", "serverbans.dat", CVAR_ARCHIVE, "File to use to store bans and exceptions");
 
+	sv_traceCache = Cvar_Get("sv_traceCache", "0", CVAR_ARCHIVE,
+		"Reuse identical trace results within a frame, 2 checks every reuse against a fresh trace");
+
 	// initialize bot cvars so they are listed and can be set before loading the botlib
 	SV_BotInitCvars();
 
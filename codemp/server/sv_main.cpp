@@ -68,6 +68,7 @@ cvar_t* sv_autoDemoBots;
 cvar_t* sv_autoDemoMaxMaps;
 cvar_t* sv_legacyFixes;
 cvar_t* sv_banFile;
+cvar_t* sv_traceCache;
 
 serverBan_t serverBans[SERVER_MAXBANS];
 int serverBansCount = 0;
@@ -158,6 +158,7 @@ void SV_ClearWorld(void)
 
 	Com_Memset(sv_worldSectors, 0, sizeof sv_worldSectors);
 	sv_numworldSectors = 0;
+	SV_TraceCacheClear();
 
 	// get world map bounds
 	const clip_handle_t h = CM_InlineModel(0);
@@ -175,6 +176,8 @@ void SV_UnlinkEntity(sharedEntity_t* g_ent)
 {
 	svEntity_t* ent = SV_SvEntityForGentity(g_ent);
 
+	SV_TraceCacheClear();
+
 	g_ent->r.linked = qfalse;
 
 	worldSector_t* ws = ent->worldSector;
@@ -220,7 +223,11 @@ void SV_LinkEntity(sharedEntity_t* g_ent)
 
 	if (ent->worldSector)
 	{
-		SV_UnlinkEntity(g_ent); // unlink from old position
+		SV_UnlinkEntity(g_ent); // unlink from old position, which also clears the trace cache
+	}
+	else
+	{
+		SV_TraceCacheClear();
 	}
 
 	// encode the size into the entityState_t for client prediction
@@ -862,8 +869,9 @@ pass_entity_num and entities owned by pass_entity_num are explicitly not checked
 /*
 Ghoul2 Insert Start
 */
-void SV_Trace(trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
-	const int pass_entity_num, const int contentmask, const int capsule, const int traceFlags, const int useLod)
+static void SV_TraceUncached(trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+	const vec3_t end, const int pass_entity_num, const int contentmask, const int capsule, const int traceFlags,
+	const int useLod)
 {
 	/*
 	Ghoul2 Insert End
@@ -931,6 +939,152 @@ void SV_Trace(trace_t* results, const vec3_t start, const vec3_t mins, const vec
 	*results = clip.trace;
 }
 
+/*
+===============================================================================
+
+TRACE CACHE
+
+AI code asks the same question over and over within a frame: the same start, end,
+box, pass entity and mask from NPC_ClearLOS, NAV_ClearPathToPoint, the bot visibility
+checks and so on. With sv_traceCache on, results are kept until the end of the game
+frame or until anything links or unlinks, whichever comes first.
+
+Game code that changes an entity's contents, owner or flags without relinking it
+can get a stale answer back, which is why it's off by default. sv_traceCache 2 runs
+every hit again for real and reports any difference.
+
+===============================================================================
+*/
+
+#define TRACE_CACHE_SIZE	1024 // power of two
+
+using traceCacheKey_t = struct traceCacheKey_s
+{
+	vec3_t start, end, mins, maxs;
+	int pass_entity_num, contentmask, capsule, traceFlags, useLod;
+};
+
+using traceCacheEntry_t = struct traceCacheEntry_s
+{
+	traceCacheKey_t key;
+	int generation;
+
+	// everything in front of G2CollisionMap, which is always empty for the traces kept here
+	byte result[offsetof(trace_t, G2CollisionMap)];
+};
+
+static traceCacheEntry_t sv_traceCacheEntries[TRACE_CACHE_SIZE];
+static int sv_traceCacheGeneration = 1; // entries from an older one are dead
+
+static int sv_traceCacheHits, sv_traceCacheMisses, sv_traceCacheClears, sv_traceCacheMismatches;
+
+/*
+==================
+SV_TraceCacheClear
+
+Called at the start of each game frame and whenever an entity links or unlinks
+==================
+*/
+void SV_TraceCacheClear(void)
+{
+	sv_traceCacheGeneration++;
+	sv_traceCacheClears++;
+}
+
+/*
+==================
+SV_TraceCacheInfo_f
+==================
+*/
+void SV_TraceCacheInfo_f(void)
+{
+	const int lookups = sv_traceCacheHits + sv_traceCacheMisses;
+
+	Com_Printf("trace cache: %s\n", sv_traceCache->integer == 2 ? "verifying" : sv_traceCache->integer ? "on" : "off");
+	Com_Printf("%i lookups, %i hits (%.1f%%), %i clears", lookups, sv_traceCacheHits,
+		lookups ? 100.0f * sv_traceCacheHits / lookups : 0.0f, sv_traceCacheClears);
+	if (sv_traceCache->integer == 2)
+	{
+		Com_Printf(", %i wrong", sv_traceCacheMismatches);
+	}
+	Com_Printf(" since last time\n");
+
+	sv_traceCacheHits = sv_traceCacheMisses = sv_traceCacheClears = sv_traceCacheMismatches = 0;
+}
+
+static qboolean SV_TraceCacheSame(const trace_t* a, const trace_t* b)
+{
+	return static_cast<qboolean>(a->allsolid == b->allsolid && a->startsolid == b->startsolid &&
+		a->entityNum == b->entityNum && a->fraction == b->fraction && VectorCompare(a->endpos, b->endpos) &&
+		VectorCompare(a->plane.normal, b->plane.normal) && a->plane.dist == b->plane.dist &&
+		a->surfaceFlags == b->surfaceFlags && a->contents == b->contents);
+}
+
+void SV_Trace(trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
+	const int pass_entity_num, const int contentmask, const int capsule, const int traceFlags, const int useLod)
+{
+	// ghoul2 traces depend on animation state and fill in the collision map, never cache those
+	if (!sv_traceCache->integer || traceFlags & G2TRFLAG_DOGHOULTRACE)
+	{
+		SV_TraceUncached(results, start, mins, maxs, end, pass_entity_num, contentmask, capsule, traceFlags, useLod);
+		return;
+	}
+
+	traceCacheKey_t key;
+
+	VectorCopy(start, key.start);
+	VectorCopy(end, key.end);
+	VectorCopy(mins ? mins : vec3_origin, key.mins);
+	VectorCopy(maxs ? maxs : vec3_origin, key.maxs);
+	key.pass_entity_num = pass_entity_num;
+	key.contentmask = contentmask;
+	key.capsule = capsule;
+	key.traceFlags = traceFlags;
+	key.useLod = useLod;
+
+	// FNV-1a over the key, the floats compare bit for bit
+	uint32_t hash = 2166136261u;
+	const byte* bytes = reinterpret_cast<const byte*>(&key);
+	for (size_t i = 0; i < sizeof key; i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	traceCacheEntry_t* entry = &sv_traceCacheEntries[hash & (TRACE_CACHE_SIZE - 1)];
+
+	if (entry->generation == sv_traceCacheGeneration && !memcmp(&entry->key, &key, sizeof key))
+	{
+		sv_traceCacheHits++;
+
+		if (sv_traceCache->integer == 2)
+		{
+			trace_t cached;
+
+			memcpy(&cached, entry->result, sizeof entry->result);
+			SV_TraceUncached(results, start, mins, maxs, end, pass_entity_num, contentmask, capsule, traceFlags,
+				useLod);
+			if (!SV_TraceCacheSame(&cached, results))
+			{
+				sv_traceCacheMismatches++;
+				Com_DPrintf(S_COLOR_YELLOW "SV_Trace: cached (%.3f, ent %i) vs fresh (%.3f, ent %i), pass %i mask 0x%x\n",
+					cached.fraction, cached.entityNum, results->fraction, results->entityNum, pass_entity_num,
+					contentmask);
+			}
+			return;
+		}
+
+		memcpy(results, entry->result, sizeof entry->result);
+		memset(results->G2CollisionMap, 0, sizeof results->G2CollisionMap);
+		return;
+	}
+
+	sv_traceCacheMisses++;
+	SV_TraceUncached(results, start, mins, maxs, end, pass_entity_num, contentmask, capsule, traceFlags, useLod);
+
+	entry->key = key;
+	entry->generation = sv_traceCacheGeneration;
+	memcpy(entry->result, results, sizeof entry->result);
+}
+
 /*
 =============
 SV_PointContents
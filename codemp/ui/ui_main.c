@@ -1176,7 +1176,7 @@ static qboolean Asset_Parse(int handle)
 {
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 	if (Q_stricmp(token.string, "{") != 0)
 	{
@@ -1187,7 +1187,7 @@ static qboolean Asset_Parse(int handle)
 	{
 		memset(&token, 0, sizeof(pc_token_t));
 
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 			return qfalse;
 
 		if (Q_stricmp(token.string, "}") == 0)
@@ -1199,7 +1199,7 @@ static qboolean Asset_Parse(int handle)
 		if (Q_stricmp(token.string, "font") == 0)
 		{
 			int pointSize;
-			if (!trap->PC_ReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
+			if (!PC_CacheReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
 			{
 				return qfalse;
 			}
@@ -1212,7 +1212,7 @@ static qboolean Asset_Parse(int handle)
 		if (Q_stricmp(token.string, "smallFont") == 0)
 		{
 			int pointSize;
-			if (!trap->PC_ReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
+			if (!PC_CacheReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
 			{
 				return qfalse;
 			}
@@ -1224,7 +1224,7 @@ static qboolean Asset_Parse(int handle)
 		if (Q_stricmp(token.string, "small2Font") == 0)
 		{
 			int pointSize;
-			if (!trap->PC_ReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
+			if (!PC_CacheReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
 			{
 				return qfalse;
 			}
@@ -1236,7 +1236,7 @@ static qboolean Asset_Parse(int handle)
 		if (Q_stricmp(token.string, "bigFont") == 0)
 		{
 			int pointSize;
-			if (!trap->PC_ReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
+			if (!PC_CacheReadToken(handle, &token) || !PC_Int_Parse(handle, &pointSize))
 			{
 				return qfalse;
 			}
@@ -1382,7 +1382,7 @@ static qboolean Asset_Parse(int handle)
 		// gradientbar
 		if (Q_stricmp(token.string, "gradientbar") == 0)
 		{
-			if (!trap->PC_ReadToken(handle, &token))
+			if (!PC_CacheReadToken(handle, &token))
 			{
 				return qfalse;
 			}
@@ -1393,7 +1393,7 @@ static qboolean Asset_Parse(int handle)
 		// enterMenuSound
 		if (Q_stricmp(token.string, "menuEnterSound") == 0)
 		{
-			if (!trap->PC_ReadToken(handle, &token))
+			if (!PC_CacheReadToken(handle, &token))
 			{
 				return qfalse;
 			}
@@ -1404,7 +1404,7 @@ static qboolean Asset_Parse(int handle)
 		// exitMenuSound
 		if (Q_stricmp(token.string, "menuExitSound") == 0)
 		{
-			if (!trap->PC_ReadToken(handle, &token))
+			if (!PC_CacheReadToken(handle, &token))
 			{
 				return qfalse;
 			}
@@ -1415,7 +1415,7 @@ static qboolean Asset_Parse(int handle)
 		// itemFocusSound
 		if (Q_stricmp(token.string, "itemFocusSound") == 0)
 		{
-			if (!trap->PC_ReadToken(handle, &token))
+			if (!PC_CacheReadToken(handle, &token))
 			{
 				return qfalse;
 			}
@@ -1426,7 +1426,7 @@ static qboolean Asset_Parse(int handle)
 		// menuBuzzSound
 		if (Q_stricmp(token.string, "menuBuzzSound") == 0)
 		{
-			if (!trap->PC_ReadToken(handle, &token))
+			if (!PC_CacheReadToken(handle, &token))
 			{
 				return qfalse;
 			}
@@ -1491,7 +1491,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "moveRollSound") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.moveRollSound = trap->S_RegisterSound(token.string);
 			}
@@ -1500,7 +1500,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "moveJumpSound") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.moveJumpSound = trap->S_RegisterSound(token.string);
 			}
@@ -1509,7 +1509,7 @@ static qboolean Asset_Parse(int handle)
 		}
 		if (Q_stricmp(token.string, "datapadmoveSaberSound1") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound1 = trap->S_RegisterSound(token.string);
 			}
@@ -1519,7 +1519,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "datapadmoveSaberSound2") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound2 = trap->S_RegisterSound(token.string);
 			}
@@ -1529,7 +1529,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "datapadmoveSaberSound3") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound3 = trap->S_RegisterSound(token.string);
 			}
@@ -1539,7 +1539,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "datapadmoveSaberSound4") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound4 = trap->S_RegisterSound(token.string);
 			}
@@ -1549,7 +1549,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "datapadmoveSaberSound5") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound5 = trap->S_RegisterSound(token.string);
 			}
@@ -1559,7 +1559,7 @@ static qboolean Asset_Parse(int handle)
 
 		if (Q_stricmp(token.string, "datapadmoveSaberSound6") == 0)
 		{
-			if (trap->PC_ReadToken(handle, &token))
+			if (PC_CacheReadToken(handle, &token))
 			{
 				uiInfo.uiDC.Assets.datapadmoveSaberSound6 = trap->S_RegisterSound(token.string);
 			}
@@ -1596,7 +1596,9 @@ void UI_ParseMenu(const char* menuFile)
 {
 	pc_token_t token;
 
-	const int handle = trap->PC_LoadSource(menuFile);
+	// everything parsing menus goes through the compiled menu cache, see ui_shared.c
+	const int handle = ui_menuCache.integer ? PC_CacheLoadSource(menuFile, "ui/mdmp/menudef.h")
+		: trap->PC_LoadSource(menuFile);
 	if (!handle)
 	{
 		return;
@@ -1605,7 +1607,7 @@ void UI_ParseMenu(const char* menuFile)
 	while (1)
 	{
 		memset(&token, 0, sizeof(pc_token_t));
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 		{
 			break;
 		}
@@ -1640,7 +1642,7 @@ void UI_ParseMenu(const char* menuFile)
 			Menu_New(handle);
 		}
 	}
-	trap->PC_FreeSource(handle);
+	PC_CacheFreeSource(handle);
 }
 
 static qboolean Load_Menu(int handle)
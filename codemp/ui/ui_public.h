@@ -25,7 +25,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include <qcommon\q_shared.h>
 #include <rd-common\tr_types.h>
 
-#define UI_API_VERSION 4
+#define UI_API_VERSION 5
 #define UI_LEGACY_API_VERSION 7
 
 typedef struct uiClientState_s {
@@ -381,6 +381,10 @@ typedef struct uiImport_s {
 		void			(*AddCommand)							(const char* cmd_name);
 		void			(*RemoveCommand)						(const char* cmd_name);
 	} ext;
+
+	// interned StringEd lookups, resolve a reference once then fetch it by handle
+	int				(*SE_GetStringHandle)					(const char* text);
+	qboolean(*SE_GetStringFromHandle)				(int handle, char* buffer, int bufferLength);
 } uiImport_t;
 
 typedef struct uiExport_s {
@@ -317,6 +317,532 @@ void String_Init()
 	}
 }
 
+/*
+===============================================================================
+
+COMPILED MENU CACHE
+
+Running a .menu file through the precompiler costs a token_t alloc per token plus
+all the #define and #include expansion, which adds up over the whole menu set. So
+the first time a menu is parsed the expanded token stream gets recorded, and is
+written out to menucache/<menu file>.mnc in the home path along with a checksum
+of every file that went into it (the menu itself, whatever it #includes, and the
+global defines). From then on, as long as those checksums still match, the parse
+code is fed straight from the compiled tokens and the precompiler isn't touched.
+
+The PC_Cache* functions take precompiler handles as well, and just pass those on,
+so any of the parse code can be handed either kind.
+
+===============================================================================
+*/
+
+#define MENUCACHE_IDENT			(('C'<<24)+('N'<<16)+('M'<<8)+'M')
+#define MENUCACHE_VERSION		1
+#define MENUCACHE_MAX_SOURCES	64
+#define MENUCACHE_MAX_OPEN		4
+#define MENUCACHE_HANDLE_BASE	0x10000	// precompiler handles are always well below this
+
+typedef struct menuCacheHeader_s
+{
+	int ident;
+	int version;
+	int tokenSize; // sizeof(pc_token_t) when written, in case MAX_TOKENLENGTH ever changes
+	int numSources;
+	int numTokens;
+	int stringBytes;
+} menuCacheHeader_t;
+
+typedef struct menuCacheSource_s
+{
+	char name[MAX_QPATH];
+	int length; // -1 if it wasn't there
+	unsigned int checksum;
+} menuCacheSource_t;
+
+typedef struct menuCacheToken_s
+{
+	int type;
+	int subtype;
+	int intvalue;
+	float floatvalue;
+	int string; // offset into the string block
+	int source; // index into the source list, for error reporting
+	int line;
+} menuCacheToken_t;
+
+typedef struct menuCacheFile_s
+{
+	qboolean inUse;
+	int pcHandle; // precompiler handle while recording, 0 when playing back
+	qboolean recordFailed;
+	char cacheName[MAX_QPATH];
+	menuCacheHeader_t header;
+	menuCacheSource_t sources[MENUCACHE_MAX_SOURCES];
+	menuCacheToken_t* tokens;
+	char* strings;
+	int maxTokens;
+	int maxStringBytes;
+	int readPos; // next token to play back
+} menuCacheFile_t;
+
+static menuCacheFile_t menuCacheFiles[MENUCACHE_MAX_OPEN];
+
+/*
+=================
+MenuCache_ChecksumFile
+=================
+*/
+static void MenuCache_ChecksumFile(menuCacheSource_t* source, char** text)
+{
+	fileHandle_t f;
+	const int len = trap->FS_Open(source->name, &f, FS_READ);
+
+	source->length = -1;
+	source->checksum = 0;
+	if (text)
+	{
+		*text = NULL;
+	}
+
+	if (!f)
+	{
+		return;
+	}
+
+	char* buf = malloc(len + 1);
+	trap->FS_Read(buf, len, f);
+	trap->FS_Close(f);
+	buf[len] = '\0';
+
+	// FNV-1a
+	unsigned int checksum = 2166136261u;
+	for (int i = 0; i < len; i++)
+	{
+		checksum = (checksum ^ (unsigned char)buf[i]) * 16777619u;
+	}
+
+	source->length = len;
+	source->checksum = checksum;
+
+	if (text)
+	{
+		*text = buf;
+	}
+	else
+	{
+		free(buf);
+	}
+}
+
+/*
+=================
+MenuCache_AddSource
+=================
+*/
+static int MenuCache_AddSource(menuCacheFile_t* file, const char* name)
+{
+	int i;
+
+	for (i = 0; i < file->header.numSources; i++)
+	{
+		if (!Q_stricmp(file->sources[i].name, name))
+		{
+			return i;
+		}
+	}
+
+	if (i == MENUCACHE_MAX_SOURCES)
+	{
+		file->recordFailed = qtrue;
+		return 0;
+	}
+
+	Q_strncpyz(file->sources[i].name, name, sizeof file->sources[i].name);
+	file->header.numSources++;
+
+	return i;
+}
+
+/*
+=================
+MenuCache_AddIncludes
+
+A header that's nothing but #defines never produces a token, so the
+#include lines are picked out of the text to make sure they get checksummed too
+=================
+*/
+static void MenuCache_AddIncludes(menuCacheFile_t* file, const char* text)
+{
+	const char* p = text;
+
+	while ((p = strstr(p, "#include")) != NULL)
+	{
+		char name[MAX_QPATH];
+		int len = 0;
+
+		p += 8;
+		while (*p == ' ' || *p == '\t')
+		{
+			p++;
+		}
+		if (*p != '"' && *p != '<')
+		{
+			continue;
+		}
+
+		const char endChar = *p == '"' ? '"' : '>';
+		p++;
+		while (*p && *p != endChar && *p != '\n' && len < MAX_QPATH - 1)
+		{
+			name[len++] = *p == '\\' ? '/' : *p;
+			p++;
+		}
+		name[len] = '\0';
+
+		if (len)
+		{
+			MenuCache_AddSource(file, name);
+		}
+	}
+}
+
+/*
+=================
+MenuCache_Open
+=================
+*/
+static menuCacheFile_t* MenuCache_Open(const char* filename)
+{
+	for (int i = 0; i < MENUCACHE_MAX_OPEN; i++)
+	{
+		menuCacheFile_t* file = &menuCacheFiles[i];
+
+		if (!file->inUse)
+		{
+			memset(file, 0, sizeof * file);
+			file->inUse = qtrue;
+			Com_sprintf(file->cacheName, sizeof file->cacheName, "menucache/%s", filename);
+			COM_StripExtension(file->cacheName, file->cacheName, sizeof file->cacheName);
+			Q_strcat(file->cacheName, sizeof file->cacheName, ".mnc");
+			return file;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+=================
+MenuCache_Close
+=================
+*/
+static void MenuCache_Close(menuCacheFile_t* file)
+{
+	free(file->tokens);
+	free(file->strings);
+	file->tokens = NULL;
+	file->strings = NULL;
+	file->inUse = qfalse;
+}
+
+/*
+=================
+MenuCache_Read
+
+Loads the compiled tokens if every source still checksums the same
+=================
+*/
+static qboolean MenuCache_Read(menuCacheFile_t* file)
+{
+	fileHandle_t f;
+	const int len = trap->FS_Open(file->cacheName, &f, FS_READ);
+
+	if (!f)
+	{
+		return qfalse;
+	}
+
+	menuCacheHeader_t* header = &file->header;
+	qboolean valid = qfalse;
+
+	if (len >= (int)sizeof * header)
+	{
+		trap->FS_Read(header, sizeof * header, f);
+
+		valid = header->ident == MENUCACHE_IDENT && header->version == MENUCACHE_VERSION &&
+			header->tokenSize == (int)sizeof(pc_token_t) &&
+			header->numSources > 0 && header->numSources <= MENUCACHE_MAX_SOURCES &&
+			header->numTokens >= 0 && header->stringBytes >= 0 &&
+			len == (int)(sizeof * header + header->numSources * sizeof(menuCacheSource_t) +
+				header->numTokens * sizeof(menuCacheToken_t)) + header->stringBytes;
+	}
+
+	if (valid)
+	{
+		trap->FS_Read(file->sources, header->numSources * sizeof(menuCacheSource_t), f);
+
+		for (int i = 0; i < header->numSources && valid; i++)
+		{
+			menuCacheSource_t current = file->sources[i];
+
+			MenuCache_ChecksumFile(&current, NULL);
+			valid = current.length == file->sources[i].length && current.checksum == file->sources[i].checksum;
+		}
+	}
+
+	if (valid)
+	{
+		file->tokens = malloc(header->numTokens * sizeof(menuCacheToken_t) + 1);
+		file->strings = malloc(header->stringBytes + 1);
+		trap->FS_Read(file->tokens, header->numTokens * sizeof(menuCacheToken_t), f);
+		trap->FS_Read(file->strings, header->stringBytes, f);
+		file->strings[header->stringBytes] = '\0';
+
+		for (int i = 0; i < header->numTokens && valid; i++)
+		{
+			const menuCacheToken_t* token = &file->tokens[i];
+
+			valid = token->string >= 0 && token->string < header->stringBytes &&
+				token->source >= 0 && token->source < header->numSources;
+		}
+	}
+
+	trap->FS_Close(f);
+
+	return valid;
+}
+
+/*
+=================
+MenuCache_Record
+=================
+*/
+static void MenuCache_Record(menuCacheFile_t* file, const pc_token_t* token)
+{
+	char filename[1024];
+	int line = 0;
+	const int stringLen = strlen(token->string) + 1;
+
+	if (file->header.numTokens == file->maxTokens)
+	{
+		file->maxTokens = file->maxTokens ? file->maxTokens * 2 : 4096;
+		file->tokens = realloc(file->tokens, file->maxTokens * sizeof(menuCacheToken_t));
+	}
+	while (file->header.stringBytes + stringLen > file->maxStringBytes)
+	{
+		file->maxStringBytes = file->maxStringBytes ? file->maxStringBytes * 2 : 32768;
+		file->strings = realloc(file->strings, file->maxStringBytes);
+	}
+
+	filename[0] = '\0';
+	trap->PC_SourceFileAndLine(file->pcHandle, filename, &line);
+
+	menuCacheToken_t* out = &file->tokens[file->header.numTokens++];
+	out->type = token->type;
+	out->subtype = token->subtype;
+	out->intvalue = token->intvalue;
+	out->floatvalue = token->floatvalue;
+	out->string = file->header.stringBytes;
+	out->source = MenuCache_AddSource(file, filename);
+	out->line = line;
+
+	memcpy(file->strings + file->header.stringBytes, token->string, stringLen);
+	file->header.stringBytes += stringLen;
+}
+
+/*
+=================
+MenuCache_Write
+=================
+*/
+static void MenuCache_Write(menuCacheFile_t* file)
+{
+	fileHandle_t f;
+	menuCacheHeader_t* header = &file->header;
+
+	// checksum everything that went in, pulling in #includes as they turn up (the list grows as this goes)
+	for (int i = 0; i < header->numSources; i++)
+	{
+		char* text;
+
+		MenuCache_ChecksumFile(&file->sources[i], &text);
+		if (text)
+		{
+			MenuCache_AddIncludes(file, text);
+			free(text);
+		}
+	}
+
+	if (file->recordFailed)
+	{
+		return;
+	}
+
+	header->ident = MENUCACHE_IDENT;
+	header->version = MENUCACHE_VERSION;
+	header->tokenSize = sizeof(pc_token_t);
+
+	trap->FS_Open(file->cacheName, &f, FS_WRITE);
+	if (!f)
+	{
+		return;
+	}
+
+	trap->FS_Write(header, sizeof * header, f);
+	trap->FS_Write(file->sources, header->numSources * sizeof(menuCacheSource_t), f);
+	trap->FS_Write(file->tokens, header->numTokens * sizeof(menuCacheToken_t), f);
+	trap->FS_Write(file->strings, header->stringBytes, f);
+	trap->FS_Close(f);
+}
+
+/*
+=================
+PC_CacheLoadSource
+
+globalDefines is the file the caller has loaded with PC_LoadGlobalDefines, if any
+=================
+*/
+int PC_CacheLoadSource(const char* filename, const char* globalDefines)
+{
+	menuCacheFile_t* file = MenuCache_Open(filename);
+
+	if (!file)
+	{
+		return trap->PC_LoadSource(filename);
+	}
+
+	if (MenuCache_Read(file))
+	{
+		return MENUCACHE_HANDLE_BASE + (file - menuCacheFiles);
+	}
+
+	// no good, so parse it for real and record it on the way through
+	free(file->tokens);
+	free(file->strings);
+	file->tokens = NULL;
+	file->strings = NULL;
+	memset(&file->header, 0, sizeof file->header);
+
+	file->pcHandle = trap->PC_LoadSource(filename);
+	if (!file->pcHandle)
+	{
+		MenuCache_Close(file);
+		return 0;
+	}
+
+	MenuCache_AddSource(file, filename);
+	if (globalDefines)
+	{
+		MenuCache_AddSource(file, globalDefines);
+	}
+
+	return MENUCACHE_HANDLE_BASE + (file - menuCacheFiles);
+}
+
+/*
+=================
+PC_CacheFreeSource
+=================
+*/
+int PC_CacheFreeSource(const int handle)
+{
+	if (handle < MENUCACHE_HANDLE_BASE)
+	{
+		return trap->PC_FreeSource(handle);
+	}
+
+	menuCacheFile_t* file = &menuCacheFiles[handle - MENUCACHE_HANDLE_BASE];
+
+	if (file->pcHandle)
+	{
+		pc_token_t token;
+
+		// the parse may have stopped early, the cache has to hold all of it
+		while (trap->PC_ReadToken(file->pcHandle, &token))
+		{
+			MenuCache_Record(file, &token);
+		}
+
+		MenuCache_Write(file);
+		trap->PC_FreeSource(file->pcHandle);
+	}
+
+	MenuCache_Close(file);
+
+	return qtrue;
+}
+
+/*
+=================
+PC_CacheReadToken
+=================
+*/
+int PC_CacheReadToken(const int handle, pc_token_t* token)
+{
+	if (handle < MENUCACHE_HANDLE_BASE)
+	{
+		return trap->PC_ReadToken(handle, token);
+	}
+
+	menuCacheFile_t* file = &menuCacheFiles[handle - MENUCACHE_HANDLE_BASE];
+
+	if (file->pcHandle)
+	{
+		if (!trap->PC_ReadToken(file->pcHandle, token))
+		{
+			return qfalse;
+		}
+
+		MenuCache_Record(file, token);
+		return qtrue;
+	}
+
+	if (file->readPos >= file->header.numTokens)
+	{
+		return qfalse;
+	}
+
+	const menuCacheToken_t* in = &file->tokens[file->readPos++];
+	token->type = in->type;
+	token->subtype = in->subtype;
+	token->intvalue = in->intvalue;
+	token->floatvalue = in->floatvalue;
+	Q_strncpyz(token->string, file->strings + in->string, sizeof token->string);
+
+	return qtrue;
+}
+
+/*
+=================
+PC_CacheSourceFileAndLine
+=================
+*/
+int PC_CacheSourceFileAndLine(const int handle, char* filename, int* line)
+{
+	if (handle < MENUCACHE_HANDLE_BASE)
+	{
+		return trap->PC_SourceFileAndLine(handle, filename, line);
+	}
+
+	const menuCacheFile_t* file = &menuCacheFiles[handle - MENUCACHE_HANDLE_BASE];
+
+	if (file->pcHandle)
+	{
+		return trap->PC_SourceFileAndLine(file->pcHandle, filename, line);
+	}
+
+	if (!file->readPos)
+	{
+		return qfalse;
+	}
+
+	const menuCacheToken_t* last = &file->tokens[file->readPos - 1];
+	strcpy(filename, file->sources[last->source].name);
+	*line = last->line;
+
+	return qtrue;
+}
+
 #if 0
 /*
 =================
@@ -335,7 +861,7 @@ static void PC_SourceWarning(int handle, char* format, ...) {
 
 	filename[0] = '\0';
 	line = 0;
-	trap->PC_SourceFileAndLine(handle, filename, &line);
+	PC_CacheSourceFileAndLine(handle, filename, &line);
 
 	Com_Printf(S_COLOR_YELLOW "WARNING: %s, line %d: %s\n", filename, line, string);
 }
@@ -359,7 +885,7 @@ static void PC_SourceError(const int handle, char* format, ...)
 
 	filename[0] = '\0';
 	line = 0;
-	trap->PC_SourceFileAndLine(handle, filename, &line);
+	PC_CacheSourceFileAndLine(handle, filename, &line);
 
 	Com_Printf(S_COLOR_RED "ERROR: %s, line %d: %s\n", filename, line, string);
 }
@@ -408,12 +934,12 @@ qboolean PC_Float_Parse(const int handle, float* f)
 	pc_token_t token;
 	int negative = qfalse;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 
 	if (token.string[0] == '-')
 	{
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 			return qfalse;
 		negative = qtrue;
 	}
@@ -496,11 +1022,11 @@ qboolean PC_Int_Parse(const int handle, int* i)
 	pc_token_t token;
 	int negative = qfalse;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 	if (token.string[0] == '-')
 	{
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 			return qfalse;
 		negative = qtrue;
 	}
@@ -586,7 +1112,7 @@ qboolean PC_String_Parse(const int handle, const char** out)
 {
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -618,7 +1144,7 @@ qboolean PC_Script_Parse(const int handle, const char** out)
 	// scripts start with { and have ; separated command lists.. commands are command, arg..
 	// basically we want everything between the { } as it will be interpreted at run time
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 	if (Q_stricmp(token.string, "{") != 0)
 	{
@@ -627,7 +1153,7 @@ qboolean PC_Script_Parse(const int handle, const char** out)
 
 	while (1)
 	{
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 			return qfalse;
 
 		if (Q_stricmp(token.string, "}") == 0)
@@ -4844,6 +5370,34 @@ void Item_TextColor(itemDef_t* item, vec4_t* newColor)
 	}
 }
 
+/*
+=================
+String_GetRef
+
+Looks up a StringEd reference, caching its handle in ref so repeat paints of the
+same item text skip the string hash. The handle is re-resolved whenever the text
+pointer changes. A NULL ref, or a legacy syscall build with no handle imports, uses
+the plain lookup
+=================
+*/
+static void String_GetRef(const char* reference, stringRef_t* ref, char* buffer, const int bufferLength)
+{
+	if (ref && trap->SE_GetStringHandle && trap->SE_GetStringFromHandle)
+	{
+		if (ref->text != reference)
+		{
+			ref->text = reference;
+			ref->handle = trap->SE_GetStringHandle(reference);
+		}
+		if (ref->handle)
+		{
+			trap->SE_GetStringFromHandle(ref->handle, buffer, bufferLength);
+			return;
+		}
+	}
+	trap->SE_GetStringTextString(reference, buffer, bufferLength);
+}
+
 void Item_Text_AutoWrapped_Paint(itemDef_t* item)
 {
 	char text[2048];
@@ -4869,7 +5423,7 @@ void Item_Text_AutoWrapped_Paint(itemDef_t* item)
 	}
 	if (*textPtr == '@') // string reference
 	{
-		trap->SE_GetStringTextString(&textPtr[1], text, sizeof text);
+		String_GetRef(&textPtr[1], item->text ? &item->textRef : NULL, text, sizeof text);
 		textPtr = text;
 	}
 	if (*textPtr == '\0')
@@ -4966,7 +5520,7 @@ void Item_Text_Wrapped_Paint(itemDef_t* item)
 	}
 	if (*textPtr == '@') // string reference
 	{
-		trap->SE_GetStringTextString(&textPtr[1], text, sizeof text);
+		String_GetRef(&textPtr[1], item->text ? &item->textRef : NULL, text, sizeof text);
 		textPtr = text;
 	}
 	if (*textPtr == '\0')
@@ -5026,7 +5580,7 @@ void Item_Text_Paint(itemDef_t* item)
 	}
 	if (*textPtr == '@') // string reference
 	{
-		trap->SE_GetStringTextString(&textPtr[1], text, sizeof text);
+		String_GetRef(&textPtr[1], item->text ? &item->textRef : NULL, text, sizeof text);
 		textPtr = text;
 	}
 
@@ -5048,7 +5602,7 @@ void Item_Text_Paint(itemDef_t* item)
 		textPtr = item->text2;
 		if (*textPtr == '@') // string reference
 		{
-			trap->SE_GetStringTextString(&textPtr[1], text, sizeof text);
+			String_GetRef(&textPtr[1], &item->text2Ref, text, sizeof text);
 			textPtr = text;
 		}
 		Item_TextColor(item, &color);
@@ -7418,7 +7972,7 @@ qboolean ItemParse_name(itemDef_t* item, const int handle)
 qboolean ItemParse_focusSound(itemDef_t* item, const int handle)
 {
 	pc_token_t token;
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -7686,7 +8240,7 @@ qboolean ItemParse_asset_model(itemDef_t* item, const int handle)
 
 	Item_ValidateTypeData(item);
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -7708,7 +8262,7 @@ qboolean ItemParse_asset_model(itemDef_t* item, const int handle)
 qboolean ItemParse_asset_shader(itemDef_t* item, const int handle)
 {
 	pc_token_t token;
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -7851,7 +8405,7 @@ qboolean ItemParse_model_g2skin(itemDef_t* item, const int handle)
 	Item_ValidateTypeData(item);
 	modelDef_t* modelPtr = item->typeData.model;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -7876,7 +8430,7 @@ qboolean ItemParse_model_g2anim(itemDef_t* item, const int handle)
 	Item_ValidateTypeData(item);
 	modelDef_t* modelPtr = item->typeData.model;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -7965,7 +8519,7 @@ qboolean ItemParse_rectcvar(itemDef_t* item, const int handle)
 
 	// get Cvar name
 	pc_token_t token;
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -8017,7 +8571,7 @@ qboolean ItemParse_flag(itemDef_t* item, const int handle)
 	int i;
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -8440,7 +8994,7 @@ qboolean ItemParse_background(itemDef_t* item, const int handle)
 {
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -8700,7 +9254,7 @@ qboolean ItemParse_cvarStrList(itemDef_t* item, const int handle)
 	multiPtr->count = 0;
 	multiPtr->strDef = qtrue;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -8794,7 +9348,7 @@ qboolean ItemParse_cvarFloatList(itemDef_t* item, const int handle)
 	multiPtr->count = 0;
 	multiPtr->strDef = qfalse;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -9193,7 +9747,7 @@ qboolean Item_Parse(const int handle, itemDef_t* item)
 {
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 
 	if (*token.string != '{')
@@ -9202,7 +9756,7 @@ qboolean Item_Parse(const int handle, itemDef_t* item)
 	}
 	while (1)
 	{
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 		{
 			PC_SourceError(handle, "end of file inside menu item");
 			return qfalse;
@@ -9808,7 +10362,7 @@ qboolean MenuParse_background(itemDef_t* item, const int handle)
 	pc_token_t token;
 	menuDef_t* menu = (menuDef_t*)item;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 	{
 		return qfalse;
 	}
@@ -10012,7 +10566,7 @@ qboolean Menu_Parse(const int handle, menuDef_t* menu)
 {
 	pc_token_t token;
 
-	if (!trap->PC_ReadToken(handle, &token))
+	if (!PC_CacheReadToken(handle, &token))
 		return qfalse;
 	if (*token.string != '{')
 	{
@@ -10021,7 +10575,7 @@ qboolean Menu_Parse(const int handle, menuDef_t* menu)
 
 	while (1)
 	{
-		if (!trap->PC_ReadToken(handle, &token))
+		if (!PC_CacheReadToken(handle, &token))
 		{
 			PC_SourceError(handle, "end of file inside menu");
 			return qfalse;
@@ -274,6 +274,12 @@ typedef struct textScrollDef_s
 
 #define ITF_ISANYSABER		(ITF_ISSABER|ITF_ISSABER2)	//either saber
 
+// an "@REF" StringEd reference resolved once to a handle, see String_GetRef
+typedef struct stringRef_s {
+	const char* text;						// the reference the handle was resolved from
+	int			handle;						// 0 if unresolved or not a valid reference
+} stringRef_t;
+
 typedef struct itemDef_s {
 	windowDef_t	window;						// common positional, border, style, layout info
 	rectDef_t	textRect;					// rectangle the text ( if any ) consumes
@@ -286,6 +292,8 @@ typedef struct itemDef_s {
 	int			textStyle;					// ( optional ) style, normal and shadowed are it for now
 	const char* text;						// display text
 	const char* text2;						// display text, 2nd line
+	stringRef_t	textRef;					// StringEd handle for an "@" text
+	stringRef_t	text2Ref;					// StringEd handle for an "@" text2
 	float		text2alignx;				// ( optional ) text2 alignment x coord
 	float		text2aligny;				// ( optional ) text2 alignment y coord
 	void* parent;					// menu owner
@@ -539,6 +547,10 @@ qboolean PC_Int_Parse(int handle, int* i);
 qboolean PC_Rect_Parse(int handle, rectDef_t* r);
 qboolean PC_String_Parse(int handle, const char** out);
 qboolean PC_Script_Parse(int handle, const char** out);
+int PC_CacheLoadSource(const char* filename, const char* globalDefines);
+int PC_CacheFreeSource(int handle);
+int PC_CacheReadToken(int handle, pc_token_t* token);
+int PC_CacheSourceFileAndLine(int handle, char* filename, int* line);
 int Menu_Count();
 void Menu_New(int handle);
 void Menu_PaintAll();
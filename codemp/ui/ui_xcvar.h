@@ -94,6 +94,7 @@ XCVAR_DEF(ui_lastServerRefresh_4, "", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
 XCVAR_DEF(ui_lastServerRefresh_5, "", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
 XCVAR_DEF(ui_lastServerRefresh_6, "", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
 XCVAR_DEF(ui_mapIndex, "0", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
+XCVAR_DEF(ui_menuCache, "1", NULL, CVAR_ARCHIVE)
 XCVAR_DEF(ui_menuFilesMP, "ui/MovieDuels-mpmenus.txt", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
 XCVAR_DEF(ui_netGametype, "0", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)
 XCVAR_DEF(ui_netSource, "1", NULL, CVAR_ARCHIVE | CVAR_INTERNAL)